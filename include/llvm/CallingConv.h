@@ -94,7 +94,12 @@ namespace CallingConv {
 
     /// MBLAZE_INTR - Calling convention used for MBlaze interrupt support
     /// routines (i.e. GCC's save_volatiles attribute).
-    MBLAZE_SVOL = 74
+    MBLAZE_SVOL = 74,
+
+    /// ARC_INTR1, ARC_INTR2 - Calling conventions used for ARCompact level 1
+    /// and level 2 interrupt routines, which return through ILINK1 and ILINK2.
+    ARC_INTR1 = 75,
+    ARC_INTR2 = 76
   };
 } // End CallingConv namespace
 
@@ -1414,6 +1414,42 @@ error_code ELFObjectFile<target_endianness, is64Bits>
       res = "Unknown";
     }
     break;
+  case ELF::EM_ARC_COMPACT:
+    switch (type) {
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_NONE);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_8);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_16);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_24);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_32);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_N8);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_N16);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_N24);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_N32);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_SDA);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_SECTOFF);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_S21H_PCREL);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_S21W_PCREL);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_S25H_PCREL);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_S25W_PCREL);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_SDA32);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_SDA_LDST);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_SDA_LDST1);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_SDA_LDST2);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_SDA16_LD);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_SDA16_LD1);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_SDA16_LD2);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_S13_PCREL);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_W);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_32_ME);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_N32_ME);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_SECTOFF_ME);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_SDA32_ME);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_W_ME);
+      LLVM_ELF_SWITCH_RELOC_TYPE_NAME(R_ARC_PC32);
+    default:
+      res = "Unknown";
+    }
+    break;
   default:
     res = "Unknown";
   }
@@ -1489,6 +1525,15 @@ error_code ELFObjectFile<target_endianness, is64Bits>
       res = "Unknown";
     }
     break;
+  case ELF::EM_ARC_COMPACT: {
+      // All of the relocations have an explicit addend.
+      std::string fmtbuf;
+      raw_string_ostream fmt(fmtbuf);
+      fmt << symname << (addend < 0 ? "" : "+") << addend;
+      fmt.flush();
+      Result.append(fmtbuf.begin(), fmtbuf.end());
+    }
+    break;
   default:
     res = "Unknown";
   }
@@ -1888,6 +1933,8 @@ StringRef ELFObjectFile<target_endianness, is64Bits>
       return "ELF32-x86-64";
     case ELF::EM_ARM:
       return "ELF32-arm";
+    case ELF::EM_ARC_COMPACT:
+      return "ELF32-arcompact";
     default:
       return "ELF32-unknown";
     }
@@ -1915,6 +1962,8 @@ unsigned ELFObjectFile<target_endianness, is64Bits>::getArch() const {
     return Triple::x86_64;
   case ELF::EM_ARM:
     return Triple::arm;
+  case ELF::EM_ARC_COMPACT:
+    return Triple::arcompact;
   default:
     return Triple::UnknownArch;
   }
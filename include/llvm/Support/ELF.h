@@ -674,6 +674,42 @@ enum {
   R_MIPS_NUM               = 218
 };
 
+// ELF Relocation types for ARCompact
+enum {
+  R_ARC_NONE               = 0x00,
+  R_ARC_8                  = 0x01,
+  R_ARC_16                 = 0x02,
+  R_ARC_24                 = 0x03,
+  R_ARC_32                 = 0x04,
+  R_ARC_N8                 = 0x08,
+  R_ARC_N16                = 0x09,
+  R_ARC_N24                = 0x0a,
+  R_ARC_N32                = 0x0b,
+  R_ARC_SDA                = 0x0c,
+  R_ARC_SECTOFF            = 0x0d,
+  R_ARC_S21H_PCREL         = 0x0e,
+  R_ARC_S21W_PCREL         = 0x0f,
+  R_ARC_S25H_PCREL         = 0x10,
+  R_ARC_S25W_PCREL         = 0x11,
+  R_ARC_SDA32              = 0x12,
+  R_ARC_SDA_LDST           = 0x13,
+  R_ARC_SDA_LDST1          = 0x14,
+  R_ARC_SDA_LDST2          = 0x15,
+  R_ARC_SDA16_LD           = 0x16,
+  R_ARC_SDA16_LD1          = 0x17,
+  R_ARC_SDA16_LD2          = 0x18,
+  R_ARC_S13_PCREL          = 0x19,
+  R_ARC_W                  = 0x1a,
+  R_ARC_32_ME              = 0x1b,
+  R_ARC_N32_ME             = 0x1c,
+  R_ARC_SECTOFF_ME         = 0x1d,
+  R_ARC_SDA32_ME           = 0x1e,
+  R_ARC_W_ME               = 0x1f,
+  R_ARC_PC32               = 0x32,
+  R_ARC_GOTPC32            = 0x33,
+  R_ARC_PLT32              = 0x34
+};
+
 // Section header.
 struct Elf32_Shdr {
   Elf32_Word sh_name;      // Section name (index into string table)
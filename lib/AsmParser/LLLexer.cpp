@@ -518,6 +518,8 @@ lltok::Kind LLLexer::LexIdentifier() {
   KEYWORD(arm_aapcscc);
   KEYWORD(arm_aapcs_vfpcc);
   KEYWORD(msp430_intrcc);
+  KEYWORD(arc_intr1cc);
+  KEYWORD(arc_intr2cc);
   KEYWORD(ptx_kernel);
   KEYWORD(ptx_device);
 
@@ -76,6 +76,7 @@ namespace lltok {
     kw_x86_stdcallcc, kw_x86_fastcallcc, kw_x86_thiscallcc,
     kw_arm_apcscc, kw_arm_aapcscc, kw_arm_aapcs_vfpcc,
     kw_msp430_intrcc,
+    kw_arc_intr1cc, kw_arc_intr2cc,
     kw_ptx_kernel, kw_ptx_device,
 
     kw_signext,
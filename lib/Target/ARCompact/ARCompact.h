@@ -16,6 +16,7 @@
 #define TARGET_ARCOMPACT_H
 
 #include "MCTargetDesc/ARCompactMCTargetDesc.h"
+#include "llvm/MC/MCInst.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Target/TargetMachine.h"
 #include <cassert>
@@ -93,10 +94,60 @@ namespace llvm {
   // Forward declarations.
   class ARCompactTargetMachine;
   class FunctionPass;
+  class Pass;
   class formatted_raw_ostream;
 
   FunctionPass *createARCompactISelDag(ARCompactTargetMachine &TM,
       CodeGenOpt::Level OptLevel);
+  Pass *createARCompactCountedLoopsPass(ARCompactTargetMachine &TM);
+  FunctionPass *createARCompactHardwareLoopsPass();
+  FunctionPass *createARCompactBranchFusionPass();
+  FunctionPass *createARCompactSizeReductionPass();
+  FunctionPass *createARCompactDelaySlotFillerPass();
+
+  /// shortenARCompactBranch - Converts Inst into the 16-bit form of the same
+  /// branch or call where one exists. The assembler backend relaxes these back
+  /// to the 32-bit forms if the target turns out to be out of range.
+  inline static void shortenARCompactBranch(MCInst &Inst) {
+    MCInst ShortInst;
+
+    switch (Inst.getOpcode()) {
+      default:
+        return;
+      case ARC::B:
+        ShortInst.setOpcode(ARC::B_S);
+        break;
+      case ARC::BLi:
+        ShortInst.setOpcode(ARC::BL_S);
+        break;
+      case ARC::BCC:
+        switch (Inst.getOperand(1).getImm()) {
+          default:
+            // The remaining conditions have no 16-bit form.
+            return;
+          case ARCCC::COND_EQ:
+            ShortInst.setOpcode(ARC::BEQ_S);
+            break;
+          case ARCCC::COND_NE:
+            ShortInst.setOpcode(ARC::BNE_S);
+            break;
+          case ARCCC::COND_GT: case ARCCC::COND_GE:
+          case ARCCC::COND_LT: case ARCCC::COND_LE:
+          case ARCCC::COND_HI: case ARCCC::COND_HS:
+          case ARCCC::COND_LO: case ARCCC::COND_LS:
+            ShortInst.setOpcode(ARC::BCC_S);
+            ShortInst.addOperand(Inst.getOperand(0));
+            ShortInst.addOperand(Inst.getOperand(1));
+            Inst = ShortInst;
+            return;
+        }
+        break;
+    }
+
+    // Only the target operand is kept.
+    ShortInst.addOperand(Inst.getOperand(0));
+    Inst = ShortInst;
+  }
 } // end namespace llvm;
 
 #endif
@@ -20,6 +20,7 @@
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/CodeGen/AsmPrinter.h"
+#include "llvm/CodeGen/MachineBasicBlock.h"
 #include "llvm/MC/MCInst.h"
 #include "llvm/MC/MCStreamer.h"
 #include "llvm/MC/MCSymbol.h"
@@ -49,6 +50,8 @@ namespace {
     //                           unsigned OpNo, unsigned AsmVariant,
     //                           const char *ExtraCode, raw_ostream &O);
     void EmitInstruction(const MachineInstr *MI);
+    virtual bool
+    isBlockOnlyReachableByFallthrough(const MachineBasicBlock *MBB) const;
   };
 } // end of anonymous namespace
 
@@ -59,8 +62,7 @@ void ARCompactAsmPrinter::printOperand(const MachineInstr *MI, int OpNum,
   switch (MO.getType()) {
     // A register.
     case MachineOperand::MO_Register:
-      O << StringRef(
-          ARCompactInstPrinter::getRegisterName(MO.getReg())).lower();
+      O << ARCompactInstPrinter::getRegisterName(MO.getReg());
       return;
 
     // An immediate.
@@ -91,6 +93,11 @@ void ARCompactAsmPrinter::printOperand(const MachineInstr *MI, int OpNum,
       O << "@" << MO.getSymbolName();
       return;
 
+    // A jump table.
+    case MachineOperand::MO_JumpTableIndex:
+      O << "@" << *GetJTISymbol(MO.getIndex());
+      return;
+
     default:
       llvm_unreachable("Unknown operand type!");
   }
@@ -138,14 +145,53 @@ void ARCompactAsmPrinter::printMemOperand(const MachineInstr *MI, int OpNum,
 //}
 //
 //===----------------------------------------------------------------------===//
+
 void ARCompactAsmPrinter::EmitInstruction(const MachineInstr *MI) {
+  // The end of a hardware loop is only marked by the label following it.
+  if (MI->getOpcode() == ARC::LOOP_END)
+    return;
+
   ARCompactMCInstLower MCInstLowering(OutContext, *this);
 
   MCInst TmpInst;
   MCInstLowering.Lower(MI, TmpInst);
+
+  // Textual assembly is left to the assembler to relax, but when writing an
+  // object file directly branches start off in their short forms.
+  if (!OutStreamer.hasRawTextSupport())
+    shortenARCompactBranch(TmpInst);
+
   OutStreamer.EmitInstruction(TmpInst);
 }
 
+/// isBlockOnlyReachableByFallthrough - The generic version of this only looks
+/// at the terminators at the end of the predecessor, and so misses any branch
+/// to MBB which is followed by a filled delay slot. It also cannot know that
+/// the block following the end of a hardware loop is the target of its LP.
+bool ARCompactAsmPrinter::
+isBlockOnlyReachableByFallthrough(const MachineBasicBlock *MBB) const {
+  if (!AsmPrinter::isBlockOnlyReachableByFallthrough(MBB))
+    return false;
+
+  const MachineBasicBlock *Pred = *MBB->pred_begin();
+  for (MachineBasicBlock::const_iterator I = Pred->begin(), E = Pred->end();
+       I != E; ++I) {
+    if (I->getOpcode() == ARC::LOOP_END)
+      return false;
+
+    if (!I->getDesc().hasDelaySlot())
+      continue;
+
+    for (unsigned i = 0, e = I->getNumOperands(); i != e; ++i) {
+      const MachineOperand &MO = I->getOperand(i);
+      if (MO.isMBB() && MO.getMBB() == MBB)
+        return false;
+    }
+  }
+
+  return true;
+}
+
 // Force static initialization.
 extern "C" void LLVMInitializeARCompactAsmPrinter() {
   RegisterAsmPrinter<ARCompactAsmPrinter> X(TheARCompactTarget);
@@ -0,0 +1,403 @@
+//===--- ARCompactBranchFusion.cpp - ARCompact compare-and-branch fusion --===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains a post-layout peephole that fuses a CMP and the Bcc
+// which follows it into a single compare-and-branch instruction: BRcc, or
+// BBIT0/BBIT1 when the CMP, or an AND.f, tests a single bit. These leave the
+// flags alone, but can only reach 256 bytes either side of the branch.
+//
+// The pass runs once the block layout is final, and before the size
+// reduction pass and the delay slot filler. The offsets it works out from
+// the 32-bit instruction sizes are therefore upper bounds, and fusing
+// branches only shrinks the code further, so a branch is fused when its
+// target is known to stay in range. Otherwise it falls back to leaving the
+// CMP and Bcc, whose range is much larger, in place.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "arcompact-branch-fusion"
+#include "ARCompact.h"
+#include "ARCompactInstrInfo.h"
+#include "llvm/CodeGen/MachineFunctionPass.h"
+#include "llvm/CodeGen/MachineInstrBuilder.h"
+#include "llvm/MC/MCAsmInfo.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace llvm;
+
+STATISTIC(NumBRcc, "Number of compares fused into BRcc");
+STATISTIC(NumBBIT, "Number of bit tests fused into BBIT0/BBIT1");
+STATISTIC(NumOutOfRange, "Number of compares left as their target may be "
+                         "out of range");
+
+static cl::opt<bool> DisableBranchFusion("disable-arcompact-branch-fusion",
+    cl::init(false),
+    cl::desc("Never use the ARCompact compare-and-branch instructions"),
+    cl::Hidden);
+
+namespace {
+  struct ARCompactBranchFusion : public MachineFunctionPass {
+    static char ID;
+    ARCompactBranchFusion() : MachineFunctionPass(ID) {}
+
+    const TargetInstrInfo *TII;
+    const MCAsmInfo *MAI;
+
+    // The estimated offset of the start of each block, by block number.
+    SmallVector<unsigned, 16> BlockOffsets;
+
+    virtual bool runOnMachineFunction(MachineFunction &MF);
+
+    virtual const char *getPassName() const {
+      return "ARCompact Branch Fusion";
+    }
+
+  private:
+    unsigned getInstSize(const MachineInstr *MI) const;
+    void computeBlockOffsets(MachineFunction &MF);
+    bool fuseBranch(MachineBasicBlock &MBB, MachineBasicBlock::iterator Branch,
+                    unsigned BranchOffset);
+  };
+  char ARCompactBranchFusion::ID = 0;
+}
+
+/// createARCompactBranchFusionPass - Returns an instance of the compare and
+/// branch fusion pass.
+FunctionPass *llvm::createARCompactBranchFusionPass() {
+  return new ARCompactBranchFusion();
+}
+
+/// isInBRccRange - Returns true if a BRcc at an offset somewhere between
+/// MinOffset and MaxOffset can reach TargetOffset. The displacement is taken
+/// from the 32-bit aligned address of the branch, and the delay slot filler
+/// may later move the branch back by up to one 32-bit instruction.
+static bool isInBRccRange(unsigned MinOffset, unsigned MaxOffset,
+                          unsigned TargetOffset) {
+  int64_t Longest = (int64_t)TargetOffset - MinOffset + 2 + 4;
+  int64_t Shortest = (int64_t)TargetOffset - MaxOffset;
+  return Longest <= 254 && Shortest >= -256;
+}
+
+/// isUnpredicated - Returns true if MI is always executed.
+static bool isUnpredicated(const MachineInstr *MI) {
+  int PIdx = MI->findFirstPredOperandIdx();
+  return PIdx == -1 || MI->getOperand(PIdx).getImm() == ARCCC::COND_AL;
+}
+
+/// getImmediateCompare - Returns true if MI compares a register against an
+/// immediate, setting Imm to the immediate.
+static bool getImmediateCompare(const MachineInstr *MI, int64_t &Imm) {
+  switch (MI->getOpcode()) {
+    default:
+      return false;
+    case ARC::CMPrui:
+    case ARC::CMPrsi:
+    case ARC::CMPrli:
+      Imm = MI->getOperand(1).getImm();
+      return true;
+  }
+}
+
+/// isModifiedBetween - Returns true if Reg is written by any instruction from
+/// From up to, but not including, To.
+static bool isModifiedBetween(MachineBasicBlock::iterator From,
+                              MachineBasicBlock::iterator To, unsigned Reg) {
+  for (; From != To; ++From) {
+    if (From->modifiesRegister(Reg, 0)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// isReadBeforeDef - Returns true if Reg is read by I, or by an instruction
+/// after it in MBB, before it is written. Sets Defined if it is written.
+static bool isReadBeforeDef(MachineBasicBlock &MBB,
+                            MachineBasicBlock::iterator I, unsigned Reg,
+                            bool &Defined) {
+  Defined = false;
+  for (; I != MBB.end(); ++I) {
+    if (I->readsRegister(Reg)) {
+      return true;
+    }
+    if (I->definesRegister(Reg)) {
+      Defined = true;
+      return false;
+    }
+  }
+  return false;
+}
+
+/// isDeadAfter - Returns true if the value of Reg after I is never read.
+/// STATUS32 is reserved, so it never appears in the live-in lists, and the
+/// blocks reached from MBB are searched for a read of the flags instead.
+static bool isDeadAfter(MachineBasicBlock &MBB, MachineBasicBlock::iterator I,
+                        unsigned Reg) {
+  bool Defined;
+  if (isReadBeforeDef(MBB, llvm::next(I), Reg, Defined)) {
+    return false;
+  }
+  if (Defined) {
+    return true;
+  }
+
+  if (Reg != ARC::STATUS32) {
+    for (MachineBasicBlock::succ_iterator SI = MBB.succ_begin(),
+         SE = MBB.succ_end(); SI != SE; ++SI) {
+      if ((*SI)->isLiveIn(Reg)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  SmallPtrSet<MachineBasicBlock *, 8> Visited;
+  SmallVector<MachineBasicBlock *, 8> Worklist(MBB.succ_begin(),
+                                               MBB.succ_end());
+  while (!Worklist.empty()) {
+    MachineBasicBlock *Succ = Worklist.pop_back_val();
+    if (!Visited.insert(Succ)) {
+      continue;
+    }
+    if (isReadBeforeDef(*Succ, Succ->begin(), Reg, Defined)) {
+      return false;
+    }
+    if (!Defined) {
+      Worklist.append(Succ->succ_begin(), Succ->succ_end());
+    }
+  }
+  return true;
+}
+
+/// getInstSize - Returns the largest size MI may have once it is emitted.
+unsigned ARCompactBranchFusion::getInstSize(const MachineInstr *MI) const {
+  if (MI->isInlineAsm()) {
+    return TII->getInlineAsmLength(MI->getOperand(0).getSymbolName(), *MAI);
+  }
+  return MI->getDesc().getSize();
+}
+
+/// computeBlockOffsets - Works out an upper bound on the offset of each
+/// block from the start of the function, allowing for the worst case
+/// padding of any aligned blocks.
+void ARCompactBranchFusion::computeBlockOffsets(MachineFunction &MF) {
+  BlockOffsets.assign(MF.getNumBlockIDs(), 0);
+
+  unsigned Offset = 0;
+  for (MachineFunction::iterator MBB = MF.begin(), E = MF.end();
+       MBB != E; ++MBB) {
+    if (MBB->getAlignment()) {
+      Offset += (1 << MBB->getAlignment()) - 2;
+    }
+    BlockOffsets[MBB->getNumber()] = Offset;
+
+    for (MachineBasicBlock::iterator I = MBB->begin(), IE = MBB->end();
+         I != IE; ++I) {
+      Offset += getInstSize(I);
+    }
+  }
+}
+
+bool ARCompactBranchFusion::runOnMachineFunction(MachineFunction &MF) {
+  if (DisableBranchFusion) {
+    return false;
+  }
+
+  TII = MF.getTarget().getInstrInfo();
+  MAI = MF.getTarget().getMCAsmInfo();
+  computeBlockOffsets(MF);
+
+  // The offsets are not updated as branches are fused, as that only ever
+  // brings the targets closer.
+  bool Changed = false;
+  for (MachineFunction::iterator MBB = MF.begin(), E = MF.end();
+       MBB != E; ++MBB) {
+    unsigned Offset = BlockOffsets[MBB->getNumber()];
+    for (MachineBasicBlock::iterator I = MBB->begin(); I != MBB->end(); ) {
+      MachineBasicBlock::iterator Branch = I++;
+      unsigned Size = getInstSize(Branch);
+      if (Branch->getOpcode() == ARC::BCC) {
+        Changed |= fuseBranch(*MBB, Branch, Offset);
+      }
+      Offset += Size;
+    }
+  }
+
+  return Changed;
+}
+
+/// fuseBranch - If Branch is preceded by the CMP which sets its flags, and
+/// its target is in range, replaces the two with a BRcc or BBIT.
+bool ARCompactBranchFusion::fuseBranch(MachineBasicBlock &MBB,
+                                       MachineBasicBlock::iterator Branch,
+                                       unsigned BranchOffset) {
+  MachineBasicBlock *Target = Branch->getOperand(0).getMBB();
+  ARCCC::CondCodes CC =
+      static_cast<ARCCC::CondCodes>(Branch->getOperand(1).getImm());
+
+  // Find the CMP, making sure that nothing in between touches the flags.
+  MachineBasicBlock::iterator Compare = Branch;
+  unsigned CompareOffset = BranchOffset;
+  for (;;) {
+    if (Compare == MBB.begin()) {
+      return false;
+    }
+    --Compare;
+    CompareOffset -= getInstSize(Compare);
+
+    if (Compare->definesRegister(ARC::STATUS32)) {
+      break;
+    }
+    if (Compare->readsRegister(ARC::STATUS32) || !isUnpredicated(Compare) ||
+        Compare->isCall() || Compare->isInlineAsm()) {
+      return false;
+    }
+  }
+
+  // OptimizeCompareInstr turns "and rT,rB,(1 << n); cmp rT,0" into an AND
+  // which sets the flags itself. That still tests a single bit of rB.
+  unsigned Opcode = Compare->getOpcode();
+  bool IsFlagBitTest = Opcode == ARC::ANDrui_f || Opcode == ARC::ANDrli_f;
+  if (IsFlagBitTest) {
+    if ((CC != ARCCC::COND_EQ && CC != ARCCC::COND_NE) ||
+        !isPowerOf2_32(Compare->getOperand(2).getImm()) ||
+        !isDeadAfter(MBB, Compare, Compare->getOperand(0).getReg())) {
+      return false;
+    }
+  } else if (Opcode != ARC::CMPrr && Opcode != ARC::CMPrui &&
+             Opcode != ARC::CMPrsi && Opcode != ARC::CMPrli) {
+    return false;
+  }
+
+  // The compared registers must still hold the same values at the branch.
+  unsigned LHS = Compare->getOperand(IsFlagBitTest ? 1 : 0).getReg();
+  unsigned RHS = Opcode == ARC::CMPrr ? Compare->getOperand(1).getReg() : 0;
+  MachineBasicBlock::iterator AfterCompare = llvm::next(Compare);
+  if (isModifiedBetween(AfterCompare, Branch, LHS) ||
+      (RHS && isModifiedBetween(AfterCompare, Branch, RHS))) {
+    return false;
+  }
+
+  // The flags must not be needed after the branch, as they are no longer
+  // set. Only an unconditional branch may follow it.
+  if (!isDeadAfter(MBB, Branch, ARC::STATUS32)) {
+    return false;
+  }
+
+  if (!isInBRccRange(CompareOffset, BranchOffset,
+                     BlockOffsets[Target->getNumber()])) {
+    ++NumOutOfRange;
+    return false;
+  }
+
+  DebugLoc DL = Branch->getDebugLoc();
+  int64_t Imm = 0;
+  MachineInstr *BitTest = 0;
+  MachineInstrBuilder MIB;
+
+  if (IsFlagBitTest) {
+    unsigned BBITOpc = CC == ARCCC::COND_EQ ? ARC::BBIT0ru6 : ARC::BBIT1ru6;
+    MIB = BuildMI(MBB, Branch, DL, TII->get(BBITOpc))
+      .addReg(LHS).addImm(Log2_32(Compare->getOperand(2).getImm()))
+      .addMBB(Target);
+  } else if (Opcode == ARC::CMPrr) {
+    // BRcc only has EQ to HS, so form the others by swapping the operands.
+    switch (CC) {
+      default:
+        return false;
+      case ARCCC::COND_EQ:
+      case ARCCC::COND_NE:
+      case ARCCC::COND_LT:
+      case ARCCC::COND_GE:
+      case ARCCC::COND_LO:
+      case ARCCC::COND_HS:
+        break;
+      case ARCCC::COND_GT: CC = ARCCC::COND_LT; std::swap(LHS, RHS); break;
+      case ARCCC::COND_LE: CC = ARCCC::COND_GE; std::swap(LHS, RHS); break;
+      case ARCCC::COND_HI: CC = ARCCC::COND_LO; std::swap(LHS, RHS); break;
+      case ARCCC::COND_LS: CC = ARCCC::COND_HS; std::swap(LHS, RHS); break;
+    }
+
+    MIB = BuildMI(MBB, Branch, DL, TII->get(ARC::BRCCrr))
+      .addReg(LHS).addReg(RHS).addMBB(Target).addImm(CC);
+  } else {
+    getImmediateCompare(Compare, Imm);
+
+    // "and rT,rB,(1 << n); cmp rT,0; beq/bne" tests a single bit of rB.
+    if (Imm == 0 && (CC == ARCCC::COND_EQ || CC == ARCCC::COND_NE) &&
+        Compare != MBB.begin()) {
+      MachineBasicBlock::iterator And = llvm::prior(Compare);
+      if ((And->getOpcode() == ARC::ANDrui ||
+           And->getOpcode() == ARC::ANDrli) &&
+          isUnpredicated(And) && And->getOperand(0).getReg() == LHS &&
+          isPowerOf2_32(And->getOperand(2).getImm()) &&
+          isDeadAfter(MBB, Compare, LHS) &&
+          !isModifiedBetween(AfterCompare, Branch,
+                             And->getOperand(1).getReg())) {
+        BitTest = And;
+      }
+    }
+
+    if (BitTest) {
+      unsigned BBITOpc = CC == ARCCC::COND_EQ ? ARC::BBIT0ru6 : ARC::BBIT1ru6;
+      MIB = BuildMI(MBB, Branch, DL, TII->get(BBITOpc))
+        .addReg(BitTest->getOperand(1).getReg())
+        .addImm(Log2_32(BitTest->getOperand(2).getImm()))
+        .addMBB(Target);
+    } else {
+      // BRcc only takes a u6, and only has EQ to HS, so form the others by
+      // comparing against the next immediate up.
+      if (!isUInt<6>(Imm)) {
+        return false;
+      }
+      switch (CC) {
+        default:
+          return false;
+        case ARCCC::COND_EQ:
+        case ARCCC::COND_NE:
+        case ARCCC::COND_LT:
+        case ARCCC::COND_GE:
+        case ARCCC::COND_LO:
+        case ARCCC::COND_HS:
+          break;
+        case ARCCC::COND_GT: CC = ARCCC::COND_GE; ++Imm; break;
+        case ARCCC::COND_LE: CC = ARCCC::COND_LT; ++Imm; break;
+        case ARCCC::COND_HI: CC = ARCCC::COND_HS; ++Imm; break;
+        case ARCCC::COND_LS: CC = ARCCC::COND_LO; ++Imm; break;
+      }
+      if (!isUInt<6>(Imm)) {
+        return false;
+      }
+
+      MIB = BuildMI(MBB, Branch, DL, TII->get(ARC::BRCCru6))
+        .addReg(LHS).addImm(Imm).addMBB(Target).addImm(CC);
+    }
+  }
+
+  DEBUG(dbgs() << "Fusing " << *Compare << "  and " << *Branch << "  into "
+               << *MIB);
+
+  Branch->eraseFromParent();
+  Compare->eraseFromParent();
+  if (BitTest) {
+    BitTest->eraseFromParent();
+  }
+  if (BitTest || IsFlagBitTest) {
+    ++NumBBIT;
+  } else {
+    ++NumBRcc;
+  }
+  return true;
+}
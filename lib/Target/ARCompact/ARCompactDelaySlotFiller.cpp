@@ -0,0 +1,319 @@
+//===--- ARCompactDelaySlotFiller.cpp - ARCompact delay slot filler -------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains a pass that fills the delay slots of branches, calls and
+// returns. The ARCompact branches have .d forms which execute the instruction
+// that follows them before the transfer of control takes effect; this pass
+// looks back through the block for an independent instruction to move into
+// that slot, and if one is found, switches the branch to its .d form.
+// Otherwise the branch is left in its non-delayed form, so no NOPs are ever
+// inserted.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "arcompact-delay-slot-filler"
+#include "ARCompact.h"
+#include "ARCompactInstrInfo.h"
+#include "MCTargetDesc/ARCompactBaseInfo.h"
+#include "llvm/CodeGen/MachineFunctionPass.h"
+#include "llvm/CodeGen/MachineInstrBuilder.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/ADT/SmallSet.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace llvm;
+
+STATISTIC(FilledSlots, "Number of delay slots filled");
+STATISTIC(UnfilledSlots, "Number of delay slots left unfilled");
+
+static cl::opt<bool> DisableDelaySlotFiller("disable-arcompact-delay-filler",
+    cl::init(false),
+    cl::desc("Never use the .d forms of ARCompact branches"),
+    cl::Hidden);
+
+namespace {
+  typedef SmallSet<unsigned, 32> RegSet;
+
+  struct ARCompactDelaySlotFiller : public MachineFunctionPass {
+    static char ID;
+    ARCompactDelaySlotFiller() : MachineFunctionPass(ID) {}
+
+    const TargetInstrInfo *TII;
+
+    virtual bool runOnMachineFunction(MachineFunction &MF);
+
+    virtual const char *getPassName() const {
+      return "ARCompact Delay Slot Filler";
+    }
+
+  private:
+    bool runOnMachineBasicBlock(MachineBasicBlock &MBB);
+    MachineBasicBlock::iterator findFiller(MachineBasicBlock &MBB,
+        MachineBasicBlock::iterator Branch);
+    void insertDefsUses(MachineInstr *MI, RegSet &Defs, RegSet &Uses);
+    bool hasHazard(MachineInstr *MI, bool &SawLoad, bool &SawStore,
+        const RegSet &Defs, const RegSet &Uses);
+  };
+  char ARCompactDelaySlotFiller::ID = 0;
+}
+
+/// createARCompactDelaySlotFillerPass - Returns an instance of the delay slot
+/// filler.
+FunctionPass *llvm::createARCompactDelaySlotFillerPass() {
+  return new ARCompactDelaySlotFiller();
+}
+
+/// getDelayedOpcode - Returns the .d form of the given branch, or zero if it
+/// has none.
+static unsigned getDelayedOpcode(unsigned Opcode) {
+  switch (Opcode) {
+    default:            return 0;
+    case ARC::B:        return ARC::B_D;
+    case ARC::BCC:      return ARC::BCC_D;
+    case ARC::BRCCrr:   return ARC::BRCCrr_D;
+    case ARC::BRCCru6:  return ARC::BRCCru6_D;
+    case ARC::BBIT0ru6: return ARC::BBIT0ru6_D;
+    case ARC::BBIT1ru6: return ARC::BBIT1ru6_D;
+    case ARC::BLi:      return ARC::BL_D;
+    case ARC::JLr:      return ARC::JLr_D;
+    case ARC::JLr_s:    return ARC::JLr_s_D;
+    case ARC::Jr:       return ARC::Jr_D;
+    case ARC::Jr_s:     return ARC::Jr_s_D;
+    case ARC::RET:      return ARC::RET_D;
+    case ARC::RET_S:    return ARC::RET_S_D;
+    case ARC::TAILJMPi: return ARC::TAILJMPi_D;
+    case ARC::TAILJMPr: return ARC::TAILJMPr_D;
+  }
+}
+
+/// getWriteBackReg - Returns the base register which MI updates, if it uses
+/// one of the .a and .ab addressing modes, or zero otherwise. The update is
+/// not modelled by the instructions' operands.
+static unsigned getWriteBackReg(const MachineInstr *MI) {
+  switch (MI->getOpcode()) {
+    default:
+      return 0;
+    case ARC::LDri_a:
+    case ARC::LDri_ab:
+      return MI->getOperand(1).getReg();
+    case ARC::STrri_a:
+      return MI->getOperand(0).getReg();
+  }
+}
+
+/// isPredicated - Returns true if MI is only executed under some condition,
+/// and so reads the flags.
+static bool isPredicated(const MachineInstr *MI) {
+  int PIdx = MI->findFirstPredOperandIdx();
+  return PIdx != -1 && MI->getOperand(PIdx).getImm() != ARCCC::COND_AL;
+}
+
+bool ARCompactDelaySlotFiller::runOnMachineFunction(MachineFunction &MF) {
+  if (DisableDelaySlotFiller) {
+    return false;
+  }
+
+  TII = MF.getTarget().getInstrInfo();
+
+  bool Changed = false;
+  for (MachineFunction::iterator FI = MF.begin(), FE = MF.end();
+       FI != FE; ++FI) {
+    Changed |= runOnMachineBasicBlock(*FI);
+  }
+  return Changed;
+}
+
+bool ARCompactDelaySlotFiller::runOnMachineBasicBlock(MachineBasicBlock &MBB) {
+  bool Changed = false;
+
+  for (MachineBasicBlock::iterator I = MBB.begin(); I != MBB.end(); ++I) {
+    unsigned DelayedOpc = getDelayedOpcode(I->getOpcode());
+    if (DelayedOpc == 0) {
+      continue;
+    }
+
+    MachineBasicBlock::iterator Filler = findFiller(MBB, I);
+    if (Filler == MBB.end()) {
+      ++UnfilledSlots;
+      continue;
+    }
+
+    DEBUG(dbgs() << "Filling delay slot of " << *I << "  with " << *Filler);
+
+    MBB.splice(llvm::next(I), &MBB, Filler);
+    I->setDesc(TII->get(DelayedOpc));
+
+    // Skip over the instruction now in the slot.
+    ++I;
+    ++FilledSlots;
+    Changed = true;
+  }
+
+  return Changed;
+}
+
+/// findFiller - Searches backwards from Branch for an instruction which can
+/// be moved into its delay slot. Returns MBB.end() if there is none.
+MachineBasicBlock::iterator
+ARCompactDelaySlotFiller::findFiller(MachineBasicBlock &MBB,
+                                     MachineBasicBlock::iterator Branch) {
+  RegSet Defs, Uses;
+  bool SawLoad = false;
+  bool SawStore = false;
+
+  insertDefsUses(Branch, Defs, Uses);
+
+  MachineBasicBlock::iterator I = Branch;
+  while (I != MBB.begin()) {
+    --I;
+
+    if (I->isDebugValue()) {
+      continue;
+    }
+
+    // Do not take the instruction out of an earlier delay slot.
+    if (I != MBB.begin() && llvm::prior(I)->getDesc().hasDelaySlot()) {
+      break;
+    }
+
+    // Do not look past anything which changes the flow of control, nor
+    // anything whose position matters.
+    if (I->isBranch() || I->isCall() || I->isTerminator() || I->isLabel() ||
+        I->isInlineAsm() ||
+        (I->hasUnmodeledSideEffects() && getWriteBackReg(I) == 0)) {
+      break;
+    }
+
+    if (!hasHazard(I, SawLoad, SawStore, Defs, Uses) &&
+        // The instruction in a delay slot may not have a long immediate.
+        !(I->getDesc().TSFlags & ARCII::HasLimm) &&
+        // Pseudo instructions (KILL, IMPLICIT_DEF, ...) emit nothing.
+        I->getDesc().getSize() != 0) {
+      return I;
+    }
+
+    // Anything which moves into the slot must also move past I.
+    insertDefsUses(I, Defs, Uses);
+  }
+
+  return MBB.end();
+}
+
+/// insertDefsUses - Adds the registers defined and used by MI to Defs and
+/// Uses.
+void ARCompactDelaySlotFiller::insertDefsUses(MachineInstr *MI, RegSet &Defs,
+                                              RegSet &Uses) {
+  // The slot of a call or return is executed before the callee or caller, so
+  // the argument and return value registers, and any registers clobbered by
+  // the call, may be freely written there. Only look at the explicit
+  // operands.
+  unsigned NumOps = MI->getNumOperands();
+  if (MI->isCall() || MI->isReturn()) {
+    NumOps = MI->getDesc().getNumOperands();
+  }
+
+  // Calls write the return address to BLINK, and returns read it. The
+  // callee also relies on SP.
+  if (MI->isCall()) {
+    Defs.insert(ARC::BLINK);
+    Uses.insert(ARC::BLINK);
+    Uses.insert(ARC::SP);
+  }
+  if (MI->isReturn()) {
+    Uses.insert(ARC::BLINK);
+  }
+
+  // A predicated instruction reads the flags.
+  if (isPredicated(MI)) {
+    Uses.insert(ARC::STATUS32);
+  }
+
+  if (unsigned Base = getWriteBackReg(MI)) {
+    Defs.insert(Base);
+  }
+
+  for (unsigned i = 0; i != NumOps; ++i) {
+    const MachineOperand &MO = MI->getOperand(i);
+    if (!MO.isReg() || MO.getReg() == 0) {
+      continue;
+    }
+
+    if (MO.isDef()) {
+      Defs.insert(MO.getReg());
+    } else {
+      Uses.insert(MO.getReg());
+    }
+  }
+
+  // Conditional branches read the flags through an implicit operand.
+  if (MI->getDesc().hasImplicitUseOfPhysReg(ARC::STATUS32)) {
+    Uses.insert(ARC::STATUS32);
+  }
+}
+
+/// hasHazard - Returns true if MI cannot be moved past the instructions whose
+/// registers are in Defs and Uses, or past the memory operations seen so far.
+bool ARCompactDelaySlotFiller::hasHazard(MachineInstr *MI, bool &SawLoad,
+    bool &SawStore, const RegSet &Defs, const RegSet &Uses) {
+  // Anything below SP may be overwritten at any time (by an interrupt, say),
+  // so a stack adjustment must not be moved past a memory operation, which
+  // may be an access to the frame.
+  if ((SawLoad || SawStore) &&
+      (MI->modifiesRegister(ARC::SP, 0) || getWriteBackReg(MI) == ARC::SP)) {
+    return true;
+  }
+
+  // Loads may not be moved past stores, and stores may not be moved past
+  // any other memory operation.
+  if (MI->mayLoad()) {
+    if (SawStore) {
+      return true;
+    }
+    SawLoad = true;
+  }
+
+  if (MI->mayStore()) {
+    if (SawStore || SawLoad) {
+      return true;
+    }
+    SawStore = true;
+  }
+
+  if (isPredicated(MI) && Defs.count(ARC::STATUS32)) {
+    return true;
+  }
+
+  if (unsigned Base = getWriteBackReg(MI)) {
+    if (Defs.count(Base) || Uses.count(Base)) {
+      return true;
+    }
+  }
+
+  for (unsigned i = 0, e = MI->getNumOperands(); i != e; ++i) {
+    const MachineOperand &MO = MI->getOperand(i);
+    if (!MO.isReg() || MO.getReg() == 0) {
+      continue;
+    }
+
+    unsigned Reg = MO.getReg();
+    if (MO.isDef()) {
+      // Write after write, or write after read.
+      if (Defs.count(Reg) || Uses.count(Reg)) {
+        return true;
+      }
+    } else if (Defs.count(Reg)) {
+      // Read after write.
+      return true;
+    }
+  }
+
+  return false;
+}
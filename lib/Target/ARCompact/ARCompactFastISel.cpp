@@ -0,0 +1,965 @@
+//===-- ARCompactFastISel.cpp - ARCompact FastISel implementation ---------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the ARCompact-specific support for the FastISel class,
+// which is used at -O0 to select instructions without building a selection
+// DAG. It covers the integer ALU operations, loads and stores through the
+// register plus offset and register plus register addressing modes, calls,
+// returns and simple branches. Anything else is left to SelectionDAG, one
+// instruction at a time.
+//
+// The instruction selector tables tablegen can generate for FastISel know
+// nothing of the predicate operand most ARCompact instructions carry, so the
+// instructions are picked by hand here instead.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "arcompact-fast-isel"
+#include "ARCompact.h"
+#include "ARCompactISelLowering.h"
+#include "ARCompactMachineFunctionInfo.h"
+#include "ARCompactSubtarget.h"
+#include "ARCompactTargetMachine.h"
+#include "llvm/CallingConv.h"
+#include "llvm/DerivedTypes.h"
+#include "llvm/Function.h"
+#include "llvm/GlobalVariable.h"
+#include "llvm/Instructions.h"
+#include "llvm/IntrinsicInst.h"
+#include "llvm/Operator.h"
+#include "llvm/CodeGen/Analysis.h"
+#include "llvm/CodeGen/CallingConvLower.h"
+#include "llvm/CodeGen/FastISel.h"
+#include "llvm/CodeGen/FunctionLoweringInfo.h"
+#include "llvm/CodeGen/MachineFrameInfo.h"
+#include "llvm/CodeGen/MachineInstrBuilder.h"
+#include "llvm/CodeGen/MachineMemOperand.h"
+#include "llvm/CodeGen/MachineRegisterInfo.h"
+#include "llvm/Support/CallSite.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/GetElementPtrTypeIterator.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetData.h"
+#include "llvm/Target/TargetInstrInfo.h"
+#include "llvm/ADT/Statistic.h"
+using namespace llvm;
+
+#include "ARCompactGenCallingConv.inc"
+
+STATISTIC(NumTargetSelected, "Number of instructions selected by the "
+                             "ARCompact fast selector");
+STATISTIC(NumTargetRejected, "Number of instructions the ARCompact fast "
+                             "selector left to SelectionDAG");
+
+namespace {
+  /// Address - A memory address in one of the forms the ARCompact loads and
+  /// stores accept: a base register or frame index plus a constant offset,
+  /// or (for word loads) a base register plus an index register.
+  struct Address {
+    enum { RegBase, FrameIndexBase } BaseType;
+    union {
+      unsigned Reg;
+      int FI;
+    } Base;
+    unsigned IndexReg;
+    int Offset;
+
+    Address() : BaseType(RegBase), IndexReg(0), Offset(0) {
+      Base.Reg = 0;
+    }
+  };
+
+  class ARCompactFastISel : public FastISel {
+    const ARCompactSubtarget &Subtarget;
+
+  public:
+    explicit ARCompactFastISel(FunctionLoweringInfo &funcInfo)
+      : FastISel(funcInfo),
+        Subtarget(TM.getSubtarget<ARCompactSubtarget>()) {
+    }
+
+    virtual bool TargetSelectInstruction(const Instruction *I);
+
+  protected:
+    virtual unsigned FastEmit_rr(MVT VT, MVT RetVT, unsigned Opcode,
+                                 unsigned Op0, bool Op0IsKill,
+                                 unsigned Op1, bool Op1IsKill);
+    virtual unsigned FastEmit_ri(MVT VT, MVT RetVT, unsigned Opcode,
+                                 unsigned Op0, bool Op0IsKill, uint64_t Imm);
+    virtual unsigned FastEmit_i(MVT VT, MVT RetVT, unsigned Opcode,
+                                uint64_t Imm);
+    virtual unsigned TargetMaterializeConstant(const Constant *C);
+    virtual unsigned TargetMaterializeAlloca(const AllocaInst *AI);
+
+  private:
+    bool SelectLoad(const Instruction *I);
+    bool SelectStore(const Instruction *I);
+    bool SelectBranch(const Instruction *I);
+    bool SelectRet(const Instruction *I);
+    bool SelectCall(const Instruction *I);
+    bool SelectIntExt(const Instruction *I);
+    bool SelectTrunc(const Instruction *I);
+    bool SelectNarrowBinaryOp(const Instruction *I, unsigned ISDOpcode);
+
+    bool isIntType(Type *Ty, MVT &VT) const;
+    bool ComputeAddress(const Value *Obj, Address &Addr);
+    bool SimplifyAddress(Address &Addr, bool AllowIndex);
+    void AddAddressOperands(const MachineInstrBuilder &MIB, Address &Addr,
+                            unsigned Flags, unsigned Size);
+    unsigned EmitIntExt(MVT SrcVT, unsigned SrcReg, bool isZExt);
+    unsigned EmitInst(unsigned Opc, unsigned Op0, unsigned Op1);
+    unsigned EmitInstImm(unsigned Opc, unsigned Op0, uint64_t Imm);
+    unsigned MaterializeInt(uint64_t Imm);
+    const MachineInstrBuilder &AddDefaultPred(const MachineInstrBuilder &MIB);
+  };
+} // end anonymous namespace
+
+/// AddDefaultPred - Adds an always-true predicate to MIB if its instruction
+/// has a predicate operand.
+const MachineInstrBuilder &
+ARCompactFastISel::AddDefaultPred(const MachineInstrBuilder &MIB) {
+  if (MIB->getDesc().findFirstPredOperandIdx() != -1) {
+    MIB.addImm(ARCCC::COND_AL).addImm(0);
+  }
+  return MIB;
+}
+
+/// isIntType - Returns true if Ty is an integer or pointer type that lives in
+/// a single CPU register, setting VT to its value type.
+bool ARCompactFastISel::isIntType(Type *Ty, MVT &VT) const {
+  EVT evt = TLI.getValueType(Ty, true);
+  if (!evt.isSimple()) {
+    return false;
+  }
+  VT = evt.getSimpleVT();
+  return VT == MVT::i32 || VT == MVT::i16 || VT == MVT::i8 || VT == MVT::i1;
+}
+
+/// EmitInst - Emits a two register operand instruction, returning its result.
+unsigned ARCompactFastISel::EmitInst(unsigned Opc, unsigned Op0,
+    unsigned Op1) {
+  unsigned ResultReg = createResultReg(ARC::CPURegsRegisterClass);
+  AddDefaultPred(BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL,
+      TII.get(Opc), ResultReg).addReg(Op0).addReg(Op1));
+  return ResultReg;
+}
+
+/// EmitInstImm - Emits a register and immediate operand instruction,
+/// returning its result.
+unsigned ARCompactFastISel::EmitInstImm(unsigned Opc, unsigned Op0,
+    uint64_t Imm) {
+  unsigned ResultReg = createResultReg(ARC::CPURegsRegisterClass);
+  AddDefaultPred(BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL,
+      TII.get(Opc), ResultReg).addReg(Op0).addImm(Imm));
+  return ResultReg;
+}
+
+/// MaterializeInt - Moves a 32-bit constant into a new register, using the
+/// shortest encoding that holds it.
+unsigned ARCompactFastISel::MaterializeInt(uint64_t Imm) {
+  int32_t Value = (int32_t)Imm;
+  unsigned Opc = ARC::MOVrli;
+  if (isUInt<6>(Value)) {
+    Opc = ARC::MOVrui;
+  } else if (isInt<12>(Value)) {
+    Opc = ARC::MOVrsi;
+  }
+
+  unsigned ResultReg = createResultReg(ARC::CPURegsRegisterClass);
+  AddDefaultPred(BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(Opc),
+      ResultReg).addImm(Value));
+  return ResultReg;
+}
+
+/// getBinaryOpcodes - Returns the register-register, register-u6 and
+/// register-limm forms of the instruction implementing the given ISD
+/// opcode, or false if there is none.
+static bool getBinaryOpcodes(unsigned ISDOpcode,
+    const ARCompactSubtarget &Subtarget,
+    unsigned &RROpc, unsigned &RUIOpc, unsigned &RLIOpc) {
+  RUIOpc = RLIOpc = 0;
+  switch (ISDOpcode) {
+    default: return false;
+    case ISD::ADD:
+      RROpc = ARC::ADDrr; RUIOpc = ARC::ADDrui; RLIOpc = ARC::ADDrli;
+      return true;
+    case ISD::SUB:
+      RROpc = ARC::SUBrr; RUIOpc = ARC::SUBrui; RLIOpc = ARC::SUBrli;
+      return true;
+    case ISD::AND:
+      RROpc = ARC::ANDrr; RUIOpc = ARC::ANDrui; RLIOpc = ARC::ANDrli;
+      return true;
+    case ISD::OR:
+      RROpc = ARC::ORrr; RUIOpc = ARC::ORrui; RLIOpc = ARC::ORrli;
+      return true;
+    case ISD::XOR:
+      RROpc = ARC::XORrr; RUIOpc = ARC::XORrui; RLIOpc = ARC::XORrli;
+      return true;
+    case ISD::SHL:
+    case ISD::SRL:
+    case ISD::SRA:
+      if (!Subtarget.hasBarrelShifter()) {
+        return false;
+      }
+      if (ISDOpcode == ISD::SHL) {
+        RROpc = ARC::ASLrr; RUIOpc = ARC::ASLrui; RLIOpc = ARC::ASLrli;
+      } else if (ISDOpcode == ISD::SRL) {
+        RROpc = ARC::LSRrr; RUIOpc = ARC::LSRrui; RLIOpc = ARC::LSRrli;
+      } else {
+        RROpc = ARC::ASRrr; RUIOpc = ARC::ASRrui; RLIOpc = ARC::ASRrli;
+      }
+      return true;
+    case ISD::MUL:
+      if (!Subtarget.hasMPY()) {
+        return false;
+      }
+      RROpc = ARC::MPYrr;
+      return true;
+    case ISD::SDIV:
+    case ISD::UDIV:
+    case ISD::SREM:
+    case ISD::UREM:
+      if (!Subtarget.hasDiv()) {
+        return false;
+      }
+      switch (ISDOpcode) {
+        case ISD::SDIV:
+          RROpc = ARC::DIVrr; RUIOpc = ARC::DIVrui; RLIOpc = ARC::DIVrli;
+          break;
+        case ISD::UDIV:
+          RROpc = ARC::DIVUrr; RUIOpc = ARC::DIVUrui; RLIOpc = ARC::DIVUrli;
+          break;
+        case ISD::SREM:
+          RROpc = ARC::REMrr; RUIOpc = ARC::REMrui; RLIOpc = ARC::REMrli;
+          break;
+        default:
+          RROpc = ARC::REMUrr; RUIOpc = ARC::REMUrui; RLIOpc = ARC::REMUrli;
+          break;
+      }
+      return true;
+  }
+}
+
+unsigned ARCompactFastISel::FastEmit_rr(MVT VT, MVT RetVT, unsigned Opcode,
+    unsigned Op0, bool Op0IsKill, unsigned Op1, bool Op1IsKill) {
+  unsigned RROpc, RUIOpc, RLIOpc;
+  if (VT != MVT::i32 || RetVT != MVT::i32 ||
+      !getBinaryOpcodes(Opcode, Subtarget, RROpc, RUIOpc, RLIOpc)) {
+    return 0;
+  }
+  return EmitInst(RROpc, Op0, Op1);
+}
+
+unsigned ARCompactFastISel::FastEmit_ri(MVT VT, MVT RetVT, unsigned Opcode,
+    unsigned Op0, bool Op0IsKill, uint64_t Imm) {
+  unsigned RROpc, RUIOpc, RLIOpc;
+  if (VT != MVT::i32 || RetVT != MVT::i32 ||
+      !getBinaryOpcodes(Opcode, Subtarget, RROpc, RUIOpc, RLIOpc) ||
+      RLIOpc == 0) {
+    return 0;
+  }
+  Imm = (uint32_t)Imm;
+  return EmitInstImm(isUInt<6>(Imm) ? RUIOpc : RLIOpc, Op0, Imm);
+}
+
+unsigned ARCompactFastISel::FastEmit_i(MVT VT, MVT RetVT, unsigned Opcode,
+    uint64_t Imm) {
+  if (Opcode != ISD::Constant || VT != MVT::i32 || RetVT != MVT::i32) {
+    return 0;
+  }
+  return MaterializeInt(Imm);
+}
+
+unsigned ARCompactFastISel::TargetMaterializeConstant(const Constant *C) {
+  if (const GlobalValue *GV = dyn_cast<GlobalValue>(C)) {
+    // Thread local variables need the DAG lowering.
+    const GlobalVariable *GVar = dyn_cast<GlobalVariable>(GV);
+    if (GVar && GVar->isThreadLocal()) {
+      return 0;
+    }
+    unsigned ResultReg = createResultReg(ARC::CPURegsRegisterClass);
+    BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(ARC::MOVrli),
+        ResultReg).addGlobalAddress(GV);
+    return ResultReg;
+  }
+
+  if (const ConstantInt *CI = dyn_cast<ConstantInt>(C)) {
+    if (CI->getBitWidth() > 32) {
+      return 0;
+    }
+    return MaterializeInt(CI->getZExtValue());
+  }
+
+  return 0;
+}
+
+unsigned ARCompactFastISel::TargetMaterializeAlloca(const AllocaInst *AI) {
+  DenseMap<const AllocaInst*, int>::iterator SI =
+    FuncInfo.StaticAllocaMap.find(AI);
+  if (SI == FuncInfo.StaticAllocaMap.end()) {
+    return 0;
+  }
+
+  unsigned ResultReg = createResultReg(ARC::CPURegsRegisterClass);
+  BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(ARC::ADDrli),
+      ResultReg).addFrameIndex(SI->second).addImm(0);
+  return ResultReg;
+}
+
+/// ComputeAddress - Folds as much of the address computation Obj as fits
+/// into Addr, emitting code for whatever is left over.
+bool ARCompactFastISel::ComputeAddress(const Value *Obj, Address &Addr) {
+  const User *U = NULL;
+  unsigned Opcode = Instruction::UserOp1;
+  if (const Instruction *I = dyn_cast<Instruction>(Obj)) {
+    // Only look through instructions in this block, or static allocas,
+    // whose values are available everywhere.
+    if (FuncInfo.StaticAllocaMap.count(static_cast<const AllocaInst*>(Obj)) ||
+        FuncInfo.MBBMap[I->getParent()] == FuncInfo.MBB) {
+      Opcode = I->getOpcode();
+      U = I;
+    }
+  } else if (const ConstantExpr *C = dyn_cast<ConstantExpr>(Obj)) {
+    Opcode = C->getOpcode();
+    U = C;
+  }
+
+  if (PointerType *Ty = dyn_cast<PointerType>(Obj->getType())) {
+    if (Ty->getAddressSpace() != 0) {
+      return false;
+    }
+  }
+
+  switch (Opcode) {
+    default:
+      break;
+    case Instruction::BitCast:
+      return ComputeAddress(U->getOperand(0), Addr);
+    case Instruction::IntToPtr:
+    case Instruction::PtrToInt:
+      if (TLI.getValueType(U->getOperand(0)->getType()) == TLI.getPointerTy()) {
+        return ComputeAddress(U->getOperand(0), Addr);
+      }
+      break;
+    case Instruction::GetElementPtr: {
+      Address SavedAddr = Addr;
+      int TmpOffset = Addr.Offset;
+      const Value *IndexOp = NULL;
+      uint64_t IndexScale = 0;
+      bool Foldable = true;
+
+      gep_type_iterator GTI = gep_type_begin(U);
+      for (User::const_op_iterator i = U->op_begin() + 1, e = U->op_end();
+           i != e; ++i, ++GTI) {
+        const Value *Op = *i;
+        if (StructType *STy = dyn_cast<StructType>(*GTI)) {
+          const StructLayout *SL = TD.getStructLayout(STy);
+          unsigned Idx = cast<ConstantInt>(Op)->getZExtValue();
+          TmpOffset += SL->getElementOffset(Idx);
+          continue;
+        }
+
+        uint64_t S = TD.getTypeAllocSize(GTI.getIndexedType());
+        if (const ConstantInt *CI = dyn_cast<ConstantInt>(Op)) {
+          TmpOffset += CI->getSExtValue() * S;
+          continue;
+        }
+
+        // Allow one variable index, which becomes the index register.
+        if (IndexOp || Addr.IndexReg) {
+          Foldable = false;
+          break;
+        }
+        IndexOp = Op;
+        IndexScale = S;
+      }
+
+      Addr.Offset = TmpOffset;
+      if (Foldable && ComputeAddress(U->getOperand(0), Addr)) {
+        if (!IndexOp) {
+          return true;
+        }
+        if (TLI.getValueType(IndexOp->getType()) == MVT::i32) {
+          unsigned IndexReg = getRegForValue(IndexOp);
+          if (IndexReg && IndexScale != 1) {
+            IndexReg = FastEmit_ri_(MVT::i32, ISD::MUL, IndexReg, false,
+                                    IndexScale, MVT::i32);
+          }
+          if (IndexReg) {
+            Addr.IndexReg = IndexReg;
+            return true;
+          }
+        }
+      }
+
+      // Fall back to computing the whole address in a register.
+      Addr = SavedAddr;
+      break;
+    }
+    case Instruction::Alloca: {
+      const AllocaInst *AI = cast<AllocaInst>(Obj);
+      DenseMap<const AllocaInst*, int>::iterator SI =
+        FuncInfo.StaticAllocaMap.find(AI);
+      if (SI != FuncInfo.StaticAllocaMap.end()) {
+        Addr.BaseType = Address::FrameIndexBase;
+        Addr.Base.FI = SI->second;
+        return true;
+      }
+      break;
+    }
+  }
+
+  Addr.Base.Reg = getRegForValue(Obj);
+  return Addr.Base.Reg != 0;
+}
+
+/// SimplifyAddress - Rewrites Addr into a form the load or store can encode:
+/// an index register only with a zero offset and a register base when
+/// AllowIndex is set, and otherwise an offset that fits in nine signed bits.
+/// Frame index offsets are left to eliminateFrameIndex.
+bool ARCompactFastISel::SimplifyAddress(Address &Addr, bool AllowIndex) {
+  if (Addr.IndexReg) {
+    if (AllowIndex && Addr.Offset == 0 && Addr.BaseType == Address::RegBase) {
+      return true;
+    }
+
+    unsigned BaseReg;
+    if (Addr.BaseType == Address::FrameIndexBase) {
+      BaseReg = createResultReg(ARC::CPURegsRegisterClass);
+      BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(ARC::ADDrli),
+          BaseReg).addFrameIndex(Addr.Base.FI).addImm(Addr.Offset);
+      Addr.Offset = 0;
+    } else {
+      BaseReg = Addr.Base.Reg;
+    }
+    Addr.BaseType = Address::RegBase;
+    Addr.Base.Reg = EmitInst(ARC::ADDrr, BaseReg, Addr.IndexReg);
+    Addr.IndexReg = 0;
+  }
+
+  if (Addr.BaseType == Address::RegBase && !isInt<9>(Addr.Offset)) {
+    Addr.Base.Reg = EmitInstImm(ARC::ADDrli, Addr.Base.Reg, Addr.Offset);
+    Addr.Offset = 0;
+  }
+  return true;
+}
+
+/// AddAddressOperands - Adds the MEMri or MEMrr operands for Addr to MIB,
+/// along with a memory operand for frame index accesses.
+void ARCompactFastISel::AddAddressOperands(const MachineInstrBuilder &MIB,
+    Address &Addr, unsigned Flags, unsigned Size) {
+  if (Addr.BaseType == Address::FrameIndexBase) {
+    int FI = Addr.Base.FI;
+    MachineMemOperand *MMO = FuncInfo.MF->getMachineMemOperand(
+        MachinePointerInfo::getFixedStack(FI, Addr.Offset), Flags, Size,
+        MFI.getObjectAlignment(FI));
+    MIB.addFrameIndex(FI).addImm(Addr.Offset).addMemOperand(MMO);
+  } else if (Addr.IndexReg) {
+    MIB.addReg(Addr.Base.Reg).addReg(Addr.IndexReg);
+  } else {
+    MIB.addReg(Addr.Base.Reg).addImm(Addr.Offset);
+  }
+}
+
+bool ARCompactFastISel::SelectLoad(const Instruction *I) {
+  const LoadInst *LI = cast<LoadInst>(I);
+  MVT VT;
+  if (LI->isAtomic() || !isIntType(I->getType(), VT)) {
+    return false;
+  }
+
+  unsigned Size = VT == MVT::i1 ? 1 : VT.getSizeInBits() / 8;
+  if (LI->getAlignment() && LI->getAlignment() < Size) {
+    return false;
+  }
+
+  Address Addr;
+  if (!ComputeAddress(LI->getPointerOperand(), Addr)) {
+    return false;
+  }
+
+  // Only word loads have a register plus register form.
+  SimplifyAddress(Addr, VT == MVT::i32);
+
+  unsigned Opc;
+  switch (VT.SimpleTy) {
+    default: llvm_unreachable("Unexpected load type");
+    case MVT::i1:
+    case MVT::i8:  Opc = ARC::LDri_extb; break;
+    case MVT::i16: Opc = ARC::LDri_extw; break;
+    case MVT::i32: Opc = Addr.IndexReg ? ARC::LDrr : ARC::LDri; break;
+  }
+
+  unsigned ResultReg = createResultReg(ARC::CPURegsRegisterClass);
+  MachineInstrBuilder MIB = BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL,
+      TII.get(Opc), ResultReg);
+  AddAddressOperands(MIB, Addr, MachineMemOperand::MOLoad, Size);
+  UpdateValueMap(I, ResultReg);
+  return true;
+}
+
+bool ARCompactFastISel::SelectStore(const Instruction *I) {
+  const StoreInst *SI = cast<StoreInst>(I);
+  const Value *Op0 = SI->getValueOperand();
+  MVT VT;
+  if (SI->isAtomic() || !isIntType(Op0->getType(), VT)) {
+    return false;
+  }
+
+  unsigned Size = VT == MVT::i1 ? 1 : VT.getSizeInBits() / 8;
+  if (SI->getAlignment() && SI->getAlignment() < Size) {
+    return false;
+  }
+
+  unsigned SrcReg = getRegForValue(Op0);
+  if (SrcReg == 0) {
+    return false;
+  }
+
+  Address Addr;
+  if (!ComputeAddress(SI->getPointerOperand(), Addr)) {
+    return false;
+  }
+  SimplifyAddress(Addr, false);
+
+  unsigned Opc;
+  switch (VT.SimpleTy) {
+    default: llvm_unreachable("Unexpected store type");
+    case MVT::i1:
+      SrcReg = EmitIntExt(VT, SrcReg, true);
+      // Fall through.
+    case MVT::i8:  Opc = ARC::STrri_i8; break;
+    case MVT::i16: Opc = ARC::STrri_i16; break;
+    case MVT::i32: Opc = ARC::STrri; break;
+  }
+
+  MachineInstrBuilder MIB = BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL,
+      TII.get(Opc));
+  AddAddressOperands(MIB, Addr, MachineMemOperand::MOStore, Size);
+  MIB.addReg(SrcReg);
+  return true;
+}
+
+/// getCondCode - Maps an integer comparison onto an ARCompact condition.
+static ARCCC::CondCodes getCondCode(CmpInst::Predicate Pred) {
+  switch (Pred) {
+    default:                  return ARCCC::COND_INVALID;
+    case CmpInst::ICMP_EQ:    return ARCCC::COND_EQ;
+    case CmpInst::ICMP_NE:    return ARCCC::COND_NE;
+    case CmpInst::ICMP_SGT:   return ARCCC::COND_GT;
+    case CmpInst::ICMP_SGE:   return ARCCC::COND_GE;
+    case CmpInst::ICMP_SLT:   return ARCCC::COND_LT;
+    case CmpInst::ICMP_SLE:   return ARCCC::COND_LE;
+    case CmpInst::ICMP_UGT:   return ARCCC::COND_HI;
+    case CmpInst::ICMP_UGE:   return ARCCC::COND_HS;
+    case CmpInst::ICMP_ULT:   return ARCCC::COND_LO;
+    case CmpInst::ICMP_ULE:   return ARCCC::COND_LS;
+  }
+}
+
+bool ARCompactFastISel::SelectBranch(const Instruction *I) {
+  const BranchInst *BI = cast<BranchInst>(I);
+  MachineBasicBlock *TBB = FuncInfo.MBBMap[BI->getSuccessor(0)];
+  MachineBasicBlock *FBB = FuncInfo.MBBMap[BI->getSuccessor(1)];
+
+  // Fold a compare used only by this branch into it. Otherwise test the
+  // bottom bit of the boolean.
+  ARCCC::CondCodes CC = ARCCC::COND_NE;
+  const CmpInst *CI = dyn_cast<CmpInst>(BI->getCondition());
+  MVT VT;
+  if (CI && CI->hasOneUse() && CI->getParent() == I->getParent() &&
+      getCondCode(CI->getPredicate()) != ARCCC::COND_INVALID &&
+      isIntType(CI->getOperand(0)->getType(), VT)) {
+    CC = getCondCode(CI->getPredicate());
+
+    unsigned LHSReg = getRegForValue(CI->getOperand(0));
+    if (LHSReg == 0) {
+      return false;
+    }
+
+    // Narrow values have undefined upper bits, which must be cleared or
+    // copied from the sign bit before comparing.
+    bool isZExt = !CI->isSigned();
+    const ConstantInt *RHSC = dyn_cast<ConstantInt>(CI->getOperand(1));
+    if (VT != MVT::i32) {
+      LHSReg = EmitIntExt(VT, LHSReg, isZExt);
+    }
+
+    int64_t RHSImm = 0;
+    unsigned RHSReg = 0;
+    if (RHSC) {
+      RHSImm = isZExt ? (int64_t)RHSC->getZExtValue() : RHSC->getSExtValue();
+    }
+    if (!RHSC || !isUInt<6>(RHSImm)) {
+      RHSReg = getRegForValue(CI->getOperand(1));
+      if (RHSReg == 0) {
+        return false;
+      }
+      if (VT != MVT::i32) {
+        RHSReg = EmitIntExt(VT, RHSReg, isZExt);
+      }
+    }
+
+    if (RHSReg) {
+      BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(ARC::CMPrr))
+        .addReg(LHSReg).addReg(RHSReg);
+    } else {
+      BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(ARC::CMPrui))
+        .addReg(LHSReg).addImm(RHSImm);
+    }
+  } else {
+    unsigned CondReg = getRegForValue(BI->getCondition());
+    if (CondReg == 0) {
+      return false;
+    }
+    unsigned TestReg = EmitInstImm(ARC::ANDrui, CondReg, 1);
+    BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(ARC::CMPrui))
+      .addReg(TestReg).addImm(0);
+  }
+
+  // Branch on the inverted condition when the true block follows.
+  if (FuncInfo.MBB->isLayoutSuccessor(TBB)) {
+    std::swap(TBB, FBB);
+    CC = ARCCC::getOppositeCondition(CC);
+  }
+
+  BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(ARC::BCC))
+    .addMBB(TBB).addImm(CC);
+  FastEmitBranch(FBB, DL);
+  FuncInfo.MBB->addSuccessor(TBB);
+  return true;
+}
+
+bool ARCompactFastISel::SelectRet(const Instruction *I) {
+  const ReturnInst *Ret = cast<ReturnInst>(I);
+  const Function &F = *I->getParent()->getParent();
+
+  // Interrupt handlers return through their own link register, see
+  // LowerReturn.
+  if (!FuncInfo.CanLowerReturn ||
+      FuncInfo.MF->getInfo<ARCompactMachineFunctionInfo>()
+          ->isInterruptHandler()) {
+    return false;
+  }
+
+  if (Ret->getNumOperands() > 0) {
+    const Value *RV = Ret->getOperand(0);
+    MVT VT;
+    if (!isIntType(RV->getType(), VT)) {
+      return false;
+    }
+
+    unsigned Reg = getRegForValue(RV);
+    if (Reg == 0) {
+      return false;
+    }
+
+    if (VT != MVT::i32) {
+      Attributes RetAttrs = F.getAttributes().getRetAttributes();
+      if (RetAttrs & Attribute::ZExt) {
+        Reg = EmitIntExt(VT, Reg, true);
+      } else if (RetAttrs & Attribute::SExt) {
+        Reg = EmitIntExt(VT, Reg, false);
+      }
+    }
+
+    SmallVector<CCValAssign, 16> RVLocs;
+    CCState CCInfo(F.getCallingConv(), F.isVarArg(), *FuncInfo.MF, TM,
+                   RVLocs, I->getContext());
+    CCInfo.AnalyzeCallResult(MVT::i32, RetCC_ARCompact32);
+    if (RVLocs.size() != 1 || !RVLocs[0].isRegLoc()) {
+      return false;
+    }
+
+    unsigned DstReg = RVLocs[0].getLocReg();
+    BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(TargetOpcode::COPY),
+        DstReg).addReg(Reg);
+    if (MRI.liveout_empty()) {
+      MRI.addLiveOut(DstReg);
+    }
+  }
+
+  BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(ARC::RET));
+  return true;
+}
+
+bool ARCompactFastISel::SelectCall(const Instruction *I) {
+  const CallInst *CI = cast<CallInst>(I);
+  const Value *Callee = CI->getCalledValue();
+
+  // Intrinsics and inline assembly need the DAG lowering.
+  if (isa<InlineAsm>(Callee) || isa<IntrinsicInst>(CI)) {
+    return false;
+  }
+
+  ImmutableCallSite CS(CI);
+  CallingConv::ID CC = CS.getCallingConv();
+  PointerType *PT = cast<PointerType>(Callee->getType());
+  FunctionType *FTy = cast<FunctionType>(PT->getElementType());
+  if (FTy->isVarArg()) {
+    return false;
+  }
+
+  MVT RetVT = MVT::isVoid;
+  if (!I->getType()->isVoidTy() && !isIntType(I->getType(), RetVT)) {
+    return false;
+  }
+
+  // Get the arguments into registers, extending them as their attributes
+  // ask.
+  SmallVector<unsigned, 8> Args;
+  SmallVector<MVT, 8> ArgVTs;
+  SmallVector<ISD::ArgFlagsTy, 8> ArgFlags;
+  for (ImmutableCallSite::arg_iterator i = CS.arg_begin(), e = CS.arg_end();
+       i != e; ++i) {
+    unsigned AttrInd = i - CS.arg_begin() + 1;
+    if (CS.paramHasAttr(AttrInd, Attribute::InReg) ||
+        CS.paramHasAttr(AttrInd, Attribute::StructRet) ||
+        CS.paramHasAttr(AttrInd, Attribute::Nest) ||
+        CS.paramHasAttr(AttrInd, Attribute::ByVal)) {
+      return false;
+    }
+
+    MVT ArgVT;
+    if (!isIntType((*i)->getType(), ArgVT)) {
+      return false;
+    }
+
+    unsigned Arg = getRegForValue(*i);
+    if (Arg == 0) {
+      return false;
+    }
+
+    if (ArgVT != MVT::i32) {
+      if (CS.paramHasAttr(AttrInd, Attribute::ZExt)) {
+        Arg = EmitIntExt(ArgVT, Arg, true);
+      } else if (CS.paramHasAttr(AttrInd, Attribute::SExt)) {
+        Arg = EmitIntExt(ArgVT, Arg, false);
+      }
+    }
+
+    Args.push_back(Arg);
+    ArgVTs.push_back(MVT::i32);
+    ArgFlags.push_back(ISD::ArgFlagsTy());
+  }
+
+  unsigned CalleeReg = 0;
+  const GlobalValue *GV = dyn_cast<GlobalValue>(Callee);
+  if (!GV) {
+    CalleeReg = getRegForValue(Callee);
+    if (CalleeReg == 0) {
+      return false;
+    }
+  }
+
+  SmallVector<CCValAssign, 16> RVLocs;
+  if (RetVT != MVT::isVoid) {
+    CCState CCRetInfo(CC, false, *FuncInfo.MF, TM, RVLocs, I->getContext());
+    CCRetInfo.AnalyzeCallResult(MVT::i32, RetCC_ARCompact32);
+    if (RVLocs.size() != 1 || !RVLocs[0].isRegLoc()) {
+      return false;
+    }
+  }
+
+  SmallVector<CCValAssign, 16> ArgLocs;
+  CCState CCInfo(CC, false, *FuncInfo.MF, TM, ArgLocs, I->getContext());
+  CCInfo.AnalyzeCallOperands(ArgVTs, ArgFlags, CC_ARCompact32);
+  unsigned NumBytes = CCInfo.getNextStackOffset();
+
+  // Stack arguments are stored to the reserved call frame at the bottom of
+  // the stack, as LowerCall does.
+  for (unsigned i = 0, e = ArgLocs.size(); i != e; ++i) {
+    if (ArgLocs[i].isMemLoc() && !isInt<9>(ArgLocs[i].getLocMemOffset())) {
+      return false;
+    }
+  }
+
+  BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL,
+      TII.get(ARC::ADJCALLSTACKDOWN)).addImm(NumBytes);
+
+  SmallVector<unsigned, 8> RegArgs;
+  for (unsigned i = 0, e = ArgLocs.size(); i != e; ++i) {
+    CCValAssign &VA = ArgLocs[i];
+    if (VA.isRegLoc()) {
+      BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL,
+          TII.get(TargetOpcode::COPY), VA.getLocReg()).addReg(Args[i]);
+      RegArgs.push_back(VA.getLocReg());
+    } else {
+      BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(ARC::STrri))
+        .addReg(ARC::SP).addImm(VA.getLocMemOffset()).addReg(Args[i]);
+    }
+  }
+
+  MachineInstrBuilder MIB;
+  if (GV) {
+    MIB = BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(ARC::BLi))
+      .addGlobalAddress(GV);
+  } else {
+    MIB = BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(ARC::JLr))
+      .addReg(CalleeReg);
+  }
+  for (unsigned i = 0, e = RegArgs.size(); i != e; ++i) {
+    MIB.addReg(RegArgs[i], RegState::Implicit);
+  }
+
+  BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(ARC::ADJCALLSTACKUP))
+    .addImm(NumBytes).addImm(0);
+
+  if (RetVT != MVT::isVoid) {
+    unsigned ResultReg = createResultReg(ARC::CPURegsRegisterClass);
+    BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(TargetOpcode::COPY),
+        ResultReg).addReg(RVLocs[0].getLocReg());
+    MIB.addReg(RVLocs[0].getLocReg(), RegState::ImplicitDefine);
+    UpdateValueMap(I, ResultReg);
+  }
+  return true;
+}
+
+/// EmitIntExt - Zero or sign extends the narrow value in SrcReg to 32 bits.
+unsigned ARCompactFastISel::EmitIntExt(MVT SrcVT, unsigned SrcReg,
+    bool isZExt) {
+  unsigned Opc;
+  switch (SrcVT.SimpleTy) {
+    default: return SrcReg;
+    case MVT::i1: {
+      unsigned Bit = EmitInstImm(ARC::ANDrui, SrcReg, 1);
+      if (isZExt) {
+        return Bit;
+      }
+      unsigned ResultReg = createResultReg(ARC::CPURegsRegisterClass);
+      AddDefaultPred(BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL,
+          TII.get(ARC::NEGrr), ResultReg).addReg(Bit));
+      return ResultReg;
+    }
+    case MVT::i8:  Opc = isZExt ? ARC::EXTBr : ARC::SEXBr; break;
+    case MVT::i16: Opc = isZExt ? ARC::EXTWr : ARC::SEXWr; break;
+  }
+
+  unsigned ResultReg = createResultReg(ARC::CPURegsRegisterClass);
+  AddDefaultPred(BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(Opc),
+      ResultReg).addReg(SrcReg));
+  return ResultReg;
+}
+
+bool ARCompactFastISel::SelectIntExt(const Instruction *I) {
+  MVT SrcVT, DestVT;
+  if (!isIntType(I->getOperand(0)->getType(), SrcVT) ||
+      !isIntType(I->getType(), DestVT)) {
+    return false;
+  }
+
+  unsigned SrcReg = getRegForValue(I->getOperand(0));
+  if (SrcReg == 0) {
+    return false;
+  }
+
+  UpdateValueMap(I, EmitIntExt(SrcVT, SrcReg, isa<ZExtInst>(I)));
+  return true;
+}
+
+bool ARCompactFastISel::SelectTrunc(const Instruction *I) {
+  MVT SrcVT, DestVT;
+  if (!isIntType(I->getOperand(0)->getType(), SrcVT) ||
+      !isIntType(I->getType(), DestVT)) {
+    return false;
+  }
+
+  // The upper bits of narrow values are undefined, so truncation is free.
+  unsigned SrcReg = getRegForValue(I->getOperand(0));
+  if (SrcReg == 0) {
+    return false;
+  }
+  UpdateValueMap(I, SrcReg);
+  return true;
+}
+
+/// SelectNarrowBinaryOp - Selects an i8 or i16 operation whose low bits do
+/// not depend on the undefined upper bits of its operands by doing it in
+/// 32 bits. The target independent code only handles legal types.
+bool ARCompactFastISel::SelectNarrowBinaryOp(const Instruction *I,
+    unsigned ISDOpcode) {
+  MVT VT;
+  if (!isIntType(I->getType(), VT) || VT == MVT::i32) {
+    return false;
+  }
+
+  unsigned Op0 = getRegForValue(I->getOperand(0));
+  if (Op0 == 0) {
+    return false;
+  }
+
+  unsigned ResultReg;
+  if (const ConstantInt *CI = dyn_cast<ConstantInt>(I->getOperand(1))) {
+    ResultReg = FastEmit_ri_(MVT::i32, ISDOpcode, Op0, false,
+                             CI->getZExtValue(), MVT::i32);
+  } else {
+    unsigned Op1 = getRegForValue(I->getOperand(1));
+    if (Op1 == 0) {
+      return false;
+    }
+    ResultReg = FastEmit_rr(MVT::i32, MVT::i32, ISDOpcode, Op0, false,
+                            Op1, false);
+  }
+
+  if (ResultReg == 0) {
+    return false;
+  }
+  UpdateValueMap(I, ResultReg);
+  return true;
+}
+
+bool ARCompactFastISel::TargetSelectInstruction(const Instruction *I) {
+  bool Selected = false;
+  switch (I->getOpcode()) {
+    default: break;
+    case Instruction::Load:   Selected = SelectLoad(I); break;
+    case Instruction::Store:  Selected = SelectStore(I); break;
+    case Instruction::Br:     Selected = SelectBranch(I); break;
+    case Instruction::Ret:    Selected = SelectRet(I); break;
+    case Instruction::Call:   Selected = SelectCall(I); break;
+    case Instruction::ZExt:
+    case Instruction::SExt:   Selected = SelectIntExt(I); break;
+    case Instruction::Trunc:  Selected = SelectTrunc(I); break;
+    case Instruction::Add:
+      Selected = SelectNarrowBinaryOp(I, ISD::ADD);
+      break;
+    case Instruction::Sub:
+      Selected = SelectNarrowBinaryOp(I, ISD::SUB);
+      break;
+    case Instruction::Mul:
+      Selected = SelectNarrowBinaryOp(I, ISD::MUL);
+      break;
+    case Instruction::And:
+      Selected = SelectNarrowBinaryOp(I, ISD::AND);
+      break;
+    case Instruction::Or:
+      Selected = SelectNarrowBinaryOp(I, ISD::OR);
+      break;
+    case Instruction::Xor:
+      Selected = SelectNarrowBinaryOp(I, ISD::XOR);
+      break;
+    case Instruction::Shl:
+      Selected = SelectNarrowBinaryOp(I, ISD::SHL);
+      break;
+  }
+
+  if (Selected) {
+    ++NumTargetSelected;
+  } else {
+    ++NumTargetRejected;
+    DEBUG(dbgs() << "ARCompact FastISel falling back on: " << *I << "\n");
+  }
+  return Selected;
+}
+
+namespace llvm {
+  FastISel *ARCompact::createFastISel(FunctionLoweringInfo &funcInfo) {
+    return new ARCompactFastISel(funcInfo);
+  }
+}
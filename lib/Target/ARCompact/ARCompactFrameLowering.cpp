@@ -14,18 +14,21 @@
 #include "ARCompactFrameLowering.h"
 #include "ARCompactInstrInfo.h"
 #include "ARCompactMachineFunctionInfo.h"
+#include "MCTargetDesc/ARCompactBaseInfo.h"
 #include "llvm/Function.h"
 #include "llvm/CodeGen/MachineFrameInfo.h"
 #include "llvm/CodeGen/MachineFunction.h"
 #include "llvm/CodeGen/MachineInstrBuilder.h"
 #include "llvm/CodeGen/MachineModuleInfo.h"
 #include "llvm/CodeGen/MachineRegisterInfo.h"
+#include "llvm/CodeGen/RegisterScavenging.h"
 #include "llvm/Target/TargetData.h"
 #include "llvm/Target/TargetOptions.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Metadata.h"
 #include "llvm/LLVMContext.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
 
 #include "llvm/Support/Debug.h"
 
@@ -86,15 +89,199 @@ using namespace llvm;
  *   mem                               SP  +-----------------------+
  */
 
-#include <iostream>
+/// savesReturnAddress - Returns true if BLINK must be saved in the prologue.
+/// True leaf functions leave it alone.
+static bool savesReturnAddress(const MachineFunction &MF) {
+  const MachineFrameInfo *MFI = MF.getFrameInfo();
+  return MFI->hasCalls() || MFI->isReturnAddressTaken();
+}
+
+/// The state of the interrupted code, other than its registers, which an
+/// interrupt handler may change: the loop registers, which any function it
+/// calls may use for a zero-overhead loop, and the multiply result
+/// registers. The handler saves a range of them, in consecutive slots.
+enum InterruptSave {
+  IS_LPCount, IS_LPStart, IS_LPEnd, IS_MLO, IS_MHI, IS_End
+};
+
+/// writesMultiplyResult - Returns true if MF has a 64-bit multiply, which
+/// writes the multiply result registers.
+static bool writesMultiplyResult(const MachineFunction &MF) {
+  for (MachineFunction::const_iterator MBB = MF.begin(), E = MF.end();
+       MBB != E; ++MBB) {
+    for (MachineBasicBlock::const_iterator MI = MBB->begin(),
+         ME = MBB->end(); MI != ME; ++MI) {
+      if (MI->definesRegister(ARC::MLO)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/// getInterruptSaves - Returns the end of the range of InterruptSaves which
+/// the prologue must make, and sets First to its start. A handler which
+/// makes calls saves the loop registers, and with MUL64 the multiply result
+/// registers as well, which a leaf handler saves only if it multiplies.
+static unsigned getInterruptSaves(const MachineFunction &MF,
+                                  const ARCompactSubtarget &STI,
+                                  unsigned &First) {
+  const ARCompactMachineFunctionInfo *AFI =
+      MF.getInfo<ARCompactMachineFunctionInfo>();
+  unsigned End = STI.hasMul64() ? IS_End : IS_MLO;
+  First = End;
+  if (!AFI->isInterruptHandler()) {
+    return End;
+  }
+  if (MF.getFrameInfo()->hasCalls()) {
+    First = IS_LPCount;
+  } else if (STI.hasMul64() && writesMultiplyResult(MF)) {
+    First = IS_MLO;
+  }
+  return End;
+}
+
+/// getInterruptScratchReg - Returns a register which the prologue has
+/// already saved, and the epilogue is yet to restore, to copy the
+/// InterruptSaves through. processFunctionBeforeCalleeSavedScan marks R0 as
+/// used in a handler which has any, so there is always one.
+static unsigned getInterruptScratchReg(const MachineFunction &MF) {
+  const std::vector<CalleeSavedInfo> &CSI =
+      MF.getFrameInfo()->getCalleeSavedInfo();
+  unsigned Reg = 0;
+  for (unsigned i = 0, e = CSI.size(); i != e && !Reg; ++i) {
+    if (CSI[i].getReg() != ARC::FP) {
+      Reg = CSI[i].getReg();
+    }
+  }
+  assert(Reg && "No saved register to use as a scratch register!");
+  return Reg;
+}
+
+/// emitInterruptSaves - Saves the InterruptSaves of a handler, once its frame
+/// has been set up.
+static void emitInterruptSaves(MachineFunction &MF, MachineBasicBlock &MBB,
+                               MachineBasicBlock::iterator MBBI, DebugLoc dl,
+                               const ARCompactInstrInfo &TII,
+                               unsigned First, unsigned End) {
+  const TargetRegisterInfo *TRI = MF.getTarget().getRegisterInfo();
+  int FI = MF.getInfo<ARCompactMachineFunctionInfo>()->getInterruptSaveIndex();
+  unsigned Scratch = getInterruptScratchReg(MF);
+
+  for (unsigned i = First; i != End; ++i) {
+    switch (i) {
+      case IS_LPCount:
+        BuildMI(MBB, MBBI, dl, TII.get(ARC::MOVrlp), Scratch);
+        break;
+      case IS_LPStart:
+      case IS_LPEnd:
+        BuildMI(MBB, MBBI, dl, TII.get(ARC::LRrui), Scratch)
+            .addImm(i == IS_LPStart ? ARCAux::LP_START : ARCAux::LP_END);
+        break;
+      case IS_MLO:
+      case IS_MHI:
+        BuildMI(MBB, MBBI, dl, TII.get(ARC::MOVrr), Scratch)
+            .addReg(i == IS_MLO ? ARC::MLO : ARC::MHI);
+        break;
+    }
+    TII.storeRegToStackSlot(MBB, MBBI, Scratch, true, FI + i - First,
+                            &ARC::CPURegsRegClass, TRI);
+  }
+}
+
+/// emitInterruptRestores - Restores the InterruptSaves of a handler, before
+/// its frame is torn down. MLO is restored as the product of itself and one,
+/// which clears MHI, and so MHI is restored after it, through MULHI.
+static void emitInterruptRestores(MachineFunction &MF, MachineBasicBlock &MBB,
+                                  MachineBasicBlock::iterator MBBI,
+                                  DebugLoc dl, const ARCompactInstrInfo &TII,
+                                  unsigned First, unsigned End) {
+  const TargetRegisterInfo *TRI = MF.getTarget().getRegisterInfo();
+  int FI = MF.getInfo<ARCompactMachineFunctionInfo>()->getInterruptSaveIndex();
+  unsigned Scratch = getInterruptScratchReg(MF);
+
+  static const unsigned Order[] = {
+    IS_MLO, IS_MHI, IS_LPEnd, IS_LPStart, IS_LPCount
+  };
+  for (unsigned i = 0; i != array_lengthof(Order); ++i) {
+    unsigned Save = Order[i];
+    if (Save < First || Save >= End) {
+      continue;
+    }
+    TII.loadRegFromStackSlot(MBB, MBBI, Scratch, FI + Save - First,
+                             &ARC::CPURegsRegClass, TRI);
+    switch (Save) {
+      case IS_LPCount:
+        BuildMI(MBB, MBBI, dl, TII.get(ARC::MOVlpr))
+            .addReg(Scratch, RegState::Kill);
+        break;
+      case IS_LPStart:
+      case IS_LPEnd:
+        BuildMI(MBB, MBBI, dl, TII.get(ARC::SRrui))
+            .addReg(Scratch, RegState::Kill)
+            .addImm(Save == IS_LPStart ? ARCAux::LP_START : ARCAux::LP_END);
+        break;
+      case IS_MLO:
+        BuildMI(MBB, MBBI, dl, TII.get(ARC::MULU64rui))
+            .addReg(Scratch, RegState::Kill).addImm(1);
+        break;
+      case IS_MHI:
+        BuildMI(MBB, MBBI, dl, TII.get(ARC::SRrui))
+            .addReg(Scratch, RegState::Kill).addImm(ARCAux::MULHI);
+        break;
+    }
+  }
+}
+
+/// estimateStackSize - Returns an upper bound on the size of the frame,
+/// before the callee saved registers have been assigned slots.
+static unsigned estimateStackSize(const MachineFunction &MF) {
+  const MachineFrameInfo *MFI = MF.getFrameInfo();
+  const TargetRegisterInfo *TRI = MF.getTarget().getRegisterInfo();
+  unsigned Size = MFI->getMaxCallFrameSize();
+
+  for (int FI = MFI->getObjectIndexBegin(), E = MFI->getObjectIndexEnd();
+       FI != E; ++FI) {
+    if (!MFI->isDeadObjectIndex(FI)) {
+      Size += MFI->getObjectSize(FI) + MFI->getObjectAlignment(FI) - 1;
+    }
+  }
+
+  // Allow for every callee saved register, and BLINK, being pushed.
+  for (const uint16_t *CSR = TRI->getCalleeSavedRegs(&MF); *CSR; ++CSR) {
+    Size += 4;
+  }
+  return Size + 4;
+}
+
+/// emitSPAdjustment - Adds NumBytes to SP, or subtracts it if IsSub is set.
+/// The s12 form is used when NumBytes fits, and the limm form otherwise.
+static void emitSPAdjustment(MachineBasicBlock &MBB,
+                             MachineBasicBlock::iterator MBBI, DebugLoc dl,
+                             const ARCompactInstrInfo &TII, bool IsSub,
+                             unsigned NumBytes,
+                             unsigned MIFlags = MachineInstr::NoFlags) {
+  unsigned Opc;
+  if (isInt<12>(NumBytes)) {
+    Opc = IsSub ? ARC::SUBrsi : ARC::ADDrsi;
+  } else {
+    Opc = IsSub ? ARC::SUBrli : ARC::ADDrli;
+  }
+  MachineInstrBuilder MIB = BuildMI(MBB, MBBI, dl, TII.get(Opc), ARC::SP)
+      .addReg(ARC::SP).addImm(NumBytes).setMIFlags(MIFlags);
+  if (MIB->getDesc().findFirstPredOperandIdx() != -1) {
+    MIB.addImm(ARCCC::COND_AL).addImm(0);
+  }
+}
+
 void ARCompactFrameLowering::emitPrologue(MachineFunction &MF) const {
-  //dbgs() << "Prologue\n";
   MachineBasicBlock &MBB = MF.front();
   MachineBasicBlock::iterator MBBI = MBB.begin();
   MachineFrameInfo  *MFI = MF.getFrameInfo();
   ARCompactMachineFunctionInfo *AFI = MF.getInfo<ARCompactMachineFunctionInfo>();
   const ARCompactInstrInfo &TII =
       *static_cast<const ARCompactInstrInfo*>(MF.getTarget().getInstrInfo());
+  const std::vector<CalleeSavedInfo> &CSI = MFI->getCalleeSavedInfo();
 
   DebugLoc dl = MBBI != MBB.end() ? MBBI->getDebugLoc() : DebugLoc();
 
@@ -104,35 +291,54 @@ void ARCompactFrameLowering::emitPrologue(MachineFunction &MF) const {
 
   unsigned VARegSaveSize = AFI->getVarArgsRegSaveSize();
   if (VARegSaveSize) {
-    BuildMI(MBB, MBBI, dl, TII.get(ARC::SUBrsi), ARC::SP).addReg(ARC::SP)
-        .addImm(VARegSaveSize);
+    emitSPAdjustment(MBB, MBBI, dl, TII, true, VARegSaveSize,
+                     MachineInstr::FrameSetup);
   }
 
-  // Save the return address register, if necessary
-  if (MFI->hasCalls()) {
+  // Save the return address register, if necessary. Its slot is the fixed
+  // object reserved by processFunctionBeforeCalleeSavedScan, so it is
+  // already counted in the stack size.
+  unsigned CalleeSavedFrameSize = 0;
+  if (savesReturnAddress(MF)) {
     BuildMI(MBB, MBBI, dl, TII.get(ARC::STrri_a))
         .addReg(ARC::SP)
         .addImm(-UNITS_PER_WORD)
-        .addReg(ARC::BLINK);
+        .addReg(ARC::BLINK)
+        .setMIFlag(MachineInstr::FrameSetup);
+    CalleeSavedFrameSize += UNITS_PER_WORD;
   }
 
-  // TODO: Create the register save area, and save the required registers to it.
-
-  // Save the caller's frame pointer.
-  BuildMI(MBB, MBBI, dl, TII.get(ARC::STrri_a))
-      .addReg(ARC::SP)
-      .addImm(-UNITS_PER_WORD)
-      .addReg(ARC::FP);
+  // Skip over the pushes of the callee saved registers (including FP), which
+  // spillCalleeSavedRegisters has already inserted.
+  for (unsigned i = 0, e = CSI.size(); i != e; ++i) {
+    assert(MBBI != MBB.end() && MBBI->getOpcode() == ARC::STrri_a &&
+           "Expected a callee saved register push!");
+    ++MBBI;
+    CalleeSavedFrameSize += UNITS_PER_WORD;
+  }
+  AFI->setCalleeSavedFrameSize(CalleeSavedFrameSize);
 
-  // Set FP = SP.
-  BuildMI(MBB, MBBI, dl, TII.get(ARC::MOVrr), ARC::FP).addReg(ARC::SP);
+  // Set FP = SP, so that it points at the saved FP.
+  if (hasFP(MF)) {
+    BuildMI(MBB, MBBI, dl, TII.get(ARC::MOVrr), ARC::FP).addReg(ARC::SP)
+        .setMIFlag(MachineInstr::FrameSetup);
+  }
 
-  // Allocate space for local registers.
+  // Allocate space for the locals. The pushes have already allocated the
+  // rest of the frame.
+  assert(NumBytes >= CalleeSavedFrameSize && "Callee saved area not in frame!");
+  NumBytes -= CalleeSavedFrameSize;
   if (NumBytes > 0) {
     // Check we're 4-byte aligned.
     assert((NumBytes & 0x3) == 0);
-    BuildMI(MBB, MBBI, dl, TII.get(ARC::SUBrsi), ARC::SP).addReg(ARC::SP)
-        .addImm(NumBytes);
+    emitSPAdjustment(MBB, MBBI, dl, TII, true, NumBytes,
+                     MachineInstr::FrameSetup);
+  }
+
+  unsigned FirstSave;
+  unsigned EndSave = getInterruptSaves(MF, STI, FirstSave);
+  if (FirstSave != EndSave) {
+    emitInterruptSaves(MF, MBB, MBBI, dl, TII, FirstSave, EndSave);
   }
 }
 
@@ -144,6 +350,7 @@ void ARCompactFrameLowering::emitEpilogue(MachineFunction &MF,
   ARCompactMachineFunctionInfo *AFI = MF.getInfo<ARCompactMachineFunctionInfo>();
   const ARCompactInstrInfo &TII =
       *static_cast<const ARCompactInstrInfo*>(MF.getTarget().getInstrInfo());
+  const std::vector<CalleeSavedInfo> &CSI = MFI->getCalleeSavedInfo();
 
   DebugLoc dl = MBBI != MBB.end() ? MBBI->getDebugLoc() : DebugLoc();
 
@@ -154,40 +361,154 @@ void ARCompactFrameLowering::emitEpilogue(MachineFunction &MF,
   // The stack size should be 4-byte aligned.
   unsigned NumBytes = MFI->getStackSize();
   NumBytes = (NumBytes + 3) & ~3;
+  NumBytes -= AFI->getCalleeSavedFrameSize();
 
-  // Restore stack pointer to the beginning of saved register area
-  if (NumBytes > 0) {
-    BuildMI(MBB, MBBI, dl, TII.get(ARC::ADDrsi), ARC::SP).addReg(ARC::SP)
-        .addImm(NumBytes);
+  // Find the first of the pops inserted by restoreCalleeSavedRegisters; the
+  // locals must be deallocated before it.
+  MachineBasicBlock::iterator FirstPop = MBBI;
+  for (unsigned i = 0, e = CSI.size(); i != e; ++i) {
+    --FirstPop;
+    assert(FirstPop->getOpcode() == ARC::LDri_ab &&
+           "Expected a callee saved register pop!");
   }
 
-  // If there have been var sized objects (dynamic alloca/etc), we need to fix
-  // the SP.
-  if (MFI->hasVarSizedObjects()) {
-    BuildMI(MBB, MBBI, dl, TII.get(ARC::MOVrr), ARC::SP).addReg(ARC::FP);
+  unsigned FirstSave;
+  unsigned EndSave = getInterruptSaves(MF, STI, FirstSave);
+  if (FirstSave != EndSave) {
+    emitInterruptRestores(MF, MBB, FirstPop, dl, TII, FirstSave, EndSave);
   }
 
-  // TODO: Restore any registers from the register-save area.
-
-  // Load the frame pointer back.
-  // TODO: Work out if the frame pointer was needed.
-  BuildMI(MBB, MBBI, dl, TII.get(ARC::LDri_ab), ARC::FP).addReg(ARC::SP)
-      .addImm(UNITS_PER_WORD);
+  // Restore the stack pointer to the bottom of the callee saved area. If
+  // there have been var sized objects (dynamic alloca/etc), the size of the
+  // frame is not known, but FP still points there.
+  if (MFI->hasVarSizedObjects()) {
+    BuildMI(MBB, FirstPop, dl, TII.get(ARC::MOVrr), ARC::SP).addReg(ARC::FP);
+  } else if (NumBytes > 0) {
+    emitSPAdjustment(MBB, FirstPop, dl, TII, false, NumBytes);
+  }
 
   // Restore the return address register, if needed.
-  if (MFI->hasCalls()) {
+  if (savesReturnAddress(MF)) {
     BuildMI(MBB, MBBI, dl, TII.get(ARC::LDri_ab), ARC::BLINK).addReg(ARC::SP)
         .addImm(UNITS_PER_WORD);
   }
 
   unsigned VARegSaveSize = AFI->getVarArgsRegSaveSize();
   if (VARegSaveSize) {
-    BuildMI(MBB, MBBI, dl, TII.get(ARC::ADDrsi), ARC::SP).addReg(ARC::SP)
-        .addImm(VARegSaveSize);
+    emitSPAdjustment(MBB, MBBI, dl, TII, false, VARegSaveSize);
+  }
+
+  // The frame is now gone, so a sibling call can jump to its callee, which
+  // returns straight to this function's caller.
+  unsigned RetOpcode = MBBI->getOpcode();
+  if (RetOpcode == ARC::TCRETURNi || RetOpcode == ARC::TCRETURNr) {
+    unsigned JumpOpcode =
+        RetOpcode == ARC::TCRETURNi ? ARC::TAILJMPi : ARC::TAILJMPr;
+    MachineInstrBuilder MIB = BuildMI(MBB, MBBI, dl, TII.get(JumpOpcode));
+    for (unsigned i = 0, e = MBBI->getNumOperands(); i != e; ++i) {
+      MIB.addOperand(MBBI->getOperand(i));
+    }
+    MBB.erase(MBBI);
+  }
+}
+
+bool ARCompactFrameLowering::spillCalleeSavedRegisters(MachineBasicBlock &MBB,
+    MachineBasicBlock::iterator MI, const std::vector<CalleeSavedInfo> &CSI,
+    const TargetRegisterInfo *TRI) const {
+  if (CSI.empty()) {
+    return false;
+  }
+
+  const TargetInstrInfo &TII = *MBB.getParent()->getTarget().getInstrInfo();
+  DebugLoc dl = MI != MBB.end() ? MI->getDebugLoc() : DebugLoc();
+
+  // The slots which PEI assigned to CSI run downwards from the top of the
+  // frame in the same order, so they are exactly where these pushes go.
+  for (unsigned i = 0, e = CSI.size(); i != e; ++i) {
+    unsigned Reg = CSI[i].getReg();
+    MBB.addLiveIn(Reg);
+    BuildMI(MBB, MI, dl, TII.get(ARC::STrri_a))
+        .addReg(ARC::SP)
+        .addImm(-UNITS_PER_WORD)
+        .addReg(Reg, RegState::Kill)
+        .setMIFlag(MachineInstr::FrameSetup);
+  }
+
+  return true;
+}
+
+bool ARCompactFrameLowering::restoreCalleeSavedRegisters(
+    MachineBasicBlock &MBB, MachineBasicBlock::iterator MI,
+    const std::vector<CalleeSavedInfo> &CSI,
+    const TargetRegisterInfo *TRI) const {
+  if (CSI.empty()) {
+    return false;
+  }
+
+  const TargetInstrInfo &TII = *MBB.getParent()->getTarget().getInstrInfo();
+  DebugLoc dl = MI != MBB.end() ? MI->getDebugLoc() : DebugLoc();
+
+  for (unsigned i = CSI.size(); i != 0; --i) {
+    BuildMI(MBB, MI, dl, TII.get(ARC::LDri_ab), CSI[i - 1].getReg())
+        .addReg(ARC::SP)
+        .addImm(UNITS_PER_WORD);
+  }
+
+  return true;
+}
+
+void ARCompactFrameLowering::processFunctionBeforeCalleeSavedScan(
+    MachineFunction &MF, RegScavenger *RS) const {
+  MachineFrameInfo *MFI = MF.getFrameInfo();
+  ARCompactMachineFunctionInfo *AFI = MF.getInfo<ARCompactMachineFunctionInfo>();
+
+  // BLINK is pushed first, so reserve the top slot of the frame for it. The
+  // callee saved register slots are then allocated below it. This is the
+  // same slot that llvm.returnaddress reads from.
+  if (savesReturnAddress(MF) && AFI->getRAIndex() == 0) {
+    AFI->setRAIndex(MFI->CreateFixedObject(UNITS_PER_WORD, -UNITS_PER_WORD,
+                                           false));
+  }
+
+  // The slots for the InterruptSaves, which the prologue and epilogue access
+  // through their frame indices. They are copied through R0, which is then
+  // saved along with the registers the handler clobbers.
+  unsigned FirstSave;
+  unsigned EndSave = getInterruptSaves(MF, STI, FirstSave);
+  if (FirstSave != EndSave) {
+    MF.getRegInfo().setPhysRegUsed(ARC::R0);
+  }
+  for (unsigned i = FirstSave; i != EndSave; ++i) {
+    int FI = MFI->CreateStackObject(UNITS_PER_WORD, UNITS_PER_WORD, false);
+    if (i == FirstSave) {
+      AFI->setInterruptSaveIndex(FI);
+    }
+  }
+
+  // Frame indices which are out of range of a [b,s9] address need a
+  // temporary register. If the scavenger cannot find a free one, it spills
+  // one to this slot, which is allocated close to the frame register.
+  if (RS && estimateStackSize(MF) > 255) {
+    int FI = MFI->CreateStackObject(UNITS_PER_WORD, UNITS_PER_WORD, false);
+    RS->setScavengingFrameIndex(FI);
+    MF.getInfo<ARCompactMachineFunctionInfo>()->setScavengingFrameIndex(FI);
+  }
+
+  // FP is only reserved when the function has a frame pointer, in which case
+  // it is never seen to be used by the register allocator. It must be saved
+  // whenever the prologue sets it up.
+  if (hasFP(MF)) {
+    MF.getRegInfo().setPhysRegUsed(ARC::FP);
   }
 }
 
 bool ARCompactFrameLowering::hasFP(const MachineFunction &MF) const {
-  return (MF.getTarget().Options.DisableFramePointerElim(MF) ||
-      MF.getFrameInfo()->hasVarSizedObjects());
+  const MachineFrameInfo *MFI = MF.getFrameInfo();
+  // A frame pointer is only needed when it is asked for, when there are
+  // variable sized objects, or when the frame address is taken. Otherwise SP
+  // does not move within the body of the function (outgoing arguments are
+  // placed in the reserved call frame), so every frame object is at a fixed
+  // offset from it.
+  return MF.getTarget().Options.DisableFramePointerElim(MF) ||
+         MFI->hasVarSizedObjects() || MFI->isFrameAddressTaken();
 }
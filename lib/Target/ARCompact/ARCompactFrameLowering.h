@@ -57,7 +57,33 @@ public:
   ///   * Returns to caller through the address stored in the BLINK register.
   void emitEpilogue(MachineFunction &MF, MachineBasicBlock &MBB) const;
 
+  /// Push the callee saved registers (and FP, which is treated as one) with a
+  /// sequence of pre-decrementing stores, in the order in which they appear
+  /// in CSI. emitPrologue saves BLINK before these.
+  bool spillCalleeSavedRegisters(MachineBasicBlock &MBB,
+                                 MachineBasicBlock::iterator MI,
+                                 const std::vector<CalleeSavedInfo> &CSI,
+                                 const TargetRegisterInfo *TRI) const;
+
+  /// Pop the registers pushed by spillCalleeSavedRegisters, in reverse
+  /// order, with a sequence of post-incrementing loads.
+  bool restoreCalleeSavedRegisters(MachineBasicBlock &MBB,
+                                   MachineBasicBlock::iterator MI,
+                                   const std::vector<CalleeSavedInfo> &CSI,
+                                   const TargetRegisterInfo *TRI) const;
+
+  /// Reserve the BLINK save slot, and mark FP as needing to be saved if
+  /// the function will set it up.
+  void processFunctionBeforeCalleeSavedScan(MachineFunction &MF,
+                                            RegScavenger *RS = NULL) const;
+
   bool hasFP(const MachineFunction &MF) const;
+
+  /// The call frame pseudo instructions are simply discarded, so the
+  /// outgoing argument area must always be a part of the fixed frame.
+  bool hasReservedCallFrame(const MachineFunction &MF) const {
+    return true;
+  }
 };
 
 } // End llvm namespace
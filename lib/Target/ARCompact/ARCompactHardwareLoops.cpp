@@ -0,0 +1,615 @@
+//===--- ARCompactHardwareLoops.cpp - ARCompact zero-overhead loops -------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains the passes that turn innermost counted loops into the
+// ARCompact zero-overhead loops. Once set up by an LP instruction, the
+// hardware branches from the end of the loop back to its start, decrementing
+// LP_COUNT as it does so, at no cost. This is done in two stages:
+//
+//   * Before instruction selection, ARCompactCountedLoops uses scalar
+//     evolution to work out the trip count of each candidate loop, computes
+//     it in the preheader, and rewrites the loop to count it down to zero.
+//     This is a valid loop in its own right, and the loop it leaves behind
+//     is simple enough to be recognised after register allocation.
+//
+//   * Just before emission, once the layout of the function is final,
+//     ARCompactHardwareLoops looks for the counted loops again. Where the
+//     loop is laid out contiguously and is short enough to be reached by LP,
+//     the decrement, compare and branch at its end are replaced by a
+//     "mov lp_count,rN" and "lp @end" in the preheader.
+//
+// The LP_COUNT decrement and the loop back happen at the same time, so a
+// trip count of zero means 2^32 iterations. The counted loops behave the same
+// way, so a loop which is left in software keeps the same semantics.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "arcompact-hwloops"
+#include "ARCompact.h"
+#include "ARCompactInstrInfo.h"
+#include "ARCompactTargetMachine.h"
+#include "llvm/CallingConv.h"
+#include "llvm/Constants.h"
+#include "llvm/Function.h"
+#include "llvm/Instructions.h"
+#include "llvm/IntrinsicInst.h"
+#include "llvm/Pass.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/LoopPass.h"
+#include "llvm/Analysis/ScalarEvolutionExpander.h"
+#include "llvm/Analysis/ScalarEvolutionExpressions.h"
+#include "llvm/CodeGen/MachineFunctionPass.h"
+#include "llvm/CodeGen/MachineInstrBuilder.h"
+#include "llvm/CodeGen/MachineLoopInfo.h"
+#include "llvm/Target/TargetLowering.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Transforms/Scalar.h"
+#include "llvm/Transforms/Utils/BasicBlockUtils.h"
+#include "llvm/Transforms/Utils/Local.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace llvm;
+
+STATISTIC(NumCountedLoops, "Number of loops rewritten to count down");
+STATISTIC(NumHWLoops, "Number of zero-overhead loops created");
+
+static cl::opt<bool> DisableHardwareLoops("disable-arcompact-hwloops",
+    cl::init(false),
+    cl::desc("Never use the ARCompact zero-overhead loops"),
+    cl::Hidden);
+
+// LP takes a signed 13-bit displacement from its own 32-bit aligned address
+// to the end of the loop. This allows for the LP itself and the alignment of
+// its address.
+static const unsigned MaxLoopSize = 4088;
+
+/// isInterruptHandler - Returns true if F is an interrupt handler. These
+/// leave loops alone. A leaf handler saves only the registers it clobbers,
+/// and the LP instructions are formed before emission, too late for its
+/// prologue to save the loop registers of the interrupted code.
+static bool isInterruptHandler(const Function &F) {
+  return F.getCallingConv() == CallingConv::ARC_INTR1 ||
+         F.getCallingConv() == CallingConv::ARC_INTR2;
+}
+
+//===----------------------------------------------------------------------===//
+// Counted loop formation.
+//===----------------------------------------------------------------------===//
+
+namespace {
+  struct ARCompactCountedLoops : public LoopPass {
+    static char ID;
+    ARCompactCountedLoops(ARCompactTargetMachine &tm)
+      : LoopPass(ID), TLI(*tm.getTargetLowering()) {}
+
+    const TargetLowering &TLI;
+    ScalarEvolution *SE;
+
+    virtual bool runOnLoop(Loop *L, LPPassManager &LPM);
+
+    virtual const char *getPassName() const {
+      return "ARCompact Counted Loops";
+    }
+
+    // CodeGenPrepare folds away the empty preheaders of guarded loops, so
+    // LoopSimplify is run again to put them back. The trip count and the LP
+    // go there.
+    virtual void getAnalysisUsage(AnalysisUsage &AU) const {
+      AU.addRequired<LoopInfo>();
+      AU.addRequiredID(LoopSimplifyID);
+      AU.addRequired<ScalarEvolution>();
+      AU.addPreserved<LoopInfo>();
+      AU.addPreservedID(LoopSimplifyID);
+      AU.setPreservesCFG();
+    }
+
+  private:
+    bool isLibCall(unsigned Opc, Type *Ty) const;
+    bool mayBecomeCall(const Instruction *I) const;
+    bool convertToCountedLoop(Loop *L);
+  };
+  char ARCompactCountedLoops::ID = 0;
+}
+
+/// createARCompactCountedLoopsPass - Returns an instance of the pass which
+/// rewrites loops with a computable trip count to count down to zero.
+Pass *llvm::createARCompactCountedLoopsPass(ARCompactTargetMachine &TM) {
+  return new ARCompactCountedLoops(TM);
+}
+
+/// isCheapToExpand - Returns true if the trip count S can be computed in the
+/// preheader without a division, which would become a library call.
+static bool isCheapToExpand(const SCEV *S) {
+  if (const SCEVUDivExpr *D = dyn_cast<SCEVUDivExpr>(S)) {
+    const SCEVConstant *C = dyn_cast<SCEVConstant>(D->getRHS());
+    if (!C || !C->getValue()->getValue().isPowerOf2()) {
+      return false;
+    }
+    return isCheapToExpand(D->getLHS());
+  }
+
+  if (const SCEVCastExpr *C = dyn_cast<SCEVCastExpr>(S)) {
+    return isCheapToExpand(C->getOperand());
+  }
+
+  if (const SCEVNAryExpr *N = dyn_cast<SCEVNAryExpr>(S)) {
+    for (SCEVNAryExpr::op_iterator I = N->op_begin(), E = N->op_end();
+         I != E; ++I) {
+      if (!isCheapToExpand(*I)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+/// isLibCall - Returns true if the operation Opc on a value of type Ty is
+/// lowered to a library call. Integers narrower than i32 are promoted first.
+bool ARCompactCountedLoops::isLibCall(unsigned Opc, Type *Ty) const {
+  EVT VT = TLI.getValueType(Ty, true);
+  if (VT.isInteger() && VT.bitsLT(MVT::i32)) {
+    VT = MVT::i32;
+  }
+  return !TLI.isOperationLegalOrCustom(Opc, VT);
+}
+
+/// mayBecomeCall - Returns true if I may be lowered to a call, which would
+/// clobber the registers of the loop, and so prevent it from becoming a
+/// hardware loop.
+bool ARCompactCountedLoops::mayBecomeCall(const Instruction *I) const {
+  if (isa<InvokeInst>(I)) {
+    return true;
+  }
+
+  if (const IntrinsicInst *II = dyn_cast<IntrinsicInst>(I)) {
+    switch (II->getIntrinsicID()) {
+      default:
+        return true;
+      case Intrinsic::dbg_declare:
+      case Intrinsic::dbg_value:
+      case Intrinsic::lifetime_start:
+      case Intrinsic::lifetime_end:
+        return false;
+      // These are expanded inline when there is no instruction for them.
+      case Intrinsic::ctlz:
+      case Intrinsic::cttz:
+      case Intrinsic::ctpop:
+      case Intrinsic::bswap:
+        return false;
+    }
+  }
+
+  if (isa<CallInst>(I)) {
+    return true;
+  }
+
+  // The divisions are library calls unless the subtarget has the divider.
+  switch (I->getOpcode()) {
+    default:
+      break;
+    case Instruction::UDiv:
+      return isLibCall(ISD::UDIV, I->getType());
+    case Instruction::SDiv:
+      return isLibCall(ISD::SDIV, I->getType());
+    case Instruction::URem:
+      return isLibCall(ISD::UREM, I->getType());
+    case Instruction::SRem:
+      return isLibCall(ISD::SREM, I->getType());
+  }
+
+  // There is no floating point.
+  if (I->getType()->isFloatingPointTy()) {
+    return true;
+  }
+
+  for (unsigned i = 0, e = I->getNumOperands(); i != e; ++i) {
+    if (I->getOperand(i)->getType()->isFloatingPointTy()) {
+      return true;
+    }
+  }
+
+  // The wide multiplies and shifts are library calls too.
+  if (I->getType()->isIntegerTy() &&
+      I->getType()->getPrimitiveSizeInBits() > 32) {
+    switch (I->getOpcode()) {
+      default:
+        break;
+      case Instruction::Mul:
+      case Instruction::Shl:
+      case Instruction::LShr:
+      case Instruction::AShr:
+        return true;
+    }
+  }
+
+  return false;
+}
+
+bool ARCompactCountedLoops::runOnLoop(Loop *L, LPPassManager &LPM) {
+  if (DisableHardwareLoops ||
+      isInterruptHandler(*L->getHeader()->getParent())) {
+    return false;
+  }
+
+  // Only the innermost loops can become hardware loops.
+  if (!L->empty()) {
+    return false;
+  }
+
+  SE = &getAnalysis<ScalarEvolution>();
+  return convertToCountedLoop(L);
+}
+
+/// convertToCountedLoop - If L has a trip count that can be computed before
+/// the loop is entered, adds a new induction variable which counts down from
+/// the trip count, and exits the loop when it reaches zero.
+bool ARCompactCountedLoops::convertToCountedLoop(Loop *L) {
+  BasicBlock *Header = L->getHeader();
+  BasicBlock *Preheader = L->getLoopPreheader();
+  BasicBlock *Latch = L->getLoopLatch();
+
+  // The loop must be left from the latch, and from nowhere else.
+  if (!Preheader || !Latch || L->getExitingBlock() != Latch) {
+    return false;
+  }
+
+  BranchInst *BI = dyn_cast<BranchInst>(Latch->getTerminator());
+  if (!BI || !BI->isConditional()) {
+    return false;
+  }
+
+  for (Loop::block_iterator I = L->block_begin(), E = L->block_end();
+       I != E; ++I) {
+    for (BasicBlock::iterator II = (*I)->begin(), IE = (*I)->end();
+         II != IE; ++II) {
+      if (mayBecomeCall(II)) {
+        return false;
+      }
+    }
+  }
+
+  const SCEV *BackedgeTakenCount = SE->getBackedgeTakenCount(L);
+  if (isa<SCEVCouldNotCompute>(BackedgeTakenCount) ||
+      SE->getTypeSizeInBits(BackedgeTakenCount->getType()) > 32) {
+    return false;
+  }
+
+  // Nothing is gained for a loop which runs once.
+  if (BackedgeTakenCount->isZero() || !isCheapToExpand(BackedgeTakenCount)) {
+    return false;
+  }
+
+  IntegerType *Int32Ty = Type::getInt32Ty(Header->getContext());
+  const SCEV *TripCount =
+      SE->getAddExpr(SE->getNoopOrZeroExtend(BackedgeTakenCount, Int32Ty),
+                     SE->getConstant(Int32Ty, 1));
+
+  DEBUG(dbgs() << "Counting down loop " << Header->getName() << " from "
+               << *TripCount << "\n");
+
+  SCEVExpander Expander(*SE, "lc");
+  Value *Count = Expander.expandCodeFor(TripCount, Int32Ty,
+                                        Preheader->getTerminator());
+
+  PHINode *Counter = PHINode::Create(Int32Ty, 2, "lc", Header->begin());
+  Value *Next = BinaryOperator::CreateSub(Counter, ConstantInt::get(Int32Ty, 1),
+                                          "lc.next", BI);
+  Counter->addIncoming(Count, Preheader);
+  Counter->addIncoming(Next, Latch);
+
+  Value *OldCond = BI->getCondition();
+  BI->setCondition(new ICmpInst(BI, ICmpInst::ICMP_NE, Next,
+                                ConstantInt::get(Int32Ty, 0), "lc.cond"));
+  if (BI->getSuccessor(0) != Header) {
+    BI->swapSuccessors();
+  }
+
+  // The old induction variable may now be dead.
+  SE->forgetLoop(L);
+  RecursivelyDeleteTriviallyDeadInstructions(OldCond);
+  DeleteDeadPHIs(Header);
+
+  ++NumCountedLoops;
+  return true;
+}
+
+//===----------------------------------------------------------------------===//
+// Hardware loop formation.
+//===----------------------------------------------------------------------===//
+
+namespace {
+  struct ARCompactHardwareLoops : public MachineFunctionPass {
+    static char ID;
+    ARCompactHardwareLoops() : MachineFunctionPass(ID) {}
+
+    const TargetInstrInfo *TII;
+
+    virtual bool runOnMachineFunction(MachineFunction &MF);
+
+    virtual const char *getPassName() const {
+      return "ARCompact Hardware Loops";
+    }
+
+    virtual void getAnalysisUsage(AnalysisUsage &AU) const {
+      AU.addRequired<MachineLoopInfo>();
+      AU.setPreservesCFG();
+      MachineFunctionPass::getAnalysisUsage(AU);
+    }
+
+  private:
+    bool convertToHardwareLoop(MachineLoop *L);
+  };
+  char ARCompactHardwareLoops::ID = 0;
+}
+
+/// createARCompactHardwareLoopsPass - Returns an instance of the pass which
+/// turns the counted loops into zero-overhead loops.
+FunctionPass *llvm::createARCompactHardwareLoopsPass() {
+  return new ARCompactHardwareLoops();
+}
+
+/// isDecrement - Returns true if MI is "Reg = Reg - 1".
+static bool isDecrement(const MachineInstr *MI, unsigned &Reg) {
+  int64_t Step;
+  switch (MI->getOpcode()) {
+    default:
+      return false;
+    case ARC::ADDrsi:
+    case ARC::ADDrli:
+    case ARC::ADDrui:
+    case ARC::ADDrsi_f:
+    case ARC::ADDrli_f:
+    case ARC::ADDrui_f:
+      Step = -MI->getOperand(2).getImm();
+      break;
+    case ARC::SUBrsi:
+    case ARC::SUBrli:
+    case ARC::SUBrui:
+    case ARC::SUBrsi_f:
+    case ARC::SUBrli_f:
+    case ARC::SUBrui_f:
+      Step = MI->getOperand(2).getImm();
+      break;
+  }
+
+  int PIdx = MI->findFirstPredOperandIdx();
+  if (PIdx != -1 && MI->getOperand(PIdx).getImm() != ARCCC::COND_AL) {
+    return false;
+  }
+
+  Reg = MI->getOperand(0).getReg();
+  return Step == 1 && MI->getOperand(1).getReg() == Reg;
+}
+
+/// isCompareWithZero - Returns true if MI is "cmp Reg,0".
+static bool isCompareWithZero(const MachineInstr *MI, unsigned Reg) {
+  if (MI->getOpcode() != ARC::CMPrui && MI->getOpcode() != ARC::CMPrsi) {
+    return false;
+  }
+  return MI->getOperand(0).getReg() == Reg && MI->getOperand(1).getImm() == 0;
+}
+
+bool ARCompactHardwareLoops::runOnMachineFunction(MachineFunction &MF) {
+  if (DisableHardwareLoops || isInterruptHandler(*MF.getFunction())) {
+    return false;
+  }
+
+  TII = MF.getTarget().getInstrInfo();
+  MachineLoopInfo &MLI = getAnalysis<MachineLoopInfo>();
+
+  bool Changed = false;
+  SmallVector<MachineLoop *, 8> Worklist(MLI.begin(), MLI.end());
+  while (!Worklist.empty()) {
+    MachineLoop *L = Worklist.pop_back_val();
+    if (L->empty()) {
+      Changed |= convertToHardwareLoop(L);
+    } else {
+      Worklist.append(L->begin(), L->end());
+    }
+  }
+
+  return Changed;
+}
+
+/// convertToHardwareLoop - If L is a counted loop which is laid out as a
+/// single contiguous run of blocks, replaces the branch back to its header
+/// with a zero-overhead loop.
+bool ARCompactHardwareLoops::convertToHardwareLoop(MachineLoop *L) {
+  MachineBasicBlock *Header = L->getHeader();
+  MachineBasicBlock *Latch = L->getLoopLatch();
+  MachineBasicBlock *Pred = L->getLoopPredecessor();
+  if (!Latch || !Pred || L->getExitingBlock() != Latch ||
+      !Pred->isLayoutSuccessor(Header)) {
+    return false;
+  }
+
+  // The hardware branches back from the end of the latch, so the body must
+  // run from the header to the latch, and the exit must follow it.
+  MachineFunction *MF = Header->getParent();
+  MachineFunction::iterator LatchIt = Latch;
+  MachineFunction::iterator ExitIt = llvm::next(LatchIt);
+  if (ExitIt == MF->end() || L->contains(ExitIt) ||
+      !Latch->isSuccessor(ExitIt)) {
+    return false;
+  }
+  MachineBasicBlock *Exit = ExitIt;
+
+  unsigned NumBlocks = 0;
+  unsigned Size = 0;
+  for (MachineFunction::iterator I = Header; ; ++I) {
+    if (!L->contains(I)) {
+      return false;
+    }
+    ++NumBlocks;
+
+    if (I->getAlignment()) {
+      Size += (1 << I->getAlignment()) - 2;
+    }
+
+    for (MachineBasicBlock::iterator MI = I->begin(), ME = I->end();
+         MI != ME; ++MI) {
+      if (MI->isCall() || MI->isInlineAsm() || MI->isReturn()) {
+        return false;
+      }
+      Size += MI->getDesc().getSize();
+    }
+
+    if (I == LatchIt) {
+      break;
+    }
+  }
+  if (NumBlocks != L->getNumBlocks() || Size > MaxLoopSize) {
+    return false;
+  }
+
+  // Find the "add rN,rN,-1; cmp rN,0; bne @header", or "sub.f rN,rN,1; bne
+  // @header", at the end of the latch, skipping an unconditional branch to
+  // the exit.
+  MachineBasicBlock::iterator I = Latch->getFirstTerminator();
+  if (I == Latch->end() || I->getOpcode() != ARC::BCC ||
+      I->getOperand(0).getMBB() != Header ||
+      I->getOperand(1).getImm() != ARCCC::COND_NE) {
+    return false;
+  }
+  MachineInstr *Branch = I;
+
+  MachineInstr *ExitBranch = 0;
+  if (llvm::next(I) != Latch->end()) {
+    ExitBranch = llvm::next(I);
+    if (ExitBranch->getOpcode() != ARC::B ||
+        ExitBranch->getOperand(0).getMBB() != Exit ||
+        llvm::next(MachineBasicBlock::iterator(ExitBranch)) != Latch->end()) {
+      return false;
+    }
+  }
+
+  // The post-RA scheduler may have moved other instructions in between the
+  // compare and the branch, but none of them can set the flags.
+  MachineInstr *Compare = 0;
+  while (I != Latch->begin()) {
+    --I;
+    if (I->definesRegister(ARC::STATUS32)) {
+      Compare = I;
+      break;
+    }
+  }
+  if (!Compare) {
+    return false;
+  }
+
+  // The decrement may set the flags itself (see OptimizeCompareInstr), in
+  // which case there is no separate compare.
+  unsigned CountReg = 0;
+  MachineInstr *Decrement = 0;
+  if (isDecrement(Compare, CountReg)) {
+    Decrement = Compare;
+  }
+  while (!Decrement && I != Latch->begin()) {
+    --I;
+    if (isDecrement(I, CountReg)) {
+      Decrement = I;
+      break;
+    }
+  }
+  if (!Decrement ||
+      (Decrement != Compare && !isCompareWithZero(Compare, CountReg))) {
+    return false;
+  }
+
+  // Once the decrement and compare are gone, nothing else may refer to the
+  // count register, as it no longer changes. Its final value of zero is not
+  // reproduced either, so it must not be live out of the loop.
+  if (Exit->isLiveIn(CountReg)) {
+    return false;
+  }
+  for (MachineLoop::block_iterator BI = L->block_begin(), BE = L->block_end();
+       BI != BE; ++BI) {
+    for (MachineBasicBlock::iterator MI = (*BI)->begin(), ME = (*BI)->end();
+         MI != ME; ++MI) {
+      if (&*MI == Decrement || &*MI == Compare) {
+        continue;
+      }
+      for (unsigned i = 0, e = MI->getNumOperands(); i != e; ++i) {
+        const MachineOperand &MO = MI->getOperand(i);
+        if (MO.isReg() && MO.getReg() == CountReg) {
+          return false;
+        }
+      }
+    }
+  }
+
+  // The LP goes at the very end of the predecessor, after any branches to
+  // elsewhere. Only an unconditional branch to the header may follow them,
+  // which is now redundant.
+  MachineBasicBlock::iterator PredEnd = Pred->end();
+  if (PredEnd != Pred->begin()) {
+    MachineBasicBlock::iterator Last = llvm::prior(PredEnd);
+    if (Last->getOpcode() == ARC::B && Last->getOperand(0).getMBB() == Header) {
+      PredEnd = Last;
+    }
+  }
+  for (MachineBasicBlock::iterator PI = Pred->getFirstTerminator();
+       PI != PredEnd; ++PI) {
+    if (PI->getOpcode() != ARC::BCC || PI->getOperand(0).getMBB() == Header) {
+      return false;
+    }
+  }
+
+  DEBUG(dbgs() << "Converting BB#" << Header->getNumber() << " to BB#"
+               << Latch->getNumber() << " into a hardware loop\n");
+
+  DebugLoc DL = Branch->getDebugLoc();
+  if (Decrement != Compare) {
+    Decrement->eraseFromParent();
+  }
+  Compare->eraseFromParent();
+  Branch->eraseFromParent();
+  if (ExitBranch) {
+    ExitBranch->eraseFromParent();
+  }
+
+  // The last instruction of the loop must not be a branch, nor be in a delay
+  // slot, and the loop must have at least two instructions.
+  unsigned NumInstrs = 0;
+  bool NeedsPadding = true;
+  for (MachineFunction::iterator BI = Header; ; ++BI) {
+    for (MachineBasicBlock::iterator MI = BI->begin(), ME = BI->end();
+         MI != ME; ++MI) {
+      if (MI->isDebugValue()) {
+        continue;
+      }
+      ++NumInstrs;
+      NeedsPadding = MI->isBranch();
+    }
+    if (BI == LatchIt) {
+      break;
+    }
+  }
+  if (NeedsPadding || NumInstrs < 2) {
+    BuildMI(*Latch, Latch->end(), DL, TII->get(ARC::NOP_S));
+  }
+  if (NumInstrs == 0) {
+    BuildMI(*Latch, Latch->end(), DL, TII->get(ARC::NOP_S));
+  }
+  BuildMI(*Latch, Latch->end(), DL, TII->get(ARC::LOOP_END)).addMBB(Header);
+
+  if (PredEnd != Pred->end()) {
+    PredEnd->eraseFromParent();
+  }
+  BuildMI(*Pred, Pred->getFirstTerminator(), DL, TII->get(ARC::MOVlpr))
+    .addReg(CountReg);
+  BuildMI(*Pred, Pred->end(), DL, TII->get(ARC::LP)).addMBB(Exit);
+
+  ++NumHWLoops;
+  return true;
+}
@@ -12,7 +12,10 @@
 //===----------------------------------------------------------------------===//
 
 #include "ARCompactTargetMachine.h"
+#include "ARCompactTargetObjectFile.h"
 #include "llvm/Intrinsics.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/CodeGen/FunctionLoweringInfo.h"
 #include "llvm/CodeGen/SelectionDAGISel.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/Debug.h"
@@ -43,21 +46,63 @@ public:
   bool SelectADDRri2(SDValue N, SDValue &Base, SDValue &Offset);
   bool SelectADDRli(SDValue N, SDValue &AddrOut);
   bool SelectADDRrr(SDValue N, SDValue &R1, SDValue &R2);
+  template <unsigned Shift>
+  bool SelectADDRrrScaled(SDValue N, SDValue &Base, SDValue &Index);
+  template <unsigned Shift>
+  bool SelectADDRriScaled(SDValue N, SDValue &Base, SDValue &Offset);
   bool SelectADDRrli(SDValue N, SDValue &R1, SDValue &Offset);
   bool SelectADDRlir(SDValue N, SDValue &R1, SDValue &Offset);
+  bool SelectADDRgp(SDNode *Parent, SDValue N, SDValue &Base,
+                    SDValue &Offset);
 
   virtual const char *getPassName() const {
     return "ARCOMPACT DAG->DAG Pattern Instruction Selection";
   }
 
+  virtual void getAnalysisUsage(AnalysisUsage &AU) const {
+    AU.addRequired<LoopInfo>();
+    SelectionDAGISel::getAnalysisUsage(AU);
+  }
+
+  bool shouldFoldLimm(SDNode *N) const;
+
   // Include the pieces autogenerated from the target description.
   #include "ARCompactGenDAGISel.inc"
 
 private:
   SDNode *Select(SDNode *N);
+  SDNode *SelectIndexedLoad(SDNode *N);
+  SDNode *SelectIndexedStore(SDNode *N);
+  SDNode *SelectCarryOp(SDNode *N);
 };
 }  // end anonymous namespace
 
+/// shouldFoldLimm - Returns true if the long immediate N should be encoded in
+/// the instruction using it. A limm costs as much to fetch as an instruction,
+/// so one used several times in a block, or inside a loop, is instead
+/// materialized into a register with MOVrli. MachineLICM hoists that out of
+/// the loop and MachineCSE shares it, and as MOVrli is rematerializable the
+/// register allocator can still put it back next to its use.
+bool ARCompactDAGToDAGISel::shouldFoldLimm(SDNode *N) const {
+  if (OptLevel == CodeGenOpt::None) {
+    return true;
+  }
+
+  if (!N->hasOneUse()) {
+    return false;
+  }
+
+  const BasicBlock *BB = FuncInfo->MBB->getBasicBlock();
+  return !BB || !getAnalysis<LoopInfo>().getLoopFor(BB);
+}
+
+/// isAddressRegister - Returns true if N is a value which needs to be in a
+/// register, rather than one which the ri and limm addressing modes fold.
+static bool isAddressRegister(SDValue N) {
+  return !isa<ConstantSDNode>(N) && !isa<FrameIndexSDNode>(N) &&
+      N.getOpcode() != ARCISD::Wrapper;
+}
+
 /// Converts the memory address Addr into a base address Base and an immediate
 /// offset Offset, or returns false if unable to process the memory address.
 bool ARCompactDAGToDAGISel::SelectADDRri(SDValue Addr, SDValue &Base,
@@ -95,16 +140,9 @@ bool ARCompactDAGToDAGISel::SelectADDRri(SDValue Addr, SDValue &Base,
       }
       break;
     case ARCISD::Wrapper:
-      // The address is wrapped in a specific ARCompact wrapper, meaning it
-      // might be a GlobalAddress, or ??.
-      SDValue N0 = Addr.getOperand(0);
-      if (GlobalAddressSDNode *G = dyn_cast<GlobalAddressSDNode>(N0)) {
-        Base = CurDAG->getTargetGlobalAddress(G->getGlobal(),
-            Addr.getDebugLoc(), MVT::i32, G->getOffset());
-        Offset = CurDAG->getTargetConstant(0, MVT::i32);
-
-        return true;
-      }
+      // A global address cannot be placed in the base register field; it is
+      // either matched by ADDRli (as a long immediate) or moved into a
+      // register by the default case below.
       break;
   }
 
@@ -123,13 +161,17 @@ bool ARCompactDAGToDAGISel::SelectADDRli(SDValue Addr, SDValue &AddrOut) {
   switch (Addr.getOpcode()) {
     case ARCISD::Wrapper:
       // The address is wrapped in a specific ARCompact wrapper, meaning it
-      // might be a GlobalAddress, or ??.
+      // is either a GlobalAddress or a JumpTable.
       SDValue N0 = Addr.getOperand(0);
       if (GlobalAddressSDNode *G = dyn_cast<GlobalAddressSDNode>(N0)) {
         AddrOut = CurDAG->getTargetGlobalAddress(G->getGlobal(),
             Addr.getDebugLoc(), MVT::i32, G->getOffset());
         return true;
       }
+      if (JumpTableSDNode *JT = dyn_cast<JumpTableSDNode>(N0)) {
+        AddrOut = CurDAG->getTargetJumpTable(JT->getIndex(), MVT::i32);
+        return true;
+      }
       break;
   }
 
@@ -188,9 +230,70 @@ bool ARCompactDAGToDAGISel::SelectADDRri2(SDValue Addr, SDValue &Base,
 /// it is not a register, register address).
 bool ARCompactDAGToDAGISel::SelectADDRrr(SDValue Addr, SDValue &R1,
     SDValue &R2) {
+  if (Addr.getOpcode() != ISD::ADD ||
+      !isAddressRegister(Addr.getOperand(0)) ||
+      !isAddressRegister(Addr.getOperand(1))) {
+    return false;
+  }
+
+  R1 = Addr.getOperand(0);
+  R2 = Addr.getOperand(1);
+  return true;
+}
+
+/// Matches base + (index << Shift), the address of an element of an array of
+/// 1 << Shift byte elements, setting Base and Index for the .as form of LDrr
+/// which does the shift itself.
+template <unsigned Shift>
+bool ARCompactDAGToDAGISel::SelectADDRrrScaled(SDValue Addr, SDValue &Base,
+    SDValue &Index) {
+  if (Addr.getOpcode() != ISD::ADD) {
+    return false;
+  }
+
+  for (unsigned i = 0; i != 2; ++i) {
+    SDValue Shl = Addr.getOperand(i);
+    SDValue Other = Addr.getOperand(1 - i);
+    if (Shl.getOpcode() != ISD::SHL || !isAddressRegister(Other)) {
+      continue;
+    }
+    ConstantSDNode *CN = dyn_cast<ConstantSDNode>(Shl.getOperand(1));
+    if (CN && CN->getZExtValue() == Shift) {
+      Base = Other;
+      Index = Shl.getOperand(0);
+      return true;
+    }
+  }
   return false;
 }
 
+/// Matches base + offset where the offset is too big for the 9-bit field,
+/// but is a multiple of 1 << Shift that fits once scaled, setting Offset to
+/// the scaled offset for the .as forms of LDri and STrri. Frame indexes are
+/// left to SelectADDRri, as their offsets are only known later.
+template <unsigned Shift>
+bool ARCompactDAGToDAGISel::SelectADDRriScaled(SDValue Addr, SDValue &Base,
+    SDValue &Offset) {
+  if (Addr.getOpcode() != ISD::ADD ||
+      !isAddressRegister(Addr.getOperand(0))) {
+    return false;
+  }
+
+  ConstantSDNode *CN = dyn_cast<ConstantSDNode>(Addr.getOperand(1));
+  if (!CN) {
+    return false;
+  }
+  int64_t CVal = CN->getSExtValue();
+  if (isInt<9>(CVal) || (CVal & ((1 << Shift) - 1)) ||
+      !isInt<9>(CVal >> Shift)) {
+    return false;
+  }
+
+  Base = Addr.getOperand(0);
+  Offset = CurDAG->getTargetConstant(CVal >> Shift, MVT::i32);
+  return true;
+}
+
 /// Sets R1 and Offset to the values of the memory address operands, or
 /// return false if unable to process the memory address (e.g. if
 /// it is not a register, long-immediate address).
@@ -207,6 +310,171 @@ bool ARCompactDAGToDAGISel::SelectADDRlir(SDValue Addr, SDValue &Offset,
   return false;
 }
 
+/// Sets Base to GP and Offset to the global if Addr is a global in the small
+/// data sections, plus an optional constant, or returns false otherwise. The
+/// word and half-word accesses have scaled offsets, so they must be aligned.
+bool ARCompactDAGToDAGISel::SelectADDRgp(SDNode *Parent, SDValue Addr,
+    SDValue &Base, SDValue &Offset) {
+  int64_t Disp = 0;
+  if (Addr.getOpcode() == ISD::ADD) {
+    ConstantSDNode *CN = dyn_cast<ConstantSDNode>(Addr.getOperand(1));
+    if (!CN) {
+      return false;
+    }
+    Disp = CN->getSExtValue();
+    Addr = Addr.getOperand(0);
+  }
+  if (Addr.getOpcode() != ARCISD::Wrapper) {
+    return false;
+  }
+
+  GlobalAddressSDNode *G = dyn_cast<GlobalAddressSDNode>(Addr.getOperand(0));
+  const ARCompactTargetObjectFile &TLOF =
+    static_cast<const ARCompactTargetObjectFile &>(
+        TM.getTargetLowering()->getObjFileLowering());
+  if (!G || !TLOF.IsGlobalInSmallSection(G->getGlobal(), TM)) {
+    return false;
+  }
+
+  MemSDNode *Mem = cast<MemSDNode>(Parent);
+  if (Mem->getAlignment() < Mem->getMemoryVT().getStoreSize()) {
+    return false;
+  }
+
+  Base = CurDAG->getRegister(ARC::GP, MVT::i32);
+  Offset = CurDAG->getTargetGlobalAddress(G->getGlobal(), Addr.getDebugLoc(),
+      MVT::i32, G->getOffset() + Disp);
+  return true;
+}
+
+/// Selects a pre- or post-incremented load, formed by the DAG combiner
+/// from a load and an update of its pointer, as one of the .a or .ab loads.
+/// Returns null if N is not an indexed load.
+SDNode *ARCompactDAGToDAGISel::SelectIndexedLoad(SDNode *N) {
+  LoadSDNode *LD = cast<LoadSDNode>(N);
+  ISD::MemIndexedMode AM = LD->getAddressingMode();
+  if (AM == ISD::UNINDEXED) {
+    return NULL;
+  }
+
+  bool isPre = AM == ISD::PRE_INC;
+  bool isSExt = LD->getExtensionType() == ISD::SEXTLOAD;
+  unsigned Opc;
+  switch (LD->getMemoryVT().getSimpleVT().SimpleTy) {
+    default:
+      return NULL;
+    case MVT::i1:
+    case MVT::i8:
+      if (isSExt) {
+        Opc = isPre ? ARC::LDri_sextb_a_upd : ARC::LDri_sextb_ab_upd;
+      } else {
+        Opc = isPre ? ARC::LDri_extb_a_upd : ARC::LDri_extb_ab_upd;
+      }
+      break;
+    case MVT::i16:
+      if (isSExt) {
+        Opc = isPre ? ARC::LDri_sextw_a_upd : ARC::LDri_sextw_ab_upd;
+      } else {
+        Opc = isPre ? ARC::LDri_extw_a_upd : ARC::LDri_extw_ab_upd;
+      }
+      break;
+    case MVT::i32:
+      Opc = isPre ? ARC::LDri_a_upd : ARC::LDri_ab_upd;
+      break;
+  }
+
+  int64_t Inc = cast<ConstantSDNode>(LD->getOffset())->getSExtValue();
+  SDValue Ops[] = { LD->getBasePtr(), CurDAG->getTargetConstant(Inc, MVT::i32),
+                    LD->getChain() };
+  MachineSDNode *ResNode = CurDAG->getMachineNode(Opc, N->getDebugLoc(),
+      MVT::i32, MVT::i32, MVT::Other, Ops, 3);
+
+  MachineSDNode::mmo_iterator MemOp = MF->allocateMemRefsArray(1);
+  MemOp[0] = LD->getMemOperand();
+  ResNode->setMemRefs(MemOp, MemOp + 1);
+  return ResNode;
+}
+
+/// Selects a pre- or post-incremented store as one of the .a or .ab stores.
+/// Returns null if N is not an indexed store.
+SDNode *ARCompactDAGToDAGISel::SelectIndexedStore(SDNode *N) {
+  StoreSDNode *ST = cast<StoreSDNode>(N);
+  ISD::MemIndexedMode AM = ST->getAddressingMode();
+  if (AM == ISD::UNINDEXED) {
+    return NULL;
+  }
+
+  bool isPre = AM == ISD::PRE_INC;
+  unsigned Opc;
+  switch (ST->getMemoryVT().getSimpleVT().SimpleTy) {
+    default:
+      return NULL;
+    case MVT::i1:
+    case MVT::i8:
+      Opc = isPre ? ARC::STrri_i8_a_upd : ARC::STrri_i8_ab_upd;
+      break;
+    case MVT::i16:
+      Opc = isPre ? ARC::STrri_i16_a_upd : ARC::STrri_i16_ab_upd;
+      break;
+    case MVT::i32:
+      Opc = isPre ? ARC::STrri_a_upd : ARC::STrri_ab_upd;
+      break;
+  }
+
+  int64_t Inc = cast<ConstantSDNode>(ST->getOffset())->getSExtValue();
+  SDValue Ops[] = { ST->getBasePtr(), CurDAG->getTargetConstant(Inc, MVT::i32),
+                    ST->getValue(), ST->getChain() };
+  MachineSDNode *ResNode = CurDAG->getMachineNode(Opc, N->getDebugLoc(),
+      MVT::i32, MVT::Other, Ops, 4);
+
+  MachineSDNode::mmo_iterator MemOp = MF->allocateMemRefsArray(1);
+  MemOp[0] = ST->getMemOperand();
+  ResNode->setMemRefs(MemOp, MemOp + 1);
+  return ResNode;
+}
+
+/// SelectCarryOp - Selects an ADDE or SUBE whose carry out is unused, such as
+/// the one adding the high words of a 64-bit sum, to the plain ADC or SBC,
+/// which leave the flags alone. Returns null if the carry out is used, to
+/// leave the node to the .f patterns.
+SDNode *ARCompactDAGToDAGISel::SelectCarryOp(SDNode *N) {
+  if (N->hasAnyUseOfValue(1)) {
+    return NULL;
+  }
+
+  bool IsAdd = N->getOpcode() == ISD::ADDE;
+  SDValue LHS = N->getOperand(0);
+  SDValue RHS = N->getOperand(1);
+  SDValue CarryIn = N->getOperand(2);
+  SDValue Pred = CurDAG->getTargetConstant(ARCCC::COND_AL, MVT::i32);
+  SDValue PredReg = CurDAG->getRegister(0, MVT::i32);
+
+  // The rr and rui forms take a predicate, the rsi and rli forms do not.
+  ConstantSDNode *C = dyn_cast<ConstantSDNode>(RHS);
+  if (C && isUInt<6>(C->getZExtValue())) {
+    SDValue Imm = CurDAG->getTargetConstant(C->getZExtValue(), MVT::i32);
+    SDValue Ops[] = { LHS, Imm, Pred, PredReg, CarryIn };
+    return CurDAG->SelectNodeTo(N, IsAdd ? ARC::ADCrui : ARC::SBCrui,
+                                MVT::i32, Ops, 5);
+  }
+
+  if (C && (isInt<12>(C->getSExtValue()) || shouldFoldLimm(C))) {
+    SDValue Imm = CurDAG->getTargetConstant(C->getZExtValue(), MVT::i32);
+    SDValue Ops[] = { LHS, Imm, CarryIn };
+    unsigned Opc;
+    if (isInt<12>(C->getSExtValue())) {
+      Opc = IsAdd ? ARC::ADCrsi : ARC::SBCrsi;
+    } else {
+      Opc = IsAdd ? ARC::ADCrli : ARC::SBCrli;
+    }
+    return CurDAG->SelectNodeTo(N, Opc, MVT::i32, Ops, 3);
+  }
+
+  SDValue Ops[] = { LHS, RHS, Pred, PredReg, CarryIn };
+  return CurDAG->SelectNodeTo(N, IsAdd ? ARC::ADCrr : ARC::SBCrr, MVT::i32,
+                              Ops, 5);
+}
+
 SDNode *ARCompactDAGToDAGISel::Select(SDNode *Op) {
   DebugLoc dl = Op->getDebugLoc();
 
@@ -230,6 +498,22 @@ SDNode *ARCompactDAGToDAGISel::Select(SDNode *Op) {
       return CurDAG->getMachineNode(ARC::ADDrli, dl, MVT::i32, TFI,
           CurDAG->getTargetConstant(0, MVT::i32));
     }
+    case ISD::LOAD:
+      if (SDNode *ResNode = SelectIndexedLoad(Op)) {
+        return ResNode;
+      }
+      break;
+    case ISD::STORE:
+      if (SDNode *ResNode = SelectIndexedStore(Op)) {
+        return ResNode;
+      }
+      break;
+    case ISD::ADDE:
+    case ISD::SUBE:
+      if (SDNode *ResNode = SelectCarryOp(Op)) {
+        return ResNode;
+      }
+      break;
     default:
       // Do nothing - let SelectCode handle it.
       break;
@@ -12,11 +12,14 @@
 //
 //===----------------------------------------------------------------------===//
 
+#define DEBUG_TYPE "arcompact-lower"
 #include "ARCompactISelLowering.h"
 #include "ARCompactMachineFunctionInfo.h"
 #include "ARCompactTargetMachine.h"
+#include "ARCompactTargetObjectFile.h"
 #include "llvm/DerivedTypes.h"
 #include "llvm/Function.h"
+#include "llvm/Intrinsics.h"
 #include "llvm/Module.h"
 #include "llvm/CodeGen/CallingConvLower.h"
 #include "llvm/CodeGen/MachineFrameInfo.h"
@@ -24,17 +27,20 @@
 #include "llvm/CodeGen/MachineInstrBuilder.h"
 #include "llvm/CodeGen/MachineRegisterInfo.h"
 #include "llvm/CodeGen/SelectionDAG.h"
-#include "llvm/CodeGen/TargetLoweringObjectFileImpl.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
 using namespace llvm;
 
 #include "ARCompactGenCallingConv.inc"
 
+STATISTIC(NumTailCalls, "Number of tail calls");
+
 ARCompactTargetLowering::ARCompactTargetLowering(ARCompactTargetMachine &tm)
-    : TargetLowering(tm, new TargetLoweringObjectFileELF()) {
+    : TargetLowering(tm, new ARCompactTargetObjectFile()) {
 
   TD = getTargetData();
+  const ARCompactSubtarget &Subtarget = tm.getSubtarget<ARCompactSubtarget>();
 
   //DEBUG(dbgs() << "ARCompactTargetLowering::ARCompactTargetLowering()\n");
   // Set up the register classes.
@@ -43,23 +49,37 @@ ARCompactTargetLowering::ARCompactTargetLowering(ARCompactTargetMachine &tm)
   // Compute the derived properties from the register classes.
   computeRegisterProperties();
 
-  // Do not have division, so int-division is expensive.
-  setIntDivIsCheap(false);
+  // Without the divider, int-division is expensive.
+  setIntDivIsCheap(Subtarget.hasDiv());
 
   setStackPointerRegisterToSaveRestore(ARC::SP);
 
+  // BL can only branch to 32-bit aligned targets.
+  setMinFunctionAlignment(2);
+
   // We don't have 1-bit extension (i.e. for bools).
   setLoadExtAction(ISD::EXTLOAD,  MVT::i1,  Promote);
   setLoadExtAction(ISD::SEXTLOAD, MVT::i1,  Promote);
   setLoadExtAction(ISD::ZEXTLOAD, MVT::i1,  Promote);
 
-  // Global addresses are custom lowered to ARCISD:Wrappers.
+  // The .a and .ab address write-back modes give pre- and post-incremented
+  // loads and stores of every size (see getPreIndexedAddressParts).
+  for (unsigned VT = MVT::i8; VT <= MVT::i32; ++VT) {
+    setIndexedLoadAction(ISD::PRE_INC,   (MVT::SimpleValueType)VT, Legal);
+    setIndexedLoadAction(ISD::POST_INC,  (MVT::SimpleValueType)VT, Legal);
+    setIndexedStoreAction(ISD::PRE_INC,  (MVT::SimpleValueType)VT, Legal);
+    setIndexedStoreAction(ISD::POST_INC, (MVT::SimpleValueType)VT, Legal);
+  }
+
+  // Global addresses and jump tables are custom lowered to ARCISD:Wrappers.
   setOperationAction(ISD::GlobalAddress,  MVT::i32,   Custom);
+  setOperationAction(ISD::JumpTable,      MVT::i32,   Custom);
 
-  // Expand non-supported branches.
-  // TODO: Check if these can be supported.
+  // BR_JT is expanded to a load of the target address from the table and an
+  // indirect branch, which is a plain J [reg]. Having BRIND legal is what lets
+  // SelectionDAGBuilder turn dense switches (at least four cases, covering at
+  // least 40% of their range) into jump tables.
   setOperationAction(ISD::BR_JT,          MVT::Other, Expand);
-  setOperationAction(ISD::BRIND,          MVT::Other, Expand);
 
   // BRCOND is expanded to ???, BR_CC is lowered to a CMP and Bcc.
   setOperationAction(ISD::BR_CC,          MVT::i32,   Custom);
@@ -73,19 +93,22 @@ ARCompactTargetLowering::ARCompactTargetLowering(ARCompactTargetMachine &tm)
   // SETCC is expanded to ???
   setOperationAction(ISD::SETCC,          MVT::i32,   Expand);
 
-  // SREM is expanded to ???
-  setOperationAction(ISD::SREM,           MVT::i32,   Expand);
-
-  // SDIV is expanded to ???
-  setOperationAction(ISD::SDIV,           MVT::i32,   Expand);
-
-  // SDIVREM is expanded to ???
+  // 64-bit compares chain the flags from the low words into the high words,
+  // rather than being split into separate compares (see EmitCMP64).
+  setOperationAction(ISD::BR_CC,          MVT::i64,   Custom);
+  setOperationAction(ISD::SELECT_CC,      MVT::i64,   Custom);
+  setOperationAction(ISD::SETCC,          MVT::i64,   Custom);
+
+  // Division and remainder are only native with the divider, and are
+  // otherwise expanded to library calls. SDIVREM and UDIVREM are always
+  // expanded, to a division and a remainder.
+  if (!Subtarget.hasDiv()) {
+    setOperationAction(ISD::SREM,         MVT::i32,   Expand);
+    setOperationAction(ISD::SDIV,         MVT::i32,   Expand);
+    setOperationAction(ISD::UREM,         MVT::i32,   Expand);
+    setOperationAction(ISD::UDIV,         MVT::i32,   Expand);
+  }
   setOperationAction(ISD::SDIVREM,        MVT::i32,   Expand);
-
-  // Expand UDIV too.
-  setOperationAction(ISD::UDIV,           MVT::i32,   Expand);
-
-  // UDIVREM
   setOperationAction(ISD::UDIVREM,        MVT::i32,   Expand);
 
   // Variadic function-related stuff.
@@ -94,14 +117,75 @@ ARCompactTargetLowering::ARCompactTargetLowering(ARCompactTargetMachine &tm)
   setOperationAction(ISD::VACOPY,         MVT::Other, Expand);
   setOperationAction(ISD::VAEND,          MVT::Other, Expand);
 
-  setOperationAction(ISD::UREM,           MVT::i32,   Expand);
-
+  // The barrel shifter can only rotate right. Left rotates are not formed
+  // when only right rotates are legal.
   setOperationAction(ISD::ROTL,           MVT::i32,   Expand);
-  setOperationAction(ISD::ROTR,           MVT::i32,   Expand);
+  if (!Subtarget.hasBarrelShifter()) {
+    setOperationAction(ISD::ROTR,         MVT::i32,   Expand);
+  }
+
+  // MPY, MPYH and MPYHU give the low and high words of a product directly,
+  // so the MUL_LOHIs are expanded to them. Otherwise MUL64 and MULU64 give
+  // both at once, through MLO and MHI, which then have to be copied out.
+  if (!Subtarget.hasMPY()) {
+    LegalizeAction MulAction = Subtarget.hasMul64() ? Custom : Expand;
+    setOperationAction(ISD::MUL,          MVT::i32,   MulAction);
+    setOperationAction(ISD::MULHS,        MVT::i32,   MulAction);
+    setOperationAction(ISD::MULHU,        MVT::i32,   MulAction);
+  }
+  if (Subtarget.hasMul64() && !Subtarget.hasMPY()) {
+    setOperationAction(ISD::SMUL_LOHI,    MVT::i32,   Custom);
+    setOperationAction(ISD::UMUL_LOHI,    MVT::i32,   Custom);
+  } else {
+    setOperationAction(ISD::SMUL_LOHI,    MVT::i32,   Expand);
+    setOperationAction(ISD::UMUL_LOHI,    MVT::i32,   Expand);
+  }
 
-  setOperationAction(ISD::UMUL_LOHI,      MVT::i32,   Expand);
+  // The halves of a 64-bit shift by a variable amount are put together with
+  // MOV.cc (see LowerShiftParts).
+  setOperationAction(ISD::SHL_PARTS,      MVT::i32,   Custom);
+  setOperationAction(ISD::SRL_PARTS,      MVT::i32,   Custom);
+  setOperationAction(ISD::SRA_PARTS,      MVT::i32,   Custom);
+
+  // Bytes are reversed with byte rotates, or with a SWAP of the half-words
+  // followed by byte shifts (see LowerBSWAP). A 16-bit BSWAP is done with
+  // shifts (see ReplaceNodeResults).
+  setOperationAction(ISD::BSWAP,          MVT::i16,   Custom);
+  if (Subtarget.hasBarrelShifter() || Subtarget.hasSwap()) {
+    setOperationAction(ISD::BSWAP,        MVT::i32,   Custom);
+  } else {
+    setOperationAction(ISD::BSWAP,        MVT::i32,   Expand);
+  }
+
+  // NORM counts leading sign bits, from which the leading and trailing zeros
+  // follow. Without it, trailing zeros are counted with CTPOP.
+  if (Subtarget.hasNorm()) {
+    setOperationAction(ISD::CTLZ,         MVT::i32,   Custom);
+    setOperationAction(ISD::CTTZ,         MVT::i32,   Custom);
+    setOperationAction(ISD::CTTZ_ZERO_UNDEF, MVT::i32, Custom);
+  } else {
+    setOperationAction(ISD::CTLZ,         MVT::i32,   Expand);
+    setOperationAction(ISD::CTLZ_ZERO_UNDEF, MVT::i32, Expand);
+    setOperationAction(ISD::CTTZ,         MVT::i32,   Expand);
+    setOperationAction(ISD::CTTZ_ZERO_UNDEF, MVT::i32, Expand);
+  }
+  setOperationAction(ISD::CTPOP,          MVT::i32,   Custom);
 
-  setOperationAction(ISD::BSWAP,          MVT::i32,   Expand);
+  // The saturating arithmetic and NORM intrinsics are lowered to generic
+  // nodes when the instructions for them are missing (see
+  // LowerINTRINSIC_WO_CHAIN).
+  if (!Subtarget.hasSat() || !Subtarget.hasNorm()) {
+    setOperationAction(ISD::INTRINSIC_WO_CHAIN, MVT::Other, Custom);
+  }
+
+  // Small memcpys and memsets are done with straight-line loads and stores.
+  // Larger ones become LD.AB/ST.AB loops (see ARCompactSelectionDAGInfo).
+  maxStoresPerMemset = 8;
+  maxStoresPerMemsetOptSize = 4;
+  maxStoresPerMemcpy = 4;
+  maxStoresPerMemcpyOptSize = 2;
+  maxStoresPerMemmove = 4;
+  maxStoresPerMemmoveOptSize = 2;
 
   setOperationAction(ISD::DYNAMIC_STACKALLOC, MVT::i32, Expand);
 
@@ -118,11 +202,21 @@ const char* ARCompactTargetLowering::getTargetNodeName(unsigned Opcode) const {
   //DEBUG(dbgs() << "ARCompactTargetLowering::getTargetNodeName()\n");
   switch (Opcode) {
     case ARCISD::CALL:        return "ARCISD::CALL";
+    case ARCISD::TAIL_CALL:   return "ARCISD::TAIL_CALL";
     case ARCISD::CMP:         return "ARCISD::CMP";
     case ARCISD::BR_CC:       return "ARCISD::BR_CC";
     case ARCISD::SELECT_CC:   return "ARCISD::SELECT_CC";
+    case ARCISD::MIN:         return "ARCISD::MIN";
+    case ARCISD::MAX:         return "ARCISD::MAX";
     case ARCISD::Wrapper:     return "ARCISD::Wrapper";
+    case ARCISD::MUL64:       return "ARCISD::MUL64";
+    case ARCISD::MULU64:      return "ARCISD::MULU64";
+    case ARCISD::NORM:        return "ARCISD::NORM";
+    case ARCISD::MEMCPY:      return "ARCISD::MEMCPY";
+    case ARCISD::MEMMOVE:     return "ARCISD::MEMMOVE";
+    case ARCISD::MEMSET:      return "ARCISD::MEMSET";
     case ARCISD::RET_FLAG:    return "ARCISD::RET_FLAG";
+    case ARCISD::RET_INTR:    return "ARCISD::RET_INTR";
     default:                  return 0;
   }
 }
@@ -132,17 +226,52 @@ SDValue ARCompactTargetLowering::LowerOperation(SDValue Op, SelectionDAG &DAG)
   //DEBUG(dbgs() << "ARCompactTargetLowering::LowerOperation()\n");
   switch (Op.getOpcode()) {
     case ISD::GlobalAddress:        return LowerGlobalAddress(Op, DAG);
+    case ISD::JumpTable:            return LowerJumpTable(Op, DAG);
     case ISD::BR_CC:                return LowerBR_CC(Op, DAG);
     case ISD::SELECT_CC:            return LowerSELECT_CC(Op, DAG);
+    case ISD::SETCC:                return LowerSETCC(Op, DAG);
+    case ISD::SHL_PARTS:
+    case ISD::SRL_PARTS:
+    case ISD::SRA_PARTS:            return LowerShiftParts(Op, DAG);
     case ISD::VASTART:              return LowerVASTART(Op, DAG);
     case ISD::FRAMEADDR:            return LowerFRAMEADDR(Op, DAG);
     case ISD::RETURNADDR:           return LowerRETURNADDR(Op, DAG);
+    case ISD::MUL:
+    case ISD::MULHS:
+    case ISD::MULHU:
+    case ISD::SMUL_LOHI:
+    case ISD::UMUL_LOHI:            return LowerMUL64(Op, DAG);
+    case ISD::CTLZ:                 return LowerCTLZ(Op, DAG);
+    case ISD::CTTZ:
+    case ISD::CTTZ_ZERO_UNDEF:      return LowerCTTZ(Op, DAG);
+    case ISD::CTPOP:                return LowerCTPOP(Op, DAG);
+    case ISD::BSWAP:                return LowerBSWAP(Op, DAG);
+    case ISD::INTRINSIC_WO_CHAIN:   return LowerINTRINSIC_WO_CHAIN(Op, DAG);
     default:
       assert(0 && "Unimplemented operation!");
       return SDValue();
   }
 }
 
+void ARCompactTargetLowering::ReplaceNodeResults(SDNode *N,
+    SmallVectorImpl<SDValue> &Results, SelectionDAG &DAG) const {
+  if (N->getOpcode() != ISD::BSWAP) {
+    return;
+  }
+
+  // Only the bottom two bytes are wanted, so the upper bits of the promoted
+  // value can be left as they are.
+  DebugLoc dl = N->getDebugLoc();
+  SDValue Src = DAG.getNode(ISD::ANY_EXTEND, dl, MVT::i32, N->getOperand(0));
+  SDValue Eight = DAG.getConstant(8, MVT::i32);
+  SDValue Hi = DAG.getNode(ISD::SHL, dl, MVT::i32, Src, Eight);
+  SDValue Lo = DAG.getNode(ISD::AND, dl, MVT::i32,
+                           DAG.getNode(ISD::SRL, dl, MVT::i32, Src, Eight),
+                           DAG.getConstant(0xFF, MVT::i32));
+  Results.push_back(DAG.getNode(ISD::TRUNCATE, dl, MVT::i16,
+                                DAG.getNode(ISD::OR, dl, MVT::i32, Hi, Lo)));
+}
+
 SDValue ARCompactTargetLowering::LowerVASTART(SDValue Op, SelectionDAG &DAG) const {
   MachineFunction &MF = DAG.getMachineFunction();
   ARCompactMachineFunctionInfo *FuncInfo = MF.getInfo<ARCompactMachineFunctionInfo>();
@@ -174,6 +303,11 @@ SDValue ARCompactTargetLowering::LowerFormalArguments(SDValue Chain,
   MachineFrameInfo *MFI = MF.getFrameInfo();
   ARCompactMachineFunctionInfo *AFI = MF.getInfo<ARCompactMachineFunctionInfo>();
 
+  // Nothing is passed to an interrupt handler.
+  if (AFI->isInterruptHandler() && !Ins.empty()) {
+    report_fatal_error("ISRs cannot have arguments");
+  }
+
   // Assign locations to all of the incoming arguments.
   SmallVector<CCValAssign, 16> ArgLocs;
   CCState CCInfo(CallConv, isVarArg, DAG.getMachineFunction(),
@@ -241,9 +375,6 @@ SDValue ARCompactTargetLowering::LowerFormalArguments(SDValue Chain,
     // Update the ARCompactMachineFunctionInfo with the details about the varargs.
     AFI->setVarArgsRegSaveSize(VARegSaveSize);
     int64_t offset = CCInfo.getNextStackOffset() + VARegSaveSize - VARegSize;
-    // Adjust the offset for the fact that the save locations starts at least 8
-    // above the FP, not at the FP.
-    offset += 8;
     //dbgs() << "offset: " << offset << "\n";
     AFI->setVarArgsFrameIndex(MFI->CreateFixedObject(VARegSaveSize,
         offset, false));
@@ -284,6 +415,18 @@ SDValue ARCompactTargetLowering::LowerReturn(SDValue Chain,
     const {
   //DEBUG(dbgs() << "ARCompactTargetLowering::LowerReturn()\n");
   MachineFunction &MF = DAG.getMachineFunction();
+  const ARCompactMachineFunctionInfo *AFI =
+      MF.getInfo<ARCompactMachineFunctionInfo>();
+
+  // An interrupt handler returns nothing, through the link register of its
+  // interrupt level.
+  if (AFI->isInterruptHandler()) {
+    if (!Outs.empty()) {
+      report_fatal_error("ISRs cannot return any value");
+    }
+    return DAG.getNode(ARCISD::RET_INTR, dl, MVT::Other, Chain,
+        DAG.getTargetConstant(AFI->getInterruptLevel(), MVT::i32));
+  }
 
   // CCValAssign - represent the assignment of the return value to locations.
   SmallVector<CCValAssign, 16> RVLocs;
@@ -339,8 +482,11 @@ SDValue ARCompactTargetLowering::LowerCall(SDValue Chain, SDValue Callee,
   //DEBUG(dbgs() << "ARCompactTargetLowering::LowerCall()\n");
   //DEBUG(Chain.getNode()->dump());
   //DEBUG(dbgs() << "isVarArg? " << isVarArg << "\n");
-  // ARCompact does not support tail calls yet.
-  isTailCall = false;
+
+  if (CallConv == CallingConv::ARC_INTR1 ||
+      CallConv == CallingConv::ARC_INTR2) {
+    report_fatal_error("ISRs cannot be called directly");
+  }
 
   // Analyze operands of the call, assigning locations to each operand.
   SmallVector<CCValAssign, 16> ArgLocs;
@@ -352,8 +498,20 @@ SDValue ARCompactTargetLowering::LowerCall(SDValue Chain, SDValue Callee,
   // Get a count of how many bytes are to be pushed on the stack.
   unsigned NumBytes = CCInfo.getNextStackOffset();
 
-  Chain = DAG.getCALLSEQ_START(Chain,
-      DAG.getConstant(NumBytes, getPointerTy(), true));
+  // Only sibling calls are supported, so GuaranteedTailCallOpt is ignored.
+  if (isTailCall) {
+    isTailCall = IsEligibleForTailCallOptimization(CallConv, isVarArg,
+        NumBytes, Outs, DAG);
+    if (isTailCall) {
+      ++NumTailCalls;
+    }
+  }
+
+  // A sibling call has no call frame of its own.
+  if (!isTailCall) {
+    Chain = DAG.getCALLSEQ_START(Chain,
+        DAG.getConstant(NumBytes, getPointerTy(), true));
+  }
 
   SmallVector<std::pair<unsigned, SDValue>, 4> RegsToPass;
   SmallVector<SDValue, 12> MemOpChains;
@@ -451,6 +609,12 @@ SDValue ARCompactTargetLowering::LowerCall(SDValue Chain, SDValue Callee,
     Ops.push_back(InFlag);
   }
 
+  // The sibling call also returns from this function, so there are no
+  // results to copy out.
+  if (isTailCall) {
+    return DAG.getNode(ARCISD::TAIL_CALL, dl, NodeTys, &Ops[0], Ops.size());
+  }
+
   Chain = DAG.getNode(ARCISD::CALL, dl, NodeTys, &Ops[0], Ops.size());
   InFlag = Chain.getValue(1);
 
@@ -466,6 +630,42 @@ SDValue ARCompactTargetLowering::LowerCall(SDValue Chain, SDValue Callee,
       InVals);
 }
 
+bool ARCompactTargetLowering::IsEligibleForTailCallOptimization(
+    CallingConv::ID CalleeCC, bool isVarArg, unsigned NumStackBytes,
+    const SmallVectorImpl<ISD::OutputArg> &Outs, SelectionDAG &DAG) const {
+  const MachineFunction &MF = DAG.getMachineFunction();
+  const Function *CallerF = MF.getFunction();
+
+  if (getTargetMachine().Options.DisableTailCalls) {
+    return false;
+  }
+
+  // The callee must expect the same registers to be preserved, and find its
+  // arguments in the same places, as the caller's caller set up.
+  if (CalleeCC != CallerF->getCallingConv()) {
+    return false;
+  }
+
+  // The callee's stack arguments would have to be written over the caller's
+  // incoming arguments, which may still be in use. Variadic callers also
+  // pop their register save area in the epilogue.
+  if (NumStackBytes != 0 || isVarArg || CallerF->isVarArg()) {
+    return false;
+  }
+
+  // A struct return pointer must be handed back in R0 by its own function.
+  if (CallerF->hasStructRetAttr()) {
+    return false;
+  }
+  for (unsigned i = 0, e = Outs.size(); i != e; ++i) {
+    if (Outs[i].Flags.isSRet() || Outs[i].Flags.isByVal()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 SDValue ARCompactTargetLowering::LowerCallResult(SDValue Chain, SDValue InFlag,
     CallingConv::ID CallConv, bool isVarArg,
     const SmallVectorImpl<ISD::InputArg> &Ins,
@@ -495,6 +695,203 @@ EVT ARCompactTargetLowering::getSetCCResultType(EVT VT) const {
   return MVT::i32;
 }
 
+/// isLegalAddressingMode - The loads and stores take a register plus a
+/// signed 9-bit offset, which the .as forms scale by the size of the access,
+/// or a long immediate address. Loads also take a register plus a register,
+/// which the .as forms scale. Stores have no register + register form, but
+/// an ADD1/ADD2 makes up the address in a single instruction.
+bool ARCompactTargetLowering::isLegalAddressingMode(const AddrMode &AM,
+    Type *Ty) const {
+  unsigned Size = Ty->isSized() ? TD->getTypeAllocSize(Ty) : 0;
+
+  // [limm] addresses an absolute global, offset included.
+  if (AM.BaseGV) {
+    return !AM.HasBaseReg && AM.Scale == 0;
+  }
+
+  bool ScaledOffset = (Size == 2 || Size == 4) && AM.BaseOffs % Size == 0 &&
+      isInt<9>(AM.BaseOffs / Size);
+  if (!isInt<9>(AM.BaseOffs) && !ScaledOffset) {
+    return false;
+  }
+
+  switch (AM.Scale) {
+    case 0:
+      // [r,s9], or [s9] with a zero base.
+      return true;
+    case 1:
+      // [r,r], or [r,s9] if there is no base register.
+      return !AM.HasBaseReg || AM.BaseOffs == 0;
+    default:
+      // [r,r] with the index scaled by the size of the access, or r + r for
+      // an index scaled by two with no base register.
+      if (AM.BaseOffs != 0) {
+        return false;
+      }
+      if (!AM.HasBaseReg) {
+        return AM.Scale == 2;
+      }
+      return (uint64_t)AM.Scale == Size && (Size == 2 || Size == 4);
+  }
+}
+
+/// isLegalICmpImmediate - CMP takes a signed 12-bit immediate in place of its
+/// second operand. Anything wider needs a long immediate word, which costs as
+/// much to fetch as another instruction.
+bool ARCompactTargetLowering::isLegalICmpImmediate(int64_t Imm) const {
+  return isInt<12>(Imm);
+}
+
+/// isLegalAddImmediate - ADD takes a signed 12-bit immediate if the
+/// destination is also the first source, and an unsigned 6-bit one otherwise.
+/// Small negative values are handled by SUB.
+bool ARCompactTargetLowering::isLegalAddImmediate(int64_t Imm) const {
+  return isInt<12>(Imm);
+}
+
+/// getIndexedIncrement - Returns true if Op adds a constant which fits the
+/// signed 9-bit offset of the .a and .ab modes to a register, setting Base
+/// and Offset to its operands.
+static bool getIndexedIncrement(SDValue Op, SDValue &Base, SDValue &Offset) {
+  if (Op.getOpcode() != ISD::ADD) {
+    return false;
+  }
+
+  // A frame index base would have to be materialised to be updated, which
+  // saves nothing.
+  ConstantSDNode *CN = dyn_cast<ConstantSDNode>(Op.getOperand(1));
+  if (!CN || !isInt<9>(CN->getSExtValue()) ||
+      isa<FrameIndexSDNode>(Op.getOperand(0))) {
+    return false;
+  }
+
+  Base = Op.getOperand(0);
+  Offset = Op.getOperand(1);
+  return true;
+}
+
+/// getPreIndexedAddressParts - Returns true if the address of the load or
+/// store N can be computed by the .a mode, which adds the offset to the base
+/// register before the access and writes it back.
+bool ARCompactTargetLowering::getPreIndexedAddressParts(SDNode *N,
+    SDValue &Base, SDValue &Offset, ISD::MemIndexedMode &AM,
+    SelectionDAG &DAG) const {
+  SDValue Ptr;
+  if (LoadSDNode *LD = dyn_cast<LoadSDNode>(N)) {
+    Ptr = LD->getBasePtr();
+  } else if (StoreSDNode *ST = dyn_cast<StoreSDNode>(N)) {
+    Ptr = ST->getBasePtr();
+  } else {
+    return false;
+  }
+
+  if (!getIndexedIncrement(Ptr, Base, Offset)) {
+    return false;
+  }
+  AM = ISD::PRE_INC;
+  return true;
+}
+
+/// getPostIndexedAddressParts - Returns true if Op, an update of the address
+/// of the load or store N, can be folded into it as the .ab mode, which adds
+/// the offset to the base register after the access.
+bool ARCompactTargetLowering::getPostIndexedAddressParts(SDNode *N,
+    SDNode *Op, SDValue &Base, SDValue &Offset, ISD::MemIndexedMode &AM,
+    SelectionDAG &DAG) const {
+  if (!isa<LoadSDNode>(N) && !isa<StoreSDNode>(N)) {
+    return false;
+  }
+
+  if (!getIndexedIncrement(SDValue(Op, 0), Base, Offset)) {
+    return false;
+  }
+  AM = ISD::POST_INC;
+  return true;
+}
+
+FastISel *
+ARCompactTargetLowering::createFastISel(FunctionLoweringInfo &funcInfo) const {
+  return ARCompact::createFastISel(funcInfo);
+}
+
+/// EmitCMP64 - Emits the compare of two 64-bit values, returning the glue
+/// for the flags. Equality is tested by ORing together the differences of
+/// the halves. Otherwise the low words are compared, and the high words then
+/// subtracted with SBC.F, which leaves the carry, negative and overflow flags
+/// of the whole 64-bit subtraction, but not its zero flag. CC is changed to
+/// LT, GE, LO or HS, by swapping the operands or adjusting a constant RHS.
+static SDValue EmitCMP64(SDValue &LHS, SDValue &RHS, ISD::CondCode &CC,
+    DebugLoc dl, SelectionDAG &DAG) {
+  // Keep any constant on the right, where the immediate forms take it.
+  if (isa<ConstantSDNode>(LHS) && !isa<ConstantSDNode>(RHS)) {
+    std::swap(LHS, RHS);
+    CC = ISD::getSetCCSwappedOperands(CC);
+  }
+
+  switch (CC) {
+    default:
+      break;
+    case ISD::SETGT:
+    case ISD::SETLE:
+    case ISD::SETUGT:
+    case ISD::SETULE: {
+      bool IsSigned = CC == ISD::SETGT || CC == ISD::SETLE;
+      bool IsGreater = CC == ISD::SETGT || CC == ISD::SETUGT;
+      ConstantSDNode *C = dyn_cast<ConstantSDNode>(RHS);
+      if (!C) {
+        std::swap(LHS, RHS);
+        CC = ISD::getSetCCSwappedOperands(CC);
+        break;
+      }
+
+      // X > C is X >= C + 1, unless C is the largest value, when X > C is
+      // never true, like X < 0 (unsigned).
+      const APInt &Val = C->getAPIntValue();
+      if (IsSigned ? Val.isMaxSignedValue() : Val.isMaxValue()) {
+        RHS = DAG.getConstant(0, MVT::i64);
+        CC = IsGreater ? ISD::SETULT : ISD::SETUGE;
+      } else {
+        RHS = DAG.getConstant(Val + 1, MVT::i64);
+        if (IsGreater) {
+          CC = IsSigned ? ISD::SETGE : ISD::SETUGE;
+        } else {
+          CC = IsSigned ? ISD::SETLT : ISD::SETULT;
+        }
+      }
+      break;
+    }
+  }
+
+  SDValue LHSLo = DAG.getNode(ISD::EXTRACT_ELEMENT, dl, MVT::i32, LHS,
+                              DAG.getIntPtrConstant(0));
+  SDValue LHSHi = DAG.getNode(ISD::EXTRACT_ELEMENT, dl, MVT::i32, LHS,
+                              DAG.getIntPtrConstant(1));
+  SDValue RHSLo = DAG.getNode(ISD::EXTRACT_ELEMENT, dl, MVT::i32, RHS,
+                              DAG.getIntPtrConstant(0));
+  SDValue RHSHi = DAG.getNode(ISD::EXTRACT_ELEMENT, dl, MVT::i32, RHS,
+                              DAG.getIntPtrConstant(1));
+
+  if (CC == ISD::SETEQ || CC == ISD::SETNE) {
+    SDValue Diff = DAG.getNode(ISD::OR, dl, MVT::i32,
+        DAG.getNode(ISD::XOR, dl, MVT::i32, LHSLo, RHSLo),
+        DAG.getNode(ISD::XOR, dl, MVT::i32, LHSHi, RHSHi));
+    return DAG.getNode(ARCISD::CMP, dl, MVT::Glue, Diff,
+                       DAG.getConstant(0, MVT::i32));
+  }
+
+  // With a zero low word on the right, which includes comparing with zero,
+  // the result only depends on the high words.
+  ConstantSDNode *RHSLoC = dyn_cast<ConstantSDNode>(RHSLo);
+  if (RHSLoC && RHSLoC->isNullValue()) {
+    return DAG.getNode(ARCISD::CMP, dl, MVT::Glue, LHSHi, RHSHi);
+  }
+
+  SDValue Flag = DAG.getNode(ARCISD::CMP, dl, MVT::Glue, LHSLo, RHSLo);
+  SDValue Hi = DAG.getNode(ISD::SUBE, dl, DAG.getVTList(MVT::i32, MVT::Glue),
+                           LHSHi, RHSHi, Flag);
+  return Hi.getValue(1);
+}
+
 // Emits and returns an ARCompact compare instruction for the given
 // ISD::CondCode.
 static SDValue EmitCMP(SDValue &LHS, SDValue &RHS, SDValue &TargetCC,
@@ -502,6 +899,13 @@ static SDValue EmitCMP(SDValue &LHS, SDValue &RHS, SDValue &TargetCC,
   //DEBUG(dbgs() << "ARCompactTargetLowering::EmitCMP()\n");
   assert(!LHS.getValueType().isFloatingPoint() && "We don't do FP");
 
+  SDValue Flag;
+  if (LHS.getValueType() == MVT::i64) {
+    Flag = EmitCMP64(LHS, RHS, CC, dl, DAG);
+  } else {
+    Flag = DAG.getNode(ARCISD::CMP, dl, MVT::Glue, LHS, RHS);
+  }
+
   // From the ISD::CondCode documentation:
   //   For integer, only the SETEQ,SETNE,SETLT,SETLE,SETGT,
   //   SETGE,SETULT,SETULE,SETUGT, and SETUGE opcodes are used.
@@ -544,7 +948,7 @@ static SDValue EmitCMP(SDValue &LHS, SDValue &RHS, SDValue &TargetCC,
   }
 
   TargetCC = DAG.getConstant(TCC, MVT::i32);
-  return DAG.getNode(ARCISD::CMP, dl, MVT::Glue, LHS, RHS);
+  return Flag;
 }
 
 
@@ -569,6 +973,34 @@ SDValue ARCompactTargetLowering::LowerBR_CC(SDValue Op, SelectionDAG &DAG)
       Chain, Dest, TargetCC, Flag);
 }
 
+/// getMinMaxOpcode - Returns ARCISD::MIN or ARCISD::MAX if selecting TrueV or
+/// FalseV by comparing LHS with RHS gives the smaller or larger of the two as
+/// signed integers, or zero otherwise.
+static unsigned getMinMaxOpcode(SDValue LHS, SDValue RHS, SDValue TrueV,
+                                SDValue FalseV, ISD::CondCode CC) {
+  bool IsMax;
+  switch (CC) {
+    case ISD::SETGT:
+    case ISD::SETGE:
+      IsMax = true;
+      break;
+    case ISD::SETLT:
+    case ISD::SETLE:
+      IsMax = false;
+      break;
+    default:
+      return 0;
+  }
+
+  if (TrueV == RHS && FalseV == LHS) {
+    IsMax = !IsMax;
+  } else if (TrueV != LHS || FalseV != RHS) {
+    return 0;
+  }
+
+  return IsMax ? ARCISD::MAX : ARCISD::MIN;
+}
+
 SDValue ARCompactTargetLowering::LowerSELECT_CC(SDValue Op, SelectionDAG &DAG)
     const {
   // Arguments are the lhs, rhs, true value, false value, and condition code.
@@ -579,12 +1011,28 @@ SDValue ARCompactTargetLowering::LowerSELECT_CC(SDValue Op, SelectionDAG &DAG)
   ISD::CondCode CC = cast<CondCodeSDNode>(Op.getOperand(4))->get();
   DebugLoc dl    = Op.getDebugLoc();
 
+  // Selects between the operands of a signed compare are MIN or MAX.
+  unsigned MinMaxOpc = getMinMaxOpcode(LHS, RHS, TrueV, FalseV, CC);
+  if (MinMaxOpc != 0) {
+    return DAG.getNode(MinMaxOpc, dl, Op.getValueType(), LHS, RHS);
+  }
+
   SDValue TargetCC;
 
   // Emit a compare instruction to perform the compare and return it
   // so that the select can refer to it.
   SDValue Flag = EmitCMP(LHS, RHS, TargetCC, CC, dl, DAG);
 
+  // Only the value moved in by the MOV.cc may be an immediate; the other
+  // must already be in the destination register. Invert the condition if
+  // that puts a constant in the MOV.cc.
+  if (isa<ConstantSDNode>(FalseV) && !isa<ConstantSDNode>(TrueV)) {
+    std::swap(TrueV, FalseV);
+    ARCCC::CondCodes TCC = (ARCCC::CondCodes)
+        cast<ConstantSDNode>(TargetCC)->getZExtValue();
+    TargetCC = DAG.getConstant(ARCCC::getOppositeCondition(TCC), MVT::i32);
+  }
+
   SDVTList VTs = DAG.getVTList(Op.getValueType(), MVT::Glue);
   SmallVector<SDValue, 4> Ops;
   Ops.push_back(TrueV);
@@ -592,11 +1040,297 @@ SDValue ARCompactTargetLowering::LowerSELECT_CC(SDValue Op, SelectionDAG &DAG)
   Ops.push_back(TargetCC);
   Ops.push_back(Flag);
 
-  // Lower it to an ARCISD::SELECT_CC, which EmitInstrWithCustomInserter
-  // will take care of.
+  // Lower it to an ARCISD::SELECT_CC, which is selected to a MOV.cc, so no
+  // new blocks are needed.
   return DAG.getNode(ARCISD::SELECT_CC, dl, VTs, &Ops[0], Ops.size());
 }
 
+SDValue ARCompactTargetLowering::LowerSETCC(SDValue Op, SelectionDAG &DAG)
+    const {
+  // Only the 64-bit compares get here. They become a select of one or zero.
+  DebugLoc dl = Op.getDebugLoc();
+  EVT VT = Op.getValueType();
+  ISD::CondCode CC = cast<CondCodeSDNode>(Op.getOperand(2))->get();
+  SDValue Select = DAG.getSelectCC(dl, Op.getOperand(0), Op.getOperand(1),
+                                   DAG.getConstant(1, VT),
+                                   DAG.getConstant(0, VT), CC);
+  return LowerSELECT_CC(Select, DAG);
+}
+
+/// LowerShiftParts - Lowers the shift of a 64-bit value, given as its low and
+/// high words, by a variable amount. The shifts only use the bottom five bits
+/// of the amount, so a shift by 32 or more is the shift of one word into the
+/// other, selected by bit 5 of the amount. The bits carried between the words
+/// by a smaller shift are shifted one place first, and then by 31 minus the
+/// amount, so that a shift by zero carries nothing.
+SDValue ARCompactTargetLowering::LowerShiftParts(SDValue Op,
+    SelectionDAG &DAG) const {
+  unsigned Opc = Op.getOpcode();
+  DebugLoc dl = Op.getDebugLoc();
+  EVT VT = Op.getValueType();
+  SDValue Lo = Op.getOperand(0);
+  SDValue Hi = Op.getOperand(1);
+  SDValue Amt = Op.getOperand(2);
+  EVT AmtVT = Amt.getValueType();
+
+  SDValue One = DAG.getConstant(1, AmtVT);
+  SDValue RevAmt = DAG.getNode(ISD::XOR, dl, AmtVT, Amt,
+                               DAG.getConstant(31, AmtVT));
+  SDValue IsBig = DAG.getNode(ISD::AND, dl, AmtVT, Amt,
+                              DAG.getConstant(32, AmtVT));
+  SDValue Zero = DAG.getConstant(0, VT);
+
+  // From and To are the words the bits are shifted from and to, which are
+  // the low and high words for a left shift.
+  SDValue From = Opc == ISD::SHL_PARTS ? Lo : Hi;
+  SDValue To = Opc == ISD::SHL_PARTS ? Hi : Lo;
+  unsigned FromShift, ToShift, CarryShift;
+  if (Opc == ISD::SHL_PARTS) {
+    FromShift = ISD::SHL;
+    CarryShift = ISD::SRL;
+    ToShift = ISD::SHL;
+  } else {
+    FromShift = Opc == ISD::SRA_PARTS ? ISD::SRA : ISD::SRL;
+    CarryShift = ISD::SHL;
+    ToShift = ISD::SRL;
+  }
+
+  SDValue Carried = DAG.getNode(CarryShift, dl, VT,
+                                DAG.getNode(CarryShift, dl, VT, From, One),
+                                RevAmt);
+  SDValue SmallTo = DAG.getNode(ISD::OR, dl, VT,
+                                DAG.getNode(ToShift, dl, VT, To, Amt),
+                                Carried);
+  SDValue Shifted = DAG.getNode(FromShift, dl, VT, From, Amt);
+
+  // A big shift leaves the sign in the word shifted from, or zero.
+  SDValue BigFrom = Zero;
+  if (Opc == ISD::SRA_PARTS) {
+    BigFrom = DAG.getNode(ISD::SRA, dl, VT, From,
+                          DAG.getConstant(31, AmtVT));
+  }
+
+  SDValue NewTo = LowerSELECT_CC(
+      DAG.getSelectCC(dl, IsBig, DAG.getConstant(0, AmtVT), SmallTo, Shifted,
+                      ISD::SETEQ), DAG);
+  SDValue NewFrom = LowerSELECT_CC(
+      DAG.getSelectCC(dl, IsBig, DAG.getConstant(0, AmtVT), Shifted, BigFrom,
+                      ISD::SETEQ), DAG);
+
+  SDValue Ops[2];
+  Ops[0] = Opc == ISD::SHL_PARTS ? NewFrom : NewTo;
+  Ops[1] = Opc == ISD::SHL_PARTS ? NewTo : NewFrom;
+  return DAG.getMergeValues(Ops, 2, dl);
+}
+
+SDValue ARCompactTargetLowering::LowerMUL64(SDValue Op, SelectionDAG &DAG)
+    const {
+  unsigned Opc = Op.getOpcode();
+  DebugLoc dl = Op.getDebugLoc();
+
+  bool IsSigned = Opc == ISD::MUL || Opc == ISD::MULHS ||
+                  Opc == ISD::SMUL_LOHI;
+  SDValue Mul = DAG.getNode(IsSigned ? ARCISD::MUL64 : ARCISD::MULU64, dl,
+                            MVT::Glue, Op.getOperand(0), Op.getOperand(1));
+
+  // The copies out of MLO and MHI are glued to the multiply, so that nothing
+  // can clobber the result registers in between.
+  if (Opc == ISD::MUL) {
+    return DAG.getCopyFromReg(DAG.getEntryNode(), dl, ARC::MLO, MVT::i32, Mul);
+  }
+  if (Opc == ISD::MULHS || Opc == ISD::MULHU) {
+    return DAG.getCopyFromReg(DAG.getEntryNode(), dl, ARC::MHI, MVT::i32, Mul);
+  }
+
+  SDValue Lo = DAG.getCopyFromReg(DAG.getEntryNode(), dl, ARC::MLO, MVT::i32,
+                                  Mul);
+  SDValue Hi = DAG.getCopyFromReg(Lo.getValue(1), dl, ARC::MHI, MVT::i32,
+                                  Lo.getValue(2));
+  SDValue Ops[2] = { Lo, Hi };
+  return DAG.getMergeValues(Ops, 2, dl);
+}
+
+SDValue ARCompactTargetLowering::LowerCTLZ(SDValue Op, SelectionDAG &DAG)
+    const {
+  // CTLZ_ZERO_UNDEF is selected to a NORM (see ARCompactInstrInfo.td), which
+  // gives 31 rather than 32 for a zero input, so zero is handled separately.
+  DebugLoc dl = Op.getDebugLoc();
+  EVT VT = Op.getValueType();
+  SDValue Src = Op.getOperand(0);
+  SDValue Zero = DAG.getConstant(0, VT);
+  SDValue Count = DAG.getNode(ISD::CTLZ_ZERO_UNDEF, dl, VT, Src);
+  SDValue Select = DAG.getSelectCC(dl, Src, Zero, DAG.getConstant(32, VT),
+                                   Count, ISD::SETEQ);
+  return LowerSELECT_CC(Select, DAG);
+}
+
+SDValue ARCompactTargetLowering::LowerCTTZ(SDValue Op, SelectionDAG &DAG)
+    const {
+  // ~x & (x - 1) has a one for each trailing zero of x, and nothing above
+  // them, so 31 less its NORM is the count. This gives 0 rather than 32 for
+  // a zero input, for which the mask is -1.
+  DebugLoc dl = Op.getDebugLoc();
+  EVT VT = Op.getValueType();
+  SDValue Src = Op.getOperand(0);
+  SDValue Mask = DAG.getNode(ISD::AND, dl, VT, DAG.getNOT(dl, Src, VT),
+                             DAG.getNode(ISD::ADD, dl, VT, Src,
+                                         DAG.getConstant(-1, VT)));
+  SDValue Count = DAG.getNode(ISD::SUB, dl, VT, DAG.getConstant(31, VT),
+                              DAG.getNode(ARCISD::NORM, dl, VT, Mask));
+  if (Op.getOpcode() == ISD::CTTZ_ZERO_UNDEF) {
+    return Count;
+  }
+  SDValue Zero = DAG.getConstant(0, VT);
+  SDValue Select = DAG.getSelectCC(dl, Src, Zero, DAG.getConstant(32, VT),
+                                   Count, ISD::SETEQ);
+  return LowerSELECT_CC(Select, DAG);
+}
+
+SDValue ARCompactTargetLowering::LowerCTPOP(SDValue Op, SelectionDAG &DAG)
+    const {
+  // The bits are summed in pairs, then nibbles, then bytes. The bytes are
+  // added together with a multiply by 0x01010101 where MPY is available, and
+  // otherwise with shifts, rather than with a call to __mulsi3.
+  DebugLoc dl = Op.getDebugLoc();
+  EVT VT = Op.getValueType();
+  SDValue Src = Op.getOperand(0);
+  SDValue Pairs = DAG.getNode(ISD::SUB, dl, VT, Src,
+      DAG.getNode(ISD::AND, dl, VT,
+                  DAG.getNode(ISD::SRL, dl, VT, Src, DAG.getConstant(1, VT)),
+                  DAG.getConstant(0x55555555, VT)));
+  SDValue Mask2 = DAG.getConstant(0x33333333, VT);
+  SDValue Nibbles = DAG.getNode(ISD::ADD, dl, VT,
+      DAG.getNode(ISD::AND, dl, VT, Pairs, Mask2),
+      DAG.getNode(ISD::AND, dl, VT,
+                  DAG.getNode(ISD::SRL, dl, VT, Pairs, DAG.getConstant(2, VT)),
+                  Mask2));
+  SDValue Bytes = DAG.getNode(ISD::AND, dl, VT,
+      DAG.getNode(ISD::ADD, dl, VT, Nibbles,
+                  DAG.getNode(ISD::SRL, dl, VT, Nibbles,
+                              DAG.getConstant(4, VT))),
+      DAG.getConstant(0x0F0F0F0F, VT));
+
+  if (isOperationLegal(ISD::MUL, VT)) {
+    SDValue Sum = DAG.getNode(ISD::MUL, dl, VT, Bytes,
+                              DAG.getConstant(0x01010101, VT));
+    return DAG.getNode(ISD::SRL, dl, VT, Sum, DAG.getConstant(24, VT));
+  }
+
+  SDValue Halves = DAG.getNode(ISD::ADD, dl, VT, Bytes,
+      DAG.getNode(ISD::SRL, dl, VT, Bytes, DAG.getConstant(8, VT)));
+  SDValue Sum = DAG.getNode(ISD::ADD, dl, VT, Halves,
+      DAG.getNode(ISD::SRL, dl, VT, Halves, DAG.getConstant(16, VT)));
+  return DAG.getNode(ISD::AND, dl, VT, Sum, DAG.getConstant(0x3F, VT));
+}
+
+SDValue ARCompactTargetLowering::LowerBSWAP(SDValue Op, SelectionDAG &DAG)
+    const {
+  DebugLoc dl = Op.getDebugLoc();
+  EVT VT = Op.getValueType();
+  SDValue Src = Op.getOperand(0);
+  SDValue EvenBytes = DAG.getConstant(0x00FF00FF, VT);
+  SDValue OddBytes = DAG.getConstant(0xFF00FF00, VT);
+
+  // Rotating by 8 puts bytes 0 and 2 in place, and rotating by 24 puts bytes
+  // 1 and 3 in place.
+  if (isOperationLegal(ISD::ROTR, VT)) {
+    SDValue Ror8 = DAG.getNode(ISD::ROTR, dl, VT, Src, DAG.getConstant(8, VT));
+    SDValue Ror24 = DAG.getNode(ISD::ROTR, dl, VT, Src,
+                                DAG.getConstant(24, VT));
+    return DAG.getNode(ISD::OR, dl, VT,
+                       DAG.getNode(ISD::AND, dl, VT, Ror8, OddBytes),
+                       DAG.getNode(ISD::AND, dl, VT, Ror24, EvenBytes));
+  }
+
+  // Otherwise the half-words are exchanged with a SWAP (see the patterns in
+  // ARCompactInstrInfo.td), and then the bytes within each half-word.
+  SDValue Sixteen = DAG.getConstant(16, VT);
+  SDValue Eight = DAG.getConstant(8, VT);
+  SDValue Swap = DAG.getNode(ISD::OR, dl, VT,
+                             DAG.getNode(ISD::SHL, dl, VT, Src, Sixteen),
+                             DAG.getNode(ISD::SRL, dl, VT, Src, Sixteen));
+  return DAG.getNode(ISD::OR, dl, VT,
+      DAG.getNode(ISD::AND, dl, VT,
+                  DAG.getNode(ISD::SHL, dl, VT, Swap, Eight), OddBytes),
+      DAG.getNode(ISD::AND, dl, VT,
+                  DAG.getNode(ISD::SRL, dl, VT, Swap, Eight), EvenBytes));
+}
+
+SDValue ARCompactTargetLowering::LowerINTRINSIC_WO_CHAIN(SDValue Op,
+    SelectionDAG &DAG) const {
+  const ARCompactSubtarget &Subtarget =
+      getTargetMachine().getSubtarget<ARCompactSubtarget>();
+  unsigned IntNo = cast<ConstantSDNode>(Op.getOperand(0))->getZExtValue();
+  DebugLoc dl = Op.getDebugLoc();
+  EVT VT = Op.getValueType();
+  SDValue Src = Op.getOperand(1);
+  SDValue ThirtyOne = DAG.getConstant(31, VT);
+
+  switch (IntNo) {
+    case Intrinsic::arc_adds:
+    case Intrinsic::arc_subs: {
+      if (Subtarget.hasSat()) {
+        return SDValue();
+      }
+      // The sum overflows when the operands have the same sign and the
+      // result has the other, and the difference when the operands have
+      // different signs and the result differs from the first. The result
+      // then saturates towards the sign of the first operand.
+      SDValue RHS = Op.getOperand(2);
+      bool IsAdd = IntNo == Intrinsic::arc_adds;
+      SDValue Res = DAG.getNode(IsAdd ? ISD::ADD : ISD::SUB, dl, VT, Src, RHS);
+      SDValue ResXorLHS = DAG.getNode(ISD::XOR, dl, VT, Res, Src);
+      SDValue Overflow = DAG.getNode(ISD::AND, dl, VT, ResXorLHS,
+          IsAdd ? DAG.getNode(ISD::XOR, dl, VT, Res, RHS)
+                : DAG.getNode(ISD::XOR, dl, VT, Src, RHS));
+      SDValue Sat = DAG.getNode(ISD::XOR, dl, VT,
+                                DAG.getNode(ISD::SRA, dl, VT, Src, ThirtyOne),
+                                DAG.getConstant(0x7FFFFFFF, VT));
+      SDValue Select = DAG.getSelectCC(dl, Overflow, DAG.getConstant(0, VT),
+                                       Sat, Res, ISD::SETLT);
+      return LowerSELECT_CC(Select, DAG);
+    }
+    case Intrinsic::arc_abss:
+    case Intrinsic::arc_negs: {
+      if (Subtarget.hasSat()) {
+        return SDValue();
+      }
+      // Only the most negative number overflows, giving itself, which is
+      // the only negative result of ABS and the only one with the sign of
+      // the source for NEG. Flipping all its bits gives the most positive.
+      SDValue Res, Sign;
+      if (IntNo == Intrinsic::arc_abss) {
+        // This is the form that ABS is selected from.
+        SDValue SrcSign = DAG.getNode(ISD::SRA, dl, VT, Src, ThirtyOne);
+        Res = DAG.getNode(ISD::XOR, dl, VT,
+                          DAG.getNode(ISD::ADD, dl, VT, Src, SrcSign),
+                          SrcSign);
+        Sign = Res;
+      } else {
+        Res = DAG.getNode(ISD::SUB, dl, VT, DAG.getConstant(0, VT), Src);
+        Sign = DAG.getNode(ISD::AND, dl, VT, Res, Src);
+      }
+      return DAG.getNode(ISD::XOR, dl, VT, Res,
+                         DAG.getNode(ISD::SRA, dl, VT, Sign, ThirtyOne));
+    }
+    case Intrinsic::arc_norm: {
+      if (Subtarget.hasNorm()) {
+        return SDValue();
+      }
+      // The redundant sign bits are the leading zeros, less one, of the
+      // value with its bits flipped when it is negative.
+      SDValue Flipped = DAG.getNode(ISD::XOR, dl, VT, Src,
+                                    DAG.getNode(ISD::SRA, dl, VT, Src,
+                                                ThirtyOne));
+      return DAG.getNode(ISD::ADD, dl, VT,
+                         DAG.getNode(ISD::CTLZ, dl, VT, Flipped),
+                         DAG.getConstant(-1, VT));
+    }
+    default:
+      return SDValue();
+  }
+}
+
 SDValue ARCompactTargetLowering::getReturnAddressFrameIndex(SelectionDAG &DAG)
     const {
   MachineFunction &MF = DAG.getMachineFunction();
@@ -670,64 +1404,208 @@ SDValue ARCompactTargetLowering::LowerGlobalAddress(SDValue Op,
       getPointerTy(), Result);
 }
 
+SDValue ARCompactTargetLowering::LowerJumpTable(SDValue Op,
+    SelectionDAG &DAG) const {
+  // Jump table entries are absolute addresses (EK_BlockAddress), so the table
+  // itself is addressed with a long immediate just like a global.
+  JumpTableSDNode *JT = cast<JumpTableSDNode>(Op);
+  SDValue Result = DAG.getTargetJumpTable(JT->getIndex(), getPointerTy());
+  return DAG.getNode(ARCISD::Wrapper, Op.getDebugLoc(),
+      getPointerTy(), Result);
+}
+
 MachineBasicBlock* ARCompactTargetLowering::EmitInstrWithCustomInserter(
     MachineInstr *MI, MachineBasicBlock *BB) const {
+  switch (MI->getOpcode()) {
+    case ARC::MEMCPY:
+    case ARC::MEMMOVE:
+    case ARC::MEMSET:
+      return EmitMemOp(MI, BB);
+    default:
+      llvm_unreachable("Unexpected instruction for custom inserter!");
+  }
+}
+
+/// EmitMemOp - Expands a MEMCPY, MEMMOVE or MEMSET pseudo into loops of
+/// LD.AB and ST.AB. A MEMMOVE checks at run time which way round the buffers
+/// overlap, and copies backwards (with LD.A and ST.A) if the destination is
+/// above the source.
+MachineBasicBlock *ARCompactTargetLowering::EmitMemOp(MachineInstr *MI,
+    MachineBasicBlock *BB) const {
   const TargetInstrInfo &TII = *getTargetMachine().getInstrInfo();
+  MachineRegisterInfo &MRI = BB->getParent()->getRegInfo();
   DebugLoc dl = MI->getDebugLoc();
-  assert((MI->getOpcode() == ARC::Select) && "We can only emit SELECT_CC");
-
-  // TODO: We can totally use conditional instructions here, can't we?
-
-  // To "insert" a SELECT instruction, we actually have to insert the diamond
-  // control-flow pattern.  The incoming instruction knows the destination vreg
-  // to set, the condition code register to branch on, the true/false values to
-  // select between, and a branch opcode to use.
+  unsigned Opc = MI->getOpcode();
+  unsigned Dst = MI->getOperand(0).getReg();
+  unsigned Src = MI->getOperand(1).getReg();
+  unsigned Words = MI->getOperand(2).getImm();
+  unsigned Unroll = MI->getOperand(3).getImm();
+
+  // Everything after the pseudo moves to a new block, which the copy falls
+  // through into.
   const BasicBlock *LLVM_BB = BB->getBasicBlock();
-  MachineFunction::iterator I = BB;
-  ++I;
+  MachineFunction *F = BB->getParent();
+  MachineBasicBlock *ExitMBB = F->CreateMachineBasicBlock(LLVM_BB);
+  F->insert(llvm::next(MachineFunction::iterator(BB)), ExitMBB);
+  ExitMBB->splice(ExitMBB->begin(), BB,
+                  llvm::next(MachineBasicBlock::iterator(MI)), BB->end());
+  ExitMBB->transferSuccessorsAndUpdatePHIs(BB);
+
+  if (Opc != ARC::MEMMOVE) {
+    MachineBasicBlock *End = EmitWordLoop(BB, dl, Opc == ARC::MEMSET, Dst,
+                                          Src, Words, Unroll, false);
+    End->addSuccessor(ExitMBB);
+    MI->eraseFromParent();
+    return ExitMBB;
+  }
+
+  //  thisMBB:
+  //   cmp dst,src
+  //   bhi backMBB
+  //  fwdMBB:
+  //   (forward copy)
+  //   b exitMBB
+  //  backMBB:
+  //   (backward copy)
+  MachineBasicBlock *FwdMBB = F->CreateMachineBasicBlock(LLVM_BB);
+  MachineBasicBlock *BackMBB = F->CreateMachineBasicBlock(LLVM_BB);
+  F->insert(ExitMBB, FwdMBB);
+  F->insert(ExitMBB, BackMBB);
+
+  BuildMI(BB, dl, TII.get(ARC::CMPrr)).addReg(Dst).addReg(Src);
+  BuildMI(BB, dl, TII.get(ARC::BCC)).addMBB(BackMBB).addImm(ARCCC::COND_HI);
+  BB->addSuccessor(BackMBB);
+  BB->addSuccessor(FwdMBB);
+
+  MachineBasicBlock *End = EmitWordLoop(FwdMBB, dl, false, Dst, Src, Words,
+                                        Unroll, false);
+  BuildMI(End, dl, TII.get(ARC::B)).addMBB(ExitMBB);
+  End->addSuccessor(ExitMBB);
+
+  // The backward copy starts from the ends of the buffers.
+  unsigned DstEnd = MRI.createVirtualRegister(ARC::CPURegsRegisterClass);
+  unsigned SrcEnd = MRI.createVirtualRegister(ARC::CPURegsRegisterClass);
+  BuildMI(BackMBB, dl, TII.get(ARC::ADDrli), DstEnd).addReg(Dst)
+      .addImm(Words * 4);
+  BuildMI(BackMBB, dl, TII.get(ARC::ADDrli), SrcEnd).addReg(Src)
+      .addImm(Words * 4);
+  End = EmitWordLoop(BackMBB, dl, false, DstEnd, SrcEnd, Words, Unroll, true);
+  End->addSuccessor(ExitMBB);
+
+  MI->eraseFromParent();
+  return ExitMBB;
+}
 
-  // copy0MBB is the fallthrough block, copy1MBB is the branch
-  // block.
-  MachineBasicBlock *thisMBB = BB;
+/// EmitWordLoop - Appends to BB the code to copy Words words from Src to Dst
+/// (or, if IsSet, to store the word in Src Words times), Unroll words per
+/// iteration. Any left over words are copied after the loop. Backward copies
+/// run down from just past the ends of the buffers. Returns the block which
+/// the code ends in, which has no successors yet.
+MachineBasicBlock *ARCompactTargetLowering::EmitWordLoop(
+    MachineBasicBlock *BB, DebugLoc dl, bool IsSet, unsigned Dst,
+    unsigned Src, unsigned Words, unsigned Unroll, bool Backward) const {
+  const TargetInstrInfo &TII = *getTargetMachine().getInstrInfo();
   MachineFunction *F = BB->getParent();
-  MachineBasicBlock *copy0MBB = F->CreateMachineBasicBlock(LLVM_BB);
-  MachineBasicBlock *copy1MBB = F->CreateMachineBasicBlock(LLVM_BB);
-  F->insert(I, copy0MBB);
-  F->insert(I, copy1MBB);
-
-  // Update machine-CFG edges by transferring all successors of the current
-  // block to the new block which will contain the Phi node for the select.
-  copy1MBB->splice(copy1MBB->begin(), BB,
-                   llvm::next(MachineBasicBlock::iterator(MI)),
-                   BB->end());
-  copy1MBB->transferSuccessorsAndUpdatePHIs(BB);
-
-  // Next, add the true and fallthrough blocks as its successors.
-  BB->addSuccessor(copy0MBB);
-  BB->addSuccessor(copy1MBB);
-
-  BuildMI(BB, dl, TII.get(ARC::BCC)).addMBB(copy1MBB)
-      .addImm(MI->getOperand(3).getImm());
-
-  //  copy0MBB:
-  //   %FalseValue = ...
-  //   # fallthrough to copy1MBB
-  BB = copy0MBB;
-
-  // Update machine-CFG edges
-  BB->addSuccessor(copy1MBB);
-
-  //  copy1MBB:
-  //   %Result = phi [ %FalseValue, copy0MBB ], [ %TrueValue, thisMBB ]
-  //  ...
-  BB = copy1MBB;
-  BuildMI(*BB, BB->begin(), dl, TII.get(ARC::PHI),
-          MI->getOperand(0).getReg())
-    .addReg(MI->getOperand(2).getReg()).addMBB(copy0MBB)
-    .addReg(MI->getOperand(1).getReg()).addMBB(thisMBB);
-
-  MI->eraseFromParent();   // The pseudo instruction is gone now.
-  return BB;
+  MachineRegisterInfo &MRI = F->getRegInfo();
+  const TargetRegisterClass *RC = ARC::CPURegsRegisterClass;
+  unsigned LoadOpc = Backward ? ARC::LDri_a_upd : ARC::LDri_ab_upd;
+  unsigned StoreOpc = Backward ? ARC::STrri_a_upd : ARC::STrri_ab_upd;
+  int Step = Backward ? -4 : 4;
+
+  unsigned Iterations = Words / Unroll;
+  unsigned Rest = Words % Unroll;
+  if (Iterations < 2) {
+    Rest = Words;
+    Iterations = 0;
+  }
+
+  MachineBasicBlock *LoopMBB = BB;
+  unsigned LoopDst = Dst, LoopSrc = Src;
+  unsigned Count = 0, NextCount = 0;
+  MachineInstr *DstPHI = 0, *SrcPHI = 0;
+  if (Iterations) {
+    //  thisMBB:
+    //   mov count,Iterations
+    //  loopMBB:
+    //   (Unroll loads and stores)
+    //   sub count,count,1
+    //   cmp count,0
+    //   bne loopMBB
+    //  restMBB:
+    //   (Rest loads and stores)
+    unsigned Start = MRI.createVirtualRegister(RC);
+    BuildMI(BB, dl, TII.get(ARC::MOVrli), Start).addImm(Iterations);
+
+    LoopMBB = F->CreateMachineBasicBlock(BB->getBasicBlock());
+    F->insert(llvm::next(MachineFunction::iterator(BB)), LoopMBB);
+    BB->addSuccessor(LoopMBB);
+
+    Count = MRI.createVirtualRegister(RC);
+    NextCount = MRI.createVirtualRegister(RC);
+    BuildMI(LoopMBB, dl, TII.get(ARC::PHI), Count)
+        .addReg(Start).addMBB(BB).addReg(NextCount).addMBB(LoopMBB);
+
+    LoopDst = MRI.createVirtualRegister(RC);
+    DstPHI = BuildMI(LoopMBB, dl, TII.get(ARC::PHI), LoopDst)
+        .addReg(Dst).addMBB(BB);
+    if (!IsSet) {
+      LoopSrc = MRI.createVirtualRegister(RC);
+      SrcPHI = BuildMI(LoopMBB, dl, TII.get(ARC::PHI), LoopSrc)
+          .addReg(Src).addMBB(BB);
+    }
+  }
+
+  // Emits N loads followed by N stores at the end of MBB, updating the
+  // pointers. The loads are grouped to hide their latency.
+  MachineBasicBlock *MBB = LoopMBB;
+  unsigned N = Iterations ? Unroll : Rest;
+  for (unsigned Pass = 0; Pass < 2; ++Pass) {
+    SmallVector<unsigned, 8> Values;
+    for (unsigned i = 0; i < N; ++i) {
+      if (IsSet) {
+        Values.push_back(Src);
+        continue;
+      }
+      unsigned Value = MRI.createVirtualRegister(RC);
+      unsigned NewSrc = MRI.createVirtualRegister(RC);
+      BuildMI(MBB, dl, TII.get(LoadOpc), Value).addReg(NewSrc, RegState::Define)
+          .addReg(LoopSrc).addImm(Step);
+      Values.push_back(Value);
+      LoopSrc = NewSrc;
+    }
+    for (unsigned i = 0; i < N; ++i) {
+      unsigned NewDst = MRI.createVirtualRegister(RC);
+      BuildMI(MBB, dl, TII.get(StoreOpc), NewDst).addReg(LoopDst).addImm(Step)
+          .addReg(Values[i]);
+      LoopDst = NewDst;
+    }
+
+    if (Pass == 1 || !Iterations) {
+      break;
+    }
+
+    // Close the loop, and carry on with the left over words after it.
+    BuildMI(MBB, dl, TII.get(ARC::SUBrui), NextCount).addReg(Count).addImm(1)
+        .addImm(ARCCC::COND_AL).addImm(0);
+    BuildMI(MBB, dl, TII.get(ARC::CMPrui)).addReg(NextCount).addImm(0);
+    BuildMI(MBB, dl, TII.get(ARC::BCC)).addMBB(LoopMBB)
+        .addImm(ARCCC::COND_NE);
+    DstPHI->addOperand(MachineOperand::CreateReg(LoopDst, false));
+    DstPHI->addOperand(MachineOperand::CreateMBB(LoopMBB));
+    if (SrcPHI) {
+      SrcPHI->addOperand(MachineOperand::CreateReg(LoopSrc, false));
+      SrcPHI->addOperand(MachineOperand::CreateMBB(LoopMBB));
+    }
+
+    MachineBasicBlock *RestMBB = F->CreateMachineBasicBlock(BB->getBasicBlock());
+    F->insert(llvm::next(MachineFunction::iterator(LoopMBB)), RestMBB);
+    LoopMBB->addSuccessor(LoopMBB);
+    LoopMBB->addSuccessor(RestMBB);
+    MBB = RestMBB;
+    N = Rest;
+  }
+
+  return MBB;
 }
 
 #include <iostream>
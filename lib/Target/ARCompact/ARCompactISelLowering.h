@@ -28,6 +28,10 @@ namespace llvm {
       /// instruction, which includes a bunch of information.
       CALL,
 
+      /// TAIL_CALL - A sibling call, which also returns from the caller.
+      /// Its operands are those of CALL.
+      TAIL_CALL,
+
       /// CMP - Compare instruction.
       CMP,
 
@@ -37,20 +41,50 @@ namespace llvm {
       /// instruction.
       BR_CC,
 
-      /// SELECT_CC. Operand 0 and operand 1 are the lhs/rhs, operand 2 is the
-      /// true value, operand 3 is the false value, and operand 4 is the
-      /// condition code.
+      /// SELECT_CC - Conditional move. Operand 0 is the true value, operand 1
+      /// is the false value, operand 2 is the condition code, and operand 3 is
+      /// the flag operand produced by a CMP instruction.
       SELECT_CC,
 
+      /// MIN, MAX - Signed minimum and maximum of operands 0 and 1.
+      MIN,
+      MAX,
+
       /// Wrapper - A wrapper node for TargetConstantPool, TargetExternalSymbol,
       /// and TargetGlobalAddress.
       Wrapper,
 
+      /// MUL64, MULU64 - Signed and unsigned 32-bit by 32-bit multiplies,
+      /// which write the 64-bit result to MLO/MMID/MHI. Operands 0 and 1 are
+      /// the values to multiply, and the only result is a glue.
+      MUL64,
+      MULU64,
+
+      /// NORM - The number of redundant sign bits of operand 0, which is 31
+      /// for both 0 and -1.
+      NORM,
+
+      /// MEMCPY, MEMMOVE, MEMSET - Copy, move or fill a number of words.
+      /// Operand 0 is the chain, operand 1 the destination, operand 2 the
+      /// source (or, for MEMSET, the word to store), operand 3 the number of
+      /// words, and operand 4 the unrolling factor.
+      MEMCPY,
+      MEMMOVE,
+      MEMSET,
+
       // Return with a flag operand.
-      RET_FLAG
+      RET_FLAG,
+
+      /// RET_INTR - Return from an interrupt handler. Operand 1 is the
+      /// interrupt level, which selects ILINK1 or ILINK2.
+      RET_INTR
     };
   } // end namespace ARCISD
 
+  namespace ARCompact {
+    FastISel *createFastISel(FunctionLoweringInfo &funcInfo);
+  } // end namespace ARCompact
+
   class ARCompactTargetLowering : public TargetLowering {
   public:
     ARCompactTargetLowering(ARCompactTargetMachine &TM);
@@ -60,6 +94,13 @@ namespace llvm {
     /// LowerOperation - Provide custom lowering hooks for some operations.
     virtual SDValue LowerOperation(SDValue Op, SelectionDAG &DAG) const;
 
+    /// ReplaceNodeResults - Reverses the bytes of a 16-bit value, which would
+    /// otherwise be promoted to a 32-bit BSWAP and a shift. The 64-bit
+    /// SELECT_CC is custom lowered only once its result has been split, so
+    /// nothing is done for it here.
+    virtual void ReplaceNodeResults(SDNode *N,
+        SmallVectorImpl<SDValue> &Results, SelectionDAG &DAG) const;
+
     /// This hook must be implemented to lower the incoming (formal) arguments,
     /// described by the Ins array, into the specified DAG. The implementation
     /// should fill in the InVals array with legal-type argument values, and
@@ -100,21 +141,67 @@ namespace llvm {
 
     virtual EVT getSetCCResultType(EVT VT) const;
 
+    /// isLegalAddressingMode - Return true if the addressing mode represented
+    /// by AM is legal for this target, for a load/store of the specified type.
+    virtual bool isLegalAddressingMode(const AddrMode &AM, Type *Ty) const;
+
+    /// isLegalICmpImmediate - Return true if the immediate can be compared
+    /// against without a long immediate word.
+    virtual bool isLegalICmpImmediate(int64_t Imm) const;
+
+    /// isLegalAddImmediate - Return true if the immediate can be added to a
+    /// register without a long immediate word.
+    virtual bool isLegalAddImmediate(int64_t Imm) const;
+
+    virtual bool getPreIndexedAddressParts(SDNode *N, SDValue &Base,
+        SDValue &Offset, ISD::MemIndexedMode &AM, SelectionDAG &DAG) const;
+
+    virtual bool getPostIndexedAddressParts(SDNode *N, SDNode *Op,
+        SDValue &Base, SDValue &Offset, ISD::MemIndexedMode &AM,
+        SelectionDAG &DAG) const;
+
+    /// createFastISel - This method returns a target specific FastISel object,
+    /// or null if the target does not support "fast" ISel.
+    virtual FastISel *createFastISel(FunctionLoweringInfo &funcInfo) const;
+
     SDValue getReturnAddressFrameIndex(SelectionDAG &DAG) const;
 
+    /// IsEligibleForTailCallOptimization - Returns true if the call can be
+    /// made as a sibling call, jumping to the callee after the caller's
+    /// epilogue. NumStackBytes is the size of the outgoing stack arguments.
+    bool IsEligibleForTailCallOptimization(CallingConv::ID CalleeCC,
+        bool isVarArg, unsigned NumStackBytes,
+        const SmallVectorImpl<ISD::OutputArg> &Outs,
+        SelectionDAG &DAG) const;
+
   private:
     const TargetData *TD;
 
     SDValue LowerBR_CC(SDValue Op, SelectionDAG &DAG) const;
     SDValue LowerSELECT_CC(SDValue Op, SelectionDAG &DAG) const;
+    SDValue LowerSETCC(SDValue Op, SelectionDAG &DAG) const;
+    SDValue LowerShiftParts(SDValue Op, SelectionDAG &DAG) const;
     SDValue LowerGlobalAddress(SDValue Op, SelectionDAG &DAG) const;
+    SDValue LowerJumpTable(SDValue Op, SelectionDAG &DAG) const;
     SDValue LowerVASTART(SDValue Op, SelectionDAG &DAG) const;
     SDValue LowerFRAMEADDR(SDValue Op, SelectionDAG &DAG) const;
     SDValue LowerRETURNADDR(SDValue Op, SelectionDAG &DAG) const;
+    SDValue LowerMUL64(SDValue Op, SelectionDAG &DAG) const;
+    SDValue LowerCTLZ(SDValue Op, SelectionDAG &DAG) const;
+    SDValue LowerCTTZ(SDValue Op, SelectionDAG &DAG) const;
+    SDValue LowerCTPOP(SDValue Op, SelectionDAG &DAG) const;
+    SDValue LowerBSWAP(SDValue Op, SelectionDAG &DAG) const;
+    SDValue LowerINTRINSIC_WO_CHAIN(SDValue Op, SelectionDAG &DAG) const;
 
     MachineBasicBlock* EmitInstrWithCustomInserter(MachineInstr *MI,
         MachineBasicBlock *BB) const;
 
+    MachineBasicBlock *EmitMemOp(MachineInstr *MI,
+        MachineBasicBlock *BB) const;
+    MachineBasicBlock *EmitWordLoop(MachineBasicBlock *BB, DebugLoc dl,
+        bool IsSet, unsigned Dst, unsigned Src, unsigned Words,
+        unsigned Unroll, bool Backward) const;
+
     /// Combines DAG nodes before (after?) lowering. Return semantics:
     ///     SDValue.Val == 0 if no change was made.
     ///     SDValue.Val == N if N was replaced, is dead, & is already handled.
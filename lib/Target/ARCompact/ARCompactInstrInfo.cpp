@@ -90,8 +90,8 @@ bool ARCompactInstrInfo::AnalyzeBranch(MachineBasicBlock &MBB,
     }
 
     // Working from the bottom, when we see a non-terminator
-    // instruction, we're done.
-    // TODO: Delay slots?
+    // instruction, we're done. Delay slots are only filled after the last
+    // use of this analysis, so a branch is never followed by its slot here.
     if (!isUnpredicatedTerminator(I)) {
       break;
     }
@@ -108,8 +108,7 @@ bool ARCompactInstrInfo::AnalyzeBranch(MachineBasicBlock &MBB,
       // we can apply.
       if (AllowModify) {
         // If the block has any instructions after the unconditional branch,
-        // delete them.
-        // TODO: Check for delay slot!
+        // delete them. (They cannot be in a delay slot; see above.)
         while (llvm::next(I) != MBB.end()) {
           llvm::next(I)->eraseFromParent();
         }
@@ -134,8 +133,15 @@ bool ARCompactInstrInfo::AnalyzeBranch(MachineBasicBlock &MBB,
       continue;
     }
 
+    // The branch back to the start of a hardware loop is performed by the
+    // hardware, and cannot be removed or inverted. Neither the hardware loops
+    // nor the compare-and-branches are formed until after the last use of
+    // this analysis that could change them.
+    if (I->getOpcode() != ARC::BCC) {
+      return true;
+    }
+
     // Handle conditional branches.
-    assert(I->getOpcode() == ARC::BCC && "Invalid branch");
     ARCCC::CondCodes BranchCode =
         static_cast<ARCCC::CondCodes>(I->getOperand(1).getImm());
 
@@ -241,6 +247,10 @@ bool ARCompactInstrInfo::PredicateInstruction (MachineInstr *MI,
     // code to check and the STATUS32 register.
     MachineOperand &PMO = MI->getOperand(PIdx);
     PMO.setImm(Pred[0].getImm());
+
+    // The instruction now reads the flags, which must be visible to the
+    // post-RA scheduler so that it is not moved above the compare.
+    MI->addOperand(MachineOperand::CreateReg(ARC::STATUS32, false, true));
     return true;
   }
   return false;
@@ -381,3 +391,164 @@ bool ARCompactInstrInfo::isProfitableToIfCvt(MachineBasicBlock &TMBB,
 
   return (TCycles + FCycles + TExtra + FExtra) <= UnpredCost;
 }
+
+bool ARCompactInstrInfo::AnalyzeCompare(const MachineInstr *MI,
+    unsigned &SrcReg, int &Mask, int &Value) const {
+  switch (MI->getOpcode()) {
+    default:
+      return false;
+    case ARC::CMPrui:
+    case ARC::CMPrsi:
+      Value = MI->getOperand(1).getImm();
+      if (Value != 0 && Value != -1) {
+        return false;
+      }
+      SrcReg = MI->getOperand(0).getReg();
+      Mask = ~0;
+      return true;
+  }
+}
+
+/// getFlagSettingOpcode - Returns the .f form of Opcode, or zero if it has
+/// none. Only the operations whose Z and N flags reflect the result, as they
+/// would after a compare of the result with zero, are listed; MIN and MAX,
+/// for example, set the flags from comparing their operands.
+static unsigned getFlagSettingOpcode(unsigned Opcode) {
+#define FLAG_SETTING_FORMS(OP)                      \
+    case ARC::OP##rr:  return ARC::OP##rr_f;        \
+    case ARC::OP##rui: return ARC::OP##rui_f;       \
+    case ARC::OP##rsi: return ARC::OP##rsi_f;       \
+    case ARC::OP##rli: return ARC::OP##rli_f;
+
+  switch (Opcode) {
+    default: return 0;
+    FLAG_SETTING_FORMS(ADD)
+    FLAG_SETTING_FORMS(ADD1)
+    FLAG_SETTING_FORMS(ADD2)
+    FLAG_SETTING_FORMS(ADD3)
+    FLAG_SETTING_FORMS(AND)
+    FLAG_SETTING_FORMS(ASL)
+    FLAG_SETTING_FORMS(ASR)
+    FLAG_SETTING_FORMS(BIC)
+    FLAG_SETTING_FORMS(LSR)
+    FLAG_SETTING_FORMS(OR)
+    FLAG_SETTING_FORMS(SUB)
+    FLAG_SETTING_FORMS(SUB1)
+    FLAG_SETTING_FORMS(SUB2)
+    FLAG_SETTING_FORMS(SUB3)
+    FLAG_SETTING_FORMS(XOR)
+  }
+
+#undef FLAG_SETTING_FORMS
+}
+
+/// getFlagCondition - Returns the condition which, tested against the flags
+/// set by a .f instruction, gives the same answer as CC does after a compare
+/// of its result with Value (zero or -1). Only Z and N can be relied on, as C
+/// and V are set differently, so COND_INVALID is returned for the conditions
+/// which need them.
+static ARCCC::CondCodes getFlagCondition(ARCCC::CondCodes CC, int Value) {
+  // x > -1 and x <= -1 are sign tests, which InstCombine prefers to x >= 0
+  // and x < 0.
+  if (Value == -1) {
+    switch (CC) {
+      case ARCCC::COND_GT: return ARCCC::COND_P;
+      case ARCCC::COND_LE: return ARCCC::COND_N;
+      default:             return ARCCC::COND_INVALID;
+    }
+  }
+
+  switch (CC) {
+    case ARCCC::COND_EQ:
+    case ARCCC::COND_LS:  return ARCCC::COND_EQ;
+    case ARCCC::COND_NE:
+    case ARCCC::COND_HI:  return ARCCC::COND_NE;
+    case ARCCC::COND_N:
+    case ARCCC::COND_LT:  return ARCCC::COND_N;
+    case ARCCC::COND_P:
+    case ARCCC::COND_GE:  return ARCCC::COND_P;
+    case ARCCC::COND_PNZ:
+    case ARCCC::COND_GT:  return ARCCC::COND_PNZ;
+    default:              return ARCCC::COND_INVALID;
+  }
+}
+
+/// getConditionOperandIdx - Returns the operand of MI which holds the
+/// condition it tests the flags for, or -1 if it is not known.
+static int getConditionOperandIdx(const MachineInstr *MI) {
+  switch (MI->getOpcode()) {
+    case ARC::BCC:
+      return 1;
+    case ARC::MOVCCrr:
+    case ARC::MOVCCrui:
+    case ARC::MOVCCrli:
+      return 3;
+    default:
+      return MI->findFirstPredOperandIdx();
+  }
+}
+
+bool ARCompactInstrInfo::OptimizeCompareInstr(MachineInstr *CmpInstr,
+    unsigned SrcReg, int Mask, int Value,
+    const MachineRegisterInfo *MRI) const {
+  MachineInstr *MI = MRI->getVRegDef(SrcReg);
+  if (!MI || MI->getParent() != CmpInstr->getParent()) {
+    return false;
+  }
+
+  unsigned NewOpc = getFlagSettingOpcode(MI->getOpcode());
+  if (NewOpc == 0) {
+    return false;
+  }
+  int PIdx = MI->findFirstPredOperandIdx();
+  if (PIdx != -1 && MI->getOperand(PIdx).getImm() != ARCCC::COND_AL) {
+    return false;
+  }
+
+  // Nothing in between may use or change the flags.
+  MachineBasicBlock::iterator I = MI, E = CmpInstr;
+  for (++I; I != E; ++I) {
+    if (I->readsRegister(ARC::STATUS32) ||
+        I->modifiesRegister(ARC::STATUS32, &RI)) {
+      return false;
+    }
+  }
+
+  // Every user of the compare's flags must test a condition which can be
+  // rewritten in terms of Z and N.
+  SmallVector<std::pair<MachineInstr *, ARCCC::CondCodes>, 4> Users;
+  MachineBasicBlock::iterator BE = CmpInstr->getParent()->end();
+  for (I = llvm::next(MachineBasicBlock::iterator(CmpInstr)); I != BE; ++I) {
+    if (I->readsRegister(ARC::STATUS32)) {
+      int CCIdx = getConditionOperandIdx(I);
+      if (CCIdx == -1) {
+        return false;
+      }
+      ARCCC::CondCodes CC = getFlagCondition(
+          (ARCCC::CondCodes) I->getOperand(CCIdx).getImm(), Value);
+      if (CC == ARCCC::COND_INVALID) {
+        return false;
+      }
+      Users.push_back(std::make_pair(&*I, CC));
+    }
+    if (I->modifiesRegister(ARC::STATUS32, &RI)) {
+      break;
+    }
+  }
+
+  for (unsigned i = 0, e = Users.size(); i != e; ++i) {
+    MachineInstr *User = Users[i].first;
+    User->getOperand(getConditionOperandIdx(User)).setImm(Users[i].second);
+  }
+
+  // The .f forms cannot be predicated, so have no predicate operand.
+  MI->setDesc(get(NewOpc));
+  if (PIdx != -1) {
+    MI->RemoveOperand(PIdx + 1);
+    MI->RemoveOperand(PIdx);
+  }
+  MI->addOperand(MachineOperand::CreateReg(ARC::STATUS32, true, true));
+
+  CmpInstr->eraseFromParent();
+  return true;
+}
@@ -132,6 +132,18 @@ public:
       unsigned TExtra, MachineBasicBlock &FMBB, unsigned FCycles,
       unsigned FExtra, const BranchProbability &Probability) const;
 
+  /// For a comparison instruction, return the source register in SrcReg and
+  /// the value it compares against in Value. Only compares with zero and -1
+  /// are analysed, as those are the ones OptimizeCompareInstr can remove.
+  virtual bool AnalyzeCompare(const MachineInstr *MI, unsigned &SrcReg,
+      int &Mask, int &Value) const;
+
+  /// Removes a compare of SrcReg with zero or -1 by switching the instruction
+  /// which defines SrcReg to its .f form, which sets the flags itself.
+  /// Returns true if the compare was removed.
+  virtual bool OptimizeCompareInstr(MachineInstr *CmpInstr, unsigned SrcReg,
+      int Mask, int Value, const MachineRegisterInfo *MRI) const;
+
   /// Returns the RegisterInfo for the Target.
   virtual const ARCompactRegisterInfo &getRegisterInfo() const {
     return RI;
@@ -59,6 +59,9 @@ void ARCompactMCInstLower::Lower(const MachineInstr *MI, MCInst &OutMI) const {
       case MachineOperand::MO_BlockAddress:
         MCOp = LowerSymbolOperand(MO, GetBlockAddressSymbol(MO));
         break;
+      case MachineOperand::MO_JumpTableIndex:
+        MCOp = LowerSymbolOperand(MO, GetJumpTableSymbol(MO));
+        break;
       case MachineOperand::MO_RegisterMask:
         continue;
       default:
@@ -106,6 +109,18 @@ MCSymbol *ARCompactMCInstLower::GetBlockAddressSymbol(
   return Printer.GetBlockAddressSymbol(MO.getBlockAddress());
 }
 
+MCSymbol *ARCompactMCInstLower::GetJumpTableSymbol(
+    const MachineOperand &MO) const {
+  switch (MO.getTargetFlags()) {
+    case 0:
+      break;
+    default:
+      llvm_unreachable("Unknown target flag on JTI operand");
+  }
+
+  return Printer.GetJTISymbol(MO.getIndex());
+}
+
 MCOperand ARCompactMCInstLower::LowerSymbolOperand(const MachineOperand &MO,
     MCSymbol *Sym) const {
   // FIXME: We would like an efficient form for this, so we don't have to do a
@@ -12,6 +12,8 @@
 #define ARCCOMPACTMACHINEFUNCTIONINFO_H
 
 #include "ARCompactSubtarget.h"
+#include "llvm/CallingConv.h"
+#include "llvm/Function.h"
 #include "llvm/CodeGen/MachineFunction.h"
 #include "llvm/Target/TargetRegisterInfo.h"
 #include "llvm/Target/TargetMachine.h"
@@ -33,17 +35,48 @@ class ARCompactMachineFunctionInfo : public MachineFunctionInfo {
   /// ReturnAddrIndex - FrameIndex for return slot.
   int ReturnAddrIndex;
 
+  /// CalleeSavedFrameSize - Size of the area pushed by the prologue below the
+  /// varargs area: BLINK, the callee saved registers and FP. FP points to the
+  /// bottom of this area.
+  unsigned CalleeSavedFrameSize;
+
+  /// ScavengingFrameIndex - FrameIndex of the emergency spill slot for the
+  /// register scavenger, or -1 if there is none.
+  int ScavengingFrameIndex;
+
+  /// InterruptLevel - 1 or 2 for an interrupt handler, which returns through
+  /// ILINK1 or ILINK2, and 0 for any other function.
+  unsigned InterruptLevel;
+
+  /// InterruptSaveIndex - FrameIndex of the first of the slots in which an
+  /// interrupt handler saves the loop registers, or the multiply result
+  /// registers. The others follow it, or it is -1 if there are none.
+  int InterruptSaveIndex;
+
 public:
   ARCompactMachineFunctionInfo()
       : VarArgsRegSaveSize(0),
         VarArgsFrameIndex(0),
-        ReturnAddrIndex(0) {
+        ReturnAddrIndex(0),
+        CalleeSavedFrameSize(0),
+        ScavengingFrameIndex(-1),
+        InterruptLevel(0),
+        InterruptSaveIndex(-1) {
   }
 
   explicit ARCompactMachineFunctionInfo(MachineFunction &MF)
       : VarArgsRegSaveSize(0),
         VarArgsFrameIndex(0),
-        ReturnAddrIndex(0) {
+        ReturnAddrIndex(0),
+        CalleeSavedFrameSize(0),
+        ScavengingFrameIndex(-1),
+        InterruptLevel(0),
+        InterruptSaveIndex(-1) {
+    switch (MF.getFunction()->getCallingConv()) {
+      case CallingConv::ARC_INTR1: InterruptLevel = 1; break;
+      case CallingConv::ARC_INTR2: InterruptLevel = 2; break;
+      default: break;
+    }
   }
 
   unsigned getVarArgsRegSaveSize() const { return VarArgsRegSaveSize; }
@@ -54,6 +87,18 @@ public:
 
   int getRAIndex() const { return ReturnAddrIndex; }
   void setRAIndex(int Index) { ReturnAddrIndex = Index; }
+
+  unsigned getCalleeSavedFrameSize() const { return CalleeSavedFrameSize; }
+  void setCalleeSavedFrameSize(unsigned s) { CalleeSavedFrameSize = s; }
+
+  int getScavengingFrameIndex() const { return ScavengingFrameIndex; }
+  void setScavengingFrameIndex(int Index) { ScavengingFrameIndex = Index; }
+
+  unsigned getInterruptLevel() const { return InterruptLevel; }
+  bool isInterruptHandler() const { return InterruptLevel != 0; }
+
+  int getInterruptSaveIndex() const { return InterruptSaveIndex; }
+  void setInterruptSaveIndex(int Index) { InterruptSaveIndex = Index; }
 };
 } // End llvm namespace
 
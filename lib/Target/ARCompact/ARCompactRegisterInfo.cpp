@@ -16,10 +16,12 @@
 #include "ARCompactRegisterInfo.h"
 #include "ARCompactSubtarget.h"
 #include "ARCompactMachineFunctionInfo.h"
+#include "ARCompactTargetMachine.h"
 #include "llvm/Function.h"
 #include "llvm/CodeGen/MachineInstrBuilder.h"
 #include "llvm/CodeGen/MachineFunction.h"
 #include "llvm/CodeGen/MachineFrameInfo.h"
+#include "llvm/CodeGen/MachineRegisterInfo.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/raw_ostream.h"
@@ -42,11 +44,29 @@ ARCompactRegisterInfo::ARCompactRegisterInfo(ARCompactTargetMachine &tm,
 const uint16_t* ARCompactRegisterInfo::getCalleeSavedRegs(
     const MachineFunction *MF) const {
   // Taken from page 12 of the ARC GCC calling convention. Not sure
-  // if it extends to ARCompact.
+  // if it extends to ARCompact. FP is listed last so that it is pushed last,
+  // next to the frame it points at (see ARCompactFrameLowering).
   static const uint16_t CalleeSavedRegs[] = {
     ARC::T5, ARC::T6, ARC::T7, ARC::S0, ARC::S1, ARC::S2, ARC::S3,
-    ARC::S4, ARC::S5, ARC::S6, ARC::S7, ARC::S8, ARC::S9, 0
+    ARC::S4, ARC::S5, ARC::S6, ARC::S7, ARC::S8, ARC::S9, ARC::FP, 0
   };
+
+  // An interrupt handler must preserve every register, but only those it
+  // actually writes (or that the functions it calls may write) are saved.
+  // The loop and multiply result registers are saved by the prologue, see
+  // getInterruptSaves.
+  static const uint16_t InterruptCalleeSavedRegs[] = {
+    ARC::R0, ARC::R1, ARC::R2, ARC::R3, ARC::R4, ARC::R5, ARC::R6, ARC::R7,
+    ARC::T0, ARC::T1, ARC::T2, ARC::T3, ARC::T4, ARC::T5, ARC::T6, ARC::T7,
+    ARC::S0, ARC::S1, ARC::S2, ARC::S3, ARC::S4, ARC::S5, ARC::S6, ARC::S7,
+    ARC::S8, ARC::S9, ARC::FP, 0
+  };
+
+  const ARCompactMachineFunctionInfo *AFI =
+      MF ? MF->getInfo<ARCompactMachineFunctionInfo>() : 0;
+  if (AFI && AFI->isInterruptHandler()) {
+    return InterruptCalleeSavedRegs;
+  }
   return CalleeSavedRegs;
 }
 
@@ -54,20 +74,30 @@ BitVector ARCompactRegisterInfo::getReservedRegs(const MachineFunction &MF)
     const {
   BitVector Reserved(getNumRegs());
 
-  // The global pointer, stack pointer, frame pointer, blink and interrupt
-  // link registers are reserved.
-  // TODO: If not needed, the frame pointer isnt actually reserved.
+  // The global pointer, stack pointer, blink and interrupt link registers
+  // are reserved. The frame pointer is only reserved if the function needs
+  // one; otherwise it is allocated as a callee saved register.
   Reserved.set(ARC::GP);
   Reserved.set(ARC::SP);
-  Reserved.set(ARC::FP);
+  if (TM.getFrameLowering()->hasFP(MF)) {
+    Reserved.set(ARC::FP);
+  }
   Reserved.set(ARC::BLINK);
   Reserved.set(ARC::ILINK1);
   Reserved.set(ARC::ILINK2);
 
   Reserved.set(ARC::STATUS32);
 
-  // As with ARC-GCC, I reserve R12 (T4) for temporary calculations.
-  Reserved.set(ARC::T4);
+  // The zero-overhead loop registers are only written by the hardware loop
+  // pass, after register allocation.
+  Reserved.set(ARC::LP_COUNT);
+  Reserved.set(ARC::LP_START);
+  Reserved.set(ARC::LP_END);
+
+  // The multiply result registers are only written by MUL64 and MULU64.
+  Reserved.set(ARC::MLO);
+  Reserved.set(ARC::MMID);
+  Reserved.set(ARC::MHI);
 
   return Reserved;
 }
@@ -79,11 +109,17 @@ void ARCompactRegisterInfo::eliminateCallFramePseudoInstr(MachineFunction &MF,
   MBB.erase(I);
 }
 
-static bool IsStore(MachineInstr &MI) {
-  // TODO: Set "isStore" variable on such instructions, check for that.
+/// hasShortOffset - Returns true if the frame index operand of MI is the
+/// base of a [b,s9] address, which can only be offset by -256 to 255 bytes.
+/// The remaining users of frame indices (ADDrli) take a long immediate.
+static bool hasShortOffset(const MachineInstr &MI) {
   switch (MI.getOpcode()) {
+    case ARC::LDri:
+    case ARC::LDri_extb:
+    case ARC::LDri_extw:
+    case ARC::LDri_sextb:
+    case ARC::LDri_sextw:
     case ARC::STrri:
-    case ARC::STrli:
     case ARC::STliri:
     case ARC::STrri_i8:
     case ARC::STrri_i16:
@@ -93,6 +129,38 @@ static bool IsStore(MachineInstr &MI) {
   }
 }
 
+bool ARCompactRegisterInfo::requiresRegisterScavenging(
+    const MachineFunction &MF) const {
+  return true;
+}
+
+bool ARCompactRegisterInfo::requiresFrameIndexScavenging(
+    const MachineFunction &MF) const {
+  return true;
+}
+
+/// saveScavengerRegister - Spills Reg to the emergency spill slot while it
+/// holds a scratch register of eliminateFrameIndex. The scratch register is
+/// defined by I and only used by the instruction after it, so Reg is restored
+/// straight after that. Left to itself, the scavenger restores it as late as
+/// it can, which may be after the epilogue has moved SP away from the slot.
+bool ARCompactRegisterInfo::saveScavengerRegister(MachineBasicBlock &MBB,
+    MachineBasicBlock::iterator I, MachineBasicBlock::iterator &UseMI,
+    const TargetRegisterClass *RC, unsigned Reg) const {
+  const ARCompactMachineFunctionInfo *ARCompactFI =
+      MBB.getParent()->getInfo<ARCompactMachineFunctionInfo>();
+  int FI = ARCompactFI->getScavengingFrameIndex();
+  assert(FI >= 0 && "No emergency spill slot for the scavenged register!");
+
+  TII.storeRegToStackSlot(MBB, I, Reg, true, FI, RC, this);
+  eliminateFrameIndex(llvm::prior(I), 0);
+
+  UseMI = llvm::next(llvm::next(I));
+  TII.loadRegFromStackSlot(MBB, UseMI, Reg, FI, RC, this);
+  eliminateFrameIndex(llvm::prior(UseMI), 0);
+  return true;
+}
+
 void ARCompactRegisterInfo::eliminateFrameIndex(MachineBasicBlock::iterator II,
     int SPAdj, RegScavenger *RS) const {
   assert(SPAdj == 0 && "Unexpected non-zero adjustment!");
@@ -126,29 +194,25 @@ void ARCompactRegisterInfo::eliminateFrameIndex(MachineBasicBlock::iterator II,
                << "VARegsStart: " << ARCompactFI->getVarArgsFrameIndex() << "\n"
                << "VARegsSize : " << ARCompactFI->getVarArgsRegSaveSize() << "\n");
 
-  // TODO: Callee Saved Info?
-
-  // TODO: Figure out when to use SP and when to use FP. For now always use FP.
-  unsigned FrameReg = ARC::FP;
-
-  // Figure out the offset. If the frame index is for a memory argument, need to
-  // offset by the space used for BLINK (if required) and the old FP (always).
-  // TODO: Guess at memloc better.
+  // The object offsets are relative to the top of the frame (just below the
+  // varargs area). FP, if there is one, points to the bottom of the area
+  // pushed by the prologue (BLINK, the callee saved registers and FP itself).
+  // Otherwise SP is fixed at the bottom of the frame throughout the body of
+  // the function.
+  unsigned FrameReg = getFrameRegister(MF);
   int64_t Offset = spOffset;
-  if (FrameIndex < 0 && FrameIndex != ARCompactFI->getVarArgsFrameIndex()) {
-    // Assuming atm that this means memloc argument.
-    Offset += 4; // For the saved FP.
-    if (MFI->hasCalls()) {
-      Offset += 4; // For the BLINK.
-    }
+  if (FrameReg == ARC::FP) {
+    Offset += ARCompactFI->getCalleeSavedFrameSize();
+  } else {
+    Offset += (stackSize + 3) & ~3;
   }
   Offset += MI.getOperand(i+1).getImm();
   DEBUG(errs() << "MI.getOpera: " << MI.getOperand(i+1).getImm() << "\n");
   DEBUG(errs() << "Offset     : " << Offset << "\n");
 
-  if (IsStore(MI) && !isInt<9>(Offset)) {
-    // We insert an ADD to get the value within range. Register T4 (R12) is
-    // reserved for this purpose.
+  if (hasShortOffset(MI) && !isInt<9>(Offset)) {
+    // We insert an ADD to get the value within range, into a virtual register
+    // which the register scavenger replaces with a free physical register.
     int Difference;
     if (Offset > 255) {
       Difference = Offset - 255;
@@ -157,16 +221,19 @@ void ARCompactRegisterInfo::eliminateFrameIndex(MachineBasicBlock::iterator II,
     }
     DEBUG(errs() << "Difference: " << Difference << "\n");
 
-    BuildMI(MBB, II, dl, TII.get(ARC::ADDrli), ARC::T4).addReg(ARC::FP)
+    unsigned ScratchReg =
+        MF.getRegInfo().createVirtualRegister(&ARC::CPURegsRegClass);
+    BuildMI(MBB, II, dl, TII.get(ARC::ADDrli), ScratchReg).addReg(FrameReg)
         .addImm(Difference);
     Offset -= Difference;
 
-    FrameReg = ARC::T4;
+    FrameReg = ScratchReg;
   }
 
   DEBUG(errs() << "<--------->\n");
 
-  MI.getOperand(i).ChangeToRegister(FrameReg, false);
+  MI.getOperand(i).ChangeToRegister(FrameReg, false, false,
+                                    FrameReg != getFrameRegister(MF));
   MI.getOperand(i+1).ChangeToImmediate(Offset);
 }
 
@@ -177,5 +244,5 @@ unsigned ARCompactRegisterInfo::getRARegister() const {
 
 unsigned ARCompactRegisterInfo::getFrameRegister(const MachineFunction &MF)
     const {
-  return ARC::FP;
+  return TM.getFrameLowering()->hasFP(MF) ? ARC::FP : ARC::SP;
 }
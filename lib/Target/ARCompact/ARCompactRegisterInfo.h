@@ -40,6 +40,16 @@ struct ARCompactRegisterInfo : public ARCompactGenRegisterInfo {
   /// considered unavailable at all times, e.g. SP, BLINK.
   BitVector getReservedRegs(const MachineFunction &MF) const;
 
+  /// Frame indices too far from the frame register for a [b,s9] address are
+  /// reached through a temporary register, found by the register scavenger.
+  bool requiresRegisterScavenging(const MachineFunction &MF) const;
+  bool requiresFrameIndexScavenging(const MachineFunction &MF) const;
+
+  /// Spills a scavenged register around the one instruction which uses it.
+  bool saveScavengerRegister(MachineBasicBlock &MBB,
+      MachineBasicBlock::iterator I, MachineBasicBlock::iterator &UseMI,
+      const TargetRegisterClass *RC, unsigned Reg) const;
+
   ///  This method is called during prolog/epilog code insertion to eliminate
   /// call frame setup and destroy pseudo instructions, such as ADJCALLSTACKUP
   /// and ADJCALLSTACKDOWN.
@@ -13,8 +13,15 @@
 
 #define DEBUG_TYPE "arcompact-selectiondag-info"
 #include "ARCompactTargetMachine.h"
+#include "llvm/Function.h"
+#include "llvm/CodeGen/SelectionDAG.h"
+#include "llvm/Support/MathExtras.h"
 using namespace llvm;
 
+/// MaxInlineSize - Copies and fills of more than this many bytes are left to
+/// the library, whose routines are faster for large buffers.
+static const uint64_t MaxInlineSize = 512;
+
 ARCompactSelectionDAGInfo::ARCompactSelectionDAGInfo(
     const ARCompactTargetMachine &TM) : TargetSelectionDAGInfo(TM) {
 }
@@ -22,3 +29,111 @@ ARCompactSelectionDAGInfo::ARCompactSelectionDAGInfo(
 ARCompactSelectionDAGInfo::~ARCompactSelectionDAGInfo() {
 }
 
+
+/// getUnrollFactor - Returns how many words each iteration of an inline copy
+/// or fill should handle, or zero if they should not be inlined at all.
+static unsigned getUnrollFactor(SelectionDAG &DAG, bool AlwaysInline) {
+  const Function *F = DAG.getMachineFunction().getFunction();
+  if (F->hasFnAttr(Attribute::OptimizeForSize)) {
+    return AlwaysInline ? 1 : 0;
+  }
+
+  switch (DAG.getTarget().getOptLevel()) {
+    case CodeGenOpt::None:       return AlwaysInline ? 1 : 0;
+    case CodeGenOpt::Less:       return 1;
+    case CodeGenOpt::Default:    return 2;
+    case CodeGenOpt::Aggressive: return 4;
+  }
+  llvm_unreachable("Invalid optimisation level!");
+}
+
+/// EmitWordOp - Emits an ARCISD::MEMCPY, MEMMOVE or MEMSET for the whole
+/// words of a word aligned, constant sized copy or fill, followed by the
+/// loads and stores for any bytes left over. Returns a null SDValue if the
+/// operation is better left to the library.
+static SDValue EmitWordOp(unsigned Opc, SelectionDAG &DAG, DebugLoc dl,
+                          SDValue Chain, SDValue Dst, SDValue Src,
+                          SDValue Size, unsigned Align, bool isVolatile,
+                          bool AlwaysInline, MachinePointerInfo DstPtrInfo,
+                          MachinePointerInfo SrcPtrInfo) {
+  ConstantSDNode *ConstSize = dyn_cast<ConstantSDNode>(Size);
+  if (!ConstSize || (Align & 3) != 0) {
+    return SDValue();
+  }
+
+  uint64_t Bytes = ConstSize->getZExtValue();
+  unsigned Unroll = getUnrollFactor(DAG, AlwaysInline);
+  if (!Unroll || Bytes < 4 || (!AlwaysInline && Bytes > MaxInlineSize)) {
+    return SDValue();
+  }
+
+  // A trailing part word would have to be moved before or after the words,
+  // depending on which way round the buffers overlap.
+  if (Opc == ARCISD::MEMMOVE && (Bytes & 3) != 0) {
+    return SDValue();
+  }
+
+  // A fill stores the byte repeated across the whole word.
+  if (Opc == ARCISD::MEMSET) {
+    if (ConstantSDNode *C = dyn_cast<ConstantSDNode>(Src)) {
+      Src = DAG.getConstant((C->getZExtValue() & 0xFF) * 0x01010101,
+                            MVT::i32);
+    } else {
+      Src = DAG.getZExtOrTrunc(Src, dl, MVT::i32);
+      Src = DAG.getNode(ISD::OR, dl, MVT::i32, Src,
+                        DAG.getNode(ISD::SHL, dl, MVT::i32, Src,
+                                    DAG.getConstant(8, MVT::i32)));
+      Src = DAG.getNode(ISD::OR, dl, MVT::i32, Src,
+                        DAG.getNode(ISD::SHL, dl, MVT::i32, Src,
+                                    DAG.getConstant(16, MVT::i32)));
+    }
+  }
+
+  SDValue Ops[] = { Chain, Dst, Src, DAG.getConstant(Bytes / 4, MVT::i32),
+                    DAG.getConstant(Unroll, MVT::i32) };
+  Chain = DAG.getNode(Opc, dl, MVT::Other, Ops, array_lengthof(Ops));
+
+  // Handle the bytes after the last whole word.
+  for (uint64_t Offset = Bytes & ~3ULL; Offset != Bytes; ) {
+    EVT VT = Bytes - Offset >= 2 ? MVT::i16 : MVT::i8;
+    SDValue OffsetV = DAG.getConstant(Offset, MVT::i32);
+    SDValue DstAddr = DAG.getNode(ISD::ADD, dl, MVT::i32, Dst, OffsetV);
+    SDValue Value = Src;
+    if (Opc != ARCISD::MEMSET) {
+      SDValue SrcAddr = DAG.getNode(ISD::ADD, dl, MVT::i32, Src, OffsetV);
+      Value = DAG.getExtLoad(ISD::EXTLOAD, dl, MVT::i32, Chain, SrcAddr,
+                             SrcPtrInfo.getWithOffset(Offset), VT, isVolatile,
+                             false, MinAlign(Align, Offset));
+      Chain = Value.getValue(1);
+    }
+    Chain = DAG.getTruncStore(Chain, dl, Value, DstAddr,
+                              DstPtrInfo.getWithOffset(Offset), VT, isVolatile,
+                              false, MinAlign(Align, Offset));
+    Offset += VT.getSizeInBits() / 8;
+  }
+
+  return Chain;
+}
+
+SDValue ARCompactSelectionDAGInfo::EmitTargetCodeForMemcpy(SelectionDAG &DAG,
+    DebugLoc dl, SDValue Chain, SDValue Dst, SDValue Src, SDValue Size,
+    unsigned Align, bool isVolatile, bool AlwaysInline,
+    MachinePointerInfo DstPtrInfo, MachinePointerInfo SrcPtrInfo) const {
+  return EmitWordOp(ARCISD::MEMCPY, DAG, dl, Chain, Dst, Src, Size, Align,
+                    isVolatile, AlwaysInline, DstPtrInfo, SrcPtrInfo);
+}
+
+SDValue ARCompactSelectionDAGInfo::EmitTargetCodeForMemmove(SelectionDAG &DAG,
+    DebugLoc dl, SDValue Chain, SDValue Dst, SDValue Src, SDValue Size,
+    unsigned Align, bool isVolatile, MachinePointerInfo DstPtrInfo,
+    MachinePointerInfo SrcPtrInfo) const {
+  return EmitWordOp(ARCISD::MEMMOVE, DAG, dl, Chain, Dst, Src, Size, Align,
+                    isVolatile, false, DstPtrInfo, SrcPtrInfo);
+}
+
+SDValue ARCompactSelectionDAGInfo::EmitTargetCodeForMemset(SelectionDAG &DAG,
+    DebugLoc dl, SDValue Chain, SDValue Dst, SDValue Src, SDValue Size,
+    unsigned Align, bool isVolatile, MachinePointerInfo DstPtrInfo) const {
+  return EmitWordOp(ARCISD::MEMSET, DAG, dl, Chain, Dst, Src, Size, Align,
+                    isVolatile, false, DstPtrInfo, MachinePointerInfo());
+}
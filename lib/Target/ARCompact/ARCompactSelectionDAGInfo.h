@@ -24,6 +24,29 @@ class ARCompactSelectionDAGInfo : public TargetSelectionDAGInfo {
 public:
   explicit ARCompactSelectionDAGInfo(const ARCompactTargetMachine &TM);
   ~ARCompactSelectionDAGInfo();
+
+  virtual SDValue EmitTargetCodeForMemcpy(SelectionDAG &DAG, DebugLoc dl,
+                                          SDValue Chain,
+                                          SDValue Dst, SDValue Src,
+                                          SDValue Size, unsigned Align,
+                                          bool isVolatile, bool AlwaysInline,
+                                          MachinePointerInfo DstPtrInfo,
+                                          MachinePointerInfo SrcPtrInfo) const;
+
+  virtual SDValue EmitTargetCodeForMemmove(SelectionDAG &DAG, DebugLoc dl,
+                                           SDValue Chain,
+                                           SDValue Dst, SDValue Src,
+                                           SDValue Size, unsigned Align,
+                                           bool isVolatile,
+                                           MachinePointerInfo DstPtrInfo,
+                                           MachinePointerInfo SrcPtrInfo) const;
+
+  virtual SDValue EmitTargetCodeForMemset(SelectionDAG &DAG, DebugLoc dl,
+                                          SDValue Chain,
+                                          SDValue Dst, SDValue Src,
+                                          SDValue Size, unsigned Align,
+                                          bool isVolatile,
+                                          MachinePointerInfo DstPtrInfo) const;
 };
 
 }
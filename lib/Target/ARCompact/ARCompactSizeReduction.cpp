@@ -0,0 +1,535 @@
+//===--- ARCompactSizeReduction.cpp - Use 16-bit ARCompact instructions ---===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains a pass that rewrites 32-bit instructions into their
+// 16-bit forms where the operands allow it. The 16-bit forms can only address
+// r0-r3 and r12-r15 in most of their register fields, and have much smaller
+// immediates, so this is done after register allocation. It should be run
+// after any pass which predicates instructions, as the 16-bit forms cannot be
+// predicated.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "arcompact-size-reduction"
+#include "ARCompact.h"
+#include "ARCompactInstrInfo.h"
+#include "MCTargetDesc/ARCompactBaseInfo.h"
+#include "llvm/Function.h"
+#include "llvm/CodeGen/MachineFunctionPass.h"
+#include "llvm/CodeGen/MachineInstrBuilder.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace llvm;
+
+STATISTIC(NumReduced, "Number of 32-bit instructions reduced to 16-bit ones");
+STATISTIC(NumBytesSaved, "Number of bytes saved by size reduction");
+
+namespace {
+  enum ReductionMode {
+    ReduceNever,
+    ReduceOptSize,
+    ReduceAlways
+  };
+}
+
+// The 16-bit instructions execute no faster than the 32-bit ones, but they
+// leave the instructions which follow them only half-word aligned, and a
+// 32-bit instruction which straddles a fetch boundary takes an extra cycle to
+// fetch. By default, then, only the functions which are optimised for size
+// are reduced.
+static cl::opt<ReductionMode>
+SizeReduction("arcompact-size-reduction",
+    cl::desc("Rewrite instructions into their 16-bit forms"),
+    cl::init(ReduceOptSize),
+    cl::values(
+      clEnumValN(ReduceNever, "never", "Only use 32-bit instructions"),
+      clEnumValN(ReduceOptSize, "optsize",
+                 "Only in functions optimised for size (default)"),
+      clEnumValN(ReduceAlways, "always", "In every function"),
+      clEnumValEnd));
+
+namespace {
+  struct ARCompactSizeReduction : public MachineFunctionPass {
+    static char ID;
+    ARCompactSizeReduction() : MachineFunctionPass(ID) {}
+
+    const TargetInstrInfo *TII;
+
+    virtual bool runOnMachineFunction(MachineFunction &MF);
+
+    virtual const char *getPassName() const {
+      return "ARCompact Size Reduction";
+    }
+
+  private:
+    bool reduceMI(MachineInstr *MI);
+    MachineInstrBuilder buildReduced(MachineInstr *MI, unsigned Opcode);
+  };
+  char ARCompactSizeReduction::ID = 0;
+}
+
+/// createARCompactSizeReductionPass - Returns an instance of the size
+/// reduction pass.
+FunctionPass *llvm::createARCompactSizeReductionPass() {
+  return new ARCompactSizeReduction();
+}
+
+//===----------------------------------------------------------------------===//
+// Reduction tables.
+//===----------------------------------------------------------------------===//
+
+namespace {
+  struct ReduceEntry {
+    unsigned WideOpc;
+    unsigned NarrowOpc;
+    bool IsCommutable;
+  };
+}
+
+// "op a,b,c" with a = b (or a = c, if commutable) becomes "op_s b,b,c".
+static const ReduceEntry TiedRRTable[] = {
+  { ARC::ADD1rr, ARC::ADD1rr_s, false },
+  { ARC::ADD2rr, ARC::ADD2rr_s, false },
+  { ARC::ADD3rr, ARC::ADD3rr_s, false },
+  { ARC::ANDrr,  ARC::ANDrr_s,  true  },
+  { ARC::ASLrr,  ARC::ASLrr_s,  false },
+  { ARC::ASRrr,  ARC::ASRrr_s,  false },
+  { ARC::BICrr,  ARC::BICrr_s,  false },
+  { ARC::LSRrr,  ARC::LSRrr_s,  false },
+  { ARC::ORrr,   ARC::ORrr_s,   true  },
+  { ARC::SUBrr,  ARC::SUBrr_s,  false },
+  { ARC::XORrr,  ARC::XORrr_s,  true  }
+};
+
+// "op a,b,u" with a = b and u < 32 becomes "op_s b,b,u5".
+static const ReduceEntry TiedU5Table[] = {
+  { ARC::ASLrui,  ARC::ASLrru5_s,  false },
+  { ARC::ASLrsi,  ARC::ASLrru5_s,  false },
+  { ARC::ASRrui,  ARC::ASRrru5_s,  false },
+  { ARC::ASRrsi,  ARC::ASRrru5_s,  false },
+  { ARC::BCLRrui, ARC::BCLRrru5_s, false },
+  { ARC::BCLRrsi, ARC::BCLRrru5_s, false },
+  { ARC::BMSKrui, ARC::BMSKrru5_s, false },
+  { ARC::BMSKrsi, ARC::BMSKrru5_s, false },
+  { ARC::BSETrui, ARC::BSETrru5_s, false },
+  { ARC::BSETrsi, ARC::BSETrru5_s, false },
+  { ARC::LSRrui,  ARC::LSRrru5_s,  false },
+  { ARC::LSRrsi,  ARC::LSRrru5_s,  false }
+};
+
+// "op b,c" becomes "op_s b,c".
+static const ReduceEntry SingleOpTable[] = {
+  { ARC::ABSr,  ARC::ABSr_s,  false },
+  { ARC::ASLr,  ARC::ASLr_s,  false },
+  { ARC::ASRr,  ARC::ASRr_s,  false },
+  { ARC::EXTBr, ARC::EXTBr_s, false },
+  { ARC::EXTWr, ARC::EXTWr_s, false },
+  { ARC::LSRr,  ARC::LSRr_s,  false },
+  { ARC::NEGrr, ARC::NEGr_s,  false },
+  { ARC::NOTr,  ARC::NOTr_s,  false },
+  { ARC::SEXBr, ARC::SEXBr_s, false },
+  { ARC::SEXWr, ARC::SEXWr_s, false }
+};
+
+template <unsigned N>
+static const ReduceEntry *findEntry(const ReduceEntry (&Table)[N],
+                                    unsigned Opcode) {
+  for (unsigned i = 0; i != N; ++i) {
+    if (Table[i].WideOpc == Opcode)
+      return &Table[i];
+  }
+  return 0;
+}
+
+//===----------------------------------------------------------------------===//
+// Operand checks.
+//===----------------------------------------------------------------------===//
+
+/// isShort - Returns true if the operand is a register which can be encoded
+/// in the 3-bit register fields.
+static bool isShort(const MachineOperand &MO) {
+  return MO.isReg() && isARCompactShortRegister(MO.getReg());
+}
+
+static bool isReg(const MachineOperand &MO, unsigned Reg) {
+  return MO.isReg() && MO.getReg() == Reg;
+}
+
+static bool isSameReg(const MachineOperand &MO1, const MachineOperand &MO2) {
+  return MO1.isReg() && MO2.isReg() && MO1.getReg() == MO2.getReg();
+}
+
+/// isImmInRange - Returns true if the operand is an immediate in [Lo, Hi)
+/// which is a multiple of Align.
+static bool isImmInRange(const MachineOperand &MO, int64_t Lo, int64_t Hi,
+                         int64_t Align = 1) {
+  return MO.isImm() && MO.getImm() >= Lo && MO.getImm() < Hi &&
+      (MO.getImm() % Align) == 0;
+}
+
+/// isUnpredicated - The 16-bit instructions cannot be predicated.
+static bool isUnpredicated(const MachineInstr *MI) {
+  int PIdx = MI->findFirstPredOperandIdx();
+  return PIdx == -1 || MI->getOperand(PIdx).getImm() == ARCCC::COND_AL;
+}
+
+//===----------------------------------------------------------------------===//
+// Size reduction.
+//===----------------------------------------------------------------------===//
+
+/// buildReduced - Starts building the 16-bit replacement of MI, just before
+/// it.
+MachineInstrBuilder ARCompactSizeReduction::buildReduced(MachineInstr *MI,
+    unsigned Opcode) {
+  const MCInstrDesc &NewDesc = TII->get(Opcode);
+  MachineInstrBuilder MIB = BuildMI(*MI->getParent(), MI, MI->getDebugLoc(),
+                                    NewDesc);
+  MIB->setMemRefs(MI->memoperands_begin(), MI->memoperands_end());
+
+  ++NumReduced;
+  NumBytesSaved += MI->getDesc().getSize() - NewDesc.getSize();
+  return MIB;
+}
+
+/// reduceMI - Tries to rewrite MI into a 16-bit instruction. Returns true if
+/// MI was changed or replaced.
+bool ARCompactSizeReduction::reduceMI(MachineInstr *MI) {
+  if (!isUnpredicated(MI))
+    return false;
+
+  unsigned Opcode = MI->getOpcode();
+
+  // Instructions which only change opcode keep their operands in place.
+  unsigned InPlaceOpc = 0;
+  switch (Opcode) {
+    case ARC::NOP: InPlaceOpc = ARC::NOP_S; break;
+    case ARC::RET: InPlaceOpc = ARC::RET_S; break;
+    case ARC::JLr:
+      if (isShort(MI->getOperand(0)))
+        InPlaceOpc = ARC::JLr_s;
+      break;
+    case ARC::Jr:
+      if (isShort(MI->getOperand(0)))
+        InPlaceOpc = ARC::Jr_s;
+      break;
+  }
+  if (InPlaceOpc) {
+    DEBUG(dbgs() << "Reducing: " << *MI);
+    ++NumReduced;
+    NumBytesSaved += MI->getDesc().getSize() - TII->get(InPlaceOpc).getSize();
+    MI->setDesc(TII->get(InPlaceOpc));
+    return true;
+  }
+
+  if (MI->getNumOperands() < 2)
+    return false;
+
+  const MachineOperand &Op0 = MI->getOperand(0);
+  const MachineOperand &Op1 = MI->getOperand(1);
+
+  if (const ReduceEntry *Entry = findEntry(TiedRRTable, Opcode)) {
+    const MachineOperand &Op2 = MI->getOperand(2);
+    if (!isShort(Op0) || !isShort(Op1) || !isShort(Op2))
+      return false;
+
+    if (isSameReg(Op0, Op1))
+      buildReduced(MI, Entry->NarrowOpc).addOperand(Op0).addOperand(Op1)
+          .addOperand(Op2);
+    else if (Entry->IsCommutable && isSameReg(Op0, Op2))
+      buildReduced(MI, Entry->NarrowOpc).addOperand(Op0).addOperand(Op2)
+          .addOperand(Op1);
+    else
+      return false;
+  } else if (const ReduceEntry *Entry = findEntry(TiedU5Table, Opcode)) {
+    const MachineOperand &Op2 = MI->getOperand(2);
+    if (!isShort(Op0))
+      return false;
+
+    // ASL_S and ASR_S also have an untied form, for shifts of up to 7.
+    if (isSameReg(Op0, Op1) && isImmInRange(Op2, 0, 32))
+      buildReduced(MI, Entry->NarrowOpc).addOperand(Op0).addOperand(Op1)
+          .addOperand(Op2);
+    else if (Opcode == ARC::ASLrui && isShort(Op1) &&
+             isImmInRange(Op2, 0, 8))
+      buildReduced(MI, ARC::ASLrru3_s).addOperand(Op0).addOperand(Op1)
+          .addOperand(Op2);
+    else if (Opcode == ARC::ASRrui && isShort(Op1) &&
+             isImmInRange(Op2, 0, 8))
+      buildReduced(MI, ARC::ASRrru3_s).addOperand(Op0).addOperand(Op1)
+          .addOperand(Op2);
+    else
+      return false;
+  } else if (const ReduceEntry *Entry = findEntry(SingleOpTable, Opcode)) {
+    if (!isShort(Op0) || !isShort(Op1))
+      return false;
+
+    buildReduced(MI, Entry->NarrowOpc).addOperand(Op0).addOperand(Op1);
+  } else {
+    switch (Opcode) {
+      default:
+        return false;
+
+      case ARC::ADDrr: {
+        const MachineOperand &Op2 = MI->getOperand(2);
+        if (!isShort(Op0))
+          return false;
+
+        if (isShort(Op1) && isShort(Op2))
+          buildReduced(MI, ARC::ADDrrr_s).addOperand(Op0).addOperand(Op1)
+              .addOperand(Op2);
+        else if (isSameReg(Op0, Op1))
+          buildReduced(MI, ARC::ADDrh_s).addOperand(Op0).addOperand(Op1)
+              .addOperand(Op2);
+        else if (isSameReg(Op0, Op2))
+          buildReduced(MI, ARC::ADDrh_s).addOperand(Op0).addOperand(Op2)
+              .addOperand(Op1);
+        else
+          return false;
+        break;
+      }
+
+      case ARC::ADDrui:
+      case ARC::ADDrsi: {
+        const MachineOperand &Op2 = MI->getOperand(2);
+        if (isShort(Op0) && isShort(Op1) && isImmInRange(Op2, 0, 8))
+          buildReduced(MI, ARC::ADDrru3_s).addOperand(Op0).addOperand(Op1)
+              .addOperand(Op2);
+        else if (isShort(Op0) && isSameReg(Op0, Op1) &&
+                 isImmInRange(Op2, 0, 128))
+          buildReduced(MI, ARC::ADDrru7_s).addOperand(Op0).addOperand(Op1)
+              .addOperand(Op2);
+        else if (isShort(Op0) && isSameReg(Op0, Op1) &&
+                 isImmInRange(Op2, -31, 0))
+          buildReduced(MI, ARC::SUBrru5_s).addOperand(Op0).addOperand(Op1)
+              .addImm(-Op2.getImm());
+        else if (isShort(Op0) && isReg(Op1, ARC::SP) &&
+                 isImmInRange(Op2, 0, 128, 4))
+          buildReduced(MI, ARC::ADDrsp_s).addOperand(Op0).addOperand(Op2);
+        else if (isReg(Op0, ARC::SP) && isReg(Op1, ARC::SP) &&
+                 isImmInRange(Op2, 0, 128, 4))
+          buildReduced(MI, ARC::ADDsp_s).addOperand(Op2);
+        else if (isReg(Op0, ARC::SP) && isReg(Op1, ARC::SP) &&
+                 isImmInRange(Op2, -124, 0, 4))
+          buildReduced(MI, ARC::SUBsp_s).addImm(-Op2.getImm());
+        else
+          return false;
+        break;
+      }
+
+      case ARC::ADDrli:
+        if (!isShort(Op0) || !isSameReg(Op0, Op1))
+          return false;
+
+        buildReduced(MI, ARC::ADDrl_s).addOperand(Op0).addOperand(Op1)
+            .addOperand(MI->getOperand(2));
+        break;
+
+      case ARC::SUBrui:
+      case ARC::SUBrsi: {
+        const MachineOperand &Op2 = MI->getOperand(2);
+        if (isShort(Op0) && isShort(Op1) && isImmInRange(Op2, 0, 8))
+          buildReduced(MI, ARC::SUBrru3_s).addOperand(Op0).addOperand(Op1)
+              .addOperand(Op2);
+        else if (isShort(Op0) && isSameReg(Op0, Op1) &&
+                 isImmInRange(Op2, 0, 32))
+          buildReduced(MI, ARC::SUBrru5_s).addOperand(Op0).addOperand(Op1)
+              .addOperand(Op2);
+        else if (isShort(Op0) && isSameReg(Op0, Op1) &&
+                 isImmInRange(Op2, -127, 0))
+          buildReduced(MI, ARC::ADDrru7_s).addOperand(Op0).addOperand(Op1)
+              .addImm(-Op2.getImm());
+        else if (isReg(Op0, ARC::SP) && isReg(Op1, ARC::SP) &&
+                 isImmInRange(Op2, 0, 128, 4))
+          buildReduced(MI, ARC::SUBsp_s).addOperand(Op2);
+        else if (isReg(Op0, ARC::SP) && isReg(Op1, ARC::SP) &&
+                 isImmInRange(Op2, -124, 0, 4))
+          buildReduced(MI, ARC::ADDsp_s).addImm(-Op2.getImm());
+        else
+          return false;
+        break;
+      }
+
+      case ARC::MOVrr:
+        if (isShort(Op0))
+          buildReduced(MI, ARC::MOVrh_s).addOperand(Op0).addOperand(Op1);
+        else if (isShort(Op1))
+          buildReduced(MI, ARC::MOVhr_s).addOperand(Op0).addOperand(Op1);
+        else
+          return false;
+        break;
+
+      case ARC::MOVrui:
+      case ARC::MOVrsi:
+        if (!isShort(Op0) || !isImmInRange(Op1, 0, 256))
+          return false;
+
+        buildReduced(MI, ARC::MOVru8_s).addOperand(Op0).addOperand(Op1);
+        break;
+
+      case ARC::MOVrli:
+        if (!isShort(Op0))
+          return false;
+
+        buildReduced(MI, ARC::MOVrl_s).addOperand(Op0).addOperand(Op1);
+        break;
+
+      case ARC::CMPrr:
+        if (!isShort(Op0))
+          return false;
+
+        buildReduced(MI, ARC::CMPrh_s).addOperand(Op0).addOperand(Op1);
+        break;
+
+      case ARC::CMPrui:
+      case ARC::CMPrsi:
+        if (!isShort(Op0) || !isImmInRange(Op1, 0, 128))
+          return false;
+
+        buildReduced(MI, ARC::CMPru7_s).addOperand(Op0).addOperand(Op1);
+        break;
+
+      case ARC::CMPrli:
+        if (!isShort(Op0))
+          return false;
+
+        buildReduced(MI, ARC::CMPrl_s).addOperand(Op0).addOperand(Op1);
+        break;
+
+      case ARC::LDrr:
+        if (!isShort(Op0) || !isShort(Op1) || !isShort(MI->getOperand(2)))
+          return false;
+
+        buildReduced(MI, ARC::LDrr_s).addOperand(Op0).addOperand(Op1)
+            .addOperand(MI->getOperand(2));
+        break;
+
+      case ARC::LDri:
+      case ARC::LDri_extb:
+      case ARC::LDri_extw:
+      case ARC::LDri_sextw: {
+        // ld a,[b,s9]
+        const MachineOperand &Off = MI->getOperand(2);
+        unsigned NewOpc;
+        if (!isShort(Op0))
+          return false;
+
+        if (Opcode == ARC::LDri && isReg(Op1, ARC::SP) &&
+            isImmInRange(Off, 0, 128, 4))
+          NewOpc = ARC::LDsp_s;
+        else if (!isShort(Op1))
+          return false;
+        else if (Opcode == ARC::LDri && isImmInRange(Off, 0, 128, 4))
+          NewOpc = ARC::LDri_s;
+        else if (Opcode == ARC::LDri_extb && isImmInRange(Off, 0, 32))
+          NewOpc = ARC::LDri_extb_s;
+        else if (Opcode == ARC::LDri_extw && isImmInRange(Off, 0, 64, 2))
+          NewOpc = ARC::LDri_extw_s;
+        else if (Opcode == ARC::LDri_sextw && isImmInRange(Off, 0, 64, 2))
+          NewOpc = ARC::LDri_sextw_s;
+        else
+          return false;
+
+        buildReduced(MI, NewOpc).addOperand(Op0).addOperand(Op1)
+            .addOperand(Off);
+        break;
+      }
+
+      case ARC::STrri:
+      case ARC::STrri_i8:
+      case ARC::STrri_i16: {
+        // st c,[b,s9]
+        const MachineOperand &Src = MI->getOperand(2);
+        unsigned NewOpc;
+        if (!isShort(Src))
+          return false;
+
+        if (Opcode == ARC::STrri && isReg(Op0, ARC::SP) &&
+            isImmInRange(Op1, 0, 128, 4))
+          NewOpc = ARC::STsp_s;
+        else if (!isShort(Op0))
+          return false;
+        else if (Opcode == ARC::STrri && isImmInRange(Op1, 0, 128, 4))
+          NewOpc = ARC::STrri_s;
+        else if (Opcode == ARC::STrri_i8 && isImmInRange(Op1, 0, 32))
+          NewOpc = ARC::STrri_i8_s;
+        else if (Opcode == ARC::STrri_i16 && isImmInRange(Op1, 0, 64, 2))
+          NewOpc = ARC::STrri_i16_s;
+        else
+          return false;
+
+        buildReduced(MI, NewOpc).addOperand(Op0).addOperand(Op1)
+            .addOperand(Src);
+        break;
+      }
+
+      case ARC::STrri_a: {
+        // st.a c,[sp,-4] is a push.
+        const MachineOperand &Src = MI->getOperand(2);
+        if (!isReg(Op0, ARC::SP) || !isImmInRange(Op1, -4, -3))
+          return false;
+
+        if (isShort(Src))
+          buildReduced(MI, ARC::PUSH_S).addOperand(Src);
+        else if (isReg(Src, ARC::BLINK))
+          buildReduced(MI, ARC::PUSH_S_BLINK);
+        else
+          return false;
+        break;
+      }
+
+      case ARC::LDri_ab: {
+        // ld.ab a,[sp,4] is a pop.
+        if (!isReg(Op1, ARC::SP) || !isImmInRange(MI->getOperand(2), 4, 5))
+          return false;
+
+        if (isShort(Op0))
+          buildReduced(MI, ARC::POP_S).addOperand(Op0);
+        else if (isReg(Op0, ARC::BLINK))
+          buildReduced(MI, ARC::POP_S_BLINK);
+        else
+          return false;
+        break;
+      }
+    }
+  }
+
+  DEBUG(dbgs() << "Reducing: " << *MI);
+  MI->eraseFromParent();
+  return true;
+}
+
+bool ARCompactSizeReduction::runOnMachineFunction(MachineFunction &MF) {
+  switch (SizeReduction) {
+    case ReduceNever:
+      return false;
+    case ReduceOptSize:
+      if (!MF.getFunction()->hasFnAttr(Attribute::OptimizeForSize))
+        return false;
+      break;
+    case ReduceAlways:
+      break;
+  }
+
+  TII = MF.getTarget().getInstrInfo();
+
+  bool Changed = false;
+  for (MachineFunction::iterator MFI = MF.begin(), E = MF.end(); MFI != E;
+       ++MFI) {
+    MachineBasicBlock &MBB = *MFI;
+    for (MachineBasicBlock::iterator I = MBB.begin(); I != MBB.end(); ) {
+      MachineInstr *MI = I++;
+      Changed |= reduceMI(MI);
+    }
+  }
+
+  return Changed;
+}
@@ -13,6 +13,7 @@
 
 #include "ARCompactSubtarget.h"
 #include "ARCompact.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/TargetRegistry.h"
 
 #define GET_SUBTARGETINFO_TARGET_DESC
@@ -23,7 +24,9 @@ using namespace llvm;
 
 ARCompactSubtarget::ARCompactSubtarget(const std::string &TT,
     const std::string &CPU, const std::string &FS)
-    : ARCompactGenSubtargetInfo(TT, CPU, FS) {
+    : ARCompactGenSubtargetInfo(TT, CPU, FS), HasBarrelShifter(false),
+      HasMPY(false), HasMul64(false), HasDiv(false), HasNorm(false),
+      HasSwap(false), HasSat(false) {
   // Determine default and user specified characteristics
   std::string CPUName = CPU;
   if (CPUName.empty()) {
@@ -32,4 +35,19 @@ ARCompactSubtarget::ARCompactSubtarget(const std::string &TT,
 
   // Parse features string.
   ParseSubtargetFeatures(CPUName, FS);
+
+  // Initialize the scheduling itinerary for the specified CPU.
+  InstrItins = getInstrItineraryForCPU(CPUName);
+}
+
+bool ARCompactSubtarget::
+enablePostRAScheduler(CodeGenOpt::Level OptLevel,
+                      TargetSubtargetInfo::AntiDepBreakMode& Mode,
+                      RegClassVector& CriticalPathRCs) const {
+  // Registers are not renamed to break anti-dependencies; the passes after
+  // scheduling (hardware loops, branch fusion, delay slot filling) look for
+  // particular register uses and gain little from the extra freedom.
+  Mode = TargetSubtargetInfo::ANTIDEP_NONE;
+  CriticalPathRCs.clear();
+  return OptLevel >= CodeGenOpt::Default;
 }
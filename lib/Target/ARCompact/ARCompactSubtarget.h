@@ -15,6 +15,7 @@
 #define ARCOMPACT_SUBTARGET_H
 
 #include "llvm/Target/TargetSubtargetInfo.h"
+#include "llvm/MC/MCInstrItineraries.h"
 #include <string>
 
 #define GET_SUBTARGETINFO_HEADER
@@ -24,6 +25,16 @@ namespace llvm {
 class StringRef;
 
 class ARCompactSubtarget : public ARCompactGenSubtargetInfo {
+  bool HasBarrelShifter;
+  bool HasMPY;
+  bool HasMul64;
+  bool HasDiv;
+  bool HasNorm;
+  bool HasSwap;
+  bool HasSat;
+
+  InstrItineraryData InstrItins;
+
 public:
   ARCompactSubtarget(const std::string &TT, const std::string &CPU,
                  const std::string &FS);
@@ -32,6 +43,23 @@ public:
   /// Auto-generated by tablegen.
   void ParseSubtargetFeatures(StringRef CPU, StringRef FS);
 
+  /// enablePostRAScheduler - True at 'Default' optimization and above.
+  bool enablePostRAScheduler(CodeGenOpt::Level OptLevel,
+                             TargetSubtargetInfo::AntiDepBreakMode& Mode,
+                             RegClassVector& CriticalPathRCs) const;
+
+  /// getInstrItineraryData - Return the instruction itineraries for the
+  /// selected CPU.
+  const InstrItineraryData &getInstrItineraryData() const { return InstrItins; }
+
+  bool hasBarrelShifter() const { return HasBarrelShifter; }
+  bool hasMPY()           const { return HasMPY; }
+  bool hasMul64()         const { return HasMul64; }
+  bool hasDiv()           const { return HasDiv; }
+  bool hasNorm()          const { return HasNorm; }
+  bool hasSwap()          const { return HasSwap; }
+  bool hasSat()           const { return HasSat; }
+
   std::string getDataLayout() const {
     const char *p;
     p = "e-p:32:32:32-i1:8:8-i8:8:8-i16:16:16-i32:32:32-"
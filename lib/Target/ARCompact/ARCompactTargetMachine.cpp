@@ -37,7 +37,8 @@ ARCompactTargetMachine::ARCompactTargetMachine(const Target &T,
     TLInfo(*this),
     TSInfo(*this),
     InstrInfo(*this),
-    FrameLowering(Subtarget) {
+    FrameLowering(Subtarget),
+    InstrItins(Subtarget.getInstrItineraryData()) {
 }
 
 namespace {
@@ -51,8 +52,10 @@ public:
     return getTM<ARCompactTargetMachine>();
   }
 
+  virtual bool addPreISel();
   virtual bool addInstSelector();
   virtual bool addPreSched2();
+  virtual bool addPreEmitPass();
 };
 } // namespace
 
@@ -60,6 +63,15 @@ TargetPassConfig *ARCompactTargetMachine::createPassConfig(PassManagerBase &PM)
   return new ARCompactPassConfig(this, PM);
 }
 
+bool ARCompactPassConfig::addPreISel() {
+  // Count down the loops which may become hardware loops. This must come
+  // after loop strength reduction, which would otherwise rewrite the counter.
+  if (getOptLevel() != CodeGenOpt::None) {
+    PM->add(createARCompactCountedLoopsPass(getARCompactTargetMachine()));
+  }
+  return false;
+}
+
 bool ARCompactPassConfig::addInstSelector() {
   // Install an instruction selector.
   PM->add(createARCompactISelDag(getARCompactTargetMachine(), getOptLevel()));
@@ -72,4 +84,32 @@ bool ARCompactPassConfig::addPreSched2() {
     addPass(IfConverterID);
   }
   return false;
-}
\ No newline at end of file
+}
+
+bool ARCompactPassConfig::addPreEmitPass() {
+  if (getOptLevel() != CodeGenOpt::None) {
+    // Turn the counted loops into hardware loops once the block layout is
+    // final, as the loop body must be contiguous.
+    PM->add(createARCompactHardwareLoopsPass());
+
+    // Fuse the compares into the branches which are in range. The hardware
+    // loops are formed first, as they remove the compare and branch at the
+    // end of the loop altogether.
+    PM->add(createARCompactBranchFusionPass());
+  }
+
+  // Use the 16-bit instructions where possible. This must come after the if
+  // converter, as the 16-bit instructions cannot be predicated.
+  PM->add(createARCompactSizeReductionPass());
+  if (getOptLevel() == CodeGenOpt::None) {
+    return true;
+  }
+
+  // Fill the delay slots last, so that the instructions moved into them are
+  // already in their final form. The filled slots follow the terminators,
+  // which the machine verifier does not allow, so verify before filling them
+  // rather than after.
+  printAndVerify("After ARCompact size reduction");
+  PM->add(createARCompactDelaySlotFillerPass());
+  return false;
+}
@@ -32,6 +32,7 @@ class ARCompactTargetMachine : public LLVMTargetMachine {
   ARCompactSelectionDAGInfo TSInfo;
   ARCompactInstrInfo InstrInfo;
   ARCompactFrameLowering FrameLowering;
+  InstrItineraryData InstrItins;
 public:
   ARCompactTargetMachine(const Target &T, StringRef TT,
                       StringRef CPU, StringRef FS, const TargetOptions &Options,
@@ -59,6 +60,9 @@ public:
   virtual const TargetData *getTargetData() const {
     return &DataLayout;
   }
+  virtual const InstrItineraryData *getInstrItineraryData() const {
+    return &InstrItins;
+  }
 
   // Pass Pipeline Configuration
   virtual TargetPassConfig *createPassConfig(PassManagerBase &PM);
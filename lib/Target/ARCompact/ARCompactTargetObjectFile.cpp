@@ -0,0 +1,90 @@
+//===--- ARCompactTargetObjectFile.cpp - ARCompact Object File Lowering ---===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Globals no bigger than the small data threshold are placed in .sdata and
+// .sbss, where they can be reached by a single load or store relative to GP
+// rather than through a long immediate address. The threshold plays the same
+// part as -G in the other ARC toolchains, and a threshold of zero turns small
+// data off.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ARCompactTargetObjectFile.h"
+#include "llvm/DerivedTypes.h"
+#include "llvm/GlobalVariable.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCSectionELF.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/ELF.h"
+#include "llvm/Target/TargetData.h"
+#include "llvm/Target/TargetMachine.h"
+using namespace llvm;
+
+static cl::opt<unsigned> SmallDataThreshold("arcompact-ssection-threshold",
+    cl::Hidden, cl::init(4),
+    cl::desc("Largest object, in bytes, put in the ARCompact small data "
+             "sections, like -G (default=4)"));
+
+void ARCompactTargetObjectFile::Initialize(MCContext &Ctx,
+    const TargetMachine &TM) {
+  TargetLoweringObjectFileELF::Initialize(Ctx, TM);
+
+  SmallDataSection =
+    getContext().getELFSection(".sdata", ELF::SHT_PROGBITS,
+                               ELF::SHF_WRITE | ELF::SHF_ALLOC,
+                               SectionKind::getDataRel());
+
+  SmallBSSSection =
+    getContext().getELFSection(".sbss", ELF::SHT_NOBITS,
+                               ELF::SHF_WRITE | ELF::SHF_ALLOC,
+                               SectionKind::getBSS());
+}
+
+bool ARCompactTargetObjectFile::IsGlobalInSmallSection(const GlobalValue *GV,
+    const TargetMachine &TM) const {
+  // Only globals defined here are known to be in the small sections.
+  if (GV->isDeclaration() || GV->hasAvailableExternallyLinkage()) {
+    return false;
+  }
+
+  return IsGlobalInSmallSection(GV, TM, getKindForGlobal(GV, TM));
+}
+
+bool ARCompactTargetObjectFile::IsGlobalInSmallSection(const GlobalValue *GV,
+    const TargetMachine &TM, SectionKind Kind) const {
+  const GlobalVariable *GVA = dyn_cast<GlobalVariable>(GV);
+  if (!GVA) {
+    return false;
+  }
+
+  // Globals with a section of their own, and weak globals, which go in
+  // sections of their own, stay where they are. Common symbols and local
+  // BSS symbols are emitted with .comm, which allocates them in .bss.
+  if (GVA->hasSection() || GVA->isWeakForLinker()) {
+    return false;
+  }
+  if (Kind.isBSSLocal() || (!Kind.isBSS() && !Kind.isDataRel())) {
+    return false;
+  }
+
+  uint64_t Size =
+    TM.getTargetData()->getTypeAllocSize(GV->getType()->getElementType());
+  return Size > 0 && Size <= SmallDataThreshold;
+}
+
+const MCSection *ARCompactTargetObjectFile::SelectSectionForGlobal(
+    const GlobalValue *GV, SectionKind Kind, Mangler *Mang,
+    const TargetMachine &TM) const {
+  if (IsGlobalInSmallSection(GV, TM, Kind)) {
+    return Kind.isBSS() ? SmallBSSSection : SmallDataSection;
+  }
+
+  return TargetLoweringObjectFileELF::SelectSectionForGlobal(GV, Kind, Mang,
+                                                             TM);
+}
@@ -0,0 +1,42 @@
+//===---- ARCompactTargetObjectFile.h - ARCompact Object File Lowering ----===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the ARCompact subclass of TargetLoweringObjectFileELF,
+// which places small globals into the GP-relative small data sections.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef ARCOMPACTTARGETOBJECTFILE_H
+#define ARCOMPACTTARGETOBJECTFILE_H
+
+#include "llvm/CodeGen/TargetLoweringObjectFileImpl.h"
+
+namespace llvm {
+
+class ARCompactTargetObjectFile : public TargetLoweringObjectFileELF {
+  const MCSection *SmallDataSection;
+  const MCSection *SmallBSSSection;
+
+public:
+  virtual void Initialize(MCContext &Ctx, const TargetMachine &TM);
+
+  /// IsGlobalInSmallSection - Returns true if GV is placed in .sdata or
+  /// .sbss, and so can be addressed relative to GP.
+  bool IsGlobalInSmallSection(const GlobalValue *GV,
+                              const TargetMachine &TM) const;
+  bool IsGlobalInSmallSection(const GlobalValue *GV, const TargetMachine &TM,
+                              SectionKind Kind) const;
+
+  virtual const MCSection *SelectSectionForGlobal(const GlobalValue *GV,
+      SectionKind Kind, Mangler *Mang, const TargetMachine &TM) const;
+};
+
+} // end namespace llvm
+
+#endif
@@ -0,0 +1,812 @@
+//===-- ARCompactAsmParser.cpp - Parse ARCompact asm to MCInst instructions -===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains the parser for the ARCompact assembly syntax printed by
+// ARCompactInstPrinter, which is matched against the instructions by the
+// TableGen'erated matcher.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ARCompact.h"
+#include "MCTargetDesc/ARCompactBaseInfo.h"
+
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCExpr.h"
+#include "llvm/MC/MCInst.h"
+#include "llvm/MC/MCInstrDesc.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCParser/MCAsmLexer.h"
+#include "llvm/MC/MCParser/MCAsmParser.h"
+#include "llvm/MC/MCParser/MCParsedAsmOperand.h"
+#include "llvm/MC/MCStreamer.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/MC/MCTargetAsmParser.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace llvm;
+
+namespace {
+struct ARCompactOperand;
+
+class ARCompactAsmParser : public MCTargetAsmParser {
+  MCSubtargetInfo &STI;
+  MCAsmParser &Parser;
+  OwningPtr<const MCInstrInfo> MII;
+
+  /// MatchOperands - The operands of the instruction being matched, for
+  /// checkTargetMatchPredicate.
+  const SmallVectorImpl<MCParsedAsmOperand*> *MatchOperands;
+
+  /// ImplicitAL - True while matching with a CondCode operand which was not
+  /// written in the source.
+  bool ImplicitAL;
+
+  MCAsmParser &getParser() const { return Parser; }
+  MCAsmLexer &getLexer() const { return Parser.getLexer(); }
+
+  bool Error(SMLoc L, const Twine &Msg) { return Parser.Error(L, Msg); }
+
+  unsigned matchRegister(StringRef Name);
+  unsigned matchAuxRegister(StringRef Name);
+  bool parseSmallDataAddress(const MCExpr *&Res);
+  ARCompactOperand *parseMemory();
+  ARCompactOperand *parseOperand(StringRef Mnemonic);
+
+  virtual bool ParseRegister(unsigned &RegNo, SMLoc &StartLoc, SMLoc &EndLoc);
+
+  bool MatchAndEmitInstruction(SMLoc IDLoc,
+                               SmallVectorImpl<MCParsedAsmOperand*> &Operands,
+                               MCStreamer &Out);
+
+  unsigned checkTargetMatchPredicate(MCInst &Inst);
+
+  /// @name Auto-generated Match Functions
+  /// {
+
+#define GET_ASSEMBLER_HEADER
+#include "ARCompactGenAsmMatcher.inc"
+
+  /// }
+
+public:
+  ARCompactAsmParser(MCSubtargetInfo &_STI, MCAsmParser &_Parser)
+    : MCTargetAsmParser(), STI(_STI), Parser(_Parser),
+      MII(TheARCompactTarget.createMCInstrInfo()), MatchOperands(0),
+      ImplicitAL(false) {
+    setAvailableFeatures(ComputeAvailableFeatures(STI.getFeatureBits()));
+  }
+
+  virtual bool ParseInstruction(StringRef Name, SMLoc NameLoc,
+                                SmallVectorImpl<MCParsedAsmOperand*> &Operands);
+
+  virtual bool ParseDirective(AsmToken DirectiveID);
+};
+
+/// ARCompactOperand - Instances of this class represent a parsed ARCompact
+/// machine instruction operand.
+struct ARCompactOperand : public MCParsedAsmOperand {
+  enum KindTy {
+    Token,
+    Register,
+    Immediate,
+    CondCode,
+    Memory
+  } Kind;
+
+  SMLoc StartLoc, EndLoc;
+
+  union {
+    struct {
+      const char *Data;
+      unsigned Length;
+    } Tok;
+
+    struct {
+      unsigned RegNum;
+    } Reg;
+
+    struct {
+      const MCExpr *Val;
+    } Imm;
+
+    struct {
+      unsigned Val;
+    } CC;
+
+    /// A memory operand has either a base register or a base expression,
+    /// and either an index register or an offset expression, which may be
+    /// missing.
+    struct {
+      unsigned BaseReg;
+      const MCExpr *BaseExpr;
+      unsigned IndexReg;
+      const MCExpr *Off;
+    } Mem;
+  };
+
+  ARCompactOperand(KindTy K) : MCParsedAsmOperand(), Kind(K) {}
+
+  /// getStartLoc - Get the location of the first token of this operand.
+  SMLoc getStartLoc() const { return StartLoc; }
+
+  /// getEndLoc - Get the location of the last token of this operand.
+  SMLoc getEndLoc() const { return EndLoc; }
+
+  StringRef getToken() const {
+    assert(Kind == Token && "Invalid access!");
+    return StringRef(Tok.Data, Tok.Length);
+  }
+
+  unsigned getReg() const {
+    assert(Kind == Register && "Invalid access!");
+    return Reg.RegNum;
+  }
+
+  const MCExpr *getImm() const {
+    assert(Kind == Immediate && "Invalid access!");
+    return Imm.Val;
+  }
+
+  unsigned getCondCode() const {
+    assert(Kind == CondCode && "Invalid access!");
+    return CC.Val;
+  }
+
+  bool isToken() const { return Kind == Token; }
+  bool isReg() const { return Kind == Register; }
+  bool isImm() const { return Kind == Immediate; }
+  bool isMem() const { return Kind == Memory; }
+
+  /// isConstantImm - Returns true, and the value in Val, if this is an
+  /// immediate with a constant value.
+  bool isConstantImm(int64_t &Val) const {
+    if (Kind != Immediate)
+      return false;
+    const MCConstantExpr *CE = dyn_cast<MCConstantExpr>(Imm.Val);
+    if (!CE)
+      return false;
+    Val = CE->getValue();
+    return true;
+  }
+
+  bool isU3() const { int64_t V; return isConstantImm(V) && isUInt<3>(V); }
+  bool isU5() const { int64_t V; return isConstantImm(V) && isUInt<5>(V); }
+  bool isU6() const { int64_t V; return isConstantImm(V) && isUInt<6>(V); }
+  bool isU7() const { int64_t V; return isConstantImm(V) && isUInt<7>(V); }
+  bool isU8() const { int64_t V; return isConstantImm(V) && isUInt<8>(V); }
+  bool isS12() const { int64_t V; return isConstantImm(V) && isInt<12>(V); }
+
+  /// isU7W - A word aligned offset from SP, scaled down by four in the
+  /// encoding.
+  bool isU7W() const {
+    int64_t V;
+    return isConstantImm(V) && isUInt<7>(V) && (V & 3) == 0;
+  }
+
+  bool isCondCode() const { return Kind == CondCode; }
+
+  /// isBRccCond - The conditions which BRcc can test directly.
+  bool isBRccCond() const {
+    if (Kind != CondCode)
+      return false;
+    switch (CC.Val) {
+      case ARCCC::COND_EQ: case ARCCC::COND_NE: case ARCCC::COND_LT:
+      case ARCCC::COND_GE: case ARCCC::COND_LO: case ARCCC::COND_HS:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  /// isShortCC - The conditions which Bcc_S can test.
+  bool isShortCC() const {
+    if (Kind != CondCode)
+      return false;
+    switch (CC.Val) {
+      case ARCCC::COND_GT: case ARCCC::COND_GE: case ARCCC::COND_LT:
+      case ARCCC::COND_LE: case ARCCC::COND_HI: case ARCCC::COND_HS:
+      case ARCCC::COND_LO: case ARCCC::COND_LS:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  /// isConstantMemOffset - Returns true if this is a memory operand with a
+  /// base register and a constant offset, or no offset at all.
+  bool isConstantMemOffset(int64_t &Off) const {
+    if (Kind != Memory || !Mem.BaseReg || Mem.IndexReg)
+      return false;
+    Off = 0;
+    if (!Mem.Off)
+      return true;
+    const MCConstantExpr *CE = dyn_cast<MCConstantExpr>(Mem.Off);
+    if (!CE)
+      return false;
+    Off = CE->getValue();
+    return true;
+  }
+
+  bool isMemRI() const {
+    int64_t Off;
+    return isConstantMemOffset(Off) && isInt<9>(Off);
+  }
+
+  bool isMemLI() const {
+    return Kind == Memory && Mem.BaseExpr && !Mem.IndexReg && !Mem.Off;
+  }
+
+  bool isMemRR() const {
+    return Kind == Memory && Mem.BaseReg && Mem.IndexReg;
+  }
+
+  bool isMemLIR() const {
+    return Kind == Memory && Mem.BaseExpr && Mem.IndexReg;
+  }
+
+  bool isMemRRShort() const {
+    return isMemRR() && isARCompactShortRegister(Mem.BaseReg) &&
+           isARCompactShortRegister(Mem.IndexReg);
+  }
+
+  bool isMemRS(unsigned Shift) const {
+    int64_t Off;
+    return isConstantMemOffset(Off) && isARCompactShortRegister(Mem.BaseReg) &&
+           Off >= 0 && (Off & ((1 << Shift) - 1)) == 0 &&
+           (Off >> Shift) <= 31;
+  }
+
+  bool isMemRSWord() const { return isMemRS(2); }
+  bool isMemRSHalf() const { return isMemRS(1); }
+  bool isMemRSByte() const { return isMemRS(0); }
+
+  bool isMemSP() const {
+    int64_t Off;
+    return isConstantMemOffset(Off) && Mem.BaseReg == ARC::SP &&
+           Off >= 0 && Off <= 124 && (Off & 3) == 0;
+  }
+
+  bool isMemGP() const {
+    return Kind == Memory && Mem.BaseReg == ARC::GP && Mem.Off &&
+           !isa<MCConstantExpr>(Mem.Off);
+  }
+
+  void addExpr(MCInst &Inst, const MCExpr *Expr) const {
+    // Add as immediates when possible.
+    if (const MCConstantExpr *CE = dyn_cast<MCConstantExpr>(Expr))
+      Inst.addOperand(MCOperand::CreateImm(CE->getValue()));
+    else
+      Inst.addOperand(MCOperand::CreateExpr(Expr));
+  }
+
+  void addRegOperands(MCInst &Inst, unsigned N) const {
+    assert(N == 1 && "Invalid number of operands!");
+    Inst.addOperand(MCOperand::CreateReg(getReg()));
+  }
+
+  void addImmOperands(MCInst &Inst, unsigned N) const {
+    assert(N == 1 && "Invalid number of operands!");
+    addExpr(Inst, getImm());
+  }
+
+  /// addCondCodeOperands - A predicate has a second, register, operand which
+  /// is always zero here.
+  void addCondCodeOperands(MCInst &Inst, unsigned N) const {
+    assert((N == 1 || N == 2) && "Invalid number of operands!");
+    Inst.addOperand(MCOperand::CreateImm(getCondCode()));
+    if (N == 2)
+      Inst.addOperand(MCOperand::CreateReg(0));
+  }
+
+  void addBRccCondOperands(MCInst &Inst, unsigned N) const {
+    addCondCodeOperands(Inst, N);
+  }
+
+  void addShortCCOperands(MCInst &Inst, unsigned N) const {
+    addCondCodeOperands(Inst, N);
+  }
+
+  void addMemOperands(MCInst &Inst, unsigned N) const {
+    assert((N == 1 || N == 2) && "Invalid number of operands!");
+    if (Mem.BaseReg)
+      Inst.addOperand(MCOperand::CreateReg(Mem.BaseReg));
+    else
+      addExpr(Inst, Mem.BaseExpr);
+
+    if (N == 1)
+      return;
+    if (Mem.IndexReg)
+      Inst.addOperand(MCOperand::CreateReg(Mem.IndexReg));
+    else if (Mem.Off)
+      addExpr(Inst, Mem.Off);
+    else
+      Inst.addOperand(MCOperand::CreateImm(0));
+  }
+
+  virtual void print(raw_ostream &OS) const;
+
+  static ARCompactOperand *CreateToken(StringRef Str, SMLoc S) {
+    ARCompactOperand *Op = new ARCompactOperand(Token);
+    Op->Tok.Data = Str.data();
+    Op->Tok.Length = Str.size();
+    Op->StartLoc = S;
+    Op->EndLoc = S;
+    return Op;
+  }
+
+  static ARCompactOperand *CreateReg(unsigned RegNum, SMLoc S, SMLoc E) {
+    ARCompactOperand *Op = new ARCompactOperand(Register);
+    Op->Reg.RegNum = RegNum;
+    Op->StartLoc = S;
+    Op->EndLoc = E;
+    return Op;
+  }
+
+  static ARCompactOperand *CreateImm(const MCExpr *Val, SMLoc S, SMLoc E) {
+    ARCompactOperand *Op = new ARCompactOperand(Immediate);
+    Op->Imm.Val = Val;
+    Op->StartLoc = S;
+    Op->EndLoc = E;
+    return Op;
+  }
+
+  static ARCompactOperand *CreateCondCode(unsigned CC, SMLoc S) {
+    ARCompactOperand *Op = new ARCompactOperand(CondCode);
+    Op->CC.Val = CC;
+    Op->StartLoc = S;
+    Op->EndLoc = S;
+    return Op;
+  }
+
+  static ARCompactOperand *CreateMem(unsigned BaseReg, const MCExpr *BaseExpr,
+                                     unsigned IndexReg, const MCExpr *Off,
+                                     SMLoc S, SMLoc E) {
+    ARCompactOperand *Op = new ARCompactOperand(Memory);
+    Op->Mem.BaseReg = BaseReg;
+    Op->Mem.BaseExpr = BaseExpr;
+    Op->Mem.IndexReg = IndexReg;
+    Op->Mem.Off = Off;
+    Op->StartLoc = S;
+    Op->EndLoc = E;
+    return Op;
+  }
+};
+} // end anonymous namespace.
+
+void ARCompactOperand::print(raw_ostream &OS) const {
+  switch (Kind) {
+  case Token:
+    OS << "'" << getToken() << "'";
+    break;
+  case Register:
+    OS << "<register " << getARCompactRegisterNumbering(getReg()) << ">";
+    break;
+  case Immediate:
+    getImm()->print(OS);
+    break;
+  case CondCode:
+    OS << "<cc " << ARCCCToString((ARCCC::CondCodes)getCondCode()) << ">";
+    break;
+  case Memory:
+    OS << "<memory ";
+    if (Mem.BaseReg)
+      OS << getARCompactRegisterNumbering(Mem.BaseReg);
+    else
+      OS << *Mem.BaseExpr;
+    if (Mem.IndexReg)
+      OS << ", " << getARCompactRegisterNumbering(Mem.IndexReg);
+    else if (Mem.Off)
+      OS << ", " << *Mem.Off;
+    OS << ">";
+    break;
+  }
+}
+
+/// @name Auto-generated Match Functions
+/// {
+
+static unsigned MatchRegisterName(StringRef Name);
+
+/// }
+
+/// parseCondCodeName - Returns the condition code named by Name, including
+/// the flag based aliases, or COND_INVALID.
+static unsigned parseCondCodeName(StringRef Name) {
+  return StringSwitch<unsigned>(Name.lower())
+    .Cases("al", "ra", ARCCC::COND_AL)
+    .Cases("eq", "z", ARCCC::COND_EQ)
+    .Cases("ne", "nz", ARCCC::COND_NE)
+    .Cases("p", "pl", ARCCC::COND_P)
+    .Cases("n", "mi", ARCCC::COND_N)
+    .Cases("lo", "cs", "c", ARCCC::COND_LO)
+    .Cases("hs", "cc", "nc", ARCCC::COND_HS)
+    .Cases("v", "vs", ARCCC::COND_V)
+    .Cases("nv", "vc", ARCCC::COND_NV)
+    .Case("gt", ARCCC::COND_GT)
+    .Case("ge", ARCCC::COND_GE)
+    .Case("lt", ARCCC::COND_LT)
+    .Case("le", ARCCC::COND_LE)
+    .Case("hi", ARCCC::COND_HI)
+    .Case("ls", ARCCC::COND_LS)
+    .Case("pnz", ARCCC::COND_PNZ)
+    .Default(ARCCC::COND_INVALID);
+}
+
+unsigned ARCompactAsmParser::checkTargetMatchPredicate(MCInst &Inst) {
+  const MCInstrDesc &Desc = MII->get(Inst.getOpcode());
+
+  // A CondCode which was not written only stands for the default predicate,
+  // and not for the condition of MOVcc or Bcc.
+  if (ImplicitAL && Desc.findFirstPredOperandIdx() == -1)
+    return Match_InvalidOperand;
+
+  // The matcher ignores the source which is tied to the destination, so make
+  // sure that the two registers written for them are the same.
+  if (Desc.getNumOperands() > 1 &&
+      Desc.getOperandConstraint(1, MCOI::TIED_TO) == 0) {
+    SmallVector<unsigned, 4> Regs;
+    unsigned NumOperands = 0;
+    for (unsigned i = 1, e = MatchOperands->size(); i != e; ++i) {
+      ARCompactOperand *Op = (ARCompactOperand*)(*MatchOperands)[i];
+      if (Op->isToken() || Op->isCondCode())
+        continue;
+      ++NumOperands;
+      if (Op->isReg())
+        Regs.push_back(Op->getReg());
+    }
+    if (NumOperands >= 3 && Regs.size() >= 2 && Regs[0] != Regs[1])
+      return Match_InvalidOperand;
+  }
+
+  return Match_Success;
+}
+
+bool ARCompactAsmParser::
+MatchAndEmitInstruction(SMLoc IDLoc,
+                        SmallVectorImpl<MCParsedAsmOperand*> &Operands,
+                        MCStreamer &Out) {
+  MCInst Inst;
+  unsigned ErrorInfo;
+
+  MatchOperands = &Operands;
+  ImplicitAL = false;
+  unsigned Result = MatchInstructionImpl(Operands, Inst, ErrorInfo);
+
+  // Unless a condition was given, the predicable instructions also need to
+  // be tried with the default one, which goes after the suffixes of the
+  // mnemonic. Of the two matches, prefer the smaller one.
+  bool HasCondCode = false;
+  unsigned CCPos = 1;
+  for (unsigned i = 1, e = Operands.size(); i != e; ++i) {
+    ARCompactOperand *Op = (ARCompactOperand*)Operands[i];
+    if (Op->isCondCode())
+      HasCondCode = true;
+    if (i == CCPos && Op->isToken() && Op->getToken().startswith("."))
+      ++CCPos;
+  }
+
+  if (!HasCondCode) {
+    ARCompactOperand *AL =
+      ARCompactOperand::CreateCondCode(ARCCC::COND_AL, IDLoc);
+    SmallVector<MCParsedAsmOperand*, 8> PredOperands(Operands.begin(),
+                                                     Operands.end());
+    PredOperands.insert(PredOperands.begin() + CCPos, AL);
+
+    MCInst PredInst;
+    unsigned PredErrorInfo;
+    MatchOperands = &PredOperands;
+    ImplicitAL = true;
+    if (MatchInstructionImpl(PredOperands, PredInst, PredErrorInfo) ==
+        Match_Success) {
+      if (Result != Match_Success ||
+          MII->get(PredInst.getOpcode()).getSize() <=
+          MII->get(Inst.getOpcode()).getSize()) {
+        Inst = PredInst;
+        Result = Match_Success;
+      }
+    }
+    ImplicitAL = false;
+    delete AL;
+  }
+  MatchOperands = 0;
+
+  switch (Result) {
+  default: break;
+  case Match_Success:
+    // Like the AsmPrinter, start branches off short and let the backend
+    // relax them.
+    if (Inst.getNumOperands() && Inst.getOperand(0).isExpr())
+      shortenARCompactBranch(Inst);
+    Out.EmitInstruction(Inst);
+    return false;
+  case Match_MissingFeature:
+    return Error(IDLoc, "instruction use requires an option to be enabled");
+  case Match_MnemonicFail:
+    return Error(IDLoc, "unrecognized instruction mnemonic");
+  case Match_ConversionFail:
+    return Error(IDLoc, "unable to convert operands to instruction");
+  case Match_InvalidOperand:
+    SMLoc ErrorLoc = IDLoc;
+    if (ErrorInfo != ~0U) {
+      if (ErrorInfo >= Operands.size())
+        return Error(IDLoc, "too few operands for instruction");
+
+      ErrorLoc = ((ARCompactOperand*)Operands[ErrorInfo])->getStartLoc();
+      if (ErrorLoc == SMLoc()) ErrorLoc = IDLoc;
+    }
+
+    return Error(ErrorLoc, "invalid operand for instruction");
+  }
+
+  llvm_unreachable("Implement any new match types added!");
+}
+
+/// matchRegister - Register names are case insensitive.
+unsigned ARCompactAsmParser::matchRegister(StringRef Name) {
+  return MatchRegisterName(Name.lower());
+}
+
+/// matchAuxRegister - Returns the number of the named auxiliary register,
+/// or ~0U if there is none.
+unsigned ARCompactAsmParser::matchAuxRegister(StringRef Name) {
+  return StringSwitch<unsigned>(Name.lower())
+    .Case("lp_start", ARCAux::LP_START)
+    .Case("lp_end", ARCAux::LP_END)
+    .Case("mulhi", ARCAux::MULHI)
+    .Default(~0U);
+}
+
+bool ARCompactAsmParser::ParseRegister(unsigned &RegNo,
+                                       SMLoc &StartLoc, SMLoc &EndLoc) {
+  const AsmToken &Tok = Parser.getTok();
+  StartLoc = Tok.getLoc();
+  EndLoc = Tok.getEndLoc();
+  if (Tok.isNot(AsmToken::Identifier))
+    return true;
+  RegNo = matchRegister(Tok.getIdentifier());
+  if (RegNo == 0)
+    return true;
+  Parser.Lex();
+  return false;
+}
+
+/// parseSmallDataAddress - Parses the "@sym@sda+off" address of a small data
+/// object, which is relative to GP. The lexer includes the "@sda" in the
+/// symbol's identifier.
+///   ::= '@' identifier '@sda' [('+' | '-') expression]
+bool ARCompactAsmParser::parseSmallDataAddress(const MCExpr *&Res) {
+  SMLoc S = Parser.getTok().getLoc();
+  Parser.Lex(); // Eat the '@'.
+
+  if (getLexer().isNot(AsmToken::Identifier))
+    return Error(S, "expected a small data symbol");
+  StringRef Name = Parser.getTok().getIdentifier();
+  if (!Name.endswith("@sda"))
+    return Error(S, "expected a small data symbol");
+  Name = Name.drop_back(4);
+  Parser.Lex(); // Eat the symbol.
+
+  MCSymbol *Sym = getContext().GetOrCreateSymbol(Name);
+  Res = MCSymbolRefExpr::Create(Sym, getContext());
+
+  if (getLexer().is(AsmToken::Plus) || getLexer().is(AsmToken::Minus)) {
+    bool IsMinus = getLexer().is(AsmToken::Minus);
+    Parser.Lex();
+    const MCExpr *Off;
+    if (getParser().ParseExpression(Off))
+      return true;
+    Res = MCBinaryExpr::Create(IsMinus ? MCBinaryExpr::Sub : MCBinaryExpr::Add,
+                               Res, Off, getContext());
+  }
+  return false;
+}
+
+/// parseMemory - Parses a memory operand.
+///   ::= '[' (register | expression) [',' (register | expression | sda)] ']'
+ARCompactOperand *ARCompactAsmParser::parseMemory() {
+  SMLoc S = Parser.getTok().getLoc();
+  Parser.Lex(); // Eat the '['.
+
+  unsigned BaseReg = 0, IndexReg = 0;
+  const MCExpr *BaseExpr = 0, *Off = 0;
+  SMLoc RegS, RegE;
+  if (ParseRegister(BaseReg, RegS, RegE)) {
+    BaseReg = 0;
+    if (getParser().ParseExpression(BaseExpr))
+      return 0;
+  }
+
+  if (getLexer().is(AsmToken::Comma)) {
+    Parser.Lex(); // Eat the ','.
+    if (getLexer().is(AsmToken::At)) {
+      if (parseSmallDataAddress(Off))
+        return 0;
+    } else if (ParseRegister(IndexReg, RegS, RegE)) {
+      IndexReg = 0;
+      if (getParser().ParseExpression(Off))
+        return 0;
+    }
+  }
+
+  if (getLexer().isNot(AsmToken::RBrac)) {
+    Error(Parser.getTok().getLoc(), "expected ']'");
+    return 0;
+  }
+  SMLoc E = Parser.getTok().getEndLoc();
+  Parser.Lex(); // Eat the ']'.
+
+  if (BaseExpr && Off) {
+    Error(S, "a memory operand with a long immediate base cannot have an "
+             "offset");
+    return 0;
+  }
+
+  return ARCompactOperand::CreateMem(BaseReg, BaseExpr, IndexReg, Off, S, E);
+}
+
+ARCompactOperand *ARCompactAsmParser::parseOperand(StringRef Mnemonic) {
+  SMLoc S = Parser.getTok().getLoc();
+
+  // Jumps write the register holding their target in brackets, and LR and
+  // SR the auxiliary register they access.
+  bool IsAux = Mnemonic == "lr" || Mnemonic == "sr";
+  if (getLexer().is(AsmToken::LBrac)) {
+    if (Mnemonic.startswith("j") || IsAux) {
+      Parser.Lex();
+      return ARCompactOperand::CreateToken("[", S);
+    }
+    return parseMemory();
+  }
+  if (getLexer().is(AsmToken::RBrac)) {
+    Parser.Lex();
+    return ARCompactOperand::CreateToken("]", S);
+  }
+
+  // Branch targets are prefixed with '@'.
+  if (getLexer().is(AsmToken::At)) {
+    Parser.Lex();
+    return ARCompactOperand::CreateToken("@", S);
+  }
+
+  unsigned RegNo;
+  SMLoc E;
+  if (IsAux && getLexer().is(AsmToken::Identifier)) {
+    unsigned AuxReg = matchAuxRegister(Parser.getTok().getIdentifier());
+    if (AuxReg != ~0U) {
+      E = Parser.getTok().getEndLoc();
+      Parser.Lex();
+      return ARCompactOperand::CreateImm(
+          MCConstantExpr::Create(AuxReg, getContext()), S, E);
+    }
+  }
+
+  if (!ParseRegister(RegNo, S, E))
+    return ARCompactOperand::CreateReg(RegNo, S, E);
+
+  const MCExpr *Val;
+  if (getParser().ParseExpression(Val))
+    return 0;
+  E = SMLoc::getFromPointer(Parser.getTok().getLoc().getPointer() - 1);
+  return ARCompactOperand::CreateImm(Val, S, E);
+}
+
+/// ParseInstruction - Parses an instruction. The mnemonic is split into its
+/// stem and its suffixes, which are either condition codes, as in "add.eq",
+/// "beq" and "bgt_s", or tokens like ".f", ".d" and "_s".
+bool ARCompactAsmParser::
+ParseInstruction(StringRef Name, SMLoc NameLoc,
+                 SmallVectorImpl<MCParsedAsmOperand*> &Operands) {
+  size_t DotLoc = Name.find('.');
+  StringRef Head = Name.substr(0, DotLoc);
+
+  if (MnemonicIsValid(Head)) {
+    Operands.push_back(ARCompactOperand::CreateToken(Head, NameLoc));
+  } else {
+    // Only B and BR take their condition in the stem.
+    StringRef Stem = Head;
+    bool Short = false;
+    if (Stem.endswith("_s")) {
+      Stem = Stem.drop_back(2);
+      Short = true;
+    }
+
+    unsigned CC = ARCCC::COND_INVALID;
+    StringRef Prefix;
+    if (Stem.startswith("br")) {
+      Prefix = Stem.substr(0, 2);
+      CC = parseCondCodeName(Stem.substr(2));
+    }
+    if (CC == ARCCC::COND_INVALID && Stem.startswith("b")) {
+      Prefix = Stem.substr(0, 1);
+      CC = parseCondCodeName(Stem.substr(1));
+    }
+    if (CC == ARCCC::COND_INVALID)
+      return Error(NameLoc, "unrecognized instruction mnemonic");
+
+    Operands.push_back(ARCompactOperand::CreateToken(Prefix, NameLoc));
+    Operands.push_back(ARCompactOperand::CreateCondCode(CC, NameLoc));
+    if (Short)
+      Operands.push_back(ARCompactOperand::CreateToken(Head.substr(
+                             Head.size() - 2), NameLoc));
+  }
+
+  while (DotLoc != StringRef::npos) {
+    size_t Next = Name.find('.', DotLoc + 1);
+    StringRef Suffix = Name.slice(DotLoc, Next);
+    unsigned CC = parseCondCodeName(Suffix.substr(1));
+    if (CC != ARCCC::COND_INVALID)
+      Operands.push_back(ARCompactOperand::CreateCondCode(CC, NameLoc));
+    else
+      Operands.push_back(ARCompactOperand::CreateToken(Suffix, NameLoc));
+    DotLoc = Next;
+  }
+
+  if (getLexer().isNot(AsmToken::EndOfStatement)) {
+    for (;;) {
+      ARCompactOperand *Op = parseOperand(Head);
+      if (!Op)
+        return true;
+      Operands.push_back(Op);
+
+      // The brackets around a jump's register and the '@' before a branch
+      // target are not separated from them by commas.
+      if ((Op->isToken() && Op->getToken() != "]") ||
+          getLexer().is(AsmToken::RBrac))
+        continue;
+      if (getLexer().isNot(AsmToken::Comma))
+        break;
+      Parser.Lex(); // Eat the ','.
+    }
+  }
+
+  if (getLexer().isNot(AsmToken::EndOfStatement)) {
+    SMLoc Loc = getLexer().getLoc();
+    Parser.EatToEndOfStatement();
+    return Error(Loc, "unexpected token in argument list");
+  }
+  Parser.Lex(); // Consume the EndOfStatement.
+
+  // The 32-bit NOP is written "mov 0,0", with the zeros as part of the
+  // mnemonic rather than operands.
+  if (Head == "mov" && Operands.size() == 3) {
+    int64_t Dst, Src;
+    ARCompactOperand *DstOp = (ARCompactOperand*)Operands[1];
+    ARCompactOperand *SrcOp = (ARCompactOperand*)Operands[2];
+    if (DstOp->isConstantImm(Dst) && Dst == 0 &&
+        SrcOp->isConstantImm(Src) && Src == 0) {
+      SMLoc DstLoc = DstOp->getStartLoc(), SrcLoc = SrcOp->getStartLoc();
+      delete Operands.pop_back_val();
+      delete Operands.pop_back_val();
+      Operands.push_back(ARCompactOperand::CreateToken("0", DstLoc));
+      Operands.push_back(ARCompactOperand::CreateToken("0", SrcLoc));
+    }
+  }
+
+  return false;
+}
+
+/// ParseDirective - There are no ARCompact specific directives.
+bool ARCompactAsmParser::ParseDirective(AsmToken DirectiveID) {
+  return true;
+}
+
+/// Force static initialization.
+extern "C" void LLVMInitializeARCompactAsmParser() {
+  RegisterMCAsmParser<ARCompactAsmParser> X(TheARCompactTarget);
+}
+
+#define GET_REGISTER_MATCHER
+#define GET_MATCHER_IMPLEMENTATION
+#include "ARCompactGenAsmMatcher.inc"
@@ -0,0 +1,376 @@
+//===-- ARCompactDisassembler.cpp - Disassembler for ARCompact ------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file is part of the ARCompact Disassembler. It decodes the 16- and
+// 32-bit instructions with the TableGen'erated decoder tables, and then adds
+// back the parts of the instruction which are not described by the encoding
+// fields of the .td files: the long immediate which follows the instruction,
+// and the predicate of the conditional (P = 11) format of the general
+// operations.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "arcompact-disassembler"
+#include "ARCompact.h"
+#include "MCTargetDesc/ARCompactBaseInfo.h"
+
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/MC/MCDisassembler.h"
+#include "llvm/MC/MCInst.h"
+#include "llvm/MC/MCInstrDesc.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemoryObject.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace llvm;
+
+typedef MCDisassembler::DecodeStatus DecodeStatus;
+
+namespace {
+
+/// ARCompactDisassembler - ARCompact disassembler for all ARCompact
+/// platforms.
+class ARCompactDisassembler : public MCDisassembler {
+  OwningPtr<const MCInstrInfo> MII;
+
+public:
+  ARCompactDisassembler(const MCSubtargetInfo &STI)
+    : MCDisassembler(STI), MII(TheARCompactTarget.createMCInstrInfo()) {}
+
+  /// getInstruction - See MCDisassembler.
+  DecodeStatus getInstruction(MCInst &Instr, uint64_t &Size,
+                              const MemoryObject &Region, uint64_t Address,
+                              raw_ostream &VStream,
+                              raw_ostream &CStream) const;
+
+private:
+  /// decodeConditional - Decodes a general operation in the conditional
+  /// (P = 11) format, by rewriting it into the equivalent unconditional
+  /// register or u6 form, where the destination is the same as the first
+  /// source, and then supplying the condition code as its predicate.
+  DecodeStatus decodeConditional(MCInst &Instr, uint32_t Insn,
+                                 uint64_t Address, unsigned &CC) const;
+};
+
+} // end anonymous namespace
+
+/// readHalfWord - Reads a little endian half-word at Address.
+static bool readHalfWord(const MemoryObject &Region, uint64_t Address,
+                         uint16_t &Val) {
+  uint8_t Bytes[2];
+  if (Region.readBytes(Address, 2, Bytes, NULL) == -1)
+    return false;
+  Val = Bytes[0] | (Bytes[1] << 8);
+  return true;
+}
+
+/// readWord - Reads a 32-bit instruction or long immediate at Address. These
+/// are stored as two little endian half-words, most significant first.
+static bool readWord(const MemoryObject &Region, uint64_t Address,
+                     uint32_t &Val) {
+  uint16_t Hi, Lo;
+  if (!readHalfWord(Region, Address, Hi) ||
+      !readHalfWord(Region, Address + 2, Lo))
+    return false;
+  Val = (Hi << 16) | Lo;
+  return true;
+}
+
+static const unsigned CPURegsTable[64] = {
+  ARC::R0, ARC::R1, ARC::R2, ARC::R3, ARC::R4, ARC::R5, ARC::R6, ARC::R7,
+  ARC::T0, ARC::T1, ARC::T2, ARC::T3, ARC::T4, ARC::T5, ARC::T6, ARC::T7,
+  ARC::S0, ARC::S1, ARC::S2, ARC::S3, ARC::S4, ARC::S5, ARC::S6, ARC::S7,
+  ARC::S8, ARC::S9, ARC::GP, ARC::FP, ARC::SP, ARC::ILINK1, ARC::ILINK2,
+  ARC::BLINK,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, ARC::MLO, ARC::MMID, ARC::MHI, 0, 0, 0, 0
+};
+
+static const unsigned ShortRegsTable[8] = {
+  ARC::R0, ARC::R1, ARC::R2, ARC::R3, ARC::T4, ARC::T5, ARC::T6, ARC::T7
+};
+
+static DecodeStatus DecodeCPURegsRegisterClass(MCInst &Inst, unsigned RegNo,
+                                               uint64_t Address,
+                                               const void *Decoder) {
+  if (RegNo > 63 || CPURegsTable[RegNo] == 0)
+    return MCDisassembler::Fail;
+  Inst.addOperand(MCOperand::CreateReg(CPURegsTable[RegNo]));
+  return MCDisassembler::Success;
+}
+
+static DecodeStatus DecodeShortRegsRegisterClass(MCInst &Inst, unsigned RegNo,
+                                                 uint64_t Address,
+                                                 const void *Decoder) {
+  if (RegNo > 7)
+    return MCDisassembler::Fail;
+  Inst.addOperand(MCOperand::CreateReg(ShortRegsTable[RegNo]));
+  return MCDisassembler::Success;
+}
+
+static DecodeStatus DecodeMemriOperand(MCInst &Inst, unsigned Insn,
+                                       uint64_t Address, const void *Decoder) {
+  if (DecodeCPURegsRegisterClass(Inst, Insn & 0x3F, Address, Decoder) ==
+      MCDisassembler::Fail)
+    return MCDisassembler::Fail;
+  Inst.addOperand(MCOperand::CreateImm(SignExtend32<9>(Insn >> 6)));
+  return MCDisassembler::Success;
+}
+
+static DecodeStatus DecodeMemrrOperand(MCInst &Inst, unsigned Insn,
+                                       uint64_t Address, const void *Decoder) {
+  if (DecodeCPURegsRegisterClass(Inst, Insn & 0x3F, Address, Decoder) ==
+      MCDisassembler::Fail)
+    return MCDisassembler::Fail;
+  return DecodeCPURegsRegisterClass(Inst, (Insn >> 6) & 0x3F, Address,
+                                    Decoder);
+}
+
+/// DecodeMemlirOperand - Only the register is encoded in the instruction; the
+/// long immediate is added by getInstruction.
+static DecodeStatus DecodeMemlirOperand(MCInst &Inst, unsigned Insn,
+                                        uint64_t Address, const void *Decoder) {
+  return DecodeCPURegsRegisterClass(Inst, Insn & 0x3F, Address, Decoder);
+}
+
+static DecodeStatus DecodeMemrr_sOperand(MCInst &Inst, unsigned Insn,
+                                         uint64_t Address,
+                                         const void *Decoder) {
+  if (DecodeShortRegsRegisterClass(Inst, Insn & 0x7, Address, Decoder) ==
+      MCDisassembler::Fail)
+    return MCDisassembler::Fail;
+  return DecodeShortRegsRegisterClass(Inst, (Insn >> 6) & 0x7, Address,
+                                      Decoder);
+}
+
+static DecodeStatus DecodeMemrsOperand(MCInst &Inst, unsigned Insn,
+                                       unsigned Shift) {
+  Inst.addOperand(MCOperand::CreateReg(ShortRegsTable[Insn & 0x7]));
+  Inst.addOperand(MCOperand::CreateImm(((Insn >> 3) & 0x1F) << Shift));
+  return MCDisassembler::Success;
+}
+
+static DecodeStatus DecodeMemrsWordOperand(MCInst &Inst, unsigned Insn,
+                                           uint64_t Address,
+                                           const void *Decoder) {
+  return DecodeMemrsOperand(Inst, Insn, 2);
+}
+
+static DecodeStatus DecodeMemrsHalfOperand(MCInst &Inst, unsigned Insn,
+                                           uint64_t Address,
+                                           const void *Decoder) {
+  return DecodeMemrsOperand(Inst, Insn, 1);
+}
+
+static DecodeStatus DecodeMemrsByteOperand(MCInst &Inst, unsigned Insn,
+                                           uint64_t Address,
+                                           const void *Decoder) {
+  return DecodeMemrsOperand(Inst, Insn, 0);
+}
+
+static DecodeStatus DecodeMemspOperand(MCInst &Inst, unsigned Insn,
+                                       uint64_t Address, const void *Decoder) {
+  Inst.addOperand(MCOperand::CreateReg(ARC::SP));
+  Inst.addOperand(MCOperand::CreateImm(Insn << 2));
+  return MCDisassembler::Success;
+}
+
+/// DecodeU7WImmOperand - The inverse of getU7WImmOpValue. Only the top five
+/// bits of the word aligned offset are encoded.
+static DecodeStatus DecodeU7WImmOperand(MCInst &Inst, unsigned Insn,
+                                        uint64_t Address, const void *Decoder) {
+  Inst.addOperand(MCOperand::CreateImm(Insn << 2));
+  return MCDisassembler::Success;
+}
+
+static DecodeStatus DecodeS12Operand(MCInst &Inst, unsigned Insn,
+                                     uint64_t Address, const void *Decoder) {
+  Inst.addOperand(MCOperand::CreateImm(SignExtend32<12>(Insn)));
+  return MCDisassembler::Success;
+}
+
+/// DecodeShortCCOperand - The inverse of getShortCCOpValue.
+static DecodeStatus DecodeShortCCOperand(MCInst &Inst, unsigned Insn,
+                                         uint64_t Address,
+                                         const void *Decoder) {
+  static const unsigned CCs[8] = {
+    ARCCC::COND_GT, ARCCC::COND_GE, ARCCC::COND_LT, ARCCC::COND_LE,
+    ARCCC::COND_HI, ARCCC::COND_HS, ARCCC::COND_LO, ARCCC::COND_LS
+  };
+  Inst.addOperand(MCOperand::CreateImm(CCs[Insn & 0x7]));
+  return MCDisassembler::Success;
+}
+
+/// DecodeBRccCondOperand - The inverse of getBRccCondOpValue.
+static DecodeStatus DecodeBRccCondOperand(MCInst &Inst, unsigned Insn,
+                                          uint64_t Address,
+                                          const void *Decoder) {
+  static const unsigned CCs[6] = {
+    ARCCC::COND_EQ, ARCCC::COND_NE, ARCCC::COND_LT, ARCCC::COND_GE,
+    ARCCC::COND_LO, ARCCC::COND_HS
+  };
+  if (Insn > 5)
+    return MCDisassembler::Fail;
+  Inst.addOperand(MCOperand::CreateImm(CCs[Insn]));
+  return MCDisassembler::Success;
+}
+
+/// DecodeBranchTarget - Sign extends the displacement of a branch or call,
+/// whose width depends on the instruction. The decoder tables put the bits of
+/// the split 32-bit displacements in place, so those are already in bytes, but
+/// the 16-bit branches encode theirs in a single field and need scaling.
+static DecodeStatus DecodeBranchTarget(MCInst &Inst, unsigned Insn,
+                                       uint64_t Address, const void *Decoder) {
+  int32_t Disp;
+  switch (Inst.getOpcode()) {
+    default: return MCDisassembler::Fail;
+    case ARC::B:
+    case ARC::B_D:
+    case ARC::BLi:
+    case ARC::BL_D:
+      Disp = SignExtend32<25>(Insn);
+      break;
+    case ARC::BCC:
+    case ARC::BCC_D:
+      Disp = SignExtend32<21>(Insn);
+      break;
+    case ARC::BL_S:
+      Disp = SignExtend32<13>(Insn << 2);
+      break;
+    case ARC::LP:
+      Disp = SignExtend32<13>(Insn);
+      break;
+    case ARC::B_S:
+    case ARC::BEQ_S:
+    case ARC::BNE_S:
+      Disp = SignExtend32<10>(Insn << 1);
+      break;
+    case ARC::BRCCrr:
+    case ARC::BRCCru6:
+    case ARC::BRCCrr_D:
+    case ARC::BRCCru6_D:
+    case ARC::BBIT0ru6:
+    case ARC::BBIT1ru6:
+    case ARC::BBIT0ru6_D:
+    case ARC::BBIT1ru6_D:
+      Disp = SignExtend32<9>(Insn);
+      break;
+    case ARC::BCC_S:
+      Disp = SignExtend32<7>(Insn << 1);
+      break;
+  }
+  Inst.addOperand(MCOperand::CreateImm(Disp));
+  return MCDisassembler::Success;
+}
+
+#include "ARCompactGenDisassemblerTables.inc"
+
+DecodeStatus
+ARCompactDisassembler::decodeConditional(MCInst &Instr, uint32_t Insn,
+                                         uint64_t Address,
+                                         unsigned &CC) const {
+  unsigned Major = Insn >> 27;
+  if ((Major != 0x04 && Major != 0x05) || ((Insn >> 22) & 0x3) != 0x3)
+    return MCDisassembler::Fail;
+
+  // The b field is split, with its low three bits in 26-24 and its high
+  // three bits in 14-12.
+  unsigned B = ((Insn >> 24) & 0x7) | (((Insn >> 12) & 0x7) << 3);
+  bool IsU6 = Insn & (1 << 5);
+  CC = Insn & 0x1F;
+
+  uint32_t Uncond = Insn & ~((0x3 << 22) | 0x3F);
+  Uncond |= (IsU6 ? 0x1 : 0x0) << 22;
+  Uncond |= B;
+
+  Instr.clear();
+  if (decodeInstruction32(Instr, Uncond, Address, this, STI) ==
+      MCDisassembler::Fail)
+    return MCDisassembler::Fail;
+
+  // Only the predicable forms have a conditional format.
+  if (MII->get(Instr.getOpcode()).findFirstPredOperandIdx() == -1)
+    return MCDisassembler::Fail;
+  return MCDisassembler::Success;
+}
+
+DecodeStatus ARCompactDisassembler::getInstruction(MCInst &Instr,
+                                                   uint64_t &Size,
+                                                   const MemoryObject &Region,
+                                                   uint64_t Address,
+                                                   raw_ostream &VStream,
+                                                   raw_ostream &CStream) const {
+  Size = 0;
+
+  uint16_t First;
+  if (!readHalfWord(Region, Address, First))
+    return MCDisassembler::Fail;
+
+  // The major opcode in the top five bits says how long the instruction is:
+  // 0x00-0x0B are 32 bits long, and the rest are 16 bits.
+  unsigned CC = ARCCC::COND_AL;
+  unsigned BaseSize;
+  if ((First >> 11) >= 0x0C) {
+    BaseSize = 2;
+    Size = 2;
+    if (decodeInstruction16(Instr, First, Address, this, STI) ==
+        MCDisassembler::Fail)
+      return MCDisassembler::Fail;
+  } else {
+    BaseSize = 4;
+    uint32_t Insn;
+    if (!readWord(Region, Address, Insn))
+      return MCDisassembler::Fail;
+    Size = 4;
+    if (decodeInstruction32(Instr, Insn, Address, this, STI) ==
+            MCDisassembler::Fail &&
+        decodeConditional(Instr, Insn, Address, CC) == MCDisassembler::Fail)
+      return MCDisassembler::Fail;
+  }
+
+  const MCInstrDesc &Desc = MII->get(Instr.getOpcode());
+
+  // Add the operands which have no bits in the instruction itself, in order
+  // of their position.
+  int PredOpNo = Desc.findFirstPredOperandIdx();
+  int LimmOpNo = -1;
+  uint32_t Limm = 0;
+  if (Desc.TSFlags & ARCII::HasLimm) {
+    if (!readWord(Region, Address + BaseSize, Limm))
+      return MCDisassembler::Fail;
+    LimmOpNo = (Desc.TSFlags & ARCII::LimmOpNoMask) >> ARCII::LimmOpNoShift;
+  }
+
+  for (int OpNo = 0, E = Desc.getNumOperands(); OpNo != E; ++OpNo) {
+    if (OpNo == PredOpNo) {
+      Instr.insert(Instr.begin() + OpNo, MCOperand::CreateImm(CC));
+      Instr.insert(Instr.begin() + OpNo + 1, MCOperand::CreateReg(0));
+    } else if (OpNo == LimmOpNo) {
+      // Operands are i32, so print a long immediate the way it was written.
+      Instr.insert(Instr.begin() + OpNo,
+                   MCOperand::CreateImm(static_cast<int32_t>(Limm)));
+    }
+  }
+
+  Size = Desc.getSize();
+  return MCDisassembler::Success;
+}
+
+static MCDisassembler *createARCompactDisassembler(const Target &T,
+                                                   const MCSubtargetInfo &STI) {
+  return new ARCompactDisassembler(STI);
+}
+
+extern "C" void LLVMInitializeARCompactDisassembler() {
+  // Register the disassembler.
+  TargetRegistry::RegisterMCDisassembler(TheARCompactTarget,
+                                         createARCompactDisassembler);
+}
@@ -14,6 +14,7 @@
 #define DEBUG_TYPE "asm-printer"
 #include "ARCompact.h"
 #include "ARCompactInstPrinter.h"
+#include "MCTargetDesc/ARCompactBaseInfo.h"
 
 #include "llvm/ADT/StringRef.h"
 #include "llvm/MC/MCInst.h"
@@ -40,7 +41,7 @@ void ARCompactInstPrinter::printOperand(const MCInst *MI, unsigned OpNo,
 
   const MCOperand &Op = MI->getOperand(OpNo);
   if (Op.isReg()) {
-    O << StringRef(getRegisterName(Op.getReg())).lower();
+    O << getRegisterName(Op.getReg());
   } else if (Op.isImm()) {
     O << Op.getImm();
   } else {
@@ -66,6 +67,52 @@ void ARCompactInstPrinter::printMemOperand(const MCInst *MI, unsigned OpNo,
   O << "]";
 }
 
+// Prints a memory address given by a single long immediate, which has no
+// second part.
+void ARCompactInstPrinter::printLimmMemOperand(const MCInst *MI,
+    unsigned OpNo, raw_ostream &O) {
+  O << "[";
+  printOperand(MI, OpNo, O);
+  O << "]";
+}
+
+// Prints a small data address, relative to GP, in the "[gp,@sym@sda+4]"
+// form the assembler expects.
+void ARCompactInstPrinter::printGPRelMemOperand(const MCInst *MI,
+    unsigned OpNo, raw_ostream &O) {
+  O << "[";
+  printOperand(MI, OpNo, O);
+  O << ",@";
+
+  const MCExpr *Expr = MI->getOperand(OpNo + 1).getExpr();
+  const MCBinaryExpr *BE = dyn_cast<MCBinaryExpr>(Expr);
+  if (BE && BE->getOpcode() == MCBinaryExpr::Add &&
+      isa<MCConstantExpr>(BE->getRHS())) {
+    O << *BE->getLHS() << "@sda";
+    int64_t Offset = cast<MCConstantExpr>(BE->getRHS())->getValue();
+    if (Offset >= 0) {
+      O << "+";
+    }
+    O << Offset;
+  } else {
+    O << *Expr << "@sda";
+  }
+  O << "]";
+}
+
+// Prints the auxiliary register which LR or SR accesses, by name if it has
+// one.
+void ARCompactInstPrinter::printAuxRegOperand(const MCInst *MI, unsigned OpNo,
+    raw_ostream &O) {
+  const MCOperand &Op = MI->getOperand(OpNo);
+  const char *Name = Op.isImm() ? getARCompactAuxRegisterName(Op.getImm()) : 0;
+  if (Name) {
+    O << Name;
+  } else {
+    printOperand(MI, OpNo, O);
+  }
+}
+
 // Prints a condition code, such as "eq".
 void ARCompactInstPrinter::printCCOperand(const MCInst *MI, unsigned OpNo,
     raw_ostream &O) {
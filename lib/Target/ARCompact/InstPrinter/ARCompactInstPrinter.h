@@ -35,6 +35,12 @@ namespace llvm {
         const char *Modifier = 0);
     void printMemOperand(const MCInst *MI, unsigned OpNo,
         raw_ostream &O);
+    void printLimmMemOperand(const MCInst *MI, unsigned OpNo,
+        raw_ostream &O);
+    void printGPRelMemOperand(const MCInst *MI, unsigned OpNo,
+        raw_ostream &O);
+    void printAuxRegOperand(const MCInst *MI, unsigned OpNo,
+        raw_ostream &O);
     void printCCOperand(const MCInst *MI, unsigned OpNo, raw_ostream &O);
     void printPredicateOperand(const MCInst *MI, unsigned OpNo,
         raw_ostream &O);
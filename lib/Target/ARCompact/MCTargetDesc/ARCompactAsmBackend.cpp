@@ -0,0 +1,246 @@
+//===------- ARCompactAsmBackend.cpp - ARCompact Assembler Backend --------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the ARCompactAsmBackend class, which applies fixups
+// and relaxes the 16-bit branches to their 32-bit forms.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ARCompact.h"
+#include "MCTargetDesc/ARCompactFixupKinds.h"
+#include "MCTargetDesc/ARCompactMCTargetDesc.h"
+#include "llvm/ADT/Triple.h"
+#include "llvm/MC/MCAsmBackend.h"
+#include "llvm/MC/MCAssembler.h"
+#include "llvm/MC/MCELFObjectWriter.h"
+#include "llvm/MC/MCFixupKindInfo.h"
+#include "llvm/MC/MCInst.h"
+#include "llvm/MC/MCObjectWriter.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace llvm;
+
+/// getRelaxedOpcode - Returns the 32-bit form of a 16-bit branch, or the
+/// opcode itself if it has no longer form.
+static unsigned getRelaxedOpcode(unsigned Opcode) {
+  switch (Opcode) {
+    default: return Opcode;
+    case ARC::B_S:   return ARC::B;
+    case ARC::BEQ_S: return ARC::BCC;
+    case ARC::BNE_S: return ARC::BCC;
+    case ARC::BCC_S: return ARC::BCC;
+    case ARC::BL_S:  return ARC::BLi;
+  }
+}
+
+/// isHalfWordFixup - Returns true if the fixup patches a 16-bit instruction.
+static bool isHalfWordFixup(unsigned Kind) {
+  switch (Kind) {
+    default: return false;
+    case ARC::fixup_arc_s10h_pcrel:
+    case ARC::fixup_arc_s7h_pcrel:
+    case ARC::fixup_arc_s13w_pcrel:
+      return true;
+  }
+}
+
+/// adjustFixupValue - Scatters the value of a fixup into the bits of the
+/// instruction that it belongs in. For the 32-bit fixups, the result is
+/// the instruction word as it appears in the manual, i.e. before it has been
+/// split into half-words.
+static uint32_t adjustFixupValue(unsigned Kind, uint64_t Value) {
+  int64_t SValue = (int64_t)Value;
+
+  switch (Kind) {
+    default:
+      llvm_unreachable("Unknown fixup kind!");
+    case FK_Data_1:
+    case FK_Data_2:
+    case FK_Data_4:
+    case ARC::fixup_arc_limm:
+      return Value;
+    case ARC::fixup_arc_s21h_pcrel:
+      if (!isInt<21>(SValue) || (SValue & 0x1))
+        report_fatal_error("Bcc branch target out of range!");
+      return ((Value >> 1) & 0x3FF) << 17 | ((Value >> 11) & 0x3FF) << 6;
+    case ARC::fixup_arc_s25h_pcrel:
+      if (!isInt<25>(SValue) || (SValue & 0x1))
+        report_fatal_error("B branch target out of range!");
+      return ((Value >> 1) & 0x3FF) << 17 | ((Value >> 11) & 0x3FF) << 6 |
+          ((Value >> 21) & 0xF);
+    case ARC::fixup_arc_s21w_pcrel:
+      if (!isInt<21>(SValue) || (SValue & 0x3))
+        report_fatal_error("BLcc call target out of range!");
+      return ((Value >> 2) & 0x1FF) << 18 | ((Value >> 11) & 0x3FF) << 6;
+    case ARC::fixup_arc_s25w_pcrel:
+      if (!isInt<25>(SValue) || (SValue & 0x3))
+        report_fatal_error("BL call target out of range!");
+      return ((Value >> 2) & 0x1FF) << 18 | ((Value >> 11) & 0x3FF) << 6 |
+          ((Value >> 21) & 0xF);
+    case ARC::fixup_arc_s10h_pcrel:
+      if (!isInt<10>(SValue) || (SValue & 0x1))
+        report_fatal_error("B_S branch target out of range!");
+      return (Value >> 1) & 0x1FF;
+    case ARC::fixup_arc_s7h_pcrel:
+      if (!isInt<7>(SValue) || (SValue & 0x1))
+        report_fatal_error("Bcc_S branch target out of range!");
+      return (Value >> 1) & 0x3F;
+    case ARC::fixup_arc_s13w_pcrel:
+      if (!isInt<13>(SValue) || (SValue & 0x3))
+        report_fatal_error("BL_S call target out of range!");
+      return (Value >> 2) & 0x7FF;
+    case ARC::fixup_arc_s13h_pcrel:
+      if (!isInt<13>(SValue) || (SValue & 0x1))
+        report_fatal_error("LP loop end out of range!");
+      return ((Value >> 1) & 0x3F) << 6 | ((Value >> 7) & 0x3F);
+    case ARC::fixup_arc_s9h_pcrel:
+      if (!isInt<9>(SValue) || (SValue & 0x1))
+        report_fatal_error("BRcc branch target out of range!");
+      return ((Value >> 1) & 0x7F) << 17 | ((Value >> 8) & 0x1) << 15;
+    case ARC::fixup_arc_sda_ldst:
+    case ARC::fixup_arc_sda_ldst1:
+    case ARC::fixup_arc_sda_ldst2: {
+      // These are relative to _SDA_BASE_, so the linker always resolves
+      // them, and only the addend can turn up here.
+      unsigned Shift = Kind - ARC::fixup_arc_sda_ldst;
+      if (!isInt<9>(SValue >> Shift) || (SValue & ((1 << Shift) - 1)))
+        report_fatal_error("Small data offset out of range!");
+      Value >>= Shift;
+      return (Value & 0xFF) << 16 | ((Value >> 8) & 0x1) << 15;
+    }
+  }
+}
+
+namespace {
+class ARCompactAsmBackend : public MCAsmBackend {
+  uint8_t OSABI;
+
+public:
+  ARCompactAsmBackend(const Target &T, uint8_t _OSABI)
+    : MCAsmBackend(), OSABI(_OSABI) {}
+
+  MCObjectWriter *createObjectWriter(raw_ostream &OS) const {
+    return createARCompactELFObjectWriter(OS, OSABI);
+  }
+
+  unsigned getNumFixupKinds() const { return ARC::NumTargetFixupKinds; }
+
+  const MCFixupKindInfo &getFixupKindInfo(MCFixupKind Kind) const {
+    const static unsigned PCRel = MCFixupKindInfo::FKF_IsPCRel |
+                                  MCFixupKindInfo::FKF_IsAlignedDownTo32Bits;
+    const static MCFixupKindInfo Infos[ARC::NumTargetFixupKinds] = {
+      // This table *must* be in the same order as the fixup_* kinds in
+      // ARCompactFixupKinds.h.
+      //
+      // name                    offset  bits  flags
+      { "fixup_arc_limm",          0,     32,   0 },
+      { "fixup_arc_s21h_pcrel",    0,     32,   PCRel },
+      { "fixup_arc_s25h_pcrel",    0,     32,   PCRel },
+      { "fixup_arc_s21w_pcrel",    0,     32,   PCRel },
+      { "fixup_arc_s25w_pcrel",    0,     32,   PCRel },
+      { "fixup_arc_s10h_pcrel",    0,     16,   PCRel },
+      { "fixup_arc_s7h_pcrel",     0,     16,   PCRel },
+      { "fixup_arc_s13w_pcrel",    0,     16,   PCRel },
+      { "fixup_arc_s13h_pcrel",    0,     32,   PCRel },
+      { "fixup_arc_s9h_pcrel",     0,     32,   PCRel },
+      { "fixup_arc_sda_ldst",      0,     32,   0 },
+      { "fixup_arc_sda_ldst1",     0,     32,   0 },
+      { "fixup_arc_sda_ldst2",     0,     32,   0 }
+    };
+
+    if (Kind < FirstTargetFixupKind)
+      return MCAsmBackend::getFixupKindInfo(Kind);
+
+    assert(unsigned(Kind - FirstTargetFixupKind) < getNumFixupKinds() &&
+           "Invalid kind!");
+    return Infos[Kind - FirstTargetFixupKind];
+  }
+
+  /// applyFixup - Apply the Value for given Fixup into the provided data
+  /// fragment, at the offset specified by the fixup. Data is stored little
+  /// endian, but instruction words (and long immediates) are stored as two
+  /// little endian half-words, with the most significant half-word first.
+  void applyFixup(const MCFixup &Fixup, char *Data, unsigned DataSize,
+                  uint64_t Value) const {
+    unsigned Kind = Fixup.getKind();
+    Value = adjustFixupValue(Kind, Value);
+    if (!Value)
+      return; // Doesn't change encoding.
+
+    unsigned Offset = Fixup.getOffset();
+    unsigned NumBytes = (getFixupKindInfo(Fixup.getKind()).TargetSize + 7) / 8;
+    assert(Offset + NumBytes <= DataSize && "Invalid fixup offset!");
+
+    if (Kind < FirstTargetFixupKind || isHalfWordFixup(Kind)) {
+      // Data and 16-bit instructions are plain little endian.
+      for (unsigned i = 0; i != NumBytes; ++i)
+        Data[Offset + i] |= uint8_t((Value >> (i * 8)) & 0xff);
+      return;
+    }
+
+    Data[Offset + 0] |= uint8_t((Value >> 16) & 0xff);
+    Data[Offset + 1] |= uint8_t((Value >> 24) & 0xff);
+    Data[Offset + 2] |= uint8_t(Value & 0xff);
+    Data[Offset + 3] |= uint8_t((Value >> 8) & 0xff);
+  }
+
+  bool mayNeedRelaxation(const MCInst &Inst) const {
+    return getRelaxedOpcode(Inst.getOpcode()) != Inst.getOpcode();
+  }
+
+  bool fixupNeedsRelaxation(const MCFixup &Fixup, uint64_t Value,
+                            const MCInstFragment *DF,
+                            const MCAsmLayout &Layout) const {
+    int64_t SValue = (int64_t)Value;
+    switch ((unsigned)Fixup.getKind()) {
+      default:
+        llvm_unreachable("Unexpected fixup on a relaxable instruction!");
+      case ARC::fixup_arc_s10h_pcrel: return !isInt<10>(SValue);
+      case ARC::fixup_arc_s7h_pcrel:  return !isInt<7>(SValue);
+      case ARC::fixup_arc_s13w_pcrel: return !isInt<13>(SValue);
+    }
+  }
+
+  void relaxInstruction(const MCInst &Inst, MCInst &Res) const {
+    Res = Inst;
+    Res.setOpcode(getRelaxedOpcode(Inst.getOpcode()));
+
+    // The 32-bit conditional branch takes the full condition code, so add it
+    // (or rewrite the 16-bit one) to match.
+    switch (Inst.getOpcode()) {
+      default: break;
+      case ARC::BEQ_S:
+        Res.addOperand(MCOperand::CreateImm(ARCCC::COND_EQ));
+        break;
+      case ARC::BNE_S:
+        Res.addOperand(MCOperand::CreateImm(ARCCC::COND_NE));
+        break;
+    }
+  }
+
+  /// writeNopData - Pads with nop_s instructions. Instructions are always
+  /// half-word aligned, so an odd count cannot be filled.
+  bool writeNopData(uint64_t Count, MCObjectWriter *OW) const {
+    if (Count % 2)
+      return false;
+
+    for (uint64_t i = 0; i != Count / 2; ++i)
+      OW->Write16(0x78E0);
+    return true;
+  }
+}; // class ARCompactAsmBackend
+} // end anonymous namespace
+
+MCAsmBackend *llvm::createARCompactAsmBackend(const Target &T, StringRef TT) {
+  uint8_t OSABI = MCELFObjectTargetWriter::getOSABI(Triple(TT).getOS());
+  return new ARCompactAsmBackend(T, OSABI);
+}
@@ -0,0 +1,128 @@
+//===-------- ARCompactBaseInfo.h - Top level definitions for ARCompact ---===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains small standalone helper functions and enum definitions
+// for the ARCompact target useful for the compiler back-end and the MC
+// libraries.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef ARCOMPACTBASEINFO_H
+#define ARCOMPACTBASEINFO_H
+
+#include "ARCompactMCTargetDesc.h"
+#include "llvm/Support/ErrorHandling.h"
+
+namespace llvm {
+
+/// ARCII - This namespace holds all of the target specific flags that
+/// instruction info tracks. These must be kept in sync with the TSFlags
+/// definitions in ARCompactInstrFormats.td.
+namespace ARCII {
+  enum {
+    /// HasLimm - The instruction is followed by a 32-bit long immediate.
+    HasLimm = 1 << 0,
+
+    /// LimmOpNo - The index of the operand which holds the long immediate.
+    LimmOpNoShift = 1,
+    LimmOpNoMask = 0x7 << LimmOpNoShift
+  };
+} // end namespace ARCII
+
+/// ARCAux - The numbers of the auxiliary registers which LR and SR access.
+namespace ARCAux {
+  enum AuxRegs {
+    LP_START = 0x02,
+    LP_END   = 0x03,
+
+    /// MULHI - Writing this sets MHI, so that the multiply result registers
+    /// can be restored after an interrupt.
+    MULHI    = 0x12
+  };
+} // end namespace ARCAux
+
+/// getARCompactAuxRegisterName - Returns the name of an auxiliary register,
+/// or null if it has none.
+inline static const char *getARCompactAuxRegisterName(unsigned Num) {
+  switch (Num) {
+    case ARCAux::LP_START: return "lp_start";
+    case ARCAux::LP_END:   return "lp_end";
+    case ARCAux::MULHI:    return "mulhi";
+    default:               return 0;
+  }
+}
+
+/// getARCompactRegisterNumbering - Given the enum value for some register,
+/// return the number that it corresponds to in a 32-bit instruction.
+inline static unsigned getARCompactRegisterNumbering(unsigned RegEnum) {
+  switch (RegEnum) {
+    case ARC::R0: return 0;
+    case ARC::R1: return 1;
+    case ARC::R2: return 2;
+    case ARC::R3: return 3;
+    case ARC::R4: return 4;
+    case ARC::R5: return 5;
+    case ARC::R6: return 6;
+    case ARC::R7: return 7;
+    case ARC::T0: return 8;
+    case ARC::T1: return 9;
+    case ARC::T2: return 10;
+    case ARC::T3: return 11;
+    case ARC::T4: return 12;
+    case ARC::T5: return 13;
+    case ARC::T6: return 14;
+    case ARC::T7: return 15;
+    case ARC::S0: return 16;
+    case ARC::S1: return 17;
+    case ARC::S2: return 18;
+    case ARC::S3: return 19;
+    case ARC::S4: return 20;
+    case ARC::S5: return 21;
+    case ARC::S6: return 22;
+    case ARC::S7: return 23;
+    case ARC::S8: return 24;
+    case ARC::S9: return 25;
+    case ARC::GP: return 26;
+    case ARC::FP: return 27;
+    case ARC::SP: return 28;
+    case ARC::ILINK1: return 29;
+    case ARC::ILINK2: return 30;
+    case ARC::BLINK: return 31;
+    case ARC::MLO: return 57;
+    case ARC::MMID: return 58;
+    case ARC::MHI: return 59;
+    case ARC::LP_COUNT: return 60;
+    default: llvm_unreachable("Unknown register number!");
+  }
+}
+
+/// isARCompactShortRegister - Returns true if the register can be encoded in
+/// the 3-bit register fields of the 16-bit instructions (r0-r3, r12-r15).
+inline static bool isARCompactShortRegister(unsigned RegEnum) {
+  switch (RegEnum) {
+    case ARC::R0: case ARC::R1: case ARC::R2: case ARC::R3:
+    case ARC::T4: case ARC::T5: case ARC::T6: case ARC::T7:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/// getARCompactShortRegisterNumbering - Given the enum value for some
+/// register, return the number that it corresponds to in a 16-bit
+/// instruction.
+inline static unsigned getARCompactShortRegisterNumbering(unsigned RegEnum) {
+  assert(isARCompactShortRegister(RegEnum) &&
+         "Register not encodable in a 16-bit instruction!");
+  return getARCompactRegisterNumbering(RegEnum) & 0x7;
+}
+
+} // end namespace llvm
+
+#endif
@@ -0,0 +1,79 @@
+//===------ ARCompactELFObjectWriter.cpp - ARCompact ELF Writer -----------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the ARCompactELFObjectWriter class, which maps fixups
+// onto ARCompact ELF relocations.
+//
+//===----------------------------------------------------------------------===//
+
+#include "MCTargetDesc/ARCompactFixupKinds.h"
+#include "MCTargetDesc/ARCompactMCTargetDesc.h"
+#include "llvm/MC/MCELFObjectWriter.h"
+#include "llvm/MC/MCExpr.h"
+#include "llvm/MC/MCValue.h"
+#include "llvm/Support/ErrorHandling.h"
+
+using namespace llvm;
+
+namespace {
+  class ARCompactELFObjectWriter : public MCELFObjectTargetWriter {
+  public:
+    ARCompactELFObjectWriter(uint8_t OSABI);
+
+    virtual ~ARCompactELFObjectWriter();
+
+    virtual unsigned GetRelocType(const MCValue &Target, const MCFixup &Fixup,
+                                  bool IsPCRel, bool IsRelocWithSymbol,
+                                  int64_t Addend) const;
+  };
+}
+
+ARCompactELFObjectWriter::ARCompactELFObjectWriter(uint8_t OSABI)
+  : MCELFObjectTargetWriter(/*Is64Bit*/ false, OSABI, ELF::EM_ARC_COMPACT,
+                            /*HasRelocationAddend*/ true) {}
+
+ARCompactELFObjectWriter::~ARCompactELFObjectWriter() {}
+
+unsigned ARCompactELFObjectWriter::GetRelocType(const MCValue &Target,
+    const MCFixup &Fixup, bool IsPCRel, bool IsRelocWithSymbol,
+    int64_t Addend) const {
+  switch ((unsigned)Fixup.getKind()) {
+    case FK_Data_1:                 return ELF::R_ARC_8;
+    case FK_Data_2:                 return ELF::R_ARC_16;
+    case FK_Data_4:
+      return IsPCRel ? ELF::R_ARC_PC32 : ELF::R_ARC_32;
+    case FK_PCRel_4:                return ELF::R_ARC_PC32;
+    case ARC::fixup_arc_limm:       return ELF::R_ARC_32_ME;
+    case ARC::fixup_arc_s21h_pcrel: return ELF::R_ARC_S21H_PCREL;
+    case ARC::fixup_arc_s25h_pcrel: return ELF::R_ARC_S25H_PCREL;
+    case ARC::fixup_arc_s21w_pcrel: return ELF::R_ARC_S21W_PCREL;
+    case ARC::fixup_arc_s25w_pcrel: return ELF::R_ARC_S25W_PCREL;
+    case ARC::fixup_arc_s13w_pcrel: return ELF::R_ARC_S13_PCREL;
+    case ARC::fixup_arc_sda_ldst:   return ELF::R_ARC_SDA_LDST;
+    case ARC::fixup_arc_sda_ldst1:  return ELF::R_ARC_SDA_LDST1;
+    case ARC::fixup_arc_sda_ldst2:  return ELF::R_ARC_SDA_LDST2;
+    case ARC::fixup_arc_s10h_pcrel:
+    case ARC::fixup_arc_s7h_pcrel:
+      // There are no relocations for these; the short branches are always
+      // relaxed when the target cannot be resolved.
+      report_fatal_error("Unrelaxed short branch needs a relocation!");
+    case ARC::fixup_arc_s13h_pcrel:
+      report_fatal_error("LP loop end outside of the section!");
+    case ARC::fixup_arc_s9h_pcrel:
+      report_fatal_error("BRcc target outside of the section!");
+    default:
+      report_fatal_error("Unsupported ARCompact relocation!");
+  }
+}
+
+MCObjectWriter *llvm::createARCompactELFObjectWriter(raw_ostream &OS,
+                                                     uint8_t OSABI) {
+  MCELFObjectTargetWriter *MOTW = new ARCompactELFObjectWriter(OSABI);
+  return createELFObjectWriter(MOTW, OS, /*IsLittleEndian*/ true);
+}
@@ -0,0 +1,75 @@
+//===----- ARCompactFixupKinds.h - ARCompact Specific Fixup Entries -------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef ARCOMPACTFIXUPKINDS_H
+#define ARCOMPACTFIXUPKINDS_H
+
+#include "llvm/MC/MCFixup.h"
+
+namespace llvm {
+namespace ARC {
+  // This table *must* be in the same order as the MCFixupKindInfo Infos
+  // array in ARCompactAsmBackend.cpp.
+  //
+  // All of the branch displacements are relative to the 32-bit aligned
+  // address of the branch instruction (PCL).
+  enum Fixups {
+    // A 32-bit long immediate following an instruction, stored middle-endian.
+    // Results in R_ARC_32_ME.
+    fixup_arc_limm = FirstTargetFixupKind,
+
+    // 21-bit half-word aligned displacement of Bcc. Results in
+    // R_ARC_S21H_PCREL.
+    fixup_arc_s21h_pcrel,
+
+    // 25-bit half-word aligned displacement of B. Results in
+    // R_ARC_S25H_PCREL.
+    fixup_arc_s25h_pcrel,
+
+    // 21-bit word aligned displacement of BLcc. Results in R_ARC_S21W_PCREL.
+    fixup_arc_s21w_pcrel,
+
+    // 25-bit word aligned displacement of BL. Results in R_ARC_S25W_PCREL.
+    fixup_arc_s25w_pcrel,
+
+    // 10-bit half-word aligned displacement of B_S, BEQ_S and BNE_S. These
+    // are always relaxed if the target is not resolved.
+    fixup_arc_s10h_pcrel,
+
+    // 7-bit half-word aligned displacement of Bcc_S. These are always
+    // relaxed if the target is not resolved.
+    fixup_arc_s7h_pcrel,
+
+    // 13-bit word aligned displacement of BL_S. Results in R_ARC_S13_PCREL.
+    fixup_arc_s13w_pcrel,
+
+    // 13-bit half-word aligned displacement of LP, to the end of the loop.
+    // The loop end is always in the same function, so this never results
+    // in a relocation.
+    fixup_arc_s13h_pcrel,
+
+    // 9-bit half-word aligned displacement of BRcc, BBIT0 and BBIT1. These
+    // only ever branch within the function, so there is no relocation.
+    fixup_arc_s9h_pcrel,
+
+    // 9-bit signed offset of a GP-relative LD or ST from _SDA_BASE_, in
+    // bytes, half-words or words (for the .as forms). Result in
+    // R_ARC_SDA_LDST, R_ARC_SDA_LDST1 and R_ARC_SDA_LDST2.
+    fixup_arc_sda_ldst,
+    fixup_arc_sda_ldst1,
+    fixup_arc_sda_ldst2,
+
+    // Marker
+    LastTargetFixupKind,
+    NumTargetFixupKinds = LastTargetFixupKind - FirstTargetFixupKind
+  };
+} // end namespace ARC
+} // end namespace llvm
+
+#endif
@@ -26,6 +26,9 @@ ARCompactMCAsmInfo::ARCompactMCAsmInfo(const Target &T, StringRef TT) {
 
   CommentString = ";";
   SupportsDebugInformation = true;
+
+  // The longest instructions are followed by a 32-bit long immediate.
+  MaxInstLength = 8;
 }
 
 void ARCompactMCAsmInfo::anchor() { }
\ No newline at end of file
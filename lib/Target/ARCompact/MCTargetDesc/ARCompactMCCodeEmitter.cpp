@@ -0,0 +1,441 @@
+//===---- ARCompactMCCodeEmitter.cpp - ARCompact Machine Code Emitter -----===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the ARCompactMCCodeEmitter class.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "mccodeemitter"
+#include "ARCompact.h"
+#include "MCTargetDesc/ARCompactBaseInfo.h"
+#include "MCTargetDesc/ARCompactFixupKinds.h"
+#include "MCTargetDesc/ARCompactMCTargetDesc.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/MC/MCCodeEmitter.h"
+#include "llvm/MC/MCExpr.h"
+#include "llvm/MC/MCInst.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace llvm;
+
+STATISTIC(MCNumEmitted, "Number of MC instructions emitted");
+STATISTIC(MCNumLimms, "Number of long immediates emitted");
+
+namespace {
+class ARCompactMCCodeEmitter : public MCCodeEmitter {
+  ARCompactMCCodeEmitter(const ARCompactMCCodeEmitter &); // DO NOT IMPLEMENT
+  void operator=(const ARCompactMCCodeEmitter &); // DO NOT IMPLEMENT
+  const MCInstrInfo &MCII;
+  const MCSubtargetInfo &STI;
+  MCContext &Ctx;
+
+public:
+  ARCompactMCCodeEmitter(const MCInstrInfo &mcii, const MCSubtargetInfo &sti,
+                         MCContext &ctx)
+    : MCII(mcii), STI(sti), Ctx(ctx) {}
+
+  ~ARCompactMCCodeEmitter() {}
+
+  void EmitByte(unsigned char C, raw_ostream &OS) const {
+    OS << (char)C;
+  }
+
+  /// EmitHalfWord - 16-bit instructions are stored little endian.
+  void EmitHalfWord(unsigned Val, raw_ostream &OS) const {
+    EmitByte(Val & 0xff, OS);
+    EmitByte((Val >> 8) & 0xff, OS);
+  }
+
+  /// EmitWord - 32-bit instructions and long immediates are stored as two
+  /// little endian half-words, with the most significant half-word first.
+  void EmitWord(unsigned Val, raw_ostream &OS) const {
+    EmitHalfWord((Val >> 16) & 0xffff, OS);
+    EmitHalfWord(Val & 0xffff, OS);
+  }
+
+  void EncodeInstruction(const MCInst &MI, raw_ostream &OS,
+                         SmallVectorImpl<MCFixup> &Fixups) const;
+
+  // getBinaryCodeForInstr - TableGen'erated function for getting the
+  // binary encoding for an instruction.
+  uint64_t getBinaryCodeForInstr(const MCInst &MI,
+                                 SmallVectorImpl<MCFixup> &Fixups) const;
+
+  // getMachineOpValue - Return binary encoding of operand. If the machine
+  // operand requires relocation, record the relocation and return zero.
+  unsigned getMachineOpValue(const MCInst &MI, const MCOperand &MO,
+                             SmallVectorImpl<MCFixup> &Fixups) const;
+
+  // getUImmOpValue - Returns an unsigned immediate of the given width.
+  template<unsigned Bits>
+  unsigned getUImmOpValue(const MCInst &MI, unsigned OpNo,
+                          SmallVectorImpl<MCFixup> &Fixups) const {
+    int64_t Imm = getImmOperand(MI, OpNo);
+    if (!isUInt<Bits>(Imm))
+      reportImmOutOfRange(MI, Imm);
+    return Imm;
+  }
+
+  // getU7WImmOpValue - Returns a word aligned u7, which is encoded in the
+  // top five bits of its field.
+  unsigned getU7WImmOpValue(const MCInst &MI, unsigned OpNo,
+                            SmallVectorImpl<MCFixup> &Fixups) const {
+    int64_t Imm = getImmOperand(MI, OpNo);
+    if (!isUInt<7>(Imm) || (Imm & 0x3))
+      reportImmOutOfRange(MI, Imm);
+    return Imm;
+  }
+
+  // getS12ImmOpValue - Returns a signed 12-bit immediate.
+  unsigned getS12ImmOpValue(const MCInst &MI, unsigned OpNo,
+                            SmallVectorImpl<MCFixup> &Fixups) const {
+    int64_t Imm = getImmOperand(MI, OpNo);
+    if (!isInt<12>(Imm))
+      reportImmOutOfRange(MI, Imm);
+    return Imm & 0xFFF;
+  }
+
+  // getMemriOpValue - Returns the register in bits 5-0 and the signed 9-bit
+  // offset in bits 14-6.
+  unsigned getMemriOpValue(const MCInst &MI, unsigned OpNo,
+                           SmallVectorImpl<MCFixup> &Fixups) const;
+
+  // getMemspOpValue - Returns the word aligned u7 offset of a 16-bit SP
+  // relative access in the same bits as getMemriOpValue.
+  unsigned getMemspOpValue(const MCInst &MI, unsigned OpNo,
+                           SmallVectorImpl<MCFixup> &Fixups) const;
+
+  // getMemgp*OpValue - Returns GP in bits 5-0 and records a fixup for the
+  // offset of the small data symbol, scaled by the size of the access for
+  // the .as forms.
+  unsigned getMemgpWordOpValue(const MCInst &MI, unsigned OpNo,
+                               SmallVectorImpl<MCFixup> &Fixups) const {
+    return getMemgpOpValue(MI, OpNo, ARC::fixup_arc_sda_ldst2, Fixups);
+  }
+  unsigned getMemgpHalfOpValue(const MCInst &MI, unsigned OpNo,
+                               SmallVectorImpl<MCFixup> &Fixups) const {
+    return getMemgpOpValue(MI, OpNo, ARC::fixup_arc_sda_ldst1, Fixups);
+  }
+  unsigned getMemgpByteOpValue(const MCInst &MI, unsigned OpNo,
+                               SmallVectorImpl<MCFixup> &Fixups) const {
+    return getMemgpOpValue(MI, OpNo, ARC::fixup_arc_sda_ldst, Fixups);
+  }
+
+  // getMemrrOpValue - Returns the base register in bits 5-0 and the index
+  // register in bits 11-6.
+  unsigned getMemrrOpValue(const MCInst &MI, unsigned OpNo,
+                           SmallVectorImpl<MCFixup> &Fixups) const;
+
+  // getMemlirOpValue - Returns the register of a limm + register address;
+  // the limm itself is emitted after the instruction.
+  unsigned getMemlirOpValue(const MCInst &MI, unsigned OpNo,
+                            SmallVectorImpl<MCFixup> &Fixups) const;
+
+  // getMemrs*OpValue - Returns the short base register in bits 2-0 and the
+  // unsigned offset, scaled by the size of the access, in bits 7-3.
+  unsigned getMemrsWordOpValue(const MCInst &MI, unsigned OpNo,
+                               SmallVectorImpl<MCFixup> &Fixups) const {
+    return getMemrsOpValue(MI, OpNo, 2, Fixups);
+  }
+  unsigned getMemrsHalfOpValue(const MCInst &MI, unsigned OpNo,
+                               SmallVectorImpl<MCFixup> &Fixups) const {
+    return getMemrsOpValue(MI, OpNo, 1, Fixups);
+  }
+  unsigned getMemrsByteOpValue(const MCInst &MI, unsigned OpNo,
+                               SmallVectorImpl<MCFixup> &Fixups) const {
+    return getMemrsOpValue(MI, OpNo, 0, Fixups);
+  }
+
+  // getShortCCOpValue - Returns the 3-bit condition code field of Bcc_S.
+  unsigned getShortCCOpValue(const MCInst &MI, unsigned OpNo,
+                             SmallVectorImpl<MCFixup> &Fixups) const;
+
+  // getBRccCondOpValue - Returns the 4-bit condition field of BRcc.
+  unsigned getBRccCondOpValue(const MCInst &MI, unsigned OpNo,
+                              SmallVectorImpl<MCFixup> &Fixups) const;
+
+  // getBranchTargetOpValue - Return binary encoding of the branch target
+  // operand. If the target is a label, record the fixup and return zero.
+  unsigned getBranchTargetOpValue(const MCInst &MI, unsigned OpNo,
+                                  SmallVectorImpl<MCFixup> &Fixups) const;
+
+  // getCallTargetOpValue - Return binary encoding of the call target
+  // operand. If the target is a symbol, record the fixup and return zero.
+  unsigned getCallTargetOpValue(const MCInst &MI, unsigned OpNo,
+                                SmallVectorImpl<MCFixup> &Fixups) const;
+
+  // encodePredicate - Rewrites a general operation with a condition code
+  // other than AL into the conditional (P = 11) format.
+  unsigned encodePredicate(const MCInst &MI, unsigned Value) const;
+
+private:
+  int64_t getImmOperand(const MCInst &MI, unsigned OpNo) const;
+
+  void reportImmOutOfRange(const MCInst &MI, int64_t Imm) const;
+
+  unsigned getMemrsOpValue(const MCInst &MI, unsigned OpNo, unsigned Shift,
+                           SmallVectorImpl<MCFixup> &Fixups) const;
+
+  unsigned getPCRelOpValue(const MCInst &MI, unsigned OpNo,
+                           ARC::Fixups Kind,
+                           SmallVectorImpl<MCFixup> &Fixups) const;
+
+  unsigned getMemgpOpValue(const MCInst &MI, unsigned OpNo, ARC::Fixups Kind,
+                           SmallVectorImpl<MCFixup> &Fixups) const;
+}; // class ARCompactMCCodeEmitter
+} // end anonymous namespace
+
+MCCodeEmitter *llvm::createARCompactMCCodeEmitter(const MCInstrInfo &MCII,
+                                                  const MCSubtargetInfo &STI,
+                                                  MCContext &Ctx) {
+  return new ARCompactMCCodeEmitter(MCII, STI, Ctx);
+}
+
+/// EncodeInstruction - Emit the instruction, followed by its long immediate
+/// if it has one.
+void ARCompactMCCodeEmitter::EncodeInstruction(const MCInst &MI,
+    raw_ostream &OS, SmallVectorImpl<MCFixup> &Fixups) const {
+  const MCInstrDesc &Desc = MCII.get(MI.getOpcode());
+  uint64_t TSFlags = Desc.TSFlags;
+  unsigned Size = Desc.getSize();
+
+  // Pseudo instructions don't get encoded and shouldn't be here
+  // in the first place!
+  if (Size == 0)
+    llvm_unreachable("Pseudo opcode found in EncodeInstruction()");
+
+  uint32_t Binary = getBinaryCodeForInstr(MI, Fixups);
+
+  bool HasLimm = TSFlags & ARCII::HasLimm;
+  unsigned BaseSize = HasLimm ? Size - 4 : Size;
+
+  if (BaseSize == 2) {
+    EmitHalfWord(Binary, OS);
+  } else {
+    assert(BaseSize == 4 && "Unexpected instruction size!");
+    EmitWord(Binary, OS);
+  }
+
+  if (HasLimm) {
+    unsigned OpNo = (TSFlags & ARCII::LimmOpNoMask) >> ARCII::LimmOpNoShift;
+    const MCOperand &MO = MI.getOperand(OpNo);
+
+    if (MO.isImm()) {
+      EmitWord(MO.getImm(), OS);
+    } else {
+      assert(MO.isExpr() && "Unexpected long immediate operand!");
+      Fixups.push_back(MCFixup::Create(BaseSize, MO.getExpr(),
+          MCFixupKind(ARC::fixup_arc_limm)));
+      EmitWord(0, OS);
+    }
+
+    ++MCNumLimms;
+  }
+
+  ++MCNumEmitted;
+}
+
+/// getMachineOpValue - Return binary encoding of operand. If the machine
+/// operand requires relocation, record the relocation and return zero.
+unsigned ARCompactMCCodeEmitter::getMachineOpValue(const MCInst &MI,
+    const MCOperand &MO, SmallVectorImpl<MCFixup> &Fixups) const {
+  if (MO.isReg())
+    return getARCompactRegisterNumbering(MO.getReg());
+  if (MO.isImm())
+    return static_cast<unsigned>(MO.getImm());
+
+  // Symbolic operands are only valid in the long immediate and branch target
+  // positions, both of which are handled separately.
+  llvm_unreachable("Unable to encode MCOperand!");
+}
+
+/// getImmOperand - Returns the value of an immediate operand which has no
+/// long immediate form; symbols cannot be encoded in these fields.
+int64_t ARCompactMCCodeEmitter::getImmOperand(const MCInst &MI,
+                                              unsigned OpNo) const {
+  const MCOperand &MO = MI.getOperand(OpNo);
+  if (!MO.isImm())
+    report_fatal_error(Twine("Symbolic operand in a short immediate field of ")
+                       + MCII.getName(MI.getOpcode()) + "!");
+  return MO.getImm();
+}
+
+/// reportImmOutOfRange - Immediates are range checked when they are selected
+/// or parsed, so one that does not fit its field here would otherwise be
+/// silently truncated into different code.
+void ARCompactMCCodeEmitter::reportImmOutOfRange(const MCInst &MI,
+                                                 int64_t Imm) const {
+  report_fatal_error("Immediate " + Twine(Imm) + " does not fit in " +
+                     MCII.getName(MI.getOpcode()) + "!");
+}
+
+unsigned ARCompactMCCodeEmitter::getMemriOpValue(const MCInst &MI,
+    unsigned OpNo, SmallVectorImpl<MCFixup> &Fixups) const {
+  unsigned Reg = getMachineOpValue(MI, MI.getOperand(OpNo), Fixups);
+  int64_t Offset = getImmOperand(MI, OpNo + 1);
+  if (!isInt<9>(Offset))
+    reportImmOutOfRange(MI, Offset);
+
+  return ((Offset & 0x1FF) << 6) | (Reg & 0x3F);
+}
+
+unsigned ARCompactMCCodeEmitter::getMemspOpValue(const MCInst &MI,
+    unsigned OpNo, SmallVectorImpl<MCFixup> &Fixups) const {
+  unsigned Reg = getMachineOpValue(MI, MI.getOperand(OpNo), Fixups);
+  int64_t Offset = getImmOperand(MI, OpNo + 1);
+  if (!isUInt<7>(Offset) || (Offset & 0x3))
+    reportImmOutOfRange(MI, Offset);
+
+  return (Offset << 6) | (Reg & 0x3F);
+}
+
+unsigned ARCompactMCCodeEmitter::getMemrrOpValue(const MCInst &MI,
+    unsigned OpNo, SmallVectorImpl<MCFixup> &Fixups) const {
+  unsigned Base = getMachineOpValue(MI, MI.getOperand(OpNo), Fixups);
+  unsigned Index = getMachineOpValue(MI, MI.getOperand(OpNo + 1), Fixups);
+
+  return (Index << 6) | Base;
+}
+
+unsigned ARCompactMCCodeEmitter::getMemlirOpValue(const MCInst &MI,
+    unsigned OpNo, SmallVectorImpl<MCFixup> &Fixups) const {
+  return getMachineOpValue(MI, MI.getOperand(OpNo + 1), Fixups);
+}
+
+unsigned ARCompactMCCodeEmitter::getMemgpOpValue(const MCInst &MI,
+    unsigned OpNo, ARC::Fixups Kind, SmallVectorImpl<MCFixup> &Fixups) const {
+  unsigned Reg = getMachineOpValue(MI, MI.getOperand(OpNo), Fixups);
+  const MCOperand &Sym = MI.getOperand(OpNo + 1);
+  assert(Sym.isExpr() && "Small data address is not a symbol!");
+
+  Fixups.push_back(MCFixup::Create(0, Sym.getExpr(), MCFixupKind(Kind)));
+  return Reg & 0x3F;
+}
+
+unsigned ARCompactMCCodeEmitter::getMemrsOpValue(const MCInst &MI,
+    unsigned OpNo, unsigned Shift, SmallVectorImpl<MCFixup> &Fixups) const {
+  unsigned Reg = getMachineOpValue(MI, MI.getOperand(OpNo), Fixups);
+  int64_t Offset = getImmOperand(MI, OpNo + 1);
+  if (!isUInt<5>(Offset >> Shift) || (Offset & ((1 << Shift) - 1)))
+    reportImmOutOfRange(MI, Offset);
+
+  return ((Offset >> Shift) << 3) | (Reg & 0x7);
+}
+
+unsigned ARCompactMCCodeEmitter::getShortCCOpValue(const MCInst &MI,
+    unsigned OpNo, SmallVectorImpl<MCFixup> &Fixups) const {
+  switch (MI.getOperand(OpNo).getImm()) {
+    default: llvm_unreachable("Condition code has no 16-bit encoding!");
+    case ARCCC::COND_GT: return 0;
+    case ARCCC::COND_GE: return 1;
+    case ARCCC::COND_LT: return 2;
+    case ARCCC::COND_LE: return 3;
+    case ARCCC::COND_HI: return 4;
+    case ARCCC::COND_HS: return 5;
+    case ARCCC::COND_LO: return 6;
+    case ARCCC::COND_LS: return 7;
+  }
+}
+
+unsigned ARCompactMCCodeEmitter::getBRccCondOpValue(const MCInst &MI,
+    unsigned OpNo, SmallVectorImpl<MCFixup> &Fixups) const {
+  switch (MI.getOperand(OpNo).getImm()) {
+    default: llvm_unreachable("Condition code has no BRcc encoding!");
+    case ARCCC::COND_EQ: return 0;
+    case ARCCC::COND_NE: return 1;
+    case ARCCC::COND_LT: return 2;
+    case ARCCC::COND_GE: return 3;
+    case ARCCC::COND_LO: return 4;
+    case ARCCC::COND_HS: return 5;
+  }
+}
+
+unsigned ARCompactMCCodeEmitter::getPCRelOpValue(const MCInst &MI,
+    unsigned OpNo, ARC::Fixups Kind,
+    SmallVectorImpl<MCFixup> &Fixups) const {
+  const MCOperand &MO = MI.getOperand(OpNo);
+  if (MO.isImm())
+    return MO.getImm();
+
+  assert(MO.isExpr() && "Unexpected branch target operand!");
+  Fixups.push_back(MCFixup::Create(0, MO.getExpr(), MCFixupKind(Kind)));
+  return 0;
+}
+
+unsigned ARCompactMCCodeEmitter::getBranchTargetOpValue(const MCInst &MI,
+    unsigned OpNo, SmallVectorImpl<MCFixup> &Fixups) const {
+  switch (MI.getOpcode()) {
+    default: llvm_unreachable("Unknown branch instruction!");
+    case ARC::B:
+    case ARC::B_D:
+      return getPCRelOpValue(MI, OpNo, ARC::fixup_arc_s25h_pcrel, Fixups);
+    case ARC::BCC:
+    case ARC::BCC_D:
+      return getPCRelOpValue(MI, OpNo, ARC::fixup_arc_s21h_pcrel, Fixups);
+    case ARC::B_S:
+    case ARC::BEQ_S:
+    case ARC::BNE_S:
+      return getPCRelOpValue(MI, OpNo, ARC::fixup_arc_s10h_pcrel, Fixups);
+    case ARC::BCC_S:
+      return getPCRelOpValue(MI, OpNo, ARC::fixup_arc_s7h_pcrel, Fixups);
+    case ARC::LP:
+      return getPCRelOpValue(MI, OpNo, ARC::fixup_arc_s13h_pcrel, Fixups);
+    case ARC::BRCCrr:
+    case ARC::BRCCru6:
+    case ARC::BRCCrr_D:
+    case ARC::BRCCru6_D:
+    case ARC::BBIT0ru6:
+    case ARC::BBIT1ru6:
+    case ARC::BBIT0ru6_D:
+    case ARC::BBIT1ru6_D:
+      return getPCRelOpValue(MI, OpNo, ARC::fixup_arc_s9h_pcrel, Fixups);
+  }
+}
+
+unsigned ARCompactMCCodeEmitter::getCallTargetOpValue(const MCInst &MI,
+    unsigned OpNo, SmallVectorImpl<MCFixup> &Fixups) const {
+  switch (MI.getOpcode()) {
+    default: llvm_unreachable("Unknown call instruction!");
+    case ARC::BLi:
+    case ARC::BL_D:
+      return getPCRelOpValue(MI, OpNo, ARC::fixup_arc_s25w_pcrel, Fixups);
+    case ARC::BL_S:
+      return getPCRelOpValue(MI, OpNo, ARC::fixup_arc_s13w_pcrel, Fixups);
+    case ARC::TAILJMPi:
+    case ARC::TAILJMPi_D:
+      return getPCRelOpValue(MI, OpNo, ARC::fixup_arc_s25h_pcrel, Fixups);
+  }
+}
+
+unsigned ARCompactMCCodeEmitter::encodePredicate(const MCInst &MI,
+    unsigned Value) const {
+  int PredIdx = MCII.get(MI.getOpcode()).findFirstPredOperandIdx();
+  if (PredIdx == -1)
+    return Value;
+
+  unsigned CC = MI.getOperand(PredIdx).getImm();
+  if (CC == ARCCC::COND_AL)
+    return Value;
+
+  // Only the register (P = 00) and u6 (P = 01) formats can be made
+  // conditional, and then only if the destination is the first source; the
+  // latter is enforced by isPredicable.
+  unsigned P = (Value >> 22) & 0x3;
+  assert(P < 2 && "Instruction format cannot be predicated!");
+
+  Value &= ~((0x3 << 22) | 0x3F);
+  Value |= (0x3 << 22) | (P << 5) | CC;
+  return Value;
+}
+
+#include "ARCompactGenMCCodeEmitter.inc"
@@ -18,6 +18,7 @@
 #include "llvm/MC/MCCodeGenInfo.h"
 #include "llvm/MC/MCInstrInfo.h"
 #include "llvm/MC/MCRegisterInfo.h"
+#include "llvm/MC/MCStreamer.h"
 #include "llvm/MC/MCSubtargetInfo.h"
 #include "llvm/Support/TargetRegistry.h"
 
@@ -47,6 +48,10 @@ static MCRegisterInfo *createARCompactMCRegisterInfo(StringRef TT) {
 static MCSubtargetInfo *createARCompactMCSubtargetInfo(StringRef TT, 
     StringRef CPU, StringRef FS) {
   MCSubtargetInfo *X = new MCSubtargetInfo();
+  // Default to the same processor as ARCompactSubtarget, so that tools which
+  // only have the MC layer see the same features and itineraries as llc.
+  if (CPU.empty())
+    CPU = "encore";
   InitARCompactMCSubtargetInfo(X, TT, CPU, FS);
   return X;
 }
@@ -69,6 +74,12 @@ static MCInstPrinter *createARCompactMCInstPrinter(const Target &T,
   return 0;
 }
 
+static MCStreamer *createARCompactMCStreamer(const Target &T, StringRef TT,
+    MCContext &Ctx, MCAsmBackend &MAB, raw_ostream &OS, MCCodeEmitter *Emitter,
+    bool RelaxAll, bool NoExecStack) {
+  return createELFStreamer(Ctx, MAB, OS, Emitter, RelaxAll, NoExecStack);
+}
+
 extern "C" void LLVMInitializeARCompactTargetMC() {
   // Register the MC asm info.
   RegisterMCAsmInfo<ARCompactMCAsmInfo> X(TheARCompactTarget);
@@ -92,4 +103,16 @@ extern "C" void LLVMInitializeARCompactTargetMC() {
   // Register the MCInstPrinter.
   TargetRegistry::RegisterMCInstPrinter(TheARCompactTarget,
                                         createARCompactMCInstPrinter);
+
+  // Register the MC code emitter.
+  TargetRegistry::RegisterMCCodeEmitter(TheARCompactTarget,
+      createARCompactMCCodeEmitter);
+
+  // Register the asm backend.
+  TargetRegistry::RegisterMCAsmBackend(TheARCompactTarget,
+      createARCompactAsmBackend);
+
+  // Register the object streamer.
+  TargetRegistry::RegisterMCObjectStreamer(TheARCompactTarget,
+      createARCompactMCStreamer);
 }
@@ -14,11 +14,29 @@
 #ifndef ARCOMPACTMCTARGETDESC_H
 #define ARCOMPACTMCTARGETDESC_H
 
+#include "llvm/Support/DataTypes.h"
+
 namespace llvm {
+class MCAsmBackend;
+class MCCodeEmitter;
+class MCContext;
+class MCInstrInfo;
+class MCObjectWriter;
+class MCSubtargetInfo;
+class StringRef;
 class Target;
+class raw_ostream;
 
 extern Target TheARCompactTarget;
 
+MCCodeEmitter *createARCompactMCCodeEmitter(const MCInstrInfo &MCII,
+                                            const MCSubtargetInfo &STI,
+                                            MCContext &Ctx);
+
+MCAsmBackend *createARCompactAsmBackend(const Target &T, StringRef TT);
+
+MCObjectWriter *createARCompactELFObjectWriter(raw_ostream &OS, uint8_t OSABI);
+
 } // End llvm namespace
 
 // Defines symbolic names for ARCompact registers.  This defines a mapping from
@@ -0,0 +1,27 @@
+; RUN: llvm-as < %s | llvm-dis | FileCheck %s
+
+; The ARCompact interrupt calling conventions survive a round trip.
+
+; CHECK: define arc_intr1cc void @level1()
+define arc_intr1cc void @level1() {
+  ret void
+}
+
+; CHECK: define arc_intr2cc void @level2()
+define arc_intr2cc void @level2() {
+  ret void
+}
+
+; CHECK: declare arc_intr1cc void @ext1()
+declare arc_intr1cc void @ext1()
+
+; CHECK: declare arc_intr2cc void @ext2()
+declare arc_intr2cc void @ext2()
+
+define void @user() {
+; CHECK: call arc_intr1cc void @ext1()
+  call arc_intr1cc void @ext1()
+; CHECK: call arc_intr2cc void @ext2()
+  call arc_intr2cc void @ext2()
+  ret void
+}
@@ -0,0 +1,70 @@
+; RUN: llc < %s -march=arcompact | FileCheck %s
+
+; Pointer updates are folded into the loads and stores as pre-increments
+; (.a) or post-increments (.ab).
+
+; CHECK: sum:
+; CHECK: lp @
+; CHECK: ld.ab r3,[r2,4]
+; CHECK-NEXT: add r0,r3,r0
+define i32 @sum(i32* %p, i32 %n) nounwind readonly {
+entry:
+  %c0 = icmp eq i32 %n, 0
+  br i1 %c0, label %end, label %body
+body:
+  %i = phi i32 [ 0, %entry ], [ %inc, %body ]
+  %s = phi i32 [ 0, %entry ], [ %add, %body ]
+  %q = phi i32* [ %p, %entry ], [ %next, %body ]
+  %v = load i32* %q, align 4
+  %next = getelementptr i32* %q, i32 1
+  %add = add i32 %v, %s
+  %inc = add i32 %i, 1
+  %c = icmp eq i32 %inc, %n
+  br i1 %c, label %end, label %body
+end:
+  %r = phi i32 [ 0, %entry ], [ %add, %body ]
+  ret i32 %r
+}
+
+; CHECK: copyb:
+; CHECK: lp @
+; CHECK: ldb.ab r3,[r1,1]
+; CHECK-NEXT: stb.ab r3,[r0,1]
+define void @copyb(i8* %d, i8* %s, i32 %n) nounwind {
+entry:
+  %c0 = icmp eq i32 %n, 0
+  br i1 %c0, label %end, label %body
+body:
+  %i = phi i32 [ 0, %entry ], [ %inc, %body ]
+  %dp = phi i8* [ %d, %entry ], [ %dn, %body ]
+  %sp = phi i8* [ %s, %entry ], [ %sn, %body ]
+  %v = load i8* %sp, align 1
+  store i8 %v, i8* %dp, align 1
+  %sn = getelementptr i8* %sp, i32 1
+  %dn = getelementptr i8* %dp, i32 1
+  %inc = add i32 %i, 1
+  %c = icmp eq i32 %inc, %n
+  br i1 %c, label %end, label %body
+end:
+  ret void
+}
+
+; CHECK: pre:
+; CHECK: stw.a r1,[r0,-4]
+define i16* @pre(i16* %p, i16 %v) nounwind {
+  %q = getelementptr i16* %p, i32 -2
+  store i16 %v, i16* %q, align 2
+  ret i16* %q
+}
+
+; CHECK: postsx:
+; CHECK: ldb.x.ab r1,[r2,3]
+; CHECK: st r2,[r0]
+define i32 @postsx(i8** %pp) nounwind {
+  %p = load i8** %pp
+  %v = load i8* %p
+  %n = getelementptr i8* %p, i32 3
+  store i8* %n, i8** %pp
+  %e = sext i8 %v to i32
+  ret i32 %e
+}
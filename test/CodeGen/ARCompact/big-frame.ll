@@ -0,0 +1,47 @@
+; RUN: llc < %s -march=arcompact | FileCheck %s
+; RUN: llc < %s -march=arcompact -filetype=obj -o - \
+; RUN:   | llvm-objdump -d - | FileCheck %s -check-prefix=OBJ
+
+; SP adjustments use the s12 form while the frame fits, and the limm form
+; for frames of 2 KiB and more.
+
+declare void @use(i32*)
+
+; CHECK: small:
+; CHECK: sub sp,sp,2044
+; CHECK: add sp,sp,2044
+; OBJ: 82 24 1f 3f sub sp,sp,2044
+; OBJ: 80 24 1f 3f add sp,sp,2044
+define void @small() nounwind {
+entry:
+  %a = alloca [510 x i32]
+  %p = getelementptr [510 x i32]* %a, i32 0, i32 0
+  call void @use(i32* %p)
+  ret void
+}
+
+; CHECK: large:
+; CHECK: sub sp,sp,12004
+; CHECK: add sp,sp,12004
+; OBJ: 02 24 9c 3f 00 00 e4 2e sub sp,sp,12004
+; OBJ: 00 24 9c 3f 00 00 e4 2e add sp,sp,12004
+define void @large() nounwind {
+entry:
+  %a = alloca [3000 x i32]
+  %p = getelementptr [3000 x i32]* %a, i32 0, i32 0
+  call void @use(i32* %p)
+  ret void
+}
+
+; CHECK: varargs:
+; CHECK: sub sp,sp,28
+; CHECK: sub sp,sp,12004
+; CHECK: add sp,sp,12004
+; CHECK: add sp,sp,28
+define i32 @varargs(i32 %n, ...) nounwind {
+entry:
+  %a = alloca [3000 x i32]
+  %p = getelementptr [3000 x i32]* %a, i32 0, i32 0
+  call void @use(i32* %p)
+  ret i32 %n
+}
@@ -0,0 +1,144 @@
+; RUN: llc < %s -march=arcompact -mcpu=encore | FileCheck %s
+; RUN: llc < %s -march=arcompact -mcpu=encore-dsp \
+; RUN:   | FileCheck %s -check-prefix=DSP
+; RUN: llc < %s -march=arcompact -mcpu=encore-dsp -mattr=-barrel-shifter \
+; RUN:   | FileCheck %s -check-prefix=SWAP
+; RUN: llc < %s -march=arcompact -mattr=-mpy | FileCheck %s -check-prefix=NOMPY
+
+; The saturating intrinsics use ADDS, SUBS, ABSS and NEGS when the subtarget
+; has them, and compares or sign masks otherwise. CTTZ uses NORM, CTPOP never
+; calls __mulsi3, and BSWAP uses byte rotates or SWAP.
+
+declare i32 @llvm.arc.adds(i32, i32) nounwind readnone
+declare i32 @llvm.arc.subs(i32, i32) nounwind readnone
+declare i32 @llvm.arc.abss(i32) nounwind readnone
+declare i32 @llvm.arc.negs(i32) nounwind readnone
+declare i32 @llvm.arc.norm(i32) nounwind readnone
+declare i32 @llvm.cttz.i32(i32, i1) nounwind readnone
+declare i32 @llvm.ctpop.i32(i32) nounwind readnone
+declare i32 @llvm.bswap.i32(i32) nounwind readnone
+declare i16 @llvm.bswap.i16(i16) nounwind readnone
+
+; CHECK: adds:
+; CHECK: add r0,[[A:r[0-9]+]],r1
+; CHECK: and.f
+; CHECK: asr [[S:r[0-9]+]],[[A]],31
+; CHECK: xor [[S]],[[S]],2147483647
+; CHECK: mov.n r0,[[S]]
+; DSP: adds:
+; DSP: adds r0,r0,r1
+define i32 @adds(i32 %a, i32 %b) nounwind readnone {
+  %r = call i32 @llvm.arc.adds(i32 %a, i32 %b)
+  ret i32 %r
+}
+
+; CHECK: subs:
+; CHECK: sub r0,{{r[0-9]+}},r1
+; CHECK: and.f
+; CHECK: xor {{r[0-9]+}},{{r[0-9]+}},2147483647
+; CHECK: mov.n r0,
+; DSP: subs:
+; DSP: subs r0,r0,r1
+define i32 @subs(i32 %a, i32 %b) nounwind readnone {
+  %r = call i32 @llvm.arc.subs(i32 %a, i32 %b)
+  ret i32 %r
+}
+
+; CHECK: abss:
+; CHECK: abs r0,r0
+; CHECK-NEXT: asr r1,r0,31
+; CHECK: xor r0,r0,r1
+; DSP: abss:
+; DSP: abss r0,r0
+define i32 @abss(i32 %a) nounwind readnone {
+  %r = call i32 @llvm.arc.abss(i32 %a)
+  ret i32 %r
+}
+
+; CHECK: negs:
+; CHECK: neg r1,r0
+; CHECK-NEXT: and r0,r1,r0
+; CHECK-NEXT: asr r0,r0,31
+; CHECK: xor r0,r1,r0
+; DSP: negs:
+; DSP: negs r0,r0
+define i32 @negs(i32 %a) nounwind readnone {
+  %r = call i32 @llvm.arc.negs(i32 %a)
+  ret i32 %r
+}
+
+; CHECK: norm:
+; CHECK: asr r1,r0,31
+; CHECK-NEXT: xor r0,r0,r1
+; CHECK: add r0,r0,-1
+; DSP: norm:
+; DSP: norm r0,r0
+define i32 @norm(i32 %a) nounwind readnone {
+  %r = call i32 @llvm.arc.norm(i32 %a)
+  ret i32 %r
+}
+
+; CHECK: cttz:
+; CHECK: bic
+; CHECK: mpy
+; DSP: cttz:
+; DSP: cmp r0,0
+; DSP: bic [[M:r[0-9]+]],{{r[0-9]+}},r0
+; DSP-NEXT: norm [[M]],[[M]]
+; DSP-NEXT: sub [[M]],31,[[M]]
+; DSP-NEXT: mov.eq [[M]],32
+define i32 @cttz(i32 %a) nounwind readnone {
+  %r = call i32 @llvm.cttz.i32(i32 %a, i1 false)
+  ret i32 %r
+}
+
+; DSP: cttz_undef:
+; DSP-NOT: cmp
+; DSP: norm r0,r0
+; DSP-NEXT: sub r0,31,r0
+; DSP-NOT: mov.eq
+; DSP: .size cttz_undef
+define i32 @cttz_undef(i32 %a) nounwind readnone {
+  %r = call i32 @llvm.cttz.i32(i32 %a, i1 true)
+  ret i32 %r
+}
+
+; CHECK: ctpop:
+; CHECK: and {{r[0-9]+}},{{r[0-9]+}},1431655765
+; CHECK: and {{r[0-9]+}},{{r[0-9]+}},252645135
+; CHECK: mpy
+; CHECK: lsr r0,r0,24
+; NOMPY: ctpop:
+; NOMPY-NOT: __mulsi3
+; NOMPY: lsr r1,r0,8
+; NOMPY: lsr r1,r0,16
+; NOMPY: and r0,r0,63
+define i32 @ctpop(i32 %a) nounwind readnone {
+  %r = call i32 @llvm.ctpop.i32(i32 %a)
+  ret i32 %r
+}
+
+; CHECK: bswap:
+; CHECK: ror r1,r0,24
+; CHECK-NEXT: ror r0,r0,8
+; CHECK-NEXT: and r1,r1,16711935
+; CHECK-NEXT: and r0,r0,-16711936
+; CHECK: or r0,r0,r1
+; SWAP: bswap:
+; SWAP: swap r0,r0
+; SWAP-NEXT: lsr r1,r0,8
+; SWAP-NEXT: asl r0,r0,8
+define i32 @bswap(i32 %a) nounwind readnone {
+  %r = call i32 @llvm.bswap.i32(i32 %a)
+  ret i32 %r
+}
+
+; CHECK: bswap16:
+; CHECK: asl r1,r0,8
+; CHECK-NEXT: lsr r0,r0,8
+; CHECK-NEXT: extb r0,r0
+; CHECK: or r0,r1,r0
+define i16 @bswap16(i16 %a) nounwind readnone {
+  %r = call i16 @llvm.bswap.i16(i16 %a)
+  ret i16 %r
+}
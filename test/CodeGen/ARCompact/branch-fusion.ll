@@ -0,0 +1,91 @@
+; RUN: llc < %s -march=arcompact | FileCheck %s
+; RUN: llc < %s -march=arcompact -disable-arcompact-branch-fusion \
+; RUN:   | FileCheck %s -check-prefix=OFF
+
+; A compare and the branch on its result are fused into BRcc or BBIT once
+; the layout is final, where the target is known to be in range.
+
+declare void @f(i32)
+
+; BRcc has no GT, so the operands are swapped.
+; CHECK: rr:
+; CHECK-NOT: cmp
+; CHECK: brge.d r1,r0,@
+; OFF: rr:
+; OFF: cmp r0,r1
+; OFF-NEXT: ble.d @
+define void @rr(i32 %a, i32 %b) nounwind {
+entry:
+  %c = icmp sgt i32 %a, %b
+  br i1 %c, label %then, label %end
+then:
+  call void @f(i32 %a)
+  br label %end
+end:
+  ret void
+}
+
+; Nor HI, so the immediate is bumped instead.
+; CHECK: imm:
+; CHECK-NOT: cmp
+; CHECK: brlo.d r0,10,@
+define void @imm(i32 %a) nounwind {
+entry:
+  %c = icmp ugt i32 %a, 9
+  br i1 %c, label %then, label %end
+then:
+  call void @f(i32 %a)
+  br label %end
+end:
+  ret void
+}
+
+; BRcc only takes a u6.
+; CHECK: bigimm:
+; CHECK: cmp r0,1000
+; CHECK-NEXT: bne.d @
+define void @bigimm(i32 %a) nounwind {
+entry:
+  %c = icmp eq i32 %a, 1000
+  br i1 %c, label %then, label %end
+then:
+  call void @f(i32 %a)
+  br label %end
+end:
+  ret void
+}
+
+; A single bit test, left as an AND.f by OptimizeCompareInstr.
+; CHECK: bit:
+; CHECK-NOT: and
+; CHECK: bbit1.d r0,4,@
+; OFF: bit:
+; OFF: and.f r1,r0,16
+; OFF-NEXT: bne.d @
+define void @bit(i32 %a) nounwind {
+entry:
+  %m = and i32 %a, 16
+  %c = icmp eq i32 %m, 0
+  br i1 %c, label %then, label %end
+then:
+  call void @f(i32 %a)
+  br label %end
+end:
+  ret void
+}
+
+; The target may be out of range of BRcc.
+; CHECK: far:
+; CHECK: cmp r0,0
+; CHECK-NEXT: bne.d @
+define void @far(i32 %a) nounwind {
+entry:
+  %c = icmp eq i32 %a, 0
+  br i1 %c, label %then, label %end
+then:
+  call void asm sideeffect "add r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2\0Aadd r2,r2,r2", "~{r2}"() nounwind
+  call void @f(i32 %a)
+  br label %end
+end:
+  ret void
+}
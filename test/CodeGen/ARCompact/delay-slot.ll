@@ -0,0 +1,84 @@
+; RUN: llc < %s -march=arcompact -disable-arcompact-hwloops | FileCheck %s
+; RUN: llc < %s -march=arcompact -disable-arcompact-delay-filler \
+; RUN:   | FileCheck %s -check-prefix=NOFILL
+
+; An independent instruction before a return moves into its delay slot.
+define i32 @ret(i32 %a, i32 %b) nounwind {
+entry:
+; CHECK: ret:
+; CHECK: j.d [blink]
+; CHECK-NEXT: add r0,r0,r1
+; NOFILL: ret:
+; NOFILL: add r0,r0,r1
+; NOFILL-NEXT: j [blink]
+  %s = add i32 %a, %b
+  ret i32 %s
+}
+
+; An instruction with a long immediate may not be in a delay slot, and no
+; NOP is inserted instead.
+define i32 @ret_limm(i32 %a) nounwind {
+entry:
+; CHECK: ret_limm:
+; CHECK: add r0,r0,305419896
+; CHECK-NEXT: j [blink]
+  %s = add i32 %a, 305419896
+  ret i32 %s
+}
+
+declare i32 @f(i32)
+
+; The slot of a call may set up an argument.
+define i32 @call(i32 %a) nounwind {
+entry:
+; CHECK: call:
+; CHECK: st.a blink,[sp,-4]
+; CHECK-NEXT: bl.d @f
+; CHECK-NEXT: add r0,r0,1
+; CHECK-NEXT: ld.ab blink,[sp,4]
+; CHECK-NEXT: j [blink]
+  %b = add i32 %a, 1
+  %r = call i32 @f(i32 %b)
+  ret i32 %r
+}
+
+; The compare and branch reads the loaded value, so the load stays put.
+define i32 @dep(i32* %p) nounwind {
+entry:
+; CHECK: dep:
+; CHECK: ld r1,[r0]
+; CHECK-NEXT: breq r1,0,@.BB3_1
+; CHECK: j.d [blink]
+; CHECK-NEXT: mov r0,r1
+  %v = load i32* %p
+  %c = icmp eq i32 %v, 0
+  br i1 %c, label %t, label %e
+t:
+  store i32 1, i32* %p
+  ret i32 1
+e:
+  ret i32 %v
+}
+
+; The loop branch takes an instruction from the loop body.
+define i32 @branch(i32 %a, i32 %b, i32 %n) nounwind {
+entry:
+; CHECK: branch:
+; CHECK: .BB4_1:
+; CHECK: add r3,r3,1
+; CHECK-NEXT: brlt.d r3,r2,@.BB4_1
+; CHECK-NEXT: add r4,r4,r0
+; CHECK: j.d [blink]
+; CHECK-NEXT: xor r0,r4,r1
+  br label %loop
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i1, %loop ]
+  %s = phi i32 [ 0, %entry ], [ %s1, %loop ]
+  %s1 = add i32 %s, %a
+  %i1 = add i32 %i, 1
+  %c = icmp slt i32 %i1, %n
+  br i1 %c, label %loop, label %out
+out:
+  %r = xor i32 %s1, %b
+  ret i32 %r
+}
@@ -0,0 +1,84 @@
+; RUN: llc < %s -march=arcompact -O0 -fast-isel -fast-isel-abort | FileCheck %s
+
+; FastISel selects these without falling back to SelectionDAG.
+
+; CHECK: add:
+; CHECK: add r0,r0,r1
+define i32 @add(i32 %a, i32 %b) nounwind {
+  %r = add i32 %a, %b
+  ret i32 %r
+}
+
+; Compares take a u6 immediate, and a register otherwise.
+; CHECK: br_imm:
+; CHECK: cmp r0,63
+; CHECK-NEXT: bhs @
+define i32 @br_imm(i32 %a) nounwind {
+entry:
+  %c = icmp ult i32 %a, 63
+  br i1 %c, label %t, label %f
+t:
+  ret i32 1
+f:
+  ret i32 2
+}
+
+; CHECK: br_big:
+; CHECK: mov r1,64
+; CHECK-NEXT: cmp r0,r1
+; CHECK-NEXT: bge @
+define i32 @br_big(i32 %a) nounwind {
+entry:
+  %c = icmp slt i32 %a, 64
+  br i1 %c, label %t, label %f
+t:
+  ret i32 1
+f:
+  ret i32 2
+}
+
+; CHECK: br_neg:
+; CHECK: mov r1,-1
+; CHECK-NEXT: cmp r0,r1
+; CHECK-NEXT: ble @
+define i32 @br_neg(i32 %a) nounwind {
+entry:
+  %c = icmp sgt i32 %a, -1
+  br i1 %c, label %t, label %f
+t:
+  ret i32 1
+f:
+  ret i32 2
+}
+
+; Narrow values are extended before they are compared.
+; CHECK: br_i8:
+; CHECK: extb r0,r0
+; CHECK: cmp r0,r1
+; CHECK-NEXT: bls @
+define i32 @br_i8(i8 %a) nounwind {
+entry:
+  %c = icmp ugt i8 %a, 200
+  br i1 %c, label %t, label %f
+t:
+  ret i32 1
+f:
+  ret i32 2
+}
+
+; CHECK: load:
+; CHECK: ld r0,[r0]
+define i32 @load(i32* %p) nounwind {
+  %v = load i32* %p
+  ret i32 %v
+}
+
+declare i32 @g(i32)
+
+; CHECK: call:
+; CHECK: st.a blink,[sp,-4]
+; CHECK-NEXT: bl @g
+define i32 @call(i32 %a) nounwind {
+  %r = call i32 @g(i32 %a)
+  ret i32 %r
+}
@@ -0,0 +1,68 @@
+; RUN: llc < %s -march=arcompact | FileCheck %s
+
+; A compare of a result with zero or -1 is dropped when the instruction which
+; computes it can set the flags itself, and the conditions tested are
+; rewritten in terms of Z and N.
+
+declare void @f()
+
+; CHECK: subz:
+; CHECK: sub.f r0,r0,r1
+; CHECK-NEXT: bne.d @
+define void @subz(i32 %a, i32 %b) nounwind {
+  %d = sub i32 %a, %b
+  %c = icmp eq i32 %d, 0
+  br i1 %c, label %t, label %e
+t:
+  call void @f()
+  br label %e
+e:
+  ret void
+}
+
+; LT becomes N, so the value is kept when it is positive.
+; CHECK: andneg:
+; CHECK: and.f r0,r0,r1
+; CHECK-NOT: cmp
+; CHECK: mov.p r0,7
+define i32 @andneg(i32 %a, i32 %b) nounwind readnone {
+  %d = and i32 %a, %b
+  %c = icmp slt i32 %d, 0
+  %r = select i1 %c, i32 %d, i32 7
+  ret i32 %r
+}
+
+; x > -1 is a sign test.
+; CHECK: addgt:
+; CHECK: add.f r0,r0,r1
+; CHECK-NOT: cmp
+; CHECK: mov.p r0,r2
+define i32 @addgt(i32 %a, i32 %b, i32 %x) nounwind readnone {
+  %d = add i32 %a, %b
+  %c = icmp sgt i32 %d, -1
+  %r = select i1 %c, i32 %x, i32 %d
+  ret i32 %r
+}
+
+; CHECK: carry:
+; CHECK: add.f r0,r0,r1
+; CHECK-NOT: cmp
+; CHECK: mov.ne r0,r2
+define i32 @carry(i32 %a, i32 %b, i32 %x) nounwind readnone {
+  %d = add i32 %a, %b
+  %c = icmp ugt i32 %d, 0
+  %r = select i1 %c, i32 %x, i32 %d
+  ret i32 %r
+}
+
+; x <= 0 is canonicalised to x < 1, which still needs the compare.
+; CHECK: signed_lt:
+; CHECK: add r0,r0,r1
+; CHECK-NEXT: cmp r0,1
+; CHECK: mov.lt r0,r2
+define i32 @signed_lt(i32 %a, i32 %b, i32 %x) nounwind readnone {
+  %d = add i32 %a, %b
+  %c = icmp sle i32 %d, 0
+  %r = select i1 %c, i32 %x, i32 %d
+  ret i32 %r
+}
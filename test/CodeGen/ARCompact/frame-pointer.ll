@@ -0,0 +1,47 @@
+; RUN: llc < %s -march=arcompact | FileCheck %s
+; RUN: llc < %s -march=arcompact -disable-fp-elim \
+; RUN:   | FileCheck %s -check-prefix=FP
+
+; The frame pointer is only set up when it is needed, or asked for.
+
+declare void @use(i32*)
+
+; CHECK: nofp:
+; CHECK-NOT: mov fp,sp
+; CHECK: sub sp,sp,16
+; CHECK-NEXT: add r0,sp,0
+; CHECK-NOT: ld.ab fp
+; CHECK: j [blink]
+; FP: nofp:
+; FP: st.a fp,[sp,-4]
+; FP-NEXT: mov fp,sp
+; FP-NEXT: sub sp,sp,16
+; FP-NEXT: add r0,fp,-16
+; FP: ld.ab fp,[sp,4]
+define void @nofp() nounwind {
+  %a = alloca [4 x i32]
+  %p = getelementptr [4 x i32]* %a, i32 0, i32 0
+  call void @use(i32* %p)
+  ret void
+}
+
+; CHECK: vla:
+; CHECK: st.a fp,[sp,-4]
+; CHECK-NEXT: mov fp,sp
+; CHECK: mov sp,fp
+; CHECK-NEXT: ld.ab fp,[sp,4]
+define void @vla(i32 %n) nounwind {
+  %a = alloca i32, i32 %n
+  call void @use(i32* %a)
+  ret void
+}
+
+declare i8* @llvm.frameaddress(i32) nounwind readnone
+
+; CHECK: frameaddr:
+; CHECK: mov fp,sp
+; CHECK-NEXT: mov r0,fp
+define i8* @frameaddr() nounwind {
+  %f = call i8* @llvm.frameaddress(i32 0)
+  ret i8* %f
+}
@@ -0,0 +1,168 @@
+; RUN: llc < %s -march=arcompact | FileCheck %s
+; RUN: llc < %s -march=arcompact -mattr=+div | FileCheck %s -check-prefix=DIV
+; RUN: llc < %s -march=arcompact -disable-arcompact-hwloops \
+; RUN:   | FileCheck %s -check-prefix=OFF
+
+; Innermost loops with a computable trip count become zero-overhead loops.
+
+; A loop guarded by a test of its trip count has no preheader until
+; LoopSimplify puts one back.
+; CHECK: iota:
+; CHECK: brlt r1,1,@[[END:.BB[0-9_]+]]
+; CHECK: mov lp_count,r1
+; CHECK-NEXT: lp @[[END]]
+; CHECK-NOT: brlt
+; CHECK: j [blink]
+; OFF: iota:
+; OFF-NOT: lp_count
+; OFF: brlt r2,r1
+define void @iota(i32* nocapture %a, i32 %n) nounwind {
+entry:
+  %cmp = icmp sgt i32 %n, 0
+  br i1 %cmp, label %for.body, label %if.end
+
+for.body:
+  %i.0 = phi i32 [ %inc, %for.body ], [ 0, %entry ]
+  %arrayidx = getelementptr inbounds i32* %a, i32 %i.0
+  store i32 %i.0, i32* %arrayidx, align 4
+  %inc = add nsw i32 %i.0, 1
+  %cmp2 = icmp slt i32 %inc, %n
+  br i1 %cmp2, label %for.body, label %if.end
+
+if.end:
+  ret void
+}
+
+; CHECK: scaled:
+; CHECK: sub r2,r2,r1
+; CHECK: mov lp_count,r2
+; CHECK-NEXT: lp @
+; CHECK-NOT: brlt
+; CHECK: j [blink]
+define void @scaled(i16* nocapture %a, i32 %lo, i32 %hi) nounwind {
+entry:
+  %cmp = icmp slt i32 %lo, %hi
+  br i1 %cmp, label %for.body, label %if.end
+
+for.body:
+  %i.0 = phi i32 [ %inc, %for.body ], [ %lo, %entry ]
+  %arrayidx = getelementptr inbounds i16* %a, i32 %i.0
+  store i16 0, i16* %arrayidx, align 2
+  %inc = add nsw i32 %i.0, 1
+  %cmp2 = icmp slt i32 %inc, %hi
+  br i1 %cmp2, label %for.body, label %if.end
+
+if.end:
+  ret void
+}
+
+; A division is a library call unless the subtarget has the divider.
+; CHECK: div:
+; CHECK-NOT: lp
+; CHECK: bl.d @__udivsi3
+; CHECK: bne.d
+; DIV: div:
+; DIV: mov r3,100
+; DIV: mov lp_count,r3
+; DIV-NEXT: lp @
+; DIV: divu r4,r4,r2
+define void @div(i32* nocapture %a, i32 %n, i32 %d) nounwind {
+entry:
+  br label %body
+
+body:
+  %i = phi i32 [ 0, %entry ], [ %inc, %body ]
+  %p = getelementptr i32* %a, i32 %i
+  %v = load i32* %p, align 4
+  %q = udiv i32 %v, %d
+  store i32 %q, i32* %p, align 4
+  %inc = add i32 %i, 1
+  %c = icmp eq i32 %inc, 100
+  br i1 %c, label %end, label %body
+
+end:
+  ret void
+}
+
+; The bit counting intrinsics are expanded inline.
+; CHECK: bits:
+; CHECK: mov lp_count,r2
+; CHECK-NEXT: lp @
+; CHECK-NOT: bl
+; CHECK: j [blink]
+declare i32 @llvm.ctpop.i32(i32) nounwind readnone
+declare i32 @llvm.bswap.i32(i32) nounwind readnone
+declare i32 @llvm.ctlz.i32(i32, i1) nounwind readnone
+
+define void @bits(i32* nocapture %a) nounwind {
+entry:
+  br label %body
+
+body:
+  %i = phi i32 [ 0, %entry ], [ %inc, %body ]
+  %p = getelementptr i32* %a, i32 %i
+  %v = load i32* %p, align 4
+  %b = call i32 @llvm.bswap.i32(i32 %v)
+  %c = call i32 @llvm.ctpop.i32(i32 %b)
+  %l = call i32 @llvm.ctlz.i32(i32 %c, i1 false)
+  store i32 %l, i32* %p, align 4
+  %inc = add i32 %i, 1
+  %e = icmp eq i32 %inc, 64
+  br i1 %e, label %end, label %body
+
+end:
+  ret void
+}
+
+; A call clobbers the loop registers.
+; CHECK: call:
+; CHECK-NOT: lp
+; CHECK: bl @f
+; CHECK: add.f r13,r13,-1
+; CHECK-NEXT: bne @
+declare void @f()
+
+define void @call(i32 %n) nounwind {
+entry:
+  br label %body
+
+body:
+  %i = phi i32 [ 0, %entry ], [ %inc, %body ]
+  call void @f()
+  %inc = add i32 %i, 1
+  %e = icmp eq i32 %inc, 10
+  br i1 %e, label %end, label %body
+
+end:
+  ret void
+}
+
+; Only the inner loop of a nest becomes a hardware loop.
+; CHECK: nested:
+; CHECK: mov lp_count,r2
+; CHECK-NEXT: lp @
+; CHECK: brne r1,8,@
+define void @nested(i32* nocapture %a) nounwind {
+entry:
+  br label %outer
+
+outer:
+  %j = phi i32 [ 0, %entry ], [ %jinc, %latch ]
+  br label %inner
+
+inner:
+  %i = phi i32 [ 0, %outer ], [ %inc, %inner ]
+  %p = getelementptr i32* %a, i32 %i
+  store i32 %j, i32* %p, align 4
+  %inc = add i32 %i, 1
+  %e = icmp eq i32 %inc, 16
+  br i1 %e, label %latch, label %inner
+
+latch:
+  %jinc = add i32 %j, 1
+  %je = icmp eq i32 %jinc, 8
+  br i1 %je, label %end, label %outer
+
+end:
+  ret void
+}
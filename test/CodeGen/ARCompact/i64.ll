@@ -0,0 +1,152 @@
+; RUN: llc < %s -march=arcompact | FileCheck %s
+; RUN: llc < %s -march=arcompact -mattr=-mpy,+mul64 \
+; RUN:   | FileCheck %s -check-prefix=MUL64
+
+; 64-bit arithmetic works on register pairs, with the carry passed from the
+; low word to the high word through the flags.
+
+; CHECK: add:
+; CHECK: add.f r0,r0,r2
+; CHECK-NEXT: j.d [blink]
+; CHECK-NEXT: adc r1,r1,r3
+define i64 @add(i64 %a, i64 %b) nounwind readnone {
+  %r = add i64 %a, %b
+  ret i64 %r
+}
+
+; CHECK: sub:
+; CHECK: sub.f r0,r0,r2
+; CHECK-NEXT: j.d [blink]
+; CHECK-NEXT: sbc r1,r1,r3
+define i64 @sub(i64 %a, i64 %b) nounwind readnone {
+  %r = sub i64 %a, %b
+  ret i64 %r
+}
+
+; CHECK: addimm:
+; CHECK: add.f r0,r0,5
+; CHECK-NEXT: j.d [blink]
+; CHECK-NEXT: adc r1,r1,0
+define i64 @addimm(i64 %a) nounwind readnone {
+  %r = add i64 %a, 5
+  ret i64 %r
+}
+
+; A compare subtracts the low words, then the high words with SBC.F, which
+; leaves the flags of the whole 64-bit subtraction.
+; CHECK: ult:
+; CHECK: cmp r0,r2
+; CHECK-NEXT: sbc.f r0,r1,r3
+; CHECK-NEXT: mov r0,0
+; CHECK-NEXT: j.d [blink]
+; CHECK-NEXT: mov.lo r0,1
+define i1 @ult(i64 %a, i64 %b) nounwind readnone {
+  %c = icmp ult i64 %a, %b
+  ret i1 %c
+}
+
+; CHECK: slt:
+; CHECK: cmp r0,r2
+; CHECK-NEXT: sbc.f r0,r1,r3
+; CHECK-NEXT: mov.lt r5,r4
+define i32 @slt(i64 %a, i64 %b, i32 %x, i32 %y) nounwind readnone {
+  %c = icmp slt i64 %a, %b
+  %r = select i1 %c, i32 %x, i32 %y
+  ret i32 %r
+}
+
+; GT needs the zero flag, so the operands are swapped to make it LT.
+; CHECK: sgt:
+; CHECK: cmp r2,r0
+; CHECK-NEXT: sbc.f r0,r3,r1
+; CHECK-NEXT: bge
+define i32 @sgt(i64 %a, i64 %b) nounwind readnone {
+entry:
+  %c = icmp sgt i64 %a, %b
+  br i1 %c, label %t, label %f
+t:
+  ret i32 1
+f:
+  ret i32 2
+}
+
+; Against a constant, adding one to it does the same.
+; CHECK: ugtk:
+; CHECK: cmp r0,1
+; CHECK-NEXT: sbc.f r0,r1,1
+; CHECK: mov.hs r0,1
+define i1 @ugtk(i64 %a) nounwind readnone {
+  %c = icmp ugt i64 %a, 4294967296
+  ret i1 %c
+}
+
+; Equality ORs together the XORs of the halves.
+; CHECK: eq:
+; CHECK: xor [[HI:r[0-9]+]],r1,r3
+; CHECK-NEXT: xor [[LO:r[0-9]+]],r0,r2
+; CHECK-NEXT: or.f r0,[[LO]],[[HI]]
+; CHECK: mov.eq r0,1
+define i1 @eq(i64 %a, i64 %b) nounwind readnone {
+  %c = icmp eq i64 %a, %b
+  ret i1 %c
+}
+
+; Shifts by a variable amount combine the word shifts, and pick the halves
+; with MOV.cc on bit 5 of the amount.
+; CHECK: shl:
+; CHECK: and.f {{r[0-9]+}},r2,32
+; CHECK: mov.eq r1,
+; CHECK: mov.ne r0,0
+define i64 @shl(i64 %a, i64 %n) nounwind readnone {
+  %r = shl i64 %a, %n
+  ret i64 %r
+}
+
+; CHECK: lshr:
+; CHECK: and.f {{r[0-9]+}},r2,32
+; CHECK: mov.eq r0,
+; CHECK: mov.ne r1,0
+define i64 @lshr(i64 %a, i64 %n) nounwind readnone {
+  %r = lshr i64 %a, %n
+  ret i64 %r
+}
+
+; CHECK: ashr:
+; CHECK: and.f {{r[0-9]+}},r2,32
+; CHECK: asr r1,r1,31
+; CHECK: mov.eq r0,
+; CHECK: mov.eq r1,
+define i64 @ashr(i64 %a, i64 %n) nounwind readnone {
+  %r = ashr i64 %a, %n
+  ret i64 %r
+}
+
+; Widening multiplies use MPY with MPYHU or MPYH, or MUL64 and MULU64 when
+; only they are available.
+; CHECK: umul:
+; CHECK: mpy [[LO:r[0-9]+]],r0,r1
+; CHECK-NEXT: mpyhu r1,r0,r1
+; MUL64: umul:
+; MUL64: mulu64 r0,r1
+; MUL64-NEXT: mov r0,mlo
+; MUL64: mov r1,mhi
+define i64 @umul(i32 %a, i32 %b) nounwind readnone {
+  %x = zext i32 %a to i64
+  %y = zext i32 %b to i64
+  %r = mul i64 %x, %y
+  ret i64 %r
+}
+
+; CHECK: smul:
+; CHECK: mpy [[LO:r[0-9]+]],r0,r1
+; CHECK-NEXT: mpyh r1,r0,r1
+; MUL64: smul:
+; MUL64: mul64 r0,r1
+; MUL64-NEXT: mov r0,mlo
+; MUL64: mov r1,mhi
+define i64 @smul(i32 %a, i32 %b) nounwind readnone {
+  %x = sext i32 %a to i64
+  %y = sext i32 %b to i64
+  %r = mul i64 %x, %y
+  ret i64 %r
+}
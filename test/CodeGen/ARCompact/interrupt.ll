@@ -0,0 +1,145 @@
+; RUN: llc < %s -march=arcompact -verify-machineinstrs | FileCheck %s
+; RUN: llc < %s -march=arcompact -mcpu=encore-dsp | FileCheck %s -check-prefix=DSP
+; RUN: llc < %s -march=arcompact -O0 -mattr=-mpy,+mul64 \
+; RUN:   | FileCheck %s -check-prefix=MUL64
+
+; Interrupt handlers save every register they write, and return through the
+; link register of their level. One which makes calls also saves the loop
+; registers, as the callee may run a zero-overhead loop, and the multiply
+; result registers with MUL64. MLO is restored by multiplying it by one, and
+; MHI then through the MULHI auxiliary register.
+
+@counter = global i32 0
+@wide = global i64 0
+@table = global [16 x i32] zeroinitializer
+
+declare void @work(i32)
+
+; CHECK: leaf:
+; CHECK: st.a r0,[sp,-4]
+; CHECK-NOT: lp_count
+; CHECK-NOT: mlo
+; CHECK: ld.ab r0,[sp,4]
+; CHECK-NEXT: j.f [ilink1]
+; DSP: leaf:
+; DSP-NOT: mlo
+; DSP: j.f [ilink1]
+define arc_intr1cc void @leaf() nounwind {
+  %v = load volatile i32* @counter
+  %n = add i32 %v, 1
+  store volatile i32 %n, i32* @counter
+  ret void
+}
+
+; CHECK: caller:
+; CHECK: st.a blink,[sp,-4]
+; CHECK-NEXT: st.a r0,[sp,-4]
+; CHECK: st.a r12,[sp,-4]
+; CHECK: sub sp,sp,12
+; CHECK-NEXT: mov r0,lp_count
+; CHECK-NEXT: st r0,[sp,8]
+; CHECK-NEXT: lr r0,[lp_start]
+; CHECK-NEXT: st r0,[sp,4]
+; CHECK-NEXT: lr r0,[lp_end]
+; CHECK-NEXT: st r0,[sp]
+; CHECK-NOT: mlo
+; CHECK: bl{{(.d)?}} @work
+; CHECK: ld r0,[sp]
+; CHECK-NEXT: sr r0,[lp_end]
+; CHECK-NEXT: ld r0,[sp,4]
+; CHECK-NEXT: sr r0,[lp_start]
+; CHECK-NEXT: ld r0,[sp,8]
+; CHECK-NEXT: mov lp_count,r0
+; CHECK-NEXT: add sp,sp,12
+; CHECK: ld.ab r0,[sp,4]
+; CHECK-NEXT: ld.ab blink,[sp,4]
+; CHECK-NEXT: j.f [ilink2]
+; DSP: caller:
+; DSP: sub sp,sp,20
+; DSP-NEXT: mov r0,lp_count
+; DSP-NEXT: st r0,[sp,16]
+; DSP-NEXT: lr r0,[lp_start]
+; DSP-NEXT: st r0,[sp,12]
+; DSP-NEXT: lr r0,[lp_end]
+; DSP-NEXT: st r0,[sp,8]
+; DSP-NEXT: mov r0,mlo
+; DSP-NEXT: st r0,[sp,4]
+; DSP-NEXT: mov r0,mhi
+; DSP-NEXT: st r0,[sp]
+; DSP: bl{{(.d)?}} @work
+; DSP: ld r0,[sp,4]
+; DSP-NEXT: mulu64 r0,1
+; DSP-NEXT: ld r0,[sp]
+; DSP-NEXT: sr r0,[mulhi]
+; DSP-NEXT: ld r0,[sp,8]
+; DSP-NEXT: sr r0,[lp_end]
+; DSP-NEXT: ld r0,[sp,12]
+; DSP-NEXT: sr r0,[lp_start]
+; DSP-NEXT: ld r0,[sp,16]
+; DSP-NEXT: mov lp_count,r0
+; DSP-NEXT: add sp,sp,20
+; DSP: j.f [ilink2]
+define arc_intr2cc void @caller() nounwind {
+  %v = load volatile i32* @counter
+  call void @work(i32 %v)
+  store volatile i32 %v, i32* @counter
+  ret void
+}
+
+; A leaf handler which multiplies saves only the multiply result registers.
+; MUL64: multiplies:
+; MUL64-NOT: lp_
+; MUL64: mov r0,mlo
+; MUL64-NEXT: st r0,[sp,4]
+; MUL64-NEXT: mov r0,mhi
+; MUL64-NEXT: st r0,[sp]
+; MUL64: mul64
+; MUL64: ld r0,[sp,4]
+; MUL64-NEXT: mulu64 r0,1
+; MUL64-NEXT: ld r0,[sp]
+; MUL64-NEXT: sr r0,[mulhi]
+; MUL64-NOT: lp_
+; MUL64: j.f [ilink1]
+define arc_intr1cc void @multiplies() nounwind {
+  %v = load volatile i64* @wide
+  %m = mul i64 %v, %v
+  store volatile i64 %m, i64* @wide
+  ret void
+}
+
+; The loops of a handler are not made zero-overhead loops.
+; CHECK: loops:
+; CHECK-NOT: lp_count
+; CHECK-NOT: lp @
+; CHECK: j.f [ilink1]
+define arc_intr1cc void @loops() nounwind {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %next, %loop ]
+  %p = getelementptr [16 x i32]* @table, i32 0, i32 %i
+  store volatile i32 %i, i32* %p
+  %next = add i32 %i, 1
+  %done = icmp eq i32 %next, 16
+  br i1 %done, label %exit, label %loop
+
+exit:
+  ret void
+}
+
+; The saves are copied through R0, which is saved even when the handler does
+; not otherwise write it.
+; MUL64: asm:
+; MUL64: st.a r0,[sp,-4]
+; MUL64-NEXT: sub sp,sp,8
+; MUL64-NEXT: mov r0,mlo
+; MUL64: mul64 0,0
+; MUL64: sr r0,[mulhi]
+; MUL64-NEXT: add sp,sp,8
+; MUL64-NEXT: ld.ab r0,[sp,4]
+; MUL64-NEXT: j.f [ilink1]
+define arc_intr1cc void @asm() nounwind {
+  call void asm sideeffect "mul64 0,0", "~{mlo},~{mmid},~{mhi}"() nounwind
+  ret void
+}
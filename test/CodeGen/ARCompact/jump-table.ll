@@ -0,0 +1,46 @@
+; RUN: llc < %s -march=arcompact | FileCheck %s
+; RUN: llc < %s -march=arcompact -filetype=obj -o - \
+; RUN:   | llvm-objdump -r - | FileCheck %s -check-prefix=RELOC
+
+; Dense switches are dispatched through a table of block addresses.
+
+; CHECK: sw:
+; CHECK: brlo r0,6,@[[JT:.BB[0-9_]+]]
+; CHECK: [[JT]]:
+; CHECK-NEXT: mov r1,[[TABLE:.JTI[0-9_]+]]
+; CHECK-NEXT: add2 r0,r1,r0
+; CHECK-NEXT: ld r0,[r0]
+; CHECK-NEXT: j [r0]
+; CHECK: .section .rodata
+; CHECK: .align 4
+; CHECK-NEXT: [[TABLE]]:
+; CHECK-NEXT: .long .BB0_2
+; CHECK-NEXT: .long .BB0_3
+; CHECK-NEXT: .long .BB0_4
+; CHECK-NEXT: .long .BB0_5
+; CHECK-NEXT: .long .BB0_6
+; CHECK-NEXT: .long .BB0_7
+
+; RELOC: RELOCATION RECORDS FOR [.text]:
+; RELOC-NEXT: R_ARC_32_ME .rodata+0
+; RELOC: RELOCATION RECORDS FOR [.rodata]:
+; RELOC-NEXT: 0 R_ARC_32 .text+
+; RELOC-NEXT: 4 R_ARC_32 .text+
+define i32 @sw(i32 %x) nounwind readnone {
+entry:
+  switch i32 %x, label %def [
+    i32 0, label %a
+    i32 1, label %b
+    i32 2, label %c
+    i32 3, label %d
+    i32 4, label %e
+    i32 5, label %f
+  ]
+a: ret i32 10
+b: ret i32 21
+c: ret i32 32
+d: ret i32 43
+e: ret i32 54
+f: ret i32 65
+def: ret i32 0
+}
@@ -0,0 +1,81 @@
+; RUN: llc < %s -march=arcompact | FileCheck %s
+; RUN: llc < %s -march=arcompact -O0 | FileCheck %s -check-prefix=O0
+
+; A long immediate costs as much to fetch as another instruction. It is only
+; folded into an instruction when that is its single use outside a loop;
+; otherwise it is materialized once with a rematerializable MOV.
+
+; CHECK: single:
+; CHECK: add r0,r0,305419896
+define i32 @single(i32 %a) nounwind readnone {
+  %r = add i32 %a, 305419896
+  ret i32 %r
+}
+
+; CHECK: shared:
+; CHECK: mov [[K:r[0-9]+]],305419896
+; CHECK-NOT: 305419896
+; CHECK: xor r1,r1,[[K]]
+; CHECK: add r0,r0,[[K]]
+; O0: shared:
+; O0: add r0,r0,305419896
+; O0: xor r1,r1,305419896
+define i32 @shared(i32 %a, i32 %b) nounwind readnone {
+  %x = add i32 %a, 305419896
+  %y = xor i32 %b, 305419896
+  %r = and i32 %x, %y
+  ret i32 %r
+}
+
+; The masks are hoisted out of the loop.
+; CHECK: loop:
+; CHECK: mov [[MASK:r[0-9]+]],16777215
+; CHECK: mov [[KEY:r[0-9]+]],-1412567296
+; CHECK: lp
+; CHECK-NOT: 16777215
+; CHECK: and [[V:r[0-9]+]],{{r[0-9]+}},[[MASK]]
+; CHECK-NEXT: xor [[V]],[[V]],[[KEY]]
+define void @loop(i32* %p, i32 %n) nounwind {
+entry:
+  br label %loop
+loop:
+  %i = phi i32 [0, %entry], [%i1, %loop]
+  %a = getelementptr i32* %p, i32 %i
+  %v = load i32* %a
+  %m = and i32 %v, 16777215
+  %x = xor i32 %m, -1412567296
+  store i32 %x, i32* %a
+  %i1 = add i32 %i, 1
+  %d = icmp eq i32 %i1, %n
+  br i1 %d, label %exit, label %loop
+exit:
+  ret void
+}
+
+declare void @g(i32)
+
+; Rather than keep the constant in a callee-saved register across the calls,
+; the register allocator materializes it again after each one.
+; CHECK: remat:
+; CHECK-NOT: r13
+; CHECK: bl.d @g
+; CHECK: mov r0,305419896
+; CHECK-NEXT: bl @g
+; CHECK-NEXT: mov r0,305419896
+; CHECK-NEXT: bl @g
+define void @remat(i32 %a) nounwind {
+  %x = add i32 %a, 305419896
+  call void @g(i32 %x)
+  call void @g(i32 305419896)
+  call void @g(i32 305419896)
+  ret void
+}
+
+; Compares against anything that fits the s12 form need no long immediate.
+; CHECK: cmpimm:
+; CHECK: cmp r0,2000
+define i32 @cmpimm(i32 %a) nounwind readnone {
+  %c = icmp slt i32 %a, 2000
+  %r = select i1 %c, i32 1, i32 2
+  ret i32 %r
+}
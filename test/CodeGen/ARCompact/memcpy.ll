@@ -0,0 +1,81 @@
+; RUN: llc < %s -march=arcompact | FileCheck %s
+; RUN: llc < %s -march=arcompact -O3 | FileCheck %s -check-prefix=O3
+
+; Word aligned copies and fills of a known size are done inline, with LD.AB
+; and ST.AB loops unrolled by the optimisation level.
+
+declare void @llvm.memcpy.p0i8.p0i8.i32(i8* nocapture, i8* nocapture, i32, i32, i1) nounwind
+declare void @llvm.memmove.p0i8.p0i8.i32(i8* nocapture, i8* nocapture, i32, i32, i1) nounwind
+declare void @llvm.memset.p0i8.i32(i8* nocapture, i8, i32, i32, i1) nounwind
+
+; The two bytes after the last word are copied separately.
+; CHECK: copy:
+; CHECK: mov r2,8
+; CHECK: mov lp_count,r2
+; CHECK-NEXT: lp @
+; CHECK: ld.ab r5,[r4,4]
+; CHECK-NEXT: ld.ab r6,[r4,4]
+; CHECK-NEXT: st.ab r5,[r3,4]
+; CHECK-NEXT: st.ab r6,[r3,4]
+; CHECK: ldw r1,[r1,64]
+; CHECK: stw r1,[r0,64]
+define void @copy(i8* %d, i8* %s) nounwind {
+  call void @llvm.memcpy.p0i8.p0i8.i32(i8* %d, i8* %s, i32 66, i32 4, i1 false)
+  ret void
+}
+
+; A move copies backwards when the destination is above the source.
+; CHECK: move:
+; CHECK: brhs r1,r0,@
+; CHECK: ld.a r3,[r1,-4]
+; CHECK: st.a r3,[r0,-4]
+; CHECK: ld.ab r3,[r1,4]
+; CHECK: st.ab r3,[r0,4]
+define void @move(i8* %d, i8* %s) nounwind {
+  call void @llvm.memmove.p0i8.p0i8.i32(i8* %d, i8* %s, i32 64, i32 4, i1 false)
+  ret void
+}
+
+; The fill byte is repeated across the word.
+; CHECK: fill:
+; CHECK: extb r1,r1
+; CHECK: asl r2,r1,8
+; CHECK: or r1,r1,r2
+; CHECK: asl r2,r1,16
+; CHECK: or r1,r1,r2
+; CHECK: mov r2,16
+; CHECK: st.ab r1,[r0,4]
+; CHECK-NEXT: st.ab r1,[r0,4]
+define void @fill(i8* %d, i8 %c) nounwind {
+  call void @llvm.memset.p0i8.i32(i8* %d, i8 %c, i32 128, i32 4, i1 false)
+  ret void
+}
+
+; CHECK: zero:
+; CHECK: mov r1,0
+; CHECK: st.ab r1,[r0,4]
+; O3: zero:
+; O3: mov r2,8
+; O3: st.ab r1,[r0,4]
+; O3-NEXT: st.ab r1,[r0,4]
+; O3-NEXT: st.ab r1,[r0,4]
+; O3-NEXT: st.ab r1,[r0,4]
+define void @zero(i8* %d) nounwind {
+  call void @llvm.memset.p0i8.i32(i8* %d, i8 0, i32 128, i32 4, i1 false)
+  ret void
+}
+
+; Unaligned and large copies are left to the library.
+; CHECK: unaligned:
+; CHECK: bl.d @memcpy
+define void @unaligned(i8* %d, i8* %s) nounwind {
+  call void @llvm.memcpy.p0i8.p0i8.i32(i8* %d, i8* %s, i32 64, i32 1, i1 false)
+  ret void
+}
+
+; CHECK: huge:
+; CHECK: bl @memcpy
+define void @huge(i8* %d, i8* %s) nounwind {
+  call void @llvm.memcpy.p0i8.p0i8.i32(i8* %d, i8* %s, i32 4096, i32 4, i1 false)
+  ret void
+}
@@ -0,0 +1,68 @@
+; RUN: llc < %s -march=arcompact | FileCheck %s
+; RUN: llc < %s -march=arcompact -filetype=obj -o - \
+; RUN:   | llvm-objdump -d - | FileCheck %s -check-prefix=OBJ
+
+; Scaled indices and offsets are folded into the .as addressing forms.
+
+; CHECK: ldidx:
+; CHECK: ld.as r0,[r0,r1]
+; OBJ: ld.as r0,[r0,r1]
+define i32 @ldidx(i32* %p, i32 %i) nounwind readonly {
+  %q = getelementptr i32* %p, i32 %i
+  %v = load i32* %q
+  ret i32 %v
+}
+
+; CHECK: ldhidx:
+; CHECK: ldw.x.as r0,[r0,r1]
+; OBJ: ldw.x.as r0,[r0,r1]
+define i32 @ldhidx(i16* %p, i32 %i) nounwind readonly {
+  %q = getelementptr i16* %p, i32 %i
+  %v = load i16* %q
+  %e = sext i16 %v to i32
+  ret i32 %e
+}
+
+; CHECK: ldrr:
+; CHECK: ldb r0,[r0,r1]
+define i32 @ldrr(i8* %p, i32 %i) nounwind readonly {
+  %q = getelementptr i8* %p, i32 %i
+  %v = load i8* %q
+  %e = zext i8 %v to i32
+  ret i32 %e
+}
+
+; An offset of 400 bytes does not fit in nine bits, but 100 words do.
+; CHECK: ldfar:
+; CHECK: ld.as r0,[r0,100]
+define i32 @ldfar(i32* %p) nounwind readonly {
+  %q = getelementptr i32* %p, i32 100
+  %v = load i32* %q
+  ret i32 %v
+}
+
+; CHECK: stfar:
+; CHECK: st.as r1,[r0,100]
+define void @stfar(i32* %p, i32 %v) nounwind {
+  %q = getelementptr i32* %p, i32 100
+  store i32 %v, i32* %q
+  ret void
+}
+
+; ST has no register + register form.
+; CHECK: stidx:
+; CHECK: add2 r0,r0,r1
+; CHECK: st r2,[r0]
+define void @stidx(i32* %p, i32 %i, i32 %v) nounwind {
+  %q = getelementptr i32* %p, i32 %i
+  store i32 %v, i32* %q
+  ret void
+}
+
+; CHECK: add3:
+; CHECK: add3 r0,r0,r1
+define i32 @add3(i32 %a, i32 %b) nounwind readnone {
+  %s = shl i32 %b, 3
+  %r = add i32 %a, %s
+  ret i32 %r
+}
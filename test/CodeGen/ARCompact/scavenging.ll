@@ -0,0 +1,83 @@
+; RUN: llc < %s -march=arcompact | FileCheck %s
+; RUN: llc < %s -march=arcompact -O0 | FileCheck %s -check-prefix=O0
+
+; Frame objects out of range of a [b,s9] address are reached through a
+; scratch register found by the register scavenger.
+
+declare void @use(i32*, i32*, i32*)
+
+; CHECK: far:
+; CHECK: sub sp,sp,12012
+; CHECK-NEXT: add [[R:r[0-9]+]],sp,11753
+; CHECK-NEXT: st r0,{{\[}}[[R]],255]
+; CHECK: bl @use
+; CHECK-NEXT: add [[R2:r[0-9]+]],sp,11753
+; CHECK-NEXT: ld r0,{{\[}}[[R2]],255]
+
+; With no register free, one is spilled to the emergency slot, and restored
+; before the epilogue moves SP.
+; O0: far:
+; O0: bl @use
+; O0-NEXT: st fp,[sp]
+; O0-NEXT: add fp,sp,11753
+; O0-NEXT: ld r0,[fp,255]
+; O0-NEXT: ld fp,[sp]
+; O0: add sp,sp,12012
+define i32 @far(i32 %v, i32 %w) nounwind {
+  %x = alloca i32, align 4
+  %a = alloca [3000 x i32], align 4
+  %y = alloca i32, align 4
+  %p = getelementptr [3000 x i32]* %a, i32 0, i32 0
+  store volatile i32 %v, i32* %x, align 4
+  store volatile i32 %w, i32* %y, align 4
+  call void @use(i32* %x, i32* %p, i32* %y)
+  %r = load volatile i32* %x, align 4
+  %s = load volatile i32* %y, align 4
+  %t = add i32 %r, %s
+  ret i32 %t
+}
+
+; R12 is no longer reserved.
+; CHECK: many:
+; CHECK: ld r12,[r0]
+define i32 @many(i32* %p) nounwind {
+  %v0 = load volatile i32* %p
+  %v1 = load volatile i32* %p
+  %v2 = load volatile i32* %p
+  %v3 = load volatile i32* %p
+  %v4 = load volatile i32* %p
+  %v5 = load volatile i32* %p
+  %v6 = load volatile i32* %p
+  %v7 = load volatile i32* %p
+  %v8 = load volatile i32* %p
+  %v9 = load volatile i32* %p
+  %v10 = load volatile i32* %p
+  %v11 = load volatile i32* %p
+  %v12 = load volatile i32* %p
+  %s0 = add i32 %v0, %v1
+  %s1 = add i32 %s0, %v2
+  %s2 = add i32 %s1, %v3
+  %s3 = add i32 %s2, %v4
+  %s4 = add i32 %s3, %v5
+  %s5 = add i32 %s4, %v6
+  %s6 = add i32 %s5, %v7
+  %s7 = add i32 %s6, %v8
+  %s8 = add i32 %s7, %v9
+  %s9 = add i32 %s8, %v10
+  %s10 = add i32 %s9, %v11
+  %s11 = add i32 %s10, %v12
+  %m0 = mul i32 %v0, %s11
+  %m1 = mul i32 %v1, %m0
+  %m2 = mul i32 %v2, %m1
+  %m3 = mul i32 %v3, %m2
+  %m4 = mul i32 %v4, %m3
+  %m5 = mul i32 %v5, %m4
+  %m6 = mul i32 %v6, %m5
+  %m7 = mul i32 %v7, %m6
+  %m8 = mul i32 %v8, %m7
+  %m9 = mul i32 %v9, %m8
+  %m10 = mul i32 %v10, %m9
+  %m11 = mul i32 %v11, %m10
+  %m12 = mul i32 %v12, %m11
+  ret i32 %m12
+}
@@ -0,0 +1,33 @@
+; RUN: llc < %s -march=arcompact -mcpu=encore | FileCheck %s
+
+; The EnCore itineraries let the schedulers hide the load-use and multiply
+; latencies behind independent instructions.
+
+; CHECK: loaduse:
+; CHECK: ld r0,[r0]
+; CHECK-NEXT: or r1,r1,7
+; CHECK-NEXT: add r0,r0,r1
+define i32 @loaduse(i32* %p, i32 %a, i32 %b) nounwind readonly {
+entry:
+  %v = load i32* %p, align 4
+  %u = add i32 %v, 1
+  %x = xor i32 %a, %b
+  %y = or i32 %x, 7
+  %r = add i32 %u, %y
+  ret i32 %r
+}
+
+; CHECK: mul:
+; CHECK: mpy r0,r0,r1
+; CHECK-NEXT: xor r1,r2,r3
+; CHECK-NEXT: extb r1,r1
+; CHECK-NEXT: add r0,r0,3
+define i32 @mul(i32 %a, i32 %b, i32 %c, i32 %d) nounwind readnone {
+entry:
+  %m = mul i32 %a, %b
+  %n = add i32 %m, 3
+  %x = xor i32 %c, %d
+  %y = and i32 %x, 255
+  %r = sub i32 %n, %y
+  ret i32 %r
+}
@@ -0,0 +1,66 @@
+; RUN: llc < %s -march=arcompact | FileCheck %s
+; RUN: llc < %s -march=arcompact -arcompact-size-reduction=always \
+; RUN:   | FileCheck %s -check-prefix=SHORT
+
+; Selects become a compare and a MOV.cc, or MIN, MAX and ABS, rather than
+; branches.
+
+; CHECK: min:
+; CHECK-NOT: cmp
+; CHECK: min r0,r0,r1
+define i32 @min(i32 %a, i32 %b) nounwind readnone {
+  %c = icmp slt i32 %a, %b
+  %r = select i1 %c, i32 %a, i32 %b
+  ret i32 %r
+}
+
+; CHECK: max:
+; CHECK: max r0,r0,r1
+define i32 @max(i32 %a, i32 %b) nounwind readnone {
+  %c = icmp sgt i32 %a, %b
+  %r = select i1 %c, i32 %a, i32 %b
+  ret i32 %r
+}
+
+; CHECK: abs:
+; CHECK: abs r0,r0
+; SHORT: abs:
+; SHORT: abs_s r0,r0
+define i32 @abs(i32 %a) nounwind readnone {
+  %c = icmp slt i32 %a, 0
+  %n = sub i32 0, %a
+  %r = select i1 %c, i32 %n, i32 %a
+  ret i32 %r
+}
+
+; CHECK: sel:
+; CHECK: cmp r0,r1
+; CHECK-NEXT: mov.lo r3,r2
+; CHECK-NEXT: j.d [blink]
+; CHECK-NEXT: mov r0,r3
+define i32 @sel(i32 %a, i32 %b, i32 %x, i32 %y) nounwind readnone {
+  %c = icmp ult i32 %a, %b
+  %r = select i1 %c, i32 %x, i32 %y
+  ret i32 %r
+}
+
+; A constant is moved in when the condition is inverted.
+; CHECK: selimm:
+; CHECK: cmp r0,5
+; CHECK-NEXT: mov.ne r1,7
+define i32 @selimm(i32 %a, i32 %x) nounwind readnone {
+  %c = icmp eq i32 %a, 5
+  %r = select i1 %c, i32 %x, i32 7
+  ret i32 %r
+}
+
+; CHECK: clamp:
+; CHECK: min r0,r0,255
+; CHECK: max r0,r0,0
+define i32 @clamp(i32 %a) nounwind readnone {
+  %c = icmp sgt i32 %a, 255
+  %r = select i1 %c, i32 255, i32 %a
+  %c2 = icmp slt i32 %r, 0
+  %r2 = select i1 %c2, i32 0, i32 %r
+  ret i32 %r2
+}
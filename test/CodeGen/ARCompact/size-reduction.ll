@@ -0,0 +1,104 @@
+; RUN: llc < %s -march=arcompact | FileCheck %s
+; RUN: llc < %s -march=arcompact -arcompact-size-reduction=always \
+; RUN:   | FileCheck %s -check-prefix=ALWAYS
+; RUN: llc < %s -march=arcompact -arcompact-size-reduction=never \
+; RUN:   | FileCheck %s -check-prefix=NEVER
+
+; By default only functions optimised for size use the 16-bit forms.
+
+define i32 @add(i32 %a, i32 %b) nounwind optsize {
+entry:
+; CHECK: add:
+; CHECK: j_s.d [blink]
+; CHECK-NEXT: add_s r0,r0,r1
+; NEVER: add:
+; NEVER: j.d [blink]
+; NEVER-NEXT: add r0,r0,r1
+  %s = add i32 %a, %b
+  ret i32 %s
+}
+
+define i32 @add_speed(i32 %a, i32 %b) nounwind {
+entry:
+; CHECK: add_speed:
+; CHECK: j.d [blink]
+; CHECK-NEXT: add r0,r0,r1
+; ALWAYS: add_speed:
+; ALWAYS: j_s.d [blink]
+; ALWAYS-NEXT: add_s r0,r0,r1
+  %s = add i32 %a, %b
+  ret i32 %s
+}
+
+define i32 @sub_imm(i32 %a) nounwind optsize {
+entry:
+; CHECK: sub_imm:
+; CHECK: sub_s r0,r0,7
+  %s = sub i32 %a, 7
+  ret i32 %s
+}
+
+define i32 @shl(i32 %a) nounwind optsize {
+entry:
+; CHECK: shl:
+; CHECK: asl_s r0,r0,3
+  %s = shl i32 %a, 3
+  ret i32 %s
+}
+
+; MOV_S takes a u8, where MOV would need a long immediate.
+define i32 @mov(i32 %a) nounwind optsize {
+entry:
+; CHECK: mov:
+; CHECK: mov_s r0,200
+  ret i32 200
+}
+
+; The 16-bit loads and stores take an offset scaled by the access size.
+define i32 @load(i32* %p) nounwind optsize {
+entry:
+; CHECK: load:
+; CHECK: ld_s r0,[r0,12]
+  %q = getelementptr i32* %p, i32 3
+  %v = load i32* %q
+  ret i32 %v
+}
+
+define void @store(i16* %p, i16 %v) nounwind optsize {
+entry:
+; CHECK: store:
+; CHECK: stw_s r1,[r0,10]
+  %q = getelementptr i16* %p, i32 5
+  store i16 %v, i16* %q
+  ret void
+}
+
+define i32 @ext(i32 %a) nounwind optsize {
+entry:
+; CHECK: ext:
+; CHECK: extb_s r0,r0
+  %t = and i32 %a, 255
+  ret i32 %t
+}
+
+define i32 @neg(i32 %a) nounwind optsize {
+entry:
+; CHECK: neg:
+; CHECK: neg_s r0,r0
+  %t = sub i32 0, %a
+  ret i32 %t
+}
+
+declare void @g()
+
+; BLINK is saved with PUSH_S and POP_S.
+define void @call() nounwind optsize {
+entry:
+; CHECK: call:
+; CHECK: push_s blink
+; CHECK: bl @g
+; CHECK: pop_s blink
+; CHECK: j_s [blink]
+  call void @g()
+  ret void
+}
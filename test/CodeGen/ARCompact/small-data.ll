@@ -0,0 +1,90 @@
+; RUN: llc < %s -march=arcompact | FileCheck %s
+; RUN: llc < %s -march=arcompact -arcompact-ssection-threshold=64 \
+; RUN:   | FileCheck %s -check-prefix=G64
+; RUN: llc < %s -march=arcompact -arcompact-ssection-threshold=0 \
+; RUN:   | FileCheck %s -check-prefix=G0
+; RUN: llc < %s -march=arcompact -filetype=obj -o - \
+; RUN:   | llvm-objdump -r - | FileCheck %s -check-prefix=RELOC
+
+; Small globals defined here go in .sdata and .sbss, and are addressed
+; relative to GP.
+
+@w = global i32 1, align 4
+@h = global i16 2, align 2
+@b = global i8 3, align 1
+@z = global i32 0, align 4
+@arr = global [4 x i32] zeroinitializer, align 4
+@big = global [16 x i32] zeroinitializer, align 4
+@ext = external global i32
+@wk = weak global i32 0, align 4
+
+; CHECK: ldw:
+; CHECK: ld.as r0,[gp,@w@sda]
+; G0: ldw:
+; G0: ld r0,[w]
+; RELOC: R_ARC_SDA_LDST2 w+0
+define i32 @ldw() nounwind readonly {
+  %v = load i32* @w
+  ret i32 %v
+}
+
+; CHECK: ldh:
+; CHECK: ldw.as r0,[gp,@h@sda]
+; RELOC-NEXT: R_ARC_SDA_LDST1 h+0
+define i32 @ldh() nounwind readonly {
+  %v = load i16* @h
+  %e = zext i16 %v to i32
+  ret i32 %e
+}
+
+; CHECK: ldb:
+; CHECK: ldb.x r0,[gp,@b@sda]
+; RELOC-NEXT: R_ARC_SDA_LDST b+0
+define i32 @ldb() nounwind readonly {
+  %v = load i8* @b
+  %e = sext i8 %v to i32
+  ret i32 %e
+}
+
+; CHECK: stz:
+; CHECK: st.as r0,[gp,@z@sda]
+; RELOC-NEXT: R_ARC_SDA_LDST2 z+0
+define void @stz(i32 %a) nounwind {
+  store i32 %a, i32* @z
+  ret void
+}
+
+; Declarations and weak globals may be defined anywhere.
+; CHECK: ext_load:
+; CHECK: ld r0,[ext]
+define i32 @ext_load() nounwind readonly {
+  %v = load i32* @ext
+  ret i32 %v
+}
+
+; CHECK: weak_load:
+; CHECK: ld r0,[wk]
+define i32 @weak_load() nounwind readonly {
+  %v = load i32* @wk
+  ret i32 %v
+}
+
+; A constant offset is folded into the relocation.
+; CHECK: big_load:
+; CHECK: mov r0,big
+; G64: big_load:
+; G64: ld.as r0,[gp,@big@sda+4]
+define i32 @big_load() nounwind readonly {
+  %v = load i32* getelementptr ([16 x i32]* @big, i32 0, i32 1)
+  ret i32 %v
+}
+
+; CHECK: .section .sdata,"aw",@progbits
+; CHECK-NEXT: .globl w
+; CHECK: .section .sbss,"aw",@nobits
+; CHECK-NEXT: .globl z
+; CHECK: .section .bss,"aw",@nobits
+; CHECK-NEXT: .globl arr
+; G64: .section .sbss,"aw",@nobits
+; G64: arr:
+; G64: big:
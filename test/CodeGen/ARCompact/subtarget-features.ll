@@ -0,0 +1,68 @@
+; RUN: llc < %s -march=arcompact -mcpu=encore | FileCheck %s
+; RUN: llc < %s -march=arcompact -mattr=+div | FileCheck %s -check-prefix=DIV
+; RUN: llc < %s -march=arcompact -mattr=-mpy,+mul64 \
+; RUN:   | FileCheck %s -check-prefix=MUL64
+; RUN: llc < %s -march=arcompact -mattr=-mpy | FileCheck %s -check-prefix=NOMPY
+; RUN: llc < %s -march=arcompact -mattr=-barrel-shifter \
+; RUN:   | FileCheck %s -check-prefix=NOBS
+
+; The optional EnCore extensions are used when the subtarget has them, and
+; library calls or longer sequences otherwise.
+
+; CHECK: sdiv:
+; CHECK: bl @__divsi3
+; DIV: sdiv:
+; DIV: div r0,r0,r1
+define i32 @sdiv(i32 %a, i32 %b) nounwind readnone {
+  %r = sdiv i32 %a, %b
+  ret i32 %r
+}
+
+; CHECK: urem:
+; CHECK: bl @__umodsi3
+; DIV: urem:
+; DIV: remu r0,r0,r1
+define i32 @urem(i32 %a, i32 %b) nounwind readnone {
+  %r = urem i32 %a, %b
+  ret i32 %r
+}
+
+; CHECK: mul:
+; CHECK: mpy r0,r0,r1
+; MUL64: mul:
+; MUL64: mul64 r0,r1
+; MUL64: mov r0,mlo
+; NOMPY: mul:
+; NOMPY: bl @__mulsi3
+define i32 @mul(i32 %a, i32 %b) nounwind readnone {
+  %r = mul i32 %a, %b
+  ret i32 %r
+}
+
+; CHECK: mulhs:
+; CHECK: mpyh r0,r0,r1
+; MUL64: mulhs:
+; MUL64: mul64 r0,r1
+; MUL64: mov r0,mhi
+; NOMPY: mulhs:
+; NOMPY: bl.d @__muldi3
+define i32 @mulhs(i32 %a, i32 %b) nounwind readnone {
+  %x = sext i32 %a to i64
+  %y = sext i32 %b to i64
+  %m = mul i64 %x, %y
+  %h = lshr i64 %m, 32
+  %r = trunc i64 %h to i32
+  ret i32 %r
+}
+
+; CHECK: rotr:
+; CHECK: ror r0,r0,5
+; NOBS: rotr:
+; NOBS-NOT: ror
+; NOBS: or r0,r0,r1
+define i32 @rotr(i32 %a) nounwind readnone {
+  %l = lshr i32 %a, 5
+  %h = shl i32 %a, 27
+  %r = or i32 %l, %h
+  ret i32 %r
+}
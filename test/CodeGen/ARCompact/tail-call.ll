@@ -0,0 +1,50 @@
+; RUN: llc < %s -march=arcompact | FileCheck %s
+; RUN: llc < %s -march=arcompact -filetype=obj -o - \
+; RUN:   | llvm-objdump -d -r - | FileCheck %s -check-prefix=OBJ
+
+; Tail calls whose arguments all go in registers become branches to the
+; callee once the frame is torn down.
+
+declare i32 @callee(i32, i32)
+
+; CHECK: direct:
+; CHECK-NOT: blink
+; CHECK: b.d @callee
+; OBJ: b.d @0
+; OBJ-NEXT: R_ARC_S25H_PCREL callee+0
+define i32 @direct(i32 %a, i32 %b) nounwind {
+  %r = tail call i32 @callee(i32 %b, i32 %a)
+  ret i32 %r
+}
+
+; CHECK: indirect:
+; CHECK-NOT: blink
+; CHECK: mov r2,r0
+; CHECK: j.d [r2]
+define i32 @indirect(i32 (i32, i32)* %f, i32 %a) nounwind {
+  %r = tail call i32 %f(i32 %a, i32 1)
+  ret i32 %r
+}
+
+; The callee saved registers and BLINK are restored before the branch.
+; CHECK: saves:
+; CHECK: bl.d @callee
+; CHECK: ld.ab r13,[sp,4]
+; CHECK-NEXT: ld.ab blink,[sp,4]
+; CHECK-NEXT: b @callee
+define i32 @saves(i32 %a) nounwind {
+  %x = call i32 @callee(i32 %a, i32 0)
+  %r = tail call i32 @callee(i32 %x, i32 %a)
+  ret i32 %r
+}
+
+; Arguments on the stack would overwrite the caller's own.
+declare i32 @many(i32, i32, i32, i32, i32, i32, i32, i32, i32)
+
+; CHECK: stackargs:
+; CHECK: bl.d @many
+; CHECK: j [blink]
+define i32 @stackargs(i32 %a) nounwind {
+  %r = tail call i32 @many(i32 %a, i32 1, i32 2, i32 3, i32 4, i32 5, i32 6, i32 7, i32 8)
+  ret i32 %r
+}
@@ -0,0 +1,134 @@
+; RUN: llvm-mc -triple=arcompact -show-encoding %s | FileCheck %s
+
+; The 32-bit instruction formats. Instruction words are stored as two little
+; endian half-words, most significant half-word first.
+
+; Register-register format (P = 00).
+; CHECK: add r0,r1,r2 ; encoding: [0x00,0x21,0x80,0x00]
+	add r0,r1,r2
+; CHECK: sub r3,r4,r5 ; encoding: [0x02,0x24,0x43,0x01]
+	sub r3,r4,r5
+; CHECK: and r6,r7,r8 ; encoding: [0x04,0x27,0x06,0x02]
+	and r6,r7,r8
+; CHECK: or r9,r10,r11 ; encoding: [0x05,0x22,0xc9,0x12]
+	or r9,r10,r11
+; CHECK: xor r12,r13,r14 ; encoding: [0x07,0x25,0x8c,0x13]
+	xor r12,r13,r14
+; CHECK: bic r0,r1,r2 ; encoding: [0x06,0x21,0x80,0x00]
+	bic r0,r1,r2
+; CHECK: asl r0,r1,r2 ; encoding: [0x00,0x29,0x80,0x00]
+	asl r0,r1,r2
+; CHECK: asr r0,r1,r2 ; encoding: [0x02,0x29,0x80,0x00]
+	asr r0,r1,r2
+; CHECK: lsr r0,r1,r2 ; encoding: [0x01,0x29,0x80,0x00]
+	lsr r0,r1,r2
+; CHECK: ror r0,r1,r2 ; encoding: [0x03,0x29,0x80,0x00]
+	ror r0,r1,r2
+; CHECK: max r0,r1,r2 ; encoding: [0x08,0x21,0x80,0x00]
+	max r0,r1,r2
+; CHECK: min r0,r1,r2 ; encoding: [0x09,0x21,0x80,0x00]
+	min r0,r1,r2
+; CHECK: add r25,gp,fp ; encoding: [0x00,0x22,0xd9,0x36]
+	add r25,gp,fp
+; CHECK: sub sp,sp,r0 ; encoding: [0x02,0x24,0x1c,0x30]
+	sub sp,sp,r0
+; CHECK: add.f r0,r1,r2 ; encoding: [0x00,0x21,0x80,0x80]
+	add.f r0,r1,r2
+
+; Register-u6 format (P = 01).
+; CHECK: add r0,r1,63 ; encoding: [0x40,0x21,0xc0,0x0f]
+	add r0,r1,63
+; CHECK: sub r0,r1,1 ; encoding: [0x42,0x21,0x40,0x00]
+	sub r0,r1,1
+; CHECK: asl r0,r1,31 ; encoding: [0x40,0x29,0xc0,0x07]
+	asl r0,r1,31
+; CHECK: asr r0,r1,3 ; encoding: [0x42,0x29,0xc0,0x00]
+	asr r0,r1,3
+
+; Register-s12 format (P = 10), with the destination as the first source.
+; CHECK: add r0,r0,-2048 ; encoding: [0x80,0x20,0x20,0x00]
+	add r0,r0,-2048
+; CHECK: add r0,r0,2047 ; encoding: [0x80,0x20,0xdf,0x0f]
+	add r0,r0,2047
+; CHECK: sub sp,sp,64 ; encoding: [0x82,0x24,0x01,0x30]
+	sub sp,sp,64
+; CHECK: add sp,sp,2047 ; encoding: [0x80,0x24,0xdf,0x3f]
+	add sp,sp,2047
+
+; Conditional format (P = 11).
+; CHECK: add.eq r0,r0,r1 ; encoding: [0xc0,0x20,0x41,0x00]
+	add.eq r0,r0,r1
+; CHECK: add.ne r0,r0,5 ; encoding: [0xc0,0x20,0x62,0x01]
+	add.ne r0,r0,5
+; CHECK: sub.lt r3,r3,r4 ; encoding: [0xc2,0x23,0x0b,0x01]
+	sub.lt r3,r3,r4
+; CHECK: mov.ge r0,r1 ; encoding: [0xca,0x20,0x4a,0x00]
+	mov.ge r0,r1
+; CHECK: mov.hi r0,63 ; encoding: [0xca,0x20,0xed,0x0f]
+	mov.hi r0,63
+
+; Single operand and move instructions.
+; CHECK: mov r0,r1 ; encoding: [0x0a,0x20,0x40,0x00]
+	mov r0,r1
+; CHECK: mov r0,63 ; encoding: [0x4a,0x20,0xc0,0x0f]
+	mov r0,63
+; CHECK: mov r0,-2048 ; encoding: [0x8a,0x20,0x20,0x00]
+	mov r0,-2048
+; CHECK: mov fp,sp ; encoding: [0x0a,0x23,0x00,0x37]
+	mov fp,sp
+; CHECK: extb r0,r1 ; encoding: [0x2f,0x20,0x47,0x00]
+	extb r0,r1
+; CHECK: extw r0,r1 ; encoding: [0x2f,0x20,0x48,0x00]
+	extw r0,r1
+; CHECK: sexb r0,r1 ; encoding: [0x2f,0x20,0x45,0x00]
+	sexb r0,r1
+; CHECK: sexw r0,r1 ; encoding: [0x2f,0x20,0x46,0x00]
+	sexw r0,r1
+; CHECK: abs r0,r1 ; encoding: [0x2f,0x20,0x49,0x00]
+	abs r0,r1
+; CHECK: not r0,r1 ; encoding: [0x2f,0x20,0x4a,0x00]
+	not r0,r1
+; CHECK: neg r0,r1 ; encoding: [0x4e,0x21,0x00,0x00]
+	neg r0,r1
+
+; Compares set the flags and have no destination.
+; CHECK: cmp r0,r1 ; encoding: [0x0c,0x20,0x40,0x80]
+	cmp r0,r1
+; CHECK: cmp r0,63 ; encoding: [0x4c,0x20,0xc0,0x8f]
+	cmp r0,63
+
+; Loads and stores with a register + s9 address.
+; CHECK: ld r0,[r1,255] ; encoding: [0xff,0x11,0x00,0x00]
+	ld r0,[r1,255]
+; CHECK: ld r0,[r1,-256] ; encoding: [0x00,0x11,0x00,0x80]
+	ld r0,[r1,-256]
+; CHECK: ld r0,[r1,r2] ; encoding: [0x30,0x21,0x80,0x00]
+	ld r0,[r1,r2]
+; CHECK: ld.ab r0,[r1,4] ; encoding: [0x04,0x11,0x00,0x04]
+	ld.ab r0,[r1,4]
+; CHECK: ld.a r0,[r1,-4] ; encoding: [0xfc,0x11,0x00,0x82]
+	ld.a r0,[r1,-4]
+; CHECK: ldb r0,[r1,1] ; encoding: [0x01,0x11,0x80,0x00]
+	ldb r0,[r1,1]
+; CHECK: ldb.x r0,[r1,1] ; encoding: [0x01,0x11,0xc0,0x00]
+	ldb.x r0,[r1,1]
+; CHECK: ldw r0,[r1,2] ; encoding: [0x02,0x11,0x00,0x01]
+	ldw r0,[r1,2]
+; CHECK: ldw.x r0,[r1,2] ; encoding: [0x02,0x11,0x40,0x01]
+	ldw.x r0,[r1,2]
+; CHECK: st r0,[r1,8] ; encoding: [0x08,0x19,0x00,0x00]
+	st r0,[r1,8]
+; CHECK: st.a r0,[sp,-4] ; encoding: [0xfc,0x1c,0x08,0xb0]
+	st.a r0,[sp,-4]
+; CHECK: stb r0,[r1,1] ; encoding: [0x01,0x19,0x02,0x00]
+	stb r0,[r1,1]
+; CHECK: stw r0,[r1,-2] ; encoding: [0xfe,0x19,0x04,0x80]
+	stw r0,[r1,-2]
+
+; Jumps.
+; CHECK: j [blink] ; encoding: [0x20,0x20,0xc0,0x07]
+	j [blink]
+; CHECK: j.d [blink] ; encoding: [0x21,0x20,0xc0,0x07]
+	j.d [blink]
+; CHECK: jl [r1] ; encoding: [0x22,0x20,0x40,0x00]
+	jl [r1]
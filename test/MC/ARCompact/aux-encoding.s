@@ -0,0 +1,31 @@
+; RUN: llvm-mc -triple=arcompact -show-encoding %s | FileCheck %s
+
+; Auxiliary register moves. The auxiliary register goes in the C field, and
+; is written by name where it has one.
+
+; CHECK: lr r0,[lp_start] ; encoding: [0x6a,0x20,0x80,0x00]
+	lr r0,[lp_start]
+; CHECK: lr r1,[lp_end] ; encoding: [0x6a,0x21,0xc0,0x00]
+	lr r1,[LP_END]
+; CHECK: lr r4,[mulhi] ; encoding: [0x6a,0x24,0x80,0x04]
+	lr r4,[0x12]
+; CHECK: lr r2,[r3] ; encoding: [0x2a,0x22,0xc0,0x00]
+	lr r2,[r3]
+; CHECK: lr r5,[1024] ; encoding: [0x2a,0x25,0x80,0x0f,0x00,0x00,0x00,0x04]
+	lr r5,[0x400]
+
+; SR takes the value to write in the B field.
+; CHECK: sr r0,[lp_start] ; encoding: [0x6b,0x20,0x80,0x00]
+	sr r0,[lp_start]
+; CHECK: sr r4,[mulhi] ; encoding: [0x6b,0x24,0x80,0x04]
+	sr r4,[mulhi]
+; CHECK: sr r2,[r3] ; encoding: [0x2b,0x22,0xc0,0x00]
+	sr r2,[r3]
+; CHECK: sr r5,[1024] ; encoding: [0x2b,0x25,0x80,0x0f,0x00,0x00,0x00,0x04]
+	sr r5,[0x400]
+
+; The loop count is read as a core register, and MLO written by a multiply.
+; CHECK: mov r6,lp_count ; encoding: [0x0a,0x26,0x00,0x0f]
+	mov r6,lp_count
+; CHECK: mulu64 r7,1 ; encoding: [0x45,0x2f,0x7e,0x00]
+	mulu64 r7,1
@@ -0,0 +1,45 @@
+; RUN: llvm-mc -triple=arcompact -filetype=obj %s -o - \
+; RUN:   | llvm-objdump -r - | FileCheck %s
+
+; Fixups against undefined symbols become RELA relocations. Long immediates
+; are middle endian, and unresolved 16-bit branches are relaxed first.
+
+; CHECK: RELOCATION RECORDS FOR [.text]:
+	.text
+; CHECK-NEXT: 4 R_ARC_32_ME sym+0
+; CHECK-NEXT: 12 R_ARC_32_ME sym+8
+	mov r0,sym
+	add r0,r1,sym+8
+
+; CHECK-NEXT: 16 R_ARC_SDA_LDST2 g+0
+; CHECK-NEXT: 20 R_ARC_SDA_LDST1 g+0
+; CHECK-NEXT: 24 R_ARC_SDA_LDST g+0
+	ld.as r2,[gp,@g@sda]
+	ldw.as r2,[gp,@g@sda]
+	ldb r2,[gp,@g@sda]
+
+; CHECK-NEXT: 28 R_ARC_S25H_PCREL sym+0
+; CHECK-NEXT: 34 R_ARC_S21H_PCREL sym+0
+; CHECK-NEXT: 40 R_ARC_S25W_PCREL sym+0
+	b.d @sym
+	nop_s
+	bne.d @sym
+	nop_s
+	bl.d @sym
+	nop_s
+
+; CHECK-NEXT: 46 R_ARC_S25W_PCREL sym+0
+; CHECK-NEXT: 50 R_ARC_S25H_PCREL sym+0
+; CHECK-NEXT: 54 R_ARC_S21H_PCREL sym+0
+	bl_s @sym
+	b_s @sym
+	bgt_s @sym
+
+; CHECK: RELOCATION RECORDS FOR [.data]:
+	.data
+; CHECK-NEXT: 0 R_ARC_32 sym+0
+; CHECK-NEXT: 4 R_ARC_16 sym+0
+; CHECK-NEXT: 6 R_ARC_8 sym+0
+	.long sym
+	.short sym
+	.byte sym
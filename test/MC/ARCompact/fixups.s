@@ -0,0 +1,78 @@
+; RUN: llvm-mc -triple=arcompact -show-encoding %s | FileCheck %s
+
+; Symbols in a long immediate.
+; CHECK: mov r0,sym ; encoding: [0x0a,0x20,0x80,0x0f,A,A,A,A]
+; CHECK-NEXT: ; fixup A - offset: 4, value: sym, kind: fixup_arc_limm
+	mov r0,sym
+; CHECK: add r0,r1,sym+8 ; encoding: [0x00,0x21,0x80,0x0f,A,A,A,A]
+; CHECK-NEXT: ; fixup A - offset: 4, value: sym+8, kind: fixup_arc_limm
+	add r0,r1,sym+8
+; CHECK: ld r0,[sym] ; encoding: [0x00,0x16,0x00,0x70,A,A,A,A]
+; CHECK-NEXT: ; fixup A - offset: 4, value: sym, kind: fixup_arc_limm
+	ld r0,[sym]
+; CHECK: st r0,[sym] ; encoding: [0x00,0x1e,0x00,0x70,A,A,A,A]
+; CHECK-NEXT: ; fixup A - offset: 4, value: sym, kind: fixup_arc_limm
+	st r0,[sym]
+
+; Small data accesses relative to GP, scaled by the size of the access for
+; the .as forms.
+; CHECK: ld.as r2,[gp,@g@sda] ; encoding: [A,0x12'A',0x02'A',0x36'A']
+; CHECK-NEXT: ; fixup A - offset: 0, value: g, kind: fixup_arc_sda_ldst2
+	ld.as r2,[gp,@g@sda]
+; CHECK: ldw.as r2,[gp,@g@sda] ; encoding: [A,0x12'A',0x02'A',0x37'A']
+; CHECK-NEXT: ; fixup A - offset: 0, value: g, kind: fixup_arc_sda_ldst1
+	ldw.as r2,[gp,@g@sda]
+; CHECK: ldb r2,[gp,@g@sda] ; encoding: [A,0x12'A',0x82'A',0x30'A']
+; CHECK-NEXT: ; fixup A - offset: 0, value: g, kind: fixup_arc_sda_ldst
+	ldb r2,[gp,@g@sda]
+; CHECK: st.as r2,[gp,@g@sda] ; encoding: [A,0x1a'A',0x98'A',0x30'A']
+; CHECK-NEXT: ; fixup A - offset: 0, value: g, kind: fixup_arc_sda_ldst2
+	st.as r2,[gp,@g@sda]
+
+; 32-bit branches and calls.
+; CHECK: b.d @sym ; encoding: [0x01'A',A,0x20'A',A]
+; CHECK-NEXT: ; fixup A - offset: 0, value: sym, kind: fixup_arc_s25h_pcrel
+	b.d @sym
+; CHECK: bne.d @sym ; encoding: [A,A,0x22'A',A]
+; CHECK-NEXT: ; fixup A - offset: 0, value: sym, kind: fixup_arc_s21h_pcrel
+	bne.d @sym
+; CHECK: bl.d @sym ; encoding: [0x02'A',0x08'A',0x20'A',A]
+; CHECK-NEXT: ; fixup A - offset: 0, value: sym, kind: fixup_arc_s25w_pcrel
+	bl.d @sym
+
+; 16-bit branches and calls, which are relaxed if the target is too far.
+; CHECK: b_s @sym ; encoding: [A,0xf0'A']
+; CHECK-NEXT: ; fixup A - offset: 0, value: sym, kind: fixup_arc_s10h_pcrel
+	b_s @sym
+; CHECK: beq_s @sym ; encoding: [A,0xf2'A']
+; CHECK-NEXT: ; fixup A - offset: 0, value: sym, kind: fixup_arc_s10h_pcrel
+	beq_s @sym
+; CHECK: bne_s @sym ; encoding: [A,0xf4'A']
+; CHECK-NEXT: ; fixup A - offset: 0, value: sym, kind: fixup_arc_s10h_pcrel
+	bne_s @sym
+; CHECK: bgt_s @sym ; encoding: [A,0xf6'A']
+; CHECK-NEXT: ; fixup A - offset: 0, value: sym, kind: fixup_arc_s7h_pcrel
+	bgt_s @sym
+; CHECK: bl_s @sym ; encoding: [A,0xf8'A']
+; CHECK-NEXT: ; fixup A - offset: 0, value: sym, kind: fixup_arc_s13w_pcrel
+	bl_s @sym
+
+; Compare and branch, and the zero-overhead loop.
+; CHECK: breq r0,r1,@sym ; encoding: [0x01'A',0x08'A',0x40'A',A]
+; CHECK-NEXT: ; fixup A - offset: 0, value: sym, kind: fixup_arc_s9h_pcrel
+	breq r0,r1,@sym
+; CHECK: brne r0,63,@sym ; encoding: [0x01'A',0x08'A',0xd1'A',0x0f'A']
+; CHECK-NEXT: ; fixup A - offset: 0, value: sym, kind: fixup_arc_s9h_pcrel
+	brne r0,63,@sym
+; CHECK: brlt.d r0,r1,@sym ; encoding: [0x01'A',0x08'A',0x62'A',A]
+; CHECK-NEXT: ; fixup A - offset: 0, value: sym, kind: fixup_arc_s9h_pcrel
+	brlt.d r0,r1,@sym
+; CHECK: bbit0 r0,31,@sym ; encoding: [0x01'A',0x08'A',0xde'A',0x07'A']
+; CHECK-NEXT: ; fixup A - offset: 0, value: sym, kind: fixup_arc_s9h_pcrel
+	bbit0 r0,31,@sym
+; CHECK: bbit1 r0,0,@sym ; encoding: [0x01'A',0x08'A',0x1f'A',A]
+; CHECK-NEXT: ; fixup A - offset: 0, value: sym, kind: fixup_arc_s9h_pcrel
+	bbit1 r0,0,@sym
+; CHECK: lp @sym ; encoding: [0xa8'A',0x20'A',A,A]
+; CHECK-NEXT: ; fixup A - offset: 0, value: sym, kind: fixup_arc_s13h_pcrel
+	lp @sym
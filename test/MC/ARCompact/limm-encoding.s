@@ -0,0 +1,47 @@
+; RUN: llvm-mc -triple=arcompact -show-encoding %s | FileCheck %s
+
+; Immediates which do not fit an s12 or u6 field take the long immediate
+; form, with the limm in the following word.
+; CHECK: sub sp,sp,12004 ; encoding: [0x02,0x24,0x9c,0x3f,0x00,0x00,0xe4,0x2e]
+	sub sp,sp,12004
+; CHECK: add sp,sp,2048 ; encoding: [0x00,0x24,0x9c,0x3f,0x00,0x00,0x00,0x08]
+	add sp,sp,2048
+; CHECK: add r0,r1,64 ; encoding: [0x00,0x21,0x80,0x0f,0x00,0x00,0x40,0x00]
+	add r0,r1,64
+; CHECK: add r0,r1,-1 ; encoding: [0x00,0x21,0x80,0x0f,0xff,0xff,0xff,0xff]
+	add r0,r1,-1
+; CHECK: add r0,r1,305419896 ; encoding: [0x00,0x21,0x80,0x0f,0x34,0x12,0x78,0x56]
+	add r0,r1,0x12345678
+; CHECK: and r0,r1,4294901760 ; encoding: [0x04,0x21,0x80,0x0f,0xff,0xff,0x00,0x00]
+	and r0,r1,0xffff0000
+; CHECK: sub r0,r0,4096 ; encoding: [0x02,0x20,0x80,0x0f,0x00,0x00,0x00,0x10]
+	sub r0,r0,4096
+; CHECK: mov r0,2048 ; encoding: [0x0a,0x20,0x80,0x0f,0x00,0x00,0x00,0x08]
+	mov r0,2048
+; CHECK: mov r0,2147483648 ; encoding: [0x0a,0x20,0x80,0x0f,0x00,0x80,0x00,0x00]
+	mov r0,0x80000000
+; CHECK: mov.eq r0,305419896 ; encoding: [0xca,0x20,0x81,0x0f,0x34,0x12,0x78,0x56]
+	mov.eq r0,0x12345678
+; CHECK: cmp r0,305419896 ; encoding: [0x0c,0x20,0x80,0x8f,0x34,0x12,0x78,0x56]
+	cmp r0,0x12345678
+; CHECK: mov_s r0,4096 ; encoding: [0xcf,0x70,0x00,0x00,0x00,0x10]
+	mov_s r0,4096
+; CHECK: add_s r0,r0,4096 ; encoding: [0xc7,0x70,0x00,0x00,0x00,0x10]
+	add_s r0,r0,4096
+; CHECK: cmp_s r0,4096 ; encoding: [0xd7,0x70,0x00,0x00,0x00,0x10]
+	cmp_s r0,4096
+
+; A limm in the first source.
+; CHECK: sub r0,305419896,r1 ; encoding: [0x02,0x26,0x40,0x70,0x34,0x12,0x78,0x56]
+	sub r0,0x12345678,r1
+; CHECK: asr r0,2147483648,r1 ; encoding: [0x02,0x2e,0x40,0x70,0x00,0x80,0x00,0x00]
+	asr r0,0x80000000,r1
+
+; Loads and stores from absolute and far addresses.
+; CHECK: ld r0,[4096] ; encoding: [0x00,0x16,0x00,0x70,0x00,0x00,0x00,0x10]
+	ld r0,[0x1000]
+; CHECK: st r0,[4096] ; encoding: [0x00,0x1e,0x00,0x70,0x00,0x00,0x00,0x10]
+	st r0,[0x1000]
+; CHECK: st 305419896,[r1,4] ; encoding: [0x04,0x19,0x80,0x0f,0x34,0x12,0x78,0x56]
+	st 0x12345678,[r1,4]
+
@@ -0,0 +1,41 @@
+; RUN: llvm-mc -triple=arcompact -filetype=obj %s -o - \
+; RUN:   | llvm-objdump -d - | FileCheck %s
+
+; 16-bit branches stay 16-bit while their target is in range, and are relaxed
+; to the 32-bit forms otherwise. Displacements are from the word aligned PC.
+
+	.text
+start:
+; CHECK:      0: 00 f0 b_s @0
+; CHECK-NEXT: 2: 00 f2 beq_s @0
+; CHECK-NEXT: 4: 3e f6 bgt_s @-4
+; CHECK-NEXT: 6: ff ff bl_s @-4
+	b_s @start
+	beq_s @start
+	bgt_s @start
+	bl_s @start
+
+; CHECK-NEXT: 8: 0a f0 b_s @20
+; CHECK-NEXT: a: 0a f6 bgt_s @20
+	b_s @near
+	bgt_s @near
+
+; CHECK-NEXT: c: 13 04 00 00 b @1042
+; CHECK-NEXT: 10: 0e 04 02 00 bne @1038
+; CHECK-NEXT: 14: 0a 04 0c 00 ble @1034
+; CHECK-NEXT: 18: 0a 0c 80 00 bl @5128
+	b_s @far
+	bne_s @far
+	ble_s @far
+	bl_s @farfunc
+
+; CHECK-NEXT: 1c: e0 78 nop_s
+near:
+	nop_s
+	.space 1024
+far:
+	nop_s
+	.space 4096
+	.align 4
+farfunc:
+	j_s [blink]
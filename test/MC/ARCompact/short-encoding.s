@@ -0,0 +1,114 @@
+; RUN: llvm-mc -triple=arcompact -show-encoding %s | FileCheck %s
+
+; The 16-bit instruction formats, which are stored as a single little endian
+; half-word.
+
+; Three register and register + u3 ADD_S/SUB_S.
+; CHECK: add_s r0,r1,r2 ; encoding: [0x58,0x61]
+	add_s r0,r1,r2
+; CHECK: add_s r12,r13,r14 ; encoding: [0xdc,0x65]
+	add_s r12,r13,r14
+; CHECK: add_s r0,r1,7 ; encoding: [0x07,0x69]
+	add_s r0,r1,7
+; CHECK: sub_s r0,r1,7 ; encoding: [0x0f,0x69]
+	sub_s r0,r1,7
+
+; Two register and register + u5/u7 forms.
+; CHECK: add_s r0,r0,127 ; encoding: [0x7f,0xe0]
+	add_s r0,r0,127
+; CHECK: sub_s r1,r1,r2 ; encoding: [0x42,0x79]
+	sub_s r1,r1,r2
+; CHECK: sub_s r1,r1,31 ; encoding: [0x7f,0xb9]
+	sub_s r1,r1,31
+; CHECK: and_s r0,r0,r1 ; encoding: [0x24,0x78]
+	and_s r0,r0,r1
+; CHECK: or_s r2,r2,r3 ; encoding: [0x65,0x7a]
+	or_s r2,r2,r3
+; CHECK: xor_s r0,r0,r1 ; encoding: [0x27,0x78]
+	xor_s r0,r0,r1
+; CHECK: asl_s r0,r0,r1 ; encoding: [0x38,0x78]
+	asl_s r0,r0,r1
+; CHECK: asl_s r0,r1,3 ; encoding: [0x13,0x69]
+	asl_s r0,r1,3
+; CHECK: asr_s r0,r0,31 ; encoding: [0x5f,0xb8]
+	asr_s r0,r0,31
+; CHECK: lsr_s r3,r3,1 ; encoding: [0x21,0xbb]
+	lsr_s r3,r3,1
+; CHECK: bclr_s r0,r0,31 ; encoding: [0xbf,0xb8]
+	bclr_s r0,r0,31
+; CHECK: bset_s r0,r0,0 ; encoding: [0x80,0xb8]
+	bset_s r0,r0,0
+; CHECK: bmsk_s r0,r0,7 ; encoding: [0xc7,0xb8]
+	bmsk_s r0,r0,7
+
+; Single operand forms.
+; CHECK: abs_s r0,r1 ; encoding: [0x31,0x78]
+	abs_s r0,r1
+; CHECK: neg_s r0,r1 ; encoding: [0x33,0x78]
+	neg_s r0,r1
+; CHECK: not_s r0,r1 ; encoding: [0x32,0x78]
+	not_s r0,r1
+; CHECK: extb_s r0,r1 ; encoding: [0x2f,0x78]
+	extb_s r0,r1
+; CHECK: extw_s r0,r1 ; encoding: [0x30,0x78]
+	extw_s r0,r1
+; CHECK: sexb_s r0,r1 ; encoding: [0x2d,0x78]
+	sexb_s r0,r1
+; CHECK: sexw_s r0,r1 ; encoding: [0x2e,0x78]
+	sexw_s r0,r1
+
+; Moves and compares, which reach all 64 registers through the h field.
+; CHECK: mov_s r0,r1 ; encoding: [0x28,0x70]
+	mov_s r0,r1
+; CHECK: mov_s r0,fp ; encoding: [0x6b,0x70]
+	mov_s r0,fp
+; CHECK: mov_s r0,255 ; encoding: [0xff,0xd8]
+	mov_s r0,255
+; CHECK: cmp_s r0,r1 ; encoding: [0x30,0x70]
+	cmp_s r0,r1
+; CHECK: cmp_s r0,127 ; encoding: [0xff,0xe0]
+	cmp_s r0,127
+
+; Stack pointer forms take a word aligned u7.
+; CHECK: add_s sp,sp,124 ; encoding: [0xbf,0xc0]
+	add_s sp,sp,124
+; CHECK: sub_s sp,sp,4 ; encoding: [0xa1,0xc1]
+	sub_s sp,sp,4
+; CHECK: add_s r0,sp,64 ; encoding: [0x90,0xc0]
+	add_s r0,sp,64
+; CHECK: push_s blink ; encoding: [0xf1,0xc0]
+	push_s blink
+; CHECK: pop_s blink ; encoding: [0xd1,0xc0]
+	pop_s blink
+; CHECK: push_s r13 ; encoding: [0xe1,0xc5]
+	push_s r13
+; CHECK: pop_s r14 ; encoding: [0xc1,0xc6]
+	pop_s r14
+
+; Loads and stores with a short base and a scaled u5 offset.
+; CHECK: ld_s r0,[r1,124] ; encoding: [0x1f,0x81]
+	ld_s r0,[r1,124]
+; CHECK: ldw_s r0,[r1,62] ; encoding: [0x1f,0x91]
+	ldw_s r0,[r1,62]
+; CHECK: ldb_s r0,[r1,31] ; encoding: [0x1f,0x89]
+	ldb_s r0,[r1,31]
+; CHECK: st_s r0,[r1,4] ; encoding: [0x01,0xa1]
+	st_s r0,[r1,4]
+; CHECK: stw_s r0,[r1,2] ; encoding: [0x01,0xb1]
+	stw_s r0,[r1,2]
+; CHECK: stb_s r0,[r1,1] ; encoding: [0x01,0xa9]
+	stb_s r0,[r1,1]
+; CHECK: ld_s r0,[r1,r2] ; encoding: [0x40,0x61]
+	ld_s r0,[r1,r2]
+; CHECK: ld_s r0,[sp,124] ; encoding: [0x1f,0xc0]
+	ld_s r0,[sp,124]
+; CHECK: st_s r0,[sp] ; encoding: [0x40,0xc0]
+	st_s r0,[sp,0]
+
+; Jumps.
+; CHECK: j_s [blink] ; encoding: [0xe0,0x7e]
+	j_s [blink]
+; CHECK: j_s [r1] ; encoding: [0x00,0x79]
+	j_s [r1]
+; CHECK: jl_s [r1] ; encoding: [0x40,0x79]
+	jl_s [r1]
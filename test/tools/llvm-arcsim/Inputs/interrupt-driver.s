@@ -0,0 +1,35 @@
+; Runs a zero-overhead loop which is interrupted on each of its iterations,
+; by branching to the level 2 handler isr with the return address in ILINK2,
+; and then prints the iterations and the multiply result registers.
+
+	.text
+	.globl main
+	.align 4
+main:
+	push_s blink
+	mov r2,0x12345678
+	mov r3,0x9abcdef0
+	mulu64 r2,r3
+	mov r14,0
+	mov r0,5
+	mov lp_count,r0
+	lp @done
+	add r14,r14,1
+	mov ilink2,resume
+	b @isr
+resume:
+	add r14,r14,0
+done:
+	mov r0,fmt
+	mov r1,r14
+	mov r2,mlo
+	mov r3,mmid
+	bl.d @printf
+	mov r4,mhi
+	mov r0,0
+	pop_s blink
+	j_s [blink]
+
+	.data
+fmt:
+	.asciz "iterations %d mlo %x mmid %x mhi %x\n"
@@ -0,0 +1,86 @@
+; RUN: llc -march=arcompact %s -o %t.s
+; RUN: llvm-arcsim -quiet %t.s | FileCheck %s
+; RUN: llc -march=arcompact -mcpu=encore-dsp %s -o %t1.s
+; RUN: llvm-arcsim -quiet -mcpu=encore-dsp %t1.s | FileCheck %s
+; RUN: llc -march=arcompact -mcpu=encore-dsp -mattr=-barrel-shifter %s -o %t2.s
+; RUN: llvm-arcsim -quiet -mcpu=encore-dsp -mattr=-barrel-shifter %t2.s \
+; RUN:   | FileCheck %s
+; RUN: llc -march=arcompact -mattr=-barrel-shifter,-mpy %s -o %t3.s
+; RUN: llvm-arcsim -quiet -mattr=-barrel-shifter,-mpy %t3.s | FileCheck %s
+
+; The saturating intrinsics, NORM and the bit counting and byte reversal
+; operations give the same answers with and without the instructions for
+; them.
+
+@fmt = private constant [16 x i8] c"%x %x %x %x %x\0A\00"
+@as = global [6 x i32] [i32 0, i32 1, i32 2147483647, i32 -2147483648,
+                        i32 305419896, i32 -6]
+@bs = global [6 x i32] [i32 0, i32 2147483647, i32 1, i32 -1,
+                        i32 1879048192, i32 -2147483648]
+
+declare i32 @printf(i8*, ...)
+declare i32 @llvm.arc.adds(i32, i32) nounwind readnone
+declare i32 @llvm.arc.subs(i32, i32) nounwind readnone
+declare i32 @llvm.arc.abss(i32) nounwind readnone
+declare i32 @llvm.arc.negs(i32) nounwind readnone
+declare i32 @llvm.arc.norm(i32) nounwind readnone
+declare i32 @llvm.ctlz.i32(i32, i1) nounwind readnone
+declare i32 @llvm.cttz.i32(i32, i1) nounwind readnone
+declare i32 @llvm.ctpop.i32(i32) nounwind readnone
+declare i32 @llvm.bswap.i32(i32) nounwind readnone
+declare i16 @llvm.bswap.i16(i16) nounwind readnone
+
+define void @print(i32 %a, i32 %b, i32 %c, i32 %d, i32 %e) nounwind noinline {
+  %f = getelementptr [16 x i8]* @fmt, i32 0, i32 0
+  call i32 (i8*, ...)* @printf(i8* %f, i32 %a, i32 %b, i32 %c, i32 %d, i32 %e)
+  ret void
+}
+
+define i32 @main() nounwind {
+entry:
+  br label %sat
+; CHECK: 0 0 0 0 1f
+; CHECK-NEXT: 7fffffff 80000002 1 ffffffff 1e
+; CHECK-NEXT: 7fffffff 7ffffffe 7fffffff 80000001 0
+; CHECK-NEXT: 80000000 80000001 7fffffff 7fffffff 0
+; CHECK-NEXT: 7fffffff a2345678 12345678 edcba988 2
+; CHECK-NEXT: 80000000 7ffffffa 6 6 1c
+sat:
+  %i = phi i32 [0, %entry], [%i1, %sat]
+  %pa = getelementptr [6 x i32]* @as, i32 0, i32 %i
+  %pb = getelementptr [6 x i32]* @bs, i32 0, i32 %i
+  %a = load i32* %pa
+  %b = load i32* %pb
+  %adds = call i32 @llvm.arc.adds(i32 %a, i32 %b)
+  %subs = call i32 @llvm.arc.subs(i32 %a, i32 %b)
+  %abss = call i32 @llvm.arc.abss(i32 %a)
+  %negs = call i32 @llvm.arc.negs(i32 %a)
+  %norm = call i32 @llvm.arc.norm(i32 %a)
+  call void @print(i32 %adds, i32 %subs, i32 %abss, i32 %negs, i32 %norm)
+  %i1 = add i32 %i, 1
+  %d = icmp eq i32 %i1, 6
+  br i1 %d, label %bits, label %sat
+; CHECK-NEXT: 20 20 0 0 0
+; CHECK-NEXT: 1f 0 1 1000000 100
+; CHECK-NEXT: 1 0 1f ffffff7f ffff
+; CHECK-NEXT: 0 1f 1 80 0
+; CHECK-NEXT: 3 3 d 78563412 7856
+; CHECK-NEXT: 0 1 1e faffffff faff
+bits:
+  %j = phi i32 [0, %sat], [%j1, %bits]
+  %pc = getelementptr [6 x i32]* @as, i32 0, i32 %j
+  %c = load i32* %pc
+  %ctlz = call i32 @llvm.ctlz.i32(i32 %c, i1 false)
+  %cttz = call i32 @llvm.cttz.i32(i32 %c, i1 false)
+  %ctpop = call i32 @llvm.ctpop.i32(i32 %c)
+  %bswap = call i32 @llvm.bswap.i32(i32 %c)
+  %h = trunc i32 %c to i16
+  %hswap = call i16 @llvm.bswap.i16(i16 %h)
+  %hz = zext i16 %hswap to i32
+  call void @print(i32 %ctlz, i32 %cttz, i32 %ctpop, i32 %bswap, i32 %hz)
+  %j1 = add i32 %j, 1
+  %e = icmp eq i32 %j1, 6
+  br i1 %e, label %exit, label %bits
+exit:
+  ret i32 0
+}
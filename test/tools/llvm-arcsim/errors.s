@@ -0,0 +1,11 @@
+; RUN: not llvm-arcsim -quiet %s |& FileCheck %s
+
+; Words which do not decode as an ARCompact instruction, such as this one
+; from the extension opcode space, stop the program.
+
+; CHECK: illegal instruction at pc 0x1000
+	.text
+	.globl main
+	.align 4
+main:
+	.byte 0x00,0x30,0x00,0x00
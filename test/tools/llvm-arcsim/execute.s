@@ -0,0 +1,114 @@
+; RUN: llvm-arcsim -quiet -trace -mattr=+swap %s |& FileCheck %s
+
+; Assembly input is assembled in memory, and each instruction is decoded by
+; the ARCompact disassembler. The trace prints it with the instruction
+; printer, along with the registers it writes.
+
+	.text
+	.globl main
+	.align 4
+main:
+	push_s blink
+
+; General instructions, flags and predication.
+; CHECK: mov r0,5 r0=00000005
+; CHECK: add_s r1,r0,7 r1=0000000c
+; CHECK: sub.f r4,r0,r1 r4=fffffff9
+; CHECK: mov.lt r3,1 r3=00000001
+; CHECK-NOT: r3=
+; CHECK: asl r2,r1,3 r2=00000060
+; CHECK: bmsk_s r2,r2,5 r2=00000020
+; CHECK: max r5,r4,r0 r5=00000005
+; CHECK: mov r6,305419896 r6=12345678
+; CHECK: swap r7,r6 r7=56781234
+	mov r0,5
+	add_s r1,r0,7
+	sub.f r4,r0,r1
+	mov.lt r3,1
+	mov.ge r3,2
+	asl r2,r1,3
+	bmsk_s r2,r2,5
+	max r5,r4,r0
+	mov r6,0x12345678
+	swap r7,r6
+
+; Loads and stores, with address write back.
+; CHECK: ld.ab r9,[r8,4] r8={{[0-9a-f]+}} r9=0000000b
+; CHECK: ldb.x r10,[r8] r10=ffffff80
+; CHECK: st.a r1,[r8,4] r8=
+; CHECK: pop_s r12 r12=00000005
+	mov r8,data
+	ld.ab r9,[r8,4]
+	ldb.x r10,[r8,0]
+	st.a r1,[r8,4]
+	push_s r0
+	pop_s r12
+
+; A zero-overhead loop runs its body LP_COUNT times.
+; CHECK: mov lp_count,r11 r60=00000004
+; CHECK: add_s r0,r0,3 r0=00000003
+; CHECK: add_s r0,r0,3 r0=00000006
+; CHECK: add_s r0,r0,3 r0=00000009
+; CHECK: add_s r0,r0,3 r0=0000000c
+; CHECK-NOT: add_s r0,r0,3
+	mov r0,0
+	mov r11,4
+	mov lp_count,r11
+	lp @done
+	add_s r0,r0,3
+done:
+
+; Calls, with and without delay slots.
+; CHECK: bl.d
+; CHECK: nop_s
+; CHECK: j_s.d [blink] taken
+; CHECK: asl_s r0,r0,1 r0=00000018
+	bl.d @twice
+	nop_s
+
+; Code which is written to is decoded again.
+; CHECK: mov r0,1 r0=00000001
+; CHECK: st r9,[r10]
+; CHECK: mov r0,42 r0=0000002a
+	mov r13,r0
+	bl @slot
+	add r13,r13,r0
+	mov r8,patch
+	ld r9,[r8]
+	mov r10,slot
+	st r9,[r10]
+	bl @slot
+	add r0,r13,r0
+
+; CHECK: breq r0,0,@14 taken
+; CHECK: host call <return>
+	sub r0,r0,67
+	breq r0,0,@ok
+	mov r0,1
+	pop_s blink
+	j_s [blink]
+ok:
+	mov_s r0,0
+	pop_s blink
+	j_s [blink]
+
+	.align 4
+slot:
+	mov r0,1
+	j_s [blink]
+
+	.align 4
+patch:
+	mov r0,42
+
+	.align 4
+twice:
+	j_s.d [blink]
+	asl_s r0,r0,1
+
+	.data
+	.align 4
+data:
+	.long 11
+	.long 0x80
+	.long 0
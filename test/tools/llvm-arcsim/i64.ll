@@ -0,0 +1,115 @@
+; RUN: llc -march=arcompact %s -o %t.s
+; RUN: llvm-arcsim -quiet %t.s | FileCheck %s
+; RUN: llc -march=arcompact -O0 %s -o %t0.s
+; RUN: llvm-arcsim -quiet %t0.s | FileCheck %s
+; RUN: llc -march=arcompact -mattr=-mpy,+mul64 %s -o %t1.s
+; RUN: llvm-arcsim -quiet -mattr=-mpy,+mul64 %t1.s | FileCheck %s
+
+; The 64-bit shifts, compares and multiplies give the right answers.
+
+@fmt = private constant [10 x i8] c"%x %x %x\0A\00"
+@amounts = global [6 x i64] [i64 0, i64 1, i64 31, i64 32, i64 33, i64 63]
+
+declare i32 @printf(i8*, ...)
+
+define void @print(i32 %tag, i64 %v) nounwind noinline {
+  %lo = trunc i64 %v to i32
+  %s = lshr i64 %v, 32
+  %hi = trunc i64 %s to i32
+  %f = getelementptr [10 x i8]* @fmt, i32 0, i32 0
+  call i32 (i8*, ...)* @printf(i8* %f, i32 %tag, i32 %hi, i32 %lo)
+  ret void
+}
+
+define i32 @cmps(i64 %a, i64 %b) nounwind noinline {
+  %lt = icmp slt i64 %a, %b
+  %ult = icmp ult i64 %a, %b
+  %gt = icmp sgt i64 %a, %b
+  %ule = icmp ule i64 %a, %b
+  %eq = icmp eq i64 %a, %b
+  %b0 = zext i1 %lt to i32
+  %b1 = zext i1 %ult to i32
+  %b2 = zext i1 %gt to i32
+  %b3 = zext i1 %ule to i32
+  %b4 = zext i1 %eq to i32
+  %s1 = shl i32 %b1, 1
+  %s2 = shl i32 %b2, 2
+  %s3 = shl i32 %b3, 3
+  %s4 = shl i32 %b4, 4
+  %o1 = or i32 %b0, %s1
+  %o2 = or i32 %o1, %s2
+  %o3 = or i32 %o2, %s3
+  %o4 = or i32 %o3, %s4
+  ret i32 %o4
+}
+
+define i32 @main() nounwind {
+entry:
+  br label %loop
+loop:
+  %i = phi i32 [0, %entry], [%i1, %loop]
+  %p = getelementptr [6 x i64]* @amounts, i32 0, i32 %i
+  %n = load i64* %p
+  %shl = shl i64 -8690466096661279831, %n
+  %lshr = lshr i64 -8690466096661279831, %n
+  %ashr = ashr i64 -8690466096661279831, %n
+  call void @print(i32 %i, i64 %shl)
+  call void @print(i32 %i, i64 %lshr)
+  call void @print(i32 %i, i64 %ashr)
+  %i1 = add i32 %i, 1
+  %d = icmp eq i32 %i1, 6
+  br i1 %d, label %exit, label %loop
+exit:
+  %c0 = call i32 @cmps(i64 -1, i64 1)
+  %c1 = call i32 @cmps(i64 4294967296, i64 4294967295)
+  %c2 = call i32 @cmps(i64 7, i64 7)
+  %c3 = call i32 @cmps(i64 -4294967296, i64 -1)
+  %c4 = shl i32 %c1, 8
+  %c5 = shl i32 %c2, 16
+  %c6 = shl i32 %c3, 24
+  %c7 = or i32 %c0, %c4
+  %c8 = or i32 %c7, %c5
+  %c9 = or i32 %c8, %c6
+  %cz = zext i32 %c9 to i64
+  call void @print(i32 17, i64 %cz)
+  %ua = zext i32 -559038737 to i64
+  %ub = zext i32 305419896 to i64
+  %um = mul i64 %ua, %ub
+  call void @print(i32 18, i64 %um)
+  %sa = sext i32 -559038737 to i64
+  %sb = sext i32 305419896 to i64
+  %sm = mul i64 %sa, %sb
+  call void @print(i32 19, i64 %sm)
+  %add = add i64 %um, %sm
+  %sub = sub i64 %sm, %um
+  call void @print(i32 20, i64 %add)
+  call void @print(i32 21, i64 %sub)
+  ret i32 0
+}
+
+; Each amount gives shl, lshr and ashr of 0x876543210fedcba9.
+; CHECK: 0 87654321 fedcba9
+; CHECK-NEXT: 0 87654321 fedcba9
+; CHECK-NEXT: 0 87654321 fedcba9
+; CHECK-NEXT: 1 eca8642 1fdb9752
+; CHECK-NEXT: 1 43b2a190 87f6e5d4
+; CHECK-NEXT: 1 c3b2a190 87f6e5d4
+; CHECK-NEXT: 2 87f6e5d4 80000000
+; CHECK-NEXT: 2 1 eca8642
+; CHECK-NEXT: 2 ffffffff eca8642
+; CHECK-NEXT: 3 fedcba9 0
+; CHECK-NEXT: 3 0 87654321
+; CHECK-NEXT: 3 ffffffff 87654321
+; CHECK-NEXT: 4 1fdb9752 0
+; CHECK-NEXT: 4 0 43b2a190
+; CHECK-NEXT: 4 ffffffff c3b2a190
+; CHECK-NEXT: 5 80000000 0
+; CHECK-NEXT: 5 0 1
+; CHECK-NEXT: 5 ffffffff ffffffff
+; Compare bits for (-1, 1), (1 << 32, (1 << 32) - 1), (7, 7) and
+; (-1 << 32, -1), then the products and their sum and difference.
+; CHECK-NEXT: 11 0 b180401
+; CHECK-NEXT: 12 fd5bdee 5621ca08
+; CHECK-NEXT: 13 fda16776 5621ca08
+; CHECK-NEXT: 14 d772564 ac439410
+; CHECK-NEXT: 15 edcba988 0
@@ -0,0 +1,49 @@
+; RUN: llc -march=arcompact -mattr=-mpy,+mul64 %s -o %t.s
+; RUN: llvm-arcsim -quiet -mattr=-mpy,+mul64 %t.s %p/Inputs/interrupt-driver.s \
+; RUN:   | FileCheck %s
+; RUN: llc -march=arcompact -mattr=-mpy,+mul64 -O0 %s -o %t0.s
+; RUN: llvm-arcsim -quiet -mattr=-mpy,+mul64 %t0.s %p/Inputs/interrupt-driver.s \
+; RUN:   | FileCheck %s
+
+; A handler which calls functions with a zero-overhead loop and a 64-bit
+; multiply leaves the loop and the multiply result of the interrupted code
+; as they were. The driver interrupts each iteration of its own loop.
+
+@count = global i32 0
+@table = global [8 x i32] zeroinitializer
+@wide = global i64 0
+
+define void @fill(i32 %n) nounwind noinline {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %next, %loop ]
+  %p = getelementptr [8 x i32]* @table, i32 0, i32 %i
+  %v = add i32 %i, %n
+  store i32 %v, i32* %p
+  %next = add i32 %i, 1
+  %done = icmp eq i32 %next, 8
+  br i1 %done, label %exit, label %loop
+
+exit:
+  ret void
+}
+
+define void @square(i32 %n) nounwind noinline {
+  %x = zext i32 %n to i64
+  %m = mul i64 %x, %x
+  store volatile i64 %m, i64* @wide
+  ret void
+}
+
+define arc_intr2cc void @isr() nounwind {
+  %v = load volatile i32* @count
+  %n = add i32 %v, 1
+  store volatile i32 %n, i32* @count
+  call void @fill(i32 %n)
+  call void @square(i32 %n)
+  ret void
+}
+
+; CHECK: iterations 5 mlo 242d2080 mmid ea4e242d mhi b00ea4e
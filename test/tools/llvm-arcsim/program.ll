@@ -0,0 +1,58 @@
+; RUN: llc -march=arcompact -filetype=obj %s -o %t.o
+; RUN: llvm-arcsim %t.o |& FileCheck %s
+; RUN: llc -march=arcompact %s -o %t.s
+; RUN: llvm-arcsim -quiet %t.s | FileCheck %s -check-prefix=ASM
+
+; The same program runs from the object llc writes and from its assembly.
+; Calls to printf go to the host, and the statistics follow the output.
+
+@fmt = private constant [10 x i8] c"%d %d %x\0A\00"
+@arr = global [8 x i32] [i32 3, i32 -1, i32 4, i32 1, i32 -5, i32 9, i32 2, i32 6]
+
+declare i32 @printf(i8*, ...)
+
+define i32 @sum(i32* %p, i32 %n) nounwind {
+entry:
+  br label %loop
+loop:
+  %i = phi i32 [0, %entry], [%i1, %loop]
+  %s = phi i32 [0, %entry], [%s1, %loop]
+  %a = getelementptr i32* %p, i32 %i
+  %v = load i32* %a
+  %s1 = add i32 %s, %v
+  %i1 = add i32 %i, 1
+  %d = icmp eq i32 %i1, %n
+  br i1 %d, label %exit, label %loop
+exit:
+  ret i32 %s1
+}
+
+define i32 @fact(i32 %n) nounwind {
+  %c = icmp slt i32 %n, 2
+  br i1 %c, label %base, label %rec
+base:
+  ret i32 1
+rec:
+  %m = sub i32 %n, 1
+  %f = call i32 @fact(i32 %m)
+  %r = mul i32 %f, %n
+  ret i32 %r
+}
+
+define i32 @main() nounwind {
+  %p = getelementptr [8 x i32]* @arr, i32 0, i32 0
+  %s = call i32 @sum(i32* %p, i32 8)
+  %f = call i32 @fact(i32 10)
+  %x = xor i32 %f, -559038737
+  %fp = getelementptr [10 x i8]* @fmt, i32 0, i32 0
+  call i32 (i8*, ...)* @printf(i8* %fp, i32 %s, i32 %f, i32 %x)
+  ret i32 0
+}
+
+; CHECK: 19 3628800 de9ae1ef
+; CHECK: === ARCompact simulation ===
+; CHECK: Instructions retired
+; CHECK: Host calls
+
+; ASM: 19 3628800 de9ae1ef
+; ASM-NOT: ARCompact simulation
@@ -0,0 +1,1735 @@
+//===-- ARCSim.cpp - ARCompact instruction set simulator ------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the ARCompact instruction set simulator. Instructions
+// are decoded from memory by the ARCompact MCDisassembler, so the simulator
+// runs exactly the instructions the backend defines, and each one is timed
+// as it retires:
+//
+//   * Instructions issue one per cycle, in order.
+//   * ALU results are forwarded, so dependent instructions issue back to
+//     back. Loaded values arrive LoadLatency cycles after the load issues.
+//   * The multiplier holds the execute stage for MulLatency cycles, which
+//     stalls everything behind it.
+//   * A taken branch loses BranchPenalty fetch cycles, one fewer if it has a
+//     delay slot. The zero-overhead loop branch back to LP_START is free.
+//   * Each fetch looks up the instruction cache, and a miss stalls for
+//     ICacheMissPenalty cycles.
+//
+// The flags are always taken to be ready. Instructions which the itineraries
+// do not cover, such as the divider, are timed as single cycle ALU
+// operations.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ARCSim.h"
+#include "ARCompact.h"
+#include "MCTargetDesc/ARCompactBaseInfo.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/MC/MCDisassembler.h"
+#include "llvm/MC/MCInstPrinter.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemoryObject.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+using namespace llvm;
+using namespace arcsim;
+
+//===----------------------------------------------------------------------===//
+// Helpers.
+//===----------------------------------------------------------------------===//
+
+/// signExtend - Sign extends the bottom Bits bits of Value.
+static int32_t signExtend(uint32_t Value, unsigned Bits) {
+  return int32_t(Value << (32 - Bits)) >> (32 - Bits);
+}
+
+/// add - Returns X + Y + CarryIn, setting Carry and Overflow.
+static uint32_t add(uint32_t X, uint32_t Y, bool CarryIn, bool &Carry,
+                    bool &Overflow) {
+  uint64_t Sum = uint64_t(X) + Y + CarryIn;
+  uint32_t Result = uint32_t(Sum);
+  Carry = (Sum >> 32) & 1;
+  Overflow = ((X ^ Result) & (Y ^ Result)) >> 31;
+  return Result;
+}
+
+/// sub - Returns X - Y - BorrowIn, setting Borrow (the C flag) and Overflow.
+static uint32_t sub(uint32_t X, uint32_t Y, bool BorrowIn, bool &Borrow,
+                    bool &Overflow) {
+  uint64_t Diff = uint64_t(X) - Y - BorrowIn;
+  uint32_t Result = uint32_t(Diff);
+  Borrow = (Diff >> 32) & 1;
+  Overflow = ((X ^ Y) & (X ^ Result)) >> 31;
+  return Result;
+}
+
+/// saturate - Clamps Value to the signed 32-bit range, setting Saturated if
+/// it was out of range.
+static uint32_t saturate(int64_t Value, bool &Saturated) {
+  Saturated = Value > INT32_MAX || Value < INT32_MIN;
+  if (Value > INT32_MAX) {
+    return INT32_MAX;
+  }
+  if (Value < INT32_MIN) {
+    return uint32_t(INT32_MIN);
+  }
+  return uint32_t(Value);
+}
+
+/// norm - Returns the number of redundant sign bits of the bottom Bits bits
+/// of Value.
+static uint32_t norm(uint32_t Value, unsigned Bits) {
+  int32_t SValue = signExtend(Value, Bits);
+  uint32_t Magnitude = SValue < 0 ? ~SValue : SValue;
+  return CountLeadingZeros_32(Magnitude) - (32 - Bits) - 1;
+}
+
+//===----------------------------------------------------------------------===//
+// Stats and ICache.
+//===----------------------------------------------------------------------===//
+
+void Stats::clear() {
+  Instructions = Insts16 = Insts32 = Limms = Cycles = 0;
+  LoadUseStalls = MulStalls = BranchStalls = ICacheStalls = 0;
+  BranchesTaken = BranchesNotTaken = DelaySlots = LoopIterations = 0;
+  Loads = Stores = 0;
+  ICacheAccesses = ICacheMisses = 0;
+  HostCalls = 0;
+}
+
+bool ICache::init(unsigned Size, unsigned LineSize, unsigned NumWays) {
+  Lines.clear();
+  NumSets = 0;
+  if (Size == 0) {
+    return true;
+  }
+  if (!isPowerOf2_32(LineSize) || NumWays == 0 ||
+      Size % (LineSize * NumWays) != 0) {
+    return false;
+  }
+
+  LineShift = Log2_32(LineSize);
+  Ways = NumWays;
+  NumSets = Size / (LineSize * NumWays);
+  Line Invalid = { 0, 0, false };
+  Lines.assign(NumSets * Ways, Invalid);
+  return true;
+}
+
+bool ICache::access(uint32_t Addr) {
+  uint32_t LineAddr = Addr >> LineShift;
+  uint32_t Tag = LineAddr / NumSets;
+  Line *Set = &Lines[(LineAddr % NumSets) * Ways];
+  ++Clock;
+
+  for (unsigned i = 0; i != Ways; ++i) {
+    if (Set[i].Valid && Set[i].Tag == Tag) {
+      Set[i].LastUse = Clock;
+      return true;
+    }
+  }
+
+  // Fill an empty way if there is one, otherwise the least recently used.
+  Line *Victim = &Set[0];
+  for (unsigned i = 1; i != Ways && Victim->Valid; ++i) {
+    if (!Set[i].Valid || Set[i].LastUse < Victim->LastUse) {
+      Victim = &Set[i];
+    }
+  }
+  Victim->Tag = Tag;
+  Victim->LastUse = Clock;
+  Victim->Valid = true;
+  return false;
+}
+
+//===----------------------------------------------------------------------===//
+// Host routines.
+//
+// Calls to functions which are not defined by the program are sent to these
+// instead. They follow the ARCompact calling convention: the arguments are
+// in r0-r7 and then on the stack, and the result is returned in r0 (r0 and
+// r1 for 64-bit values, low word first).
+//===----------------------------------------------------------------------===//
+
+/// readString - Reads the NUL terminated string at Addr into Result.
+static bool readString(Simulator &Sim, uint32_t Addr, std::string &Result) {
+  for (;; ++Addr) {
+    uint8_t *P = Sim.getMemory(Addr, 1);
+    if (!P) {
+      Sim.fault("string outside of memory");
+      return false;
+    }
+    if (*P == 0) {
+      return true;
+    }
+    Result += char(*P);
+  }
+}
+
+static uint64_t getArg64(Simulator &Sim, unsigned N) {
+  return uint64_t(Sim.getArg(N + 1)) << 32 | Sim.getArg(N);
+}
+
+static void setResult64(Simulator &Sim, uint64_t Value) {
+  Sim.setReg(0, uint32_t(Value));
+  Sim.setReg(1, uint32_t(Value >> 32));
+}
+
+static bool hostReturn(Simulator &Sim) {
+  Sim.stop(Sim.getReg(0));
+  return false;
+}
+
+static bool hostExit(Simulator &Sim) {
+  Sim.stop(Sim.getArg(0));
+  return false;
+}
+
+static bool hostAbort(Simulator &Sim) {
+  Sim.fault("abort called");
+  return false;
+}
+
+static bool hostPutchar(Simulator &Sim) {
+  outs() << char(Sim.getArg(0));
+  return true;
+}
+
+static bool hostPuts(Simulator &Sim) {
+  std::string Str;
+  if (!readString(Sim, Sim.getArg(0), Str)) {
+    return false;
+  }
+  outs() << Str << '\n';
+  Sim.setReg(0, 0);
+  return true;
+}
+
+/// hostPrintf - Implements the integer, character and string conversions of
+/// printf.
+static bool hostPrintf(Simulator &Sim) {
+  std::string Fmt;
+  if (!readString(Sim, Sim.getArg(0), Fmt)) {
+    return false;
+  }
+
+  std::string Out;
+  unsigned NextArg = 1;
+  for (size_t i = 0, e = Fmt.size(); i != e; ++i) {
+    if (Fmt[i] != '%') {
+      Out += Fmt[i];
+      continue;
+    }
+
+    // Collect the flags and width, dropping any length modifiers, and hand
+    // the conversion to the host printf.
+    std::string Spec = "%";
+    for (++i; i != e && strchr("-+ #0123456789", Fmt[i]); ++i) {
+      Spec += Fmt[i];
+    }
+    while (i != e && strchr("hlz", Fmt[i])) {
+      ++i;
+    }
+    if (i == e) {
+      break;
+    }
+
+    char Buf[64];
+    char Conv = Fmt[i];
+    switch (Conv) {
+      case '%':
+        Out += '%';
+        continue;
+      case 's': {
+        std::string Str;
+        if (!readString(Sim, Sim.getArg(NextArg++), Str)) {
+          return false;
+        }
+        Out += Str;
+        continue;
+      }
+      case 'd': case 'i':
+        snprintf(Buf, sizeof(Buf), (Spec + "d").c_str(),
+                 int(Sim.getArg(NextArg++)));
+        break;
+      case 'u': case 'x': case 'X': case 'o': case 'c':
+        snprintf(Buf, sizeof(Buf), (Spec + Conv).c_str(),
+                 unsigned(Sim.getArg(NextArg++)));
+        break;
+      case 'p':
+        snprintf(Buf, sizeof(Buf), "0x%08x", unsigned(Sim.getArg(NextArg++)));
+        break;
+      default:
+        Sim.fault(std::string("unsupported printf conversion '%") + Conv +
+                  "'");
+        return false;
+    }
+    Out += Buf;
+  }
+
+  outs() << Out;
+  Sim.setReg(0, Out.size());
+  return true;
+}
+
+static bool hostMalloc(Simulator &Sim) {
+  Sim.setReg(0, Sim.allocate(Sim.getArg(0)));
+  return true;
+}
+
+static bool hostCalloc(Simulator &Sim) {
+  uint64_t Size = uint64_t(Sim.getArg(0)) * Sim.getArg(1);
+  uint32_t Addr = Size > 0xFFFFFFFF ? 0 : Sim.allocate(Size);
+  if (Addr) {
+    memset(Sim.getMemory(Addr, Size), 0, Size);
+  }
+  Sim.setReg(0, Addr);
+  return true;
+}
+
+static bool hostFree(Simulator &Sim) {
+  return true;
+}
+
+static bool hostMemmove(Simulator &Sim) {
+  uint32_t Size = Sim.getArg(2);
+  uint8_t *Dst = Sim.getMemory(Sim.getArg(0), Size);
+  uint8_t *Src = Sim.getMemory(Sim.getArg(1), Size);
+  if (!Dst || !Src) {
+    Sim.fault("memcpy outside of memory");
+    return false;
+  }
+  memmove(Dst, Src, Size);
+  return true;
+}
+
+static bool hostMemset(Simulator &Sim) {
+  uint32_t Size = Sim.getArg(2);
+  uint8_t *Dst = Sim.getMemory(Sim.getArg(0), Size);
+  if (!Dst) {
+    Sim.fault("memset outside of memory");
+    return false;
+  }
+  memset(Dst, Sim.getArg(1), Size);
+  return true;
+}
+
+static bool hostMemcmp(Simulator &Sim) {
+  uint32_t Size = Sim.getArg(2);
+  uint8_t *X = Sim.getMemory(Sim.getArg(0), Size);
+  uint8_t *Y = Sim.getMemory(Sim.getArg(1), Size);
+  if (!X || !Y) {
+    Sim.fault("memcmp outside of memory");
+    return false;
+  }
+  Sim.setReg(0, memcmp(X, Y, Size));
+  return true;
+}
+
+static bool hostStrlen(Simulator &Sim) {
+  std::string Str;
+  if (!readString(Sim, Sim.getArg(0), Str)) {
+    return false;
+  }
+  Sim.setReg(0, Str.size());
+  return true;
+}
+
+static bool hostStrcmp(Simulator &Sim) {
+  std::string X, Y;
+  if (!readString(Sim, Sim.getArg(0), X) ||
+      !readString(Sim, Sim.getArg(1), Y)) {
+    return false;
+  }
+  Sim.setReg(0, X.compare(Y));
+  return true;
+}
+
+static bool hostMulsi3(Simulator &Sim) {
+  Sim.setReg(0, Sim.getArg(0) * Sim.getArg(1));
+  return true;
+}
+
+/// checkDivisor - Faults if a library division routine is asked to divide
+/// by zero.
+static bool checkDivisor(Simulator &Sim, uint64_t Divisor) {
+  if (Divisor == 0) {
+    Sim.fault("division by zero");
+    return false;
+  }
+  return true;
+}
+
+static bool hostDivsi3(Simulator &Sim) {
+  int32_t X = Sim.getArg(0), Y = Sim.getArg(1);
+  if (!checkDivisor(Sim, Y)) {
+    return false;
+  }
+  Sim.setReg(0, Y == -1 ? 0 - uint32_t(X) : uint32_t(X / Y));
+  return true;
+}
+
+static bool hostUdivsi3(Simulator &Sim) {
+  uint32_t X = Sim.getArg(0), Y = Sim.getArg(1);
+  if (!checkDivisor(Sim, Y)) {
+    return false;
+  }
+  Sim.setReg(0, X / Y);
+  return true;
+}
+
+static bool hostModsi3(Simulator &Sim) {
+  int32_t X = Sim.getArg(0), Y = Sim.getArg(1);
+  if (!checkDivisor(Sim, Y)) {
+    return false;
+  }
+  Sim.setReg(0, Y == -1 ? 0 : uint32_t(X % Y));
+  return true;
+}
+
+static bool hostUmodsi3(Simulator &Sim) {
+  uint32_t X = Sim.getArg(0), Y = Sim.getArg(1);
+  if (!checkDivisor(Sim, Y)) {
+    return false;
+  }
+  Sim.setReg(0, X % Y);
+  return true;
+}
+
+static bool hostAshldi3(Simulator &Sim) {
+  setResult64(Sim, getArg64(Sim, 0) << (Sim.getArg(2) & 63));
+  return true;
+}
+
+static bool hostLshrdi3(Simulator &Sim) {
+  setResult64(Sim, getArg64(Sim, 0) >> (Sim.getArg(2) & 63));
+  return true;
+}
+
+static bool hostAshrdi3(Simulator &Sim) {
+  setResult64(Sim, int64_t(getArg64(Sim, 0)) >> (Sim.getArg(2) & 63));
+  return true;
+}
+
+static bool hostMuldi3(Simulator &Sim) {
+  setResult64(Sim, getArg64(Sim, 0) * getArg64(Sim, 2));
+  return true;
+}
+
+static bool hostDivdi3(Simulator &Sim) {
+  int64_t X = getArg64(Sim, 0), Y = getArg64(Sim, 2);
+  if (!checkDivisor(Sim, Y)) {
+    return false;
+  }
+  setResult64(Sim, Y == -1 ? 0 - uint64_t(X) : uint64_t(X / Y));
+  return true;
+}
+
+static bool hostUdivdi3(Simulator &Sim) {
+  uint64_t X = getArg64(Sim, 0), Y = getArg64(Sim, 2);
+  if (!checkDivisor(Sim, Y)) {
+    return false;
+  }
+  setResult64(Sim, X / Y);
+  return true;
+}
+
+static bool hostModdi3(Simulator &Sim) {
+  int64_t X = getArg64(Sim, 0), Y = getArg64(Sim, 2);
+  if (!checkDivisor(Sim, Y)) {
+    return false;
+  }
+  setResult64(Sim, Y == -1 ? 0 : uint64_t(X % Y));
+  return true;
+}
+
+static bool hostUmoddi3(Simulator &Sim) {
+  uint64_t X = getArg64(Sim, 0), Y = getArg64(Sim, 2);
+  if (!checkDivisor(Sim, Y)) {
+    return false;
+  }
+  setResult64(Sim, X % Y);
+  return true;
+}
+
+namespace {
+  struct HostRoutine {
+    const char *Name;
+    HostFn Fn;
+  };
+}
+
+/// HostRoutines - The routines which can be called by the program. The first
+/// entry is the return address given to the entry function.
+static const HostRoutine HostRoutines[] = {
+  { "<return>",  hostReturn },
+  { "exit",      hostExit },
+  { "_exit",     hostExit },
+  { "abort",     hostAbort },
+  { "putchar",   hostPutchar },
+  { "puts",      hostPuts },
+  { "printf",    hostPrintf },
+  { "malloc",    hostMalloc },
+  { "calloc",    hostCalloc },
+  { "free",      hostFree },
+  { "memcpy",    hostMemmove },
+  { "memmove",   hostMemmove },
+  { "memset",    hostMemset },
+  { "memcmp",    hostMemcmp },
+  { "strlen",    hostStrlen },
+  { "strcmp",    hostStrcmp },
+  { "__mulsi3",  hostMulsi3 },
+  { "__divsi3",  hostDivsi3 },
+  { "__udivsi3", hostUdivsi3 },
+  { "__modsi3",  hostModsi3 },
+  { "__umodsi3", hostUmodsi3 },
+  { "__ashldi3", hostAshldi3 },
+  { "__lshrdi3", hostLshrdi3 },
+  { "__ashrdi3", hostAshrdi3 },
+  { "__muldi3",  hostMuldi3 },
+  { "__divdi3",  hostDivdi3 },
+  { "__udivdi3", hostUdivdi3 },
+  { "__moddi3",  hostModdi3 },
+  { "__umoddi3", hostUmoddi3 }
+};
+
+//===----------------------------------------------------------------------===//
+// Operation tables.
+//
+// The decoded MCInsts carry the operands of each instruction in the order of
+// its definition in ARCompactInstrInfo.td. Most of them share a few operand
+// layouts, so these map the opcodes onto the operation they perform, and the
+// execute routines read the operands by position.
+//===----------------------------------------------------------------------===//
+
+namespace {
+  /// ALUOp - The operations of the general instructions, which are laid out
+  /// as "dst, src1, src2", or "src1, src2" for the compares. The single
+  /// operand ones from ALU_MOV on are laid out as "dst, src".
+  enum ALUOp {
+    ALU_None,
+    ALU_ADD, ALU_ADC, ALU_SUB, ALU_SBC, ALU_AND, ALU_OR, ALU_BIC, ALU_XOR,
+    ALU_MAX, ALU_MIN, ALU_CMP, ALU_BSET, ALU_BCLR, ALU_BXOR, ALU_BMSK,
+    ALU_ADD1, ALU_ADD2, ALU_ADD3, ALU_SUB1, ALU_SUB2, ALU_SUB3,
+    ALU_MPY, ALU_MPYH, ALU_MPYHU, ALU_ASL, ALU_LSR, ALU_ASR, ALU_ROR,
+    ALU_ADDS, ALU_SUBS, ALU_DIV, ALU_DIVU, ALU_REM, ALU_REMU,
+    ALU_MOV, ALU_ASL1, ALU_ASR1, ALU_LSR1, ALU_SEXB, ALU_SEXW, ALU_EXTB,
+    ALU_EXTW, ALU_ABS, ALU_ABSS, ALU_NOT, ALU_NEG, ALU_NEGS, ALU_NORM,
+    ALU_SWAP
+  };
+
+  /// AddrMode - The address write back modes of the loads and stores.
+  enum AddrMode {
+    AM_None,
+    AM_A,  // .a, the address is written back to the base.
+    AM_AB, // .ab, the base is the address, and is then updated.
+    AM_AS  // .as, the offset is scaled by the access size.
+  };
+
+  /// SimMemoryObject - Lets the disassembler read the simulated memory.
+  class SimMemoryObject : public MemoryObject {
+    const std::vector<uint8_t> &Bytes;
+
+  public:
+    explicit SimMemoryObject(const std::vector<uint8_t> &B) : Bytes(B) {}
+
+    uint64_t getBase() const { return 0; }
+    uint64_t getExtent() const { return Bytes.size(); }
+
+    int readByte(uint64_t Addr, uint8_t *Byte) const {
+      if (Addr >= Bytes.size()) {
+        return -1;
+      }
+      *Byte = Bytes[Addr];
+      return 0;
+    }
+  };
+}
+
+/// getALUOp - Returns the operation of a general instruction, or ALU_None
+/// if Opcode is not one.
+static ALUOp getALUOp(unsigned Opcode) {
+  switch (Opcode) {
+    default:
+      return ALU_None;
+    case ARC::ADDrr: case ARC::ADDrr_f: case ARC::ADDrsi: case ARC::ADDrsi_f:
+    case ARC::ADDrui: case ARC::ADDrui_f: case ARC::ADDrli:
+    case ARC::ADDrli_f: case ARC::ADDrrr_s: case ARC::ADDrru3_s:
+    case ARC::ADDrru7_s: case ARC::ADDrh_s: case ARC::ADDrl_s:
+      return ALU_ADD;
+    case ARC::ADCrr: case ARC::ADCrr_f: case ARC::ADCrsi: case ARC::ADCrsi_f:
+    case ARC::ADCrui: case ARC::ADCrui_f: case ARC::ADCrli:
+    case ARC::ADCrli_f:
+      return ALU_ADC;
+    case ARC::SUBrr: case ARC::SUBrr_f: case ARC::SUBrsi: case ARC::SUBrsi_f:
+    case ARC::SUBrui: case ARC::SUBrui_f: case ARC::SUBrli:
+    case ARC::SUBrli_f: case ARC::SUBlir: case ARC::SUBrr_s:
+    case ARC::SUBrru3_s: case ARC::SUBrru5_s:
+      return ALU_SUB;
+    case ARC::SBCrr: case ARC::SBCrr_f: case ARC::SBCrsi: case ARC::SBCrsi_f:
+    case ARC::SBCrui: case ARC::SBCrui_f: case ARC::SBCrli:
+    case ARC::SBCrli_f:
+      return ALU_SBC;
+    case ARC::ANDrr: case ARC::ANDrr_f: case ARC::ANDrsi: case ARC::ANDrsi_f:
+    case ARC::ANDrui: case ARC::ANDrui_f: case ARC::ANDrli:
+    case ARC::ANDrli_f: case ARC::ANDrr_s:
+      return ALU_AND;
+    case ARC::ORrr: case ARC::ORrr_f: case ARC::ORrsi: case ARC::ORrsi_f:
+    case ARC::ORrui: case ARC::ORrui_f: case ARC::ORrli: case ARC::ORrli_f:
+    case ARC::ORrr_s:
+      return ALU_OR;
+    case ARC::BICrr: case ARC::BICrr_f: case ARC::BICrsi: case ARC::BICrsi_f:
+    case ARC::BICrui: case ARC::BICrui_f: case ARC::BICrli:
+    case ARC::BICrli_f: case ARC::BICrr_s:
+      return ALU_BIC;
+    case ARC::XORrr: case ARC::XORrr_f: case ARC::XORrsi: case ARC::XORrsi_f:
+    case ARC::XORrui: case ARC::XORrui_f: case ARC::XORrli:
+    case ARC::XORrli_f: case ARC::XORrr_s:
+      return ALU_XOR;
+    case ARC::MAXrr: case ARC::MAXrr_f: case ARC::MAXrsi: case ARC::MAXrsi_f:
+    case ARC::MAXrui: case ARC::MAXrui_f: case ARC::MAXrli:
+    case ARC::MAXrli_f:
+      return ALU_MAX;
+    case ARC::MINrr: case ARC::MINrr_f: case ARC::MINrsi: case ARC::MINrsi_f:
+    case ARC::MINrui: case ARC::MINrui_f: case ARC::MINrli:
+    case ARC::MINrli_f:
+      return ALU_MIN;
+    case ARC::CMPrr: case ARC::CMPrsi: case ARC::CMPrui: case ARC::CMPrli:
+    case ARC::CMPlir: case ARC::CMPrh_s: case ARC::CMPrl_s:
+    case ARC::CMPru7_s:
+      return ALU_CMP;
+    case ARC::BSETrr: case ARC::BSETrr_f: case ARC::BSETrsi:
+    case ARC::BSETrsi_f: case ARC::BSETrui: case ARC::BSETrui_f:
+    case ARC::BSETrli: case ARC::BSETrli_f: case ARC::BSETrru5_s:
+      return ALU_BSET;
+    case ARC::BCLRrr: case ARC::BCLRrr_f: case ARC::BCLRrsi:
+    case ARC::BCLRrsi_f: case ARC::BCLRrui: case ARC::BCLRrui_f:
+    case ARC::BCLRrli: case ARC::BCLRrli_f: case ARC::BCLRrru5_s:
+      return ALU_BCLR;
+    case ARC::BXORrr: case ARC::BXORrr_f: case ARC::BXORrsi:
+    case ARC::BXORrsi_f: case ARC::BXORrui: case ARC::BXORrui_f:
+    case ARC::BXORrli: case ARC::BXORrli_f:
+      return ALU_BXOR;
+    case ARC::BMSKrr: case ARC::BMSKrr_f: case ARC::BMSKrsi:
+    case ARC::BMSKrsi_f: case ARC::BMSKrui: case ARC::BMSKrui_f:
+    case ARC::BMSKrli: case ARC::BMSKrli_f: case ARC::BMSKrru5_s:
+      return ALU_BMSK;
+    case ARC::ADD1rr: case ARC::ADD1rr_f: case ARC::ADD1rsi:
+    case ARC::ADD1rsi_f: case ARC::ADD1rui: case ARC::ADD1rui_f:
+    case ARC::ADD1rli: case ARC::ADD1rli_f: case ARC::ADD1rr_s:
+      return ALU_ADD1;
+    case ARC::ADD2rr: case ARC::ADD2rr_f: case ARC::ADD2rsi:
+    case ARC::ADD2rsi_f: case ARC::ADD2rui: case ARC::ADD2rui_f:
+    case ARC::ADD2rli: case ARC::ADD2rli_f: case ARC::ADD2rr_s:
+      return ALU_ADD2;
+    case ARC::ADD3rr: case ARC::ADD3rr_f: case ARC::ADD3rsi:
+    case ARC::ADD3rsi_f: case ARC::ADD3rui: case ARC::ADD3rui_f:
+    case ARC::ADD3rli: case ARC::ADD3rli_f: case ARC::ADD3rr_s:
+      return ALU_ADD3;
+    case ARC::SUB1rr: case ARC::SUB1rr_f: case ARC::SUB1rsi:
+    case ARC::SUB1rsi_f: case ARC::SUB1rui: case ARC::SUB1rui_f:
+    case ARC::SUB1rli: case ARC::SUB1rli_f:
+      return ALU_SUB1;
+    case ARC::SUB2rr: case ARC::SUB2rr_f: case ARC::SUB2rsi:
+    case ARC::SUB2rsi_f: case ARC::SUB2rui: case ARC::SUB2rui_f:
+    case ARC::SUB2rli: case ARC::SUB2rli_f:
+      return ALU_SUB2;
+    case ARC::SUB3rr: case ARC::SUB3rr_f: case ARC::SUB3rsi:
+    case ARC::SUB3rsi_f: case ARC::SUB3rui: case ARC::SUB3rui_f:
+    case ARC::SUB3rli: case ARC::SUB3rli_f:
+      return ALU_SUB3;
+    case ARC::MPYrr:
+      return ALU_MPY;
+    case ARC::MPYHrr:
+      return ALU_MPYH;
+    case ARC::MPYHUrr:
+      return ALU_MPYHU;
+    case ARC::ASLrr: case ARC::ASLrr_f: case ARC::ASLrsi: case ARC::ASLrsi_f:
+    case ARC::ASLrui: case ARC::ASLrui_f: case ARC::ASLrli:
+    case ARC::ASLrli_f: case ARC::ASLrr_s: case ARC::ASLrru3_s:
+    case ARC::ASLrru5_s:
+      return ALU_ASL;
+    case ARC::LSRrr: case ARC::LSRrr_f: case ARC::LSRrsi: case ARC::LSRrsi_f:
+    case ARC::LSRrui: case ARC::LSRrui_f: case ARC::LSRrli:
+    case ARC::LSRrli_f: case ARC::LSRrr_s: case ARC::LSRrru5_s:
+      return ALU_LSR;
+    case ARC::ASRrr: case ARC::ASRrr_f: case ARC::ASRrsi: case ARC::ASRrsi_f:
+    case ARC::ASRrui: case ARC::ASRrui_f: case ARC::ASRrli:
+    case ARC::ASRrli_f: case ARC::ASRlir: case ARC::ASRrr_s:
+    case ARC::ASRrru3_s: case ARC::ASRrru5_s:
+      return ALU_ASR;
+    case ARC::RORrr: case ARC::RORrr_f: case ARC::RORrsi: case ARC::RORrsi_f:
+    case ARC::RORrui: case ARC::RORrui_f: case ARC::RORrli:
+    case ARC::RORrli_f:
+      return ALU_ROR;
+    case ARC::ADDSrr: case ARC::ADDSrr_f: case ARC::ADDSrsi:
+    case ARC::ADDSrsi_f: case ARC::ADDSrui: case ARC::ADDSrui_f:
+    case ARC::ADDSrli: case ARC::ADDSrli_f:
+      return ALU_ADDS;
+    case ARC::SUBSrr: case ARC::SUBSrr_f: case ARC::SUBSrsi:
+    case ARC::SUBSrsi_f: case ARC::SUBSrui: case ARC::SUBSrui_f:
+    case ARC::SUBSrli: case ARC::SUBSrli_f:
+      return ALU_SUBS;
+    case ARC::DIVrr: case ARC::DIVrr_f: case ARC::DIVrsi: case ARC::DIVrsi_f:
+    case ARC::DIVrui: case ARC::DIVrui_f: case ARC::DIVrli:
+    case ARC::DIVrli_f:
+      return ALU_DIV;
+    case ARC::DIVUrr: case ARC::DIVUrr_f: case ARC::DIVUrsi:
+    case ARC::DIVUrsi_f: case ARC::DIVUrui: case ARC::DIVUrui_f:
+    case ARC::DIVUrli: case ARC::DIVUrli_f:
+      return ALU_DIVU;
+    case ARC::REMrr: case ARC::REMrr_f: case ARC::REMrsi: case ARC::REMrsi_f:
+    case ARC::REMrui: case ARC::REMrui_f: case ARC::REMrli:
+    case ARC::REMrli_f:
+      return ALU_REM;
+    case ARC::REMUrr: case ARC::REMUrr_f: case ARC::REMUrsi:
+    case ARC::REMUrsi_f: case ARC::REMUrui: case ARC::REMUrui_f:
+    case ARC::REMUrli: case ARC::REMUrli_f:
+      return ALU_REMU;
+    case ARC::MOVrr: case ARC::MOVrsi: case ARC::MOVrui: case ARC::MOVrli:
+    case ARC::MOVrh_s: case ARC::MOVhr_s: case ARC::MOVrl_s:
+    case ARC::MOVru8_s:
+      return ALU_MOV;
+    case ARC::ASLr: case ARC::ASLui: case ARC::ASLli: case ARC::ASLr_s:
+      return ALU_ASL1;
+    case ARC::ASRr: case ARC::ASRui: case ARC::ASRli: case ARC::ASRr_s:
+      return ALU_ASR1;
+    case ARC::LSRr: case ARC::LSRui: case ARC::LSRli: case ARC::LSRr_s:
+      return ALU_LSR1;
+    case ARC::SEXBr: case ARC::SEXBui: case ARC::SEXBli: case ARC::SEXBr_s:
+      return ALU_SEXB;
+    case ARC::SEXWr: case ARC::SEXWui: case ARC::SEXWli: case ARC::SEXWr_s:
+      return ALU_SEXW;
+    case ARC::EXTBr: case ARC::EXTBui: case ARC::EXTBli: case ARC::EXTBr_s:
+      return ALU_EXTB;
+    case ARC::EXTWr: case ARC::EXTWui: case ARC::EXTWli: case ARC::EXTWr_s:
+      return ALU_EXTW;
+    case ARC::ABSr: case ARC::ABSr_s:
+      return ALU_ABS;
+    case ARC::ABSSr:
+      return ALU_ABSS;
+    case ARC::NOTr: case ARC::NOTui: case ARC::NOTli: case ARC::NOTr_s:
+      return ALU_NOT;
+    case ARC::NEGrr: case ARC::NEGr_s:
+      return ALU_NEG;
+    case ARC::NEGSr:
+      return ALU_NEGS;
+    case ARC::NORMr:
+      return ALU_NORM;
+    case ARC::SWAPr:
+      return ALU_SWAP;
+  }
+}
+
+/// getMemoryAccess - Returns true if Opcode is a load or store, along with
+/// the size of the access, whether a load sign extends, and the address
+/// mode. Loads are laid out as "dst, address" and stores as "address, src",
+/// where the address is a base and an optional offset.
+static bool getMemoryAccess(unsigned Opcode, unsigned &Size, bool &SignExt,
+                            AddrMode &Mode) {
+  SignExt = false;
+  Mode = AM_None;
+  switch (Opcode) {
+    default:
+      return false;
+
+    case ARC::LDri_a: case ARC::LDri_extw_a: case ARC::LDri_extb_a:
+    case ARC::LDri_sextw_a: case ARC::LDri_sextb_a: case ARC::STrri_a:
+    case ARC::STrri_i16_a: case ARC::STrri_i8_a:
+      Mode = AM_A;
+      break;
+    case ARC::LDri_ab: case ARC::LDri_extw_ab: case ARC::LDri_extb_ab:
+    case ARC::LDri_sextw_ab: case ARC::LDri_sextb_ab: case ARC::STrri_ab:
+    case ARC::STrri_i16_ab: case ARC::STrri_i8_ab:
+      Mode = AM_AB;
+      break;
+    case ARC::LDri_as: case ARC::LDri_extw_as: case ARC::LDri_sextw_as:
+    case ARC::LDrr_as: case ARC::LDrr_extw_as: case ARC::LDrr_sextw_as:
+    case ARC::LDgp: case ARC::LDgp_extw: case ARC::LDgp_sextw:
+    case ARC::STrri_as: case ARC::STrri_i16_as: case ARC::STgp:
+    case ARC::STgp_i16:
+      Mode = AM_AS;
+      break;
+
+    case ARC::LDri: case ARC::LDrr: case ARC::LDli: case ARC::LDlir:
+    case ARC::LDri_s: case ARC::LDrr_s: case ARC::LDsp_s: case ARC::LDri_extw:
+    case ARC::LDrr_extw: case ARC::LDri_extw_s: case ARC::LDri_extb:
+    case ARC::LDrr_extb: case ARC::LDri_extb_s: case ARC::LDgp_extb:
+    case ARC::LDri_sextw: case ARC::LDrr_sextw: case ARC::LDri_sextw_s:
+    case ARC::LDri_sextb: case ARC::LDrr_sextb: case ARC::LDgp_sextb:
+    case ARC::STrri: case ARC::STrli: case ARC::STliri: case ARC::STrri_s:
+    case ARC::STsp_s: case ARC::STrri_i16: case ARC::STrri_i16_s:
+    case ARC::STrri_i8: case ARC::STrri_i8_s: case ARC::STgp_i8:
+      break;
+  }
+
+  switch (Opcode) {
+    case ARC::LDri_extw: case ARC::LDri_extw_a: case ARC::LDri_extw_ab:
+    case ARC::LDri_extw_as: case ARC::LDri_extw_s: case ARC::LDrr_extw:
+    case ARC::LDrr_extw_as: case ARC::LDgp_extw: case ARC::STrri_i16:
+    case ARC::STrri_i16_a: case ARC::STrri_i16_ab: case ARC::STrri_i16_as:
+    case ARC::STrri_i16_s: case ARC::STgp_i16:
+      Size = 2;
+      break;
+    case ARC::LDri_sextw: case ARC::LDri_sextw_a: case ARC::LDri_sextw_ab:
+    case ARC::LDri_sextw_as: case ARC::LDri_sextw_s: case ARC::LDrr_sextw:
+    case ARC::LDrr_sextw_as: case ARC::LDgp_sextw:
+      Size = 2;
+      SignExt = true;
+      break;
+    case ARC::LDri_extb: case ARC::LDri_extb_a: case ARC::LDri_extb_ab:
+    case ARC::LDri_extb_s: case ARC::LDrr_extb: case ARC::LDgp_extb:
+    case ARC::STrri_i8: case ARC::STrri_i8_a: case ARC::STrri_i8_ab:
+    case ARC::STrri_i8_s: case ARC::STgp_i8:
+      Size = 1;
+      break;
+    case ARC::LDri_sextb: case ARC::LDri_sextb_a: case ARC::LDri_sextb_ab:
+    case ARC::LDrr_sextb: case ARC::LDgp_sextb:
+      Size = 1;
+      SignExt = true;
+      break;
+    default:
+      Size = 4;
+      break;
+  }
+  return true;
+}
+
+//===----------------------------------------------------------------------===//
+// Simulator.
+//===----------------------------------------------------------------------===//
+
+Simulator::Simulator(const Config &C, uint32_t MemSize,
+                     const MCDisassembler &D, const MCInstrInfo &II,
+                     MCInstPrinter *P)
+  : Conf(C), Memory(MemSize), Dis(D), MII(II), IP(P), DecodedLow(~0U),
+    DecodedHigh(0), FlushDecoded(false), PC(0), Z(false), N(false),
+    C(false), V(false), LPStart(0), LPEnd(0xFFFFFFFF), HeapPtr(0),
+    HeapEnd(0), Halted(false), ExitCode(0), InDelaySlot(false),
+    DelayTarget(0), NextIssue(0), MulFree(0) {
+  memset(R, 0, sizeof(R));
+  memset(Ready, 0, sizeof(Ready));
+  for (unsigned i = 0; i != 64; ++i) {
+    ReadyClass[i] = LC_ALU;
+  }
+
+  if (!IC.init(C.ICacheSize, C.ICacheLineSize, C.ICacheWays)) {
+    fault("invalid instruction cache geometry");
+  }
+}
+
+uint8_t *Simulator::getMemory(uint32_t Addr, uint32_t Size) {
+  if (Addr > Memory.size() || Size > Memory.size() - Addr) {
+    return 0;
+  }
+  return &Memory[0] + Addr;
+}
+
+uint32_t Simulator::getHostCallAddress(StringRef Name) {
+  for (unsigned i = 0; i != array_lengthof(HostRoutines); ++i) {
+    if (Name == HostRoutines[i].Name) {
+      return HostBase + i * 4;
+    }
+  }
+  return 0;
+}
+
+uint32_t Simulator::getArg(unsigned Num) {
+  if (Num < 8) {
+    return R[Num];
+  }
+  return load(R[SP] + (Num - 8) * 4, 4);
+}
+
+void Simulator::fault(const std::string &Msg) {
+  if (Error.empty()) {
+    Error = Msg;
+  }
+  Halted = true;
+}
+
+uint32_t Simulator::allocate(uint32_t Size) {
+  uint32_t Addr = (HeapPtr + 7) & ~7U;
+  if (Addr < HeapPtr || Size > HeapEnd - Addr) {
+    return 0;
+  }
+  HeapPtr = Addr + Size;
+  return Addr;
+}
+
+uint32_t Simulator::load(uint32_t Addr, unsigned Size) {
+  uint8_t *P = getMemory(Addr, Size);
+  if (!P) {
+    fault("load outside of memory");
+    return 0;
+  }
+
+  uint32_t Value = 0;
+  for (unsigned i = 0; i != Size; ++i) {
+    Value |= uint32_t(P[i]) << (i * 8);
+  }
+  return Value;
+}
+
+void Simulator::store(uint32_t Addr, unsigned Size, uint32_t Value) {
+  uint8_t *P = getMemory(Addr, Size);
+  if (!P) {
+    fault("store outside of memory");
+    return;
+  }
+
+  for (unsigned i = 0; i != Size; ++i) {
+    P[i] = uint8_t(Value >> (i * 8));
+  }
+
+  // Code which is written to has to be decoded again.
+  if (Addr < DecodedHigh && Addr + Size > DecodedLow) {
+    FlushDecoded = true;
+  }
+}
+
+bool Simulator::run(uint32_t Entry) {
+  R[SP] = Memory.size() & ~7U;
+  R[BLINK] = HostBase;
+  PC = Entry;
+
+  while (!Halted && step()) {
+    if (Conf.MaxInstructions && S.Instructions >= Conf.MaxInstructions) {
+      fault("instruction limit reached");
+    }
+  }
+
+  S.Cycles = NextIssue;
+  return Error.empty();
+}
+
+/// callHost - Runs host routine Index, and returns to BLINK.
+bool Simulator::callHost(unsigned Index) {
+  if ((PC & 0x3) || InDelaySlot) {
+    fault("jump into the host call area");
+    return false;
+  }
+
+  ++S.HostCalls;
+  if (Conf.Trace) {
+    errs() << "  host call " << HostRoutines[Index].Name << '\n';
+  }
+  if (!HostRoutines[Index].Fn(*this)) {
+    return false;
+  }
+  PC = R[BLINK];
+  return !Halted;
+}
+
+/// decode - Returns the instruction at Addr, or null if it cannot be
+/// decoded. The result is only valid until the next call.
+const Simulator::DecodedInst *Simulator::decode(uint32_t Addr) {
+  if (FlushDecoded) {
+    Decoded.clear();
+    DecodedLow = ~0U;
+    DecodedHigh = 0;
+    FlushDecoded = false;
+  }
+
+  DenseMap<uint32_t, DecodedInst>::iterator I = Decoded.find(Addr);
+  if (I != Decoded.end()) {
+    return &I->second;
+  }
+
+  DecodedInst D;
+  uint64_t Size;
+  SimMemoryObject Region(Memory);
+  if (Dis.getInstruction(D.Inst, Size, Region, Addr, nulls(), nulls()) !=
+      MCDisassembler::Success) {
+    return 0;
+  }
+  D.Size = Size;
+  DecodedLow = std::min(DecodedLow, Addr);
+  DecodedHigh = std::max(DecodedHigh, Addr + D.Size);
+  return &(Decoded[Addr] = D);
+}
+
+/// step - Executes and times one instruction. Returns false if the program
+/// has stopped.
+bool Simulator::step() {
+  if (PC >= HostBase && PC < HostBase + 4 * array_lengthof(HostRoutines)) {
+    return callHost((PC - HostBase) / 4);
+  }
+
+  InstPC = PC;
+  UsesMul = false;
+  IsBranch = false;
+  Taken = false;
+  Delayed = false;
+  NumReads = NumWrites = 0;
+
+  if (PC & 1) {
+    fault("misaligned instruction fetch");
+    return false;
+  }
+  const DecodedInst *D = decode(PC);
+  if (!D) {
+    fault(getMemory(PC, 2) ? "illegal instruction"
+                           : "instruction fetch outside of memory");
+    return false;
+  }
+
+  // Copy the instruction, as executing it may decode others.
+  MCInst MI = D->Inst;
+  const MCInstrDesc &Desc = MII.get(MI.getOpcode());
+  InstSize = D->Size;
+  if (Desc.TSFlags & ARCII::HasLimm) {
+    ++S.Limms;
+  }
+  if (InstSize - (Desc.TSFlags & ARCII::HasLimm ? 4 : 0) == 2) {
+    ++S.Insts16;
+  } else {
+    ++S.Insts32;
+  }
+  ++S.Instructions;
+
+  execute(MI, Desc);
+  if (Halted) {
+    return false;
+  }
+
+  timeInstruction();
+
+  if (Conf.Trace) {
+    traceInstruction(MI);
+  }
+
+  if (IsBranch) {
+    if (Taken) {
+      ++S.BranchesTaken;
+    } else {
+      ++S.BranchesNotTaken;
+    }
+  }
+
+  if (InDelaySlot) {
+    // The delay slot of a taken branch. Branches may not appear here.
+    if (IsBranch) {
+      fault("branch in a delay slot");
+      return false;
+    }
+    InDelaySlot = false;
+    ++S.DelaySlots;
+    PC = DelayTarget;
+  } else if (Taken && Delayed) {
+    InDelaySlot = true;
+    DelayTarget = Target;
+    PC = InstPC + InstSize;
+  } else if (Taken) {
+    PC = Target;
+  } else {
+    PC = InstPC + InstSize;
+
+    // The end of a zero-overhead loop.
+    if (PC == LPEnd) {
+      if (R[LP_COUNT] != 1) {
+        PC = LPStart;
+        ++S.LoopIterations;
+      }
+      --R[LP_COUNT];
+    }
+  }
+
+  return true;
+}
+
+/// timeInstruction - Works out when the instruction which has just executed
+/// issued, and when its results are available.
+void Simulator::timeInstruction() {
+  uint64_t Issue = NextIssue;
+
+  // Fetch.
+  if (IC.isEnabled()) {
+    uint32_t LineSize = IC.getLineSize();
+    for (uint32_t Addr = InstPC & ~(LineSize - 1); Addr < InstPC + InstSize;
+         Addr += LineSize) {
+      ++S.ICacheAccesses;
+      if (!IC.access(Addr)) {
+        ++S.ICacheMisses;
+        S.ICacheStalls += Conf.ICacheMissPenalty;
+        Issue += Conf.ICacheMissPenalty;
+      }
+    }
+  }
+
+  // Wait for the operands.
+  for (unsigned i = 0; i != NumReads; ++i) {
+    unsigned Reg = Reads[i];
+    if (Ready[Reg] <= Issue) {
+      continue;
+    }
+    if (ReadyClass[Reg] == LC_Mul) {
+      S.MulStalls += Ready[Reg] - Issue;
+    } else {
+      S.LoadUseStalls += Ready[Reg] - Issue;
+    }
+    Issue = Ready[Reg];
+  }
+
+  // Wait for the multiplier to leave the execute stage.
+  if (MulFree > Issue) {
+    S.MulStalls += MulFree - Issue;
+    Issue = MulFree;
+  }
+
+  for (unsigned i = 0; i != NumWrites; ++i) {
+    unsigned Reg = Writes[i];
+    switch (WriteClass[i]) {
+      case LC_ALU:  Ready[Reg] = Issue + 1; break;
+      case LC_Load: Ready[Reg] = Issue + Conf.LoadLatency; break;
+      case LC_Mul:  Ready[Reg] = Issue + Conf.MulLatency; break;
+    }
+    ReadyClass[Reg] = WriteClass[i];
+  }
+  if (UsesMul) {
+    MulFree = Issue + Conf.MulLatency;
+  }
+
+  NextIssue = Issue + 1;
+  if (Taken) {
+    unsigned Penalty = Conf.BranchPenalty;
+    if (Delayed && Penalty != 0) {
+      --Penalty;
+    }
+    S.BranchStalls += Penalty;
+    NextIssue += Penalty;
+  }
+}
+
+/// traceInstruction - Prints the instruction which has just retired, and the
+/// registers it wrote.
+void Simulator::traceInstruction(const MCInst &MI) {
+  std::string Text;
+  if (IP) {
+    raw_string_ostream OS(Text);
+    IP->printInst(&MI, OS, "");
+  }
+
+  // The printer separates the mnemonic and the operands with tabs.
+  std::replace(Text.begin(), Text.end(), '\t', ' ');
+  size_t Start = Text.find_first_not_of(' ');
+  Text.erase(0, std::min(Start, Text.size()));
+  errs() << format("%08x: %-24s", InstPC, Text.c_str());
+  for (unsigned i = 0; i != NumWrites; ++i) {
+    errs() << format(" r%u=%08x", Writes[i], R[Writes[i]]);
+  }
+  if (IsBranch) {
+    errs() << (Taken ? " taken" : " not taken");
+  }
+  errs() << '\n';
+}
+
+uint32_t Simulator::readReg(unsigned Reg) {
+  if (NumReads != array_lengthof(Reads)) {
+    Reads[NumReads++] = Reg;
+  }
+  return R[Reg];
+}
+
+void Simulator::writeReg(unsigned Reg, uint32_t Value, LatencyClass LC) {
+  R[Reg] = Value;
+  if (NumWrites != array_lengthof(Writes)) {
+    WriteClass[NumWrites] = LC;
+    Writes[NumWrites++] = Reg;
+  }
+}
+
+/// readOperand - Returns the value of operand OpNo, which is either a
+/// register or an immediate.
+uint32_t Simulator::readOperand(const MCInst &MI, unsigned OpNo) {
+  const MCOperand &MO = MI.getOperand(OpNo);
+  if (MO.isImm()) {
+    return uint32_t(MO.getImm());
+  }
+  return readReg(getARCompactRegisterNumbering(MO.getReg()));
+}
+
+void Simulator::writeOperand(const MCInst &MI, unsigned OpNo, uint32_t Value,
+                             LatencyClass LC) {
+  writeReg(getARCompactRegisterNumbering(MI.getOperand(OpNo).getReg()), Value,
+           LC);
+}
+
+/// readAuxReg - Returns the value of an auxiliary register. Only the ones
+/// which compiled code accesses are modelled.
+uint32_t Simulator::readAuxReg(uint32_t Num) {
+  switch (Num) {
+    case ARCAux::LP_START: return LPStart;
+    case ARCAux::LP_END:   return LPEnd;
+    case ARCAux::MULHI:    return readReg(MHI);
+    default:
+      fault("unsupported auxiliary register 0x" + utohexstr(Num));
+      return 0;
+  }
+}
+
+void Simulator::writeAuxReg(uint32_t Num, uint32_t Value) {
+  switch (Num) {
+    case ARCAux::LP_START:
+      LPStart = Value;
+      return;
+    case ARCAux::LP_END:
+      LPEnd = Value;
+      return;
+    case ARCAux::MULHI:
+      // MMID stays the middle of the 64-bit result in MHI and MLO.
+      writeReg(MHI, Value, LC_Mul);
+      writeReg(MMID, (Value << 16) | (readReg(MLO) >> 16), LC_Mul);
+      return;
+    default:
+      fault("unsupported auxiliary register 0x" + utohexstr(Num));
+      return;
+  }
+}
+
+bool Simulator::testCondition(unsigned CC) const {
+  switch (CC) {
+    case ARCCC::COND_AL:  return true;
+    case ARCCC::COND_EQ:  return Z;
+    case ARCCC::COND_NE:  return !Z;
+    case ARCCC::COND_P:   return !N;
+    case ARCCC::COND_N:   return N;
+    case ARCCC::COND_LO:  return C;
+    case ARCCC::COND_HS:  return !C;
+    case ARCCC::COND_V:   return V;
+    case ARCCC::COND_NV:  return !V;
+    case ARCCC::COND_GT:  return N == V && !Z;
+    case ARCCC::COND_GE:  return N == V;
+    case ARCCC::COND_LT:  return N != V;
+    case ARCCC::COND_LE:  return Z || N != V;
+    case ARCCC::COND_HI:  return !C && !Z;
+    case ARCCC::COND_LS:  return C || Z;
+    case ARCCC::COND_PNZ: return !N && !Z;
+    default:              return false;
+  }
+}
+
+/// testPredicate - Returns true if MI has no predicate, or if its condition
+/// holds.
+bool Simulator::testPredicate(const MCInst &MI,
+                              const MCInstrDesc &Desc) const {
+  int PredOpNo = Desc.findFirstPredOperandIdx();
+  return PredOpNo == -1 || testCondition(MI.getOperand(PredOpNo).getImm());
+}
+
+/// branch - Transfers control to Dest once the instruction (and its delay
+/// slot, if IsDelayed) has finished.
+void Simulator::branch(uint32_t Dest, bool IsDelayed) {
+  Taken = true;
+  Delayed = IsDelayed;
+  Target = Dest;
+}
+
+/// link - Sets BLINK to the address of the instruction after this one, or
+/// after its delay slot.
+void Simulator::link(bool IsDelayed) {
+  uint32_t Next = InstPC + InstSize;
+  if (IsDelayed) {
+    const DecodedInst *Slot = decode(Next);
+    Next += Slot ? Slot->Size : 2;
+  }
+  writeReg(BLINK, Next);
+}
+
+void Simulator::doLoad(unsigned Dst, uint32_t Addr, unsigned Size,
+                       bool SignExt) {
+  uint32_t Value = load(Addr, Size);
+  if (SignExt && Size != 4) {
+    Value = signExtend(Value, Size * 8);
+  }
+  writeReg(Dst, Value, LC_Load);
+  ++S.Loads;
+}
+
+void Simulator::doStore(uint32_t Addr, unsigned Size, uint32_t Value) {
+  store(Addr, Size, Value);
+  ++S.Stores;
+}
+
+//===----------------------------------------------------------------------===//
+// Execution.
+//===----------------------------------------------------------------------===//
+
+void Simulator::execute(const MCInst &MI, const MCInstrDesc &Desc) {
+  if (executeALU(MI, Desc) || executeMemory(MI, Desc) || executeBranch(MI)) {
+    return;
+  }
+
+  switch (MI.getOpcode()) {
+    case ARC::NOP:
+    case ARC::NOP_S:
+      return;
+    case ARC::MOVCCrr:
+    case ARC::MOVCCrui:
+    case ARC::MOVCCrli: {
+      uint32_t Src = readOperand(MI, 2);
+      if (testCondition(MI.getOperand(3).getImm())) {
+        writeOperand(MI, 0, Src);
+      }
+      return;
+    }
+    case ARC::MOVlpr:
+      writeReg(LP_COUNT, readOperand(MI, 0));
+      return;
+    case ARC::MOVrlp:
+      writeOperand(MI, 0, readReg(LP_COUNT));
+      return;
+    case ARC::LRrr:
+    case ARC::LRrui:
+    case ARC::LRrli:
+      writeOperand(MI, 0, readAuxReg(readOperand(MI, 1)));
+      return;
+    case ARC::SRrr:
+    case ARC::SRrui:
+    case ARC::SRrli:
+      writeAuxReg(readOperand(MI, 1), readOperand(MI, 0));
+      return;
+    case ARC::ADDsp_s:
+      writeReg(SP, readReg(SP) + readOperand(MI, 0));
+      return;
+    case ARC::SUBsp_s:
+      writeReg(SP, readReg(SP) - readOperand(MI, 0));
+      return;
+    case ARC::ADDrsp_s:
+      writeOperand(MI, 0, readReg(SP) + readOperand(MI, 1));
+      return;
+    case ARC::PUSH_S:
+    case ARC::PUSH_S_BLINK: {
+      uint32_t Value = MI.getOpcode() == ARC::PUSH_S ? readOperand(MI, 0)
+                                                     : readReg(BLINK);
+      uint32_t Addr = readReg(SP) - 4;
+      doStore(Addr, 4, Value);
+      writeReg(SP, Addr);
+      return;
+    }
+    case ARC::POP_S:
+    case ARC::POP_S_BLINK: {
+      unsigned Reg = MI.getOpcode() == ARC::POP_S
+        ? getARCompactRegisterNumbering(MI.getOperand(0).getReg())
+        : unsigned(BLINK);
+      uint32_t Addr = readReg(SP);
+      doLoad(Reg, Addr, 4, false);
+      writeReg(SP, Addr + 4);
+      return;
+    }
+    case ARC::MUL64rr:
+    case ARC::MULU64rr:
+    case ARC::MULU64rui: {
+      uint32_t Src1 = readOperand(MI, 0), Src2 = readOperand(MI, 1);
+      uint64_t Product = MI.getOpcode() == ARC::MUL64rr
+        ? uint64_t(int64_t(int32_t(Src1)) * int32_t(Src2))
+        : uint64_t(Src1) * Src2;
+      writeReg(MLO, uint32_t(Product), LC_Mul);
+      writeReg(MMID, uint32_t(Product >> 16), LC_Mul);
+      writeReg(MHI, uint32_t(Product >> 32), LC_Mul);
+      UsesMul = true;
+      return;
+    }
+    default:
+      fault(std::string("unsupported instruction ") +
+            MII.getName(MI.getOpcode()));
+      return;
+  }
+}
+
+/// executeALU - Executes the general instructions. Returns false if MI is
+/// not one.
+bool Simulator::executeALU(const MCInst &MI, const MCInstrDesc &Desc) {
+  ALUOp Op = getALUOp(MI.getOpcode());
+  if (Op == ALU_None) {
+    return false;
+  }
+
+  // The sources are read whether or not the predicate holds.
+  unsigned NumDefs = Desc.getNumDefs();
+  uint32_t Src1 = readOperand(MI, NumDefs);
+  uint32_t Src2 = Op < ALU_MOV ? readOperand(MI, NumDefs + 1) : Src1;
+  if (!testPredicate(MI, Desc)) {
+    return true;
+  }
+
+  bool F = Desc.hasImplicitDefOfPhysReg(ARC::STATUS32);
+  uint32_t Result = 0;
+  bool WriteResult = NumDefs != 0;
+  bool NewC = C, NewV = V;
+  bool Saturated;
+  unsigned Amount = Src2 & 31;
+
+  switch (Op) {
+    case ALU_None:
+      break;
+    case ALU_ADD:  Result = add(Src1, Src2, false, NewC, NewV); break;
+    case ALU_ADC:  Result = add(Src1, Src2, C, NewC, NewV); break;
+    case ALU_SUB:  Result = sub(Src1, Src2, false, NewC, NewV); break;
+    case ALU_SBC:  Result = sub(Src1, Src2, C, NewC, NewV); break;
+    case ALU_CMP:  Result = sub(Src1, Src2, false, NewC, NewV); break;
+    case ALU_ADD1: Result = add(Src1, Src2 << 1, false, NewC, NewV); break;
+    case ALU_ADD2: Result = add(Src1, Src2 << 2, false, NewC, NewV); break;
+    case ALU_ADD3: Result = add(Src1, Src2 << 3, false, NewC, NewV); break;
+    case ALU_SUB1: Result = sub(Src1, Src2 << 1, false, NewC, NewV); break;
+    case ALU_SUB2: Result = sub(Src1, Src2 << 2, false, NewC, NewV); break;
+    case ALU_SUB3: Result = sub(Src1, Src2 << 3, false, NewC, NewV); break;
+    case ALU_AND:  Result = Src1 & Src2; break;
+    case ALU_OR:   Result = Src1 | Src2; break;
+    case ALU_BIC:  Result = Src1 & ~Src2; break;
+    case ALU_XOR:  Result = Src1 ^ Src2; break;
+    case ALU_BSET: Result = Src1 | (1U << Amount); break;
+    case ALU_BCLR: Result = Src1 & ~(1U << Amount); break;
+    case ALU_BXOR: Result = Src1 ^ (1U << Amount); break;
+    case ALU_BMSK:
+      Result = Src1 & uint32_t((uint64_t(2) << Amount) - 1);
+      break;
+    case ALU_MAX:
+    case ALU_MIN: {
+      uint32_t Diff = sub(Src1, Src2, false, NewC, NewV);
+      bool PickSrc2 = Op == ALU_MAX ? int32_t(Src2) > int32_t(Src1)
+                                    : int32_t(Src2) < int32_t(Src1);
+      Result = PickSrc2 ? Src2 : Src1;
+      NewC = PickSrc2;
+      if (F) {
+        setZN(Diff);
+        C = NewC;
+        V = NewV;
+      }
+      F = false;
+      break;
+    }
+    case ALU_MPY: {
+      int64_t Product = int64_t(int32_t(Src1)) * int32_t(Src2);
+      Result = uint32_t(Product);
+      NewV = Product != int64_t(int32_t(Result));
+      UsesMul = true;
+      break;
+    }
+    case ALU_MPYH:
+      Result = uint32_t(uint64_t(int64_t(int32_t(Src1)) * int32_t(Src2)) >> 32);
+      UsesMul = true;
+      break;
+    case ALU_MPYHU:
+      Result = uint32_t((uint64_t(Src1) * Src2) >> 32);
+      UsesMul = true;
+      break;
+    case ALU_ASL:
+      Result = Src1 << Amount;
+      if (Amount) {
+        NewC = (Src1 >> (32 - Amount)) & 0x1;
+      }
+      break;
+    case ALU_LSR:
+      Result = Src1 >> Amount;
+      if (Amount) {
+        NewC = (Src1 >> (Amount - 1)) & 0x1;
+      }
+      break;
+    case ALU_ASR:
+      Result = int32_t(Src1) >> Amount;
+      if (Amount) {
+        NewC = (Src1 >> (Amount - 1)) & 0x1;
+      }
+      break;
+    case ALU_ROR:
+      Result = Amount ? Src1 >> Amount | Src1 << (32 - Amount) : Src1;
+      if (Amount) {
+        NewC = Result >> 31;
+      }
+      break;
+    case ALU_ADDS:
+      Result = saturate(int64_t(int32_t(Src1)) + int32_t(Src2), Saturated);
+      NewV = Saturated;
+      break;
+    case ALU_SUBS:
+      Result = saturate(int64_t(int32_t(Src1)) - int32_t(Src2), Saturated);
+      NewV = Saturated;
+      break;
+    case ALU_DIV:
+    case ALU_DIVU:
+    case ALU_REM:
+    case ALU_REMU:
+      // A division by zero leaves the destination unchanged and sets V.
+      NewV = Src2 == 0;
+      WriteResult = !NewV;
+      if (NewV) {
+        break;
+      }
+      switch (Op) {
+        case ALU_DIV:
+          Result = int32_t(Src2) == -1 ? 0 - Src1
+                                       : uint32_t(int32_t(Src1) / int32_t(Src2));
+          break;
+        case ALU_DIVU:
+          Result = Src1 / Src2;
+          break;
+        case ALU_REM:
+          Result = int32_t(Src2) == -1 ? 0
+                                       : uint32_t(int32_t(Src1) % int32_t(Src2));
+          break;
+        default:
+          Result = Src1 % Src2;
+          break;
+      }
+      break;
+
+    // Single operand instructions.
+    case ALU_MOV:  Result = Src1; break;
+    case ALU_ASL1:
+      Result = Src1 << 1;
+      NewC = Src1 >> 31;
+      NewV = (Src1 ^ Result) >> 31;
+      break;
+    case ALU_ASR1: Result = int32_t(Src1) >> 1; NewC = Src1 & 0x1; break;
+    case ALU_LSR1: Result = Src1 >> 1; NewC = Src1 & 0x1; break;
+    case ALU_SEXB: Result = int8_t(Src1); break;
+    case ALU_SEXW: Result = int16_t(Src1); break;
+    case ALU_EXTB: Result = Src1 & 0xFF; break;
+    case ALU_EXTW: Result = Src1 & 0xFFFF; break;
+    case ALU_ABS:
+      Result = int32_t(Src1) < 0 ? 0 - Src1 : Src1;
+      NewC = Src1 >> 31;
+      NewV = Src1 == 0x80000000;
+      break;
+    case ALU_ABSS:
+      Result = Src1 == 0x80000000 ? 0x7FFFFFFF
+                                  : (int32_t(Src1) < 0 ? 0 - Src1 : Src1);
+      NewV = Src1 == 0x80000000;
+      break;
+    case ALU_NOT:  Result = ~Src1; break;
+    case ALU_NEG:  Result = sub(0, Src1, false, NewC, NewV); break;
+    case ALU_NEGS:
+      Result = Src1 == 0x80000000 ? 0x7FFFFFFF : 0 - Src1;
+      NewV = Src1 == 0x80000000;
+      break;
+    case ALU_NORM: Result = norm(Src1, 32); break;
+    case ALU_SWAP: Result = Src1 << 16 | Src1 >> 16; break;
+  }
+
+  if (F) {
+    setZN(Result);
+    C = NewC;
+    V = NewV;
+  }
+  if (WriteResult) {
+    writeOperand(MI, 0, Result, UsesMul ? LC_Mul : LC_ALU);
+  }
+  return true;
+}
+
+/// executeMemory - Executes the loads and stores. Returns false if MI is not
+/// one.
+bool Simulator::executeMemory(const MCInst &MI, const MCInstrDesc &Desc) {
+  unsigned Size;
+  bool SignExt;
+  AddrMode Mode;
+  if (!getMemoryAccess(MI.getOpcode(), Size, SignExt, Mode)) {
+    return false;
+  }
+
+  bool IsLoad = Desc.mayLoad();
+  unsigned BaseOpNo = IsLoad ? 1 : 0;
+  unsigned End = IsLoad ? MI.getNumOperands() : MI.getNumOperands() - 1;
+  uint32_t Value = IsLoad ? 0 : readOperand(MI, End);
+  uint32_t Base = readOperand(MI, BaseOpNo);
+  uint32_t Offset = End - BaseOpNo > 1 ? readOperand(MI, BaseOpNo + 1) : 0;
+
+  uint32_t Addr = Base + Offset;
+  switch (Mode) {
+    case AM_None:
+      break;
+    case AM_A:
+      writeOperand(MI, BaseOpNo, Addr);
+      break;
+    case AM_AB:
+      writeOperand(MI, BaseOpNo, Addr);
+      Addr = Base;
+      break;
+    case AM_AS:
+      Addr = Base + Offset * Size;
+      break;
+  }
+
+  if (IsLoad) {
+    doLoad(getARCompactRegisterNumbering(MI.getOperand(0).getReg()), Addr,
+           Size, SignExt);
+  } else {
+    doStore(Addr, Size, Value);
+  }
+  return true;
+}
+
+/// executeBranch - Executes the branches, jumps and calls, and LP. Returns
+/// false if MI is not one of them.
+bool Simulator::executeBranch(const MCInst &MI) {
+  // Displacements are relative to the word aligned address of the branch.
+  uint32_t PCL = InstPC & ~3U;
+  unsigned Opcode = MI.getOpcode();
+
+  switch (Opcode) {
+    default:
+      return false;
+
+    case ARC::B:
+    case ARC::B_D:
+    case ARC::B_S:
+      IsBranch = true;
+      branch(PCL + MI.getOperand(0).getImm(), Opcode == ARC::B_D);
+      return true;
+
+    case ARC::BCC:
+    case ARC::BCC_D:
+    case ARC::BCC_S:
+      IsBranch = true;
+      if (testCondition(MI.getOperand(1).getImm())) {
+        branch(PCL + MI.getOperand(0).getImm(), Opcode == ARC::BCC_D);
+      }
+      return true;
+
+    case ARC::BEQ_S:
+    case ARC::BNE_S:
+      IsBranch = true;
+      if (Opcode == ARC::BEQ_S ? Z : !Z) {
+        branch(PCL + MI.getOperand(0).getImm(), false);
+      }
+      return true;
+
+    case ARC::BRCCrr:
+    case ARC::BRCCrr_D:
+    case ARC::BRCCru6:
+    case ARC::BRCCru6_D: {
+      uint32_t Src1 = readOperand(MI, 0), Src2 = readOperand(MI, 1);
+      bool Cond;
+      IsBranch = true;
+      switch (MI.getOperand(3).getImm()) {
+        case ARCCC::COND_EQ: Cond = Src1 == Src2; break;
+        case ARCCC::COND_NE: Cond = Src1 != Src2; break;
+        case ARCCC::COND_LT: Cond = int32_t(Src1) < int32_t(Src2); break;
+        case ARCCC::COND_GE: Cond = int32_t(Src1) >= int32_t(Src2); break;
+        case ARCCC::COND_LO: Cond = Src1 < Src2; break;
+        case ARCCC::COND_HS: Cond = Src1 >= Src2; break;
+        default:
+          fault("illegal instruction");
+          return true;
+      }
+      if (Cond) {
+        branch(PCL + MI.getOperand(2).getImm(),
+               Opcode == ARC::BRCCrr_D || Opcode == ARC::BRCCru6_D);
+      }
+      return true;
+    }
+
+    case ARC::BBIT0ru6:
+    case ARC::BBIT0ru6_D:
+    case ARC::BBIT1ru6:
+    case ARC::BBIT1ru6_D: {
+      uint32_t Bit = (readOperand(MI, 0) >> (readOperand(MI, 1) & 31)) & 1;
+      IsBranch = true;
+      if (Bit == (Opcode == ARC::BBIT1ru6 || Opcode == ARC::BBIT1ru6_D)) {
+        branch(PCL + MI.getOperand(2).getImm(),
+               Opcode == ARC::BBIT0ru6_D || Opcode == ARC::BBIT1ru6_D);
+      }
+      return true;
+    }
+
+    case ARC::BLi:
+    case ARC::BL_D:
+    case ARC::BL_S:
+      IsBranch = true;
+      link(Opcode == ARC::BL_D);
+      branch(PCL + MI.getOperand(0).getImm(), Opcode == ARC::BL_D);
+      return true;
+
+    case ARC::Jr:
+    case ARC::Jr_D:
+    case ARC::Jr_s:
+    case ARC::Jr_s_D:
+      IsBranch = true;
+      branch(readOperand(MI, 0), Opcode == ARC::Jr_D || Opcode == ARC::Jr_s_D);
+      return true;
+
+    case ARC::JLr:
+    case ARC::JLr_D:
+    case ARC::JLr_s:
+    case ARC::JLr_s_D: {
+      bool IsDelayed = Opcode == ARC::JLr_D || Opcode == ARC::JLr_s_D;
+      uint32_t Dest = readOperand(MI, 0);
+      IsBranch = true;
+      link(IsDelayed);
+      branch(Dest, IsDelayed);
+      return true;
+    }
+
+    case ARC::RET:
+    case ARC::RET_D:
+    case ARC::RET_S:
+    case ARC::RET_S_D:
+      IsBranch = true;
+      branch(readReg(BLINK), Opcode == ARC::RET_D || Opcode == ARC::RET_S_D);
+      return true;
+
+    case ARC::RETI1:
+    case ARC::RETI2:
+      IsBranch = true;
+      branch(readReg(Opcode == ARC::RETI1 ? ILINK1 : ILINK2), false);
+      return true;
+
+    case ARC::LP:
+      LPStart = InstPC + InstSize;
+      LPEnd = PCL + MI.getOperand(0).getImm();
+      return true;
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Report.
+//===----------------------------------------------------------------------===//
+
+static void printCounter(raw_ostream &OS, const char *Name, uint64_t Value) {
+  OS << format("  %-32s %14llu\n", Name, (unsigned long long)Value);
+}
+
+void Simulator::printStats(raw_ostream &OS) const {
+  OS << "=== ARCompact simulation ===\n";
+  printCounter(OS, "Instructions retired", S.Instructions);
+  printCounter(OS, "  16-bit", S.Insts16);
+  printCounter(OS, "  32-bit", S.Insts32);
+  printCounter(OS, "  with long immediate", S.Limms);
+  printCounter(OS, "Cycles", S.Cycles);
+  OS << format("  %-32s %14.3f\n", static_cast<const char*>("CPI"),
+               S.Instructions ? double(S.Cycles) / S.Instructions : 0.0);
+  printCounter(OS, "Stall cycles", S.LoadUseStalls + S.MulStalls +
+                                   S.BranchStalls + S.ICacheStalls);
+  printCounter(OS, "  load-use", S.LoadUseStalls);
+  printCounter(OS, "  multiplier", S.MulStalls);
+  printCounter(OS, "  taken branch", S.BranchStalls);
+  printCounter(OS, "  i-cache miss", S.ICacheStalls);
+  printCounter(OS, "Branches taken", S.BranchesTaken);
+  printCounter(OS, "Branches not taken", S.BranchesNotTaken);
+  printCounter(OS, "Delay slots executed", S.DelaySlots);
+  printCounter(OS, "Zero-overhead loop iterations", S.LoopIterations);
+  printCounter(OS, "Loads", S.Loads);
+  printCounter(OS, "Stores", S.Stores);
+  if (IC.isEnabled()) {
+    printCounter(OS, "I-cache accesses", S.ICacheAccesses);
+    printCounter(OS, "I-cache misses", S.ICacheMisses);
+    OS << format("  %-32s %13.2f%%\n",
+                 static_cast<const char*>("I-cache miss rate"),
+                 S.ICacheAccesses ? 100.0 * S.ICacheMisses / S.ICacheAccesses
+                                  : 0.0);
+  }
+  printCounter(OS, "Host calls", S.HostCalls);
+}
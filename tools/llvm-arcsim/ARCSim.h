@@ -0,0 +1,302 @@
+//===-- ARCSim.h - ARCompact instruction set simulator ----------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares a simple instruction set simulator for the ARCompact
+// code produced by llc. Instructions are decoded from a flat memory image by
+// the ARCompact MCDisassembler, executed, and timed on a model of the five
+// stage EnCore pipeline described by the itineraries in ARCompactSchedule.td,
+// together with a set-associative instruction cache.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ARCSIM_H
+#define LLVM_ARCSIM_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/MC/MCInst.h"
+#include "llvm/Support/DataTypes.h"
+#include <string>
+#include <vector>
+
+namespace llvm {
+class MCDisassembler;
+class MCInstPrinter;
+class MCInstrDesc;
+class MCInstrInfo;
+class raw_ostream;
+
+namespace arcsim {
+
+/// Config - The parameters of the pipeline and instruction cache models.
+struct Config {
+  /// LoadLatency - Cycles from the issue of a load until its result can be
+  /// used. The default of two gives the one cycle load-use stall.
+  unsigned LoadLatency;
+
+  /// MulLatency - Cycles for which the multiplier occupies the execute
+  /// stage.
+  unsigned MulLatency;
+
+  /// BranchPenalty - Fetch cycles lost on a taken branch. The delay slot of
+  /// a .d branch hides one of them.
+  unsigned BranchPenalty;
+
+  /// The instruction cache. A size of zero disables it, in which case every
+  /// fetch hits.
+  unsigned ICacheSize;
+  unsigned ICacheLineSize;
+  unsigned ICacheWays;
+  unsigned ICacheMissPenalty;
+
+  /// MaxInstructions - Stop after this many instructions, if non-zero.
+  uint64_t MaxInstructions;
+
+  /// Trace - Print each instruction and the registers it writes.
+  bool Trace;
+
+  Config()
+    : LoadLatency(2), MulLatency(3), BranchPenalty(1), ICacheSize(8192),
+      ICacheLineSize(32), ICacheWays(2), ICacheMissPenalty(10),
+      MaxInstructions(0), Trace(false) {}
+};
+
+/// Stats - The counters reported at the end of a run.
+struct Stats {
+  uint64_t Instructions;
+  uint64_t Insts16;
+  uint64_t Insts32;
+  uint64_t Limms;
+  uint64_t Cycles;
+
+  uint64_t LoadUseStalls;
+  uint64_t MulStalls;
+  uint64_t BranchStalls;
+  uint64_t ICacheStalls;
+
+  uint64_t BranchesTaken;
+  uint64_t BranchesNotTaken;
+  uint64_t DelaySlots;
+  uint64_t LoopIterations;
+
+  uint64_t Loads;
+  uint64_t Stores;
+
+  uint64_t ICacheAccesses;
+  uint64_t ICacheMisses;
+
+  uint64_t HostCalls;
+
+  Stats() { clear(); }
+  void clear();
+};
+
+/// ICache - A set-associative instruction cache with LRU replacement. Only
+/// hits and misses are modelled; the cache holds no data.
+class ICache {
+  unsigned LineShift;
+  unsigned NumSets;
+  unsigned Ways;
+  uint64_t Clock;
+
+  struct Line {
+    uint32_t Tag;
+    uint64_t LastUse;
+    bool Valid;
+  };
+  std::vector<Line> Lines;
+
+public:
+  ICache() : LineShift(0), NumSets(0), Ways(0), Clock(0) {}
+
+  /// init - Sets up a cache of Size bytes. Returns false if the geometry is
+  /// not valid.
+  bool init(unsigned Size, unsigned LineSize, unsigned Ways);
+
+  bool isEnabled() const { return NumSets != 0; }
+
+  /// access - Returns true if the line holding Addr is in the cache, and
+  /// brings it in if it is not.
+  bool access(uint32_t Addr);
+
+  unsigned getLineSize() const { return 1U << LineShift; }
+};
+
+class Simulator;
+
+/// HostFn - Implements a library routine on the host. The arguments are in
+/// the argument registers of the simulated program. Returns false if the
+/// program should stop.
+typedef bool (*HostFn)(Simulator &Sim);
+
+/// Simulator - The state of the simulated processor and its memory.
+class Simulator {
+public:
+  /// Register numbers with a special meaning.
+  enum {
+    GP = 26, FP = 27, SP = 28, ILINK1 = 29, ILINK2 = 30, BLINK = 31,
+    MLO = 57, MMID = 58, MHI = 59, LP_COUNT = 60
+  };
+
+  /// HostBase - Host routines are given a word each from here up, in the
+  /// page below the program so that calls to them are in range of BL. The
+  /// first of them returns from the entry function.
+  static const uint32_t HostBase = 0x800;
+
+  /// Simulator - Creates a simulator with MemSize bytes of memory, which
+  /// decodes instructions with Dis. IP is used to print them when tracing,
+  /// and may be null.
+  Simulator(const Config &C, uint32_t MemSize, const MCDisassembler &Dis,
+            const MCInstrInfo &MII, MCInstPrinter *IP);
+
+  /// getMemorySize - Returns the size of the flat memory, which starts at
+  /// address zero.
+  uint32_t getMemorySize() const { return Memory.size(); }
+
+  /// getMemory - Returns a pointer to Size bytes of memory at Addr, or null
+  /// if they are out of range.
+  uint8_t *getMemory(uint32_t Addr, uint32_t Size);
+
+  /// getHostCallAddress - Returns the address of the host implementation
+  /// of the library routine Name, or zero if there is none.
+  uint32_t getHostCallAddress(StringRef Name);
+
+  /// setHeap - Sets the region from which malloc allocates.
+  void setHeap(uint32_t Start, uint32_t End) {
+    HeapPtr = Start;
+    HeapEnd = End;
+  }
+
+  uint32_t getReg(unsigned Reg) const { return R[Reg]; }
+  void setReg(unsigned Reg, uint32_t Value) { R[Reg] = Value; }
+
+  /// getArg - Returns argument number N of the routine being called, from
+  /// r0-r7 or the stack.
+  uint32_t getArg(unsigned N);
+
+  /// run - Calls the function at Entry and runs until it returns or the
+  /// program exits. Returns false if execution stopped on an error.
+  bool run(uint32_t Entry);
+
+  /// stop - Halts the simulation with the given exit code.
+  void stop(int Code) { Halted = true; ExitCode = Code; }
+
+  /// fault - Halts the simulation on an error.
+  void fault(const std::string &Msg);
+
+  /// getPC - Returns the address of the next instruction, or of the one
+  /// which faulted.
+  uint32_t getPC() const { return PC; }
+
+  int getExitCode() const { return ExitCode; }
+  const std::string &getError() const { return Error; }
+  const Stats &getStats() const { return S; }
+
+  /// printStats - Writes the report of the run to OS.
+  void printStats(raw_ostream &OS) const;
+
+  uint32_t load(uint32_t Addr, unsigned Size);
+  void store(uint32_t Addr, unsigned Size, uint32_t Value);
+
+  /// allocate - Allocates Size bytes of heap, returning zero if it is full.
+  uint32_t allocate(uint32_t Size);
+
+private:
+  /// The latency classes of the results written by an instruction.
+  enum LatencyClass { LC_ALU, LC_Load, LC_Mul };
+
+  /// DecodedInst - An instruction as decoded by the MCDisassembler, and its
+  /// size including any long immediate.
+  struct DecodedInst {
+    MCInst Inst;
+    unsigned Size;
+  };
+
+  Config Conf;
+  Stats S;
+  ICache IC;
+  std::vector<uint8_t> Memory;
+
+  const MCDisassembler &Dis;
+  const MCInstrInfo &MII;
+  MCInstPrinter *IP;
+
+  /// Decoded - The instructions decoded so far, by address. A store to the
+  /// range [DecodedLow, DecodedHigh) sets FlushDecoded, which throws them
+  /// away before the next decode.
+  DenseMap<uint32_t, DecodedInst> Decoded;
+  uint32_t DecodedLow, DecodedHigh;
+  bool FlushDecoded;
+
+  uint32_t R[64];
+  uint32_t PC;
+  bool Z, N, C, V;
+  uint32_t LPStart, LPEnd;
+
+  uint32_t HeapPtr, HeapEnd;
+
+  bool Halted;
+  int ExitCode;
+  std::string Error;
+
+  // The state of the instruction being executed.
+  uint32_t InstPC;
+  unsigned InstSize;
+  bool UsesMul;
+  bool IsBranch;
+  bool Taken;
+  bool Delayed;
+  uint32_t Target;
+  unsigned NumReads, NumWrites;
+  unsigned Reads[4], Writes[4];
+  LatencyClass WriteClass[4];
+
+  // Delay slot handling.
+  bool InDelaySlot;
+  uint32_t DelayTarget;
+
+  // The pipeline model.
+  uint64_t NextIssue;
+  uint64_t MulFree;
+  uint64_t Ready[64];
+  LatencyClass ReadyClass[64];
+
+  bool step();
+  bool callHost(unsigned Index);
+  const DecodedInst *decode(uint32_t Addr);
+  void execute(const MCInst &MI, const MCInstrDesc &Desc);
+  bool executeALU(const MCInst &MI, const MCInstrDesc &Desc);
+  bool executeMemory(const MCInst &MI, const MCInstrDesc &Desc);
+  bool executeBranch(const MCInst &MI);
+  void timeInstruction();
+  void traceInstruction(const MCInst &MI);
+
+  uint32_t readReg(unsigned Reg);
+  void writeReg(unsigned Reg, uint32_t Value, LatencyClass LC = LC_ALU);
+  uint32_t readOperand(const MCInst &MI, unsigned OpNo);
+  void writeOperand(const MCInst &MI, unsigned OpNo, uint32_t Value,
+                    LatencyClass LC = LC_ALU);
+
+  uint32_t readAuxReg(uint32_t Num);
+  void writeAuxReg(uint32_t Num, uint32_t Value);
+
+  bool testCondition(unsigned CC) const;
+  bool testPredicate(const MCInst &MI, const MCInstrDesc &Desc) const;
+  void setZN(uint32_t Result) { Z = Result == 0; N = Result >> 31; }
+
+  void branch(uint32_t Dest, bool IsDelayed);
+  void link(bool IsDelayed);
+  void doLoad(unsigned Dst, uint32_t Addr, unsigned Size, bool SignExt);
+  void doStore(uint32_t Addr, unsigned Size, uint32_t Value);
+};
+
+} // end namespace arcsim
+} // end namespace llvm
+
+#endif
@@ -0,0 +1,745 @@
+//===-- llvm-arcsim.cpp - ARCompact instruction set simulator -------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This program runs ARCompact code on a simple model of the EnCore pipeline,
+// and reports how many instructions were retired, how many cycles they took,
+// where the pipeline stalled and how the instruction cache behaved. It is
+// meant for measuring the code generated by llc:
+//
+//   llc -march=arcompact -filetype=obj foo.ll -o foo.o
+//   llvm-arcsim foo.o
+//
+// The inputs are relocatable ELF objects, or assembly files (ending in .s)
+// which are assembled in memory first. They are laid out in a flat memory
+// starting at 0x1000, with the small data sections last so that they can be
+// reached from GP, and then linked. Calls to functions which no input
+// defines are sent to host implementations of the common C library routines.
+// Execution starts by calling the entry function with the given arguments,
+// and ends when it returns or calls exit(). Instructions are decoded with
+// the ARCompact disassembler.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ARCSim.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/Triple.h"
+#include "llvm/MC/MCAsmBackend.h"
+#include "llvm/MC/MCAsmInfo.h"
+#include "llvm/MC/MCCodeEmitter.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCDisassembler.h"
+#include "llvm/MC/MCInstPrinter.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCObjectFileInfo.h"
+#include "llvm/MC/MCParser/MCAsmParser.h"
+#include "llvm/MC/MCRegisterInfo.h"
+#include "llvm/MC/MCStreamer.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/MC/MCTargetAsmParser.h"
+#include "llvm/MC/SubtargetFeature.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/Casting.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/ELF.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/system_error.h"
+#include <map>
+using namespace llvm;
+using namespace object;
+
+static cl::list<std::string>
+InputFilenames(cl::Positional, cl::desc("<input objects and .s files>"),
+               cl::OneOrMore);
+
+static cl::opt<std::string>
+MCPU("mcpu", cl::desc("Target CPU for assembling and decoding"),
+     cl::value_desc("cpu-name"), cl::init(""));
+
+static cl::list<std::string>
+MAttrs("mattr", cl::CommaSeparated,
+       cl::desc("Target features for assembling and decoding"),
+       cl::value_desc("a1,+a2,-a3,..."));
+
+static cl::opt<std::string>
+EntryName("entry", cl::desc("Function to call (default = main)"),
+          cl::init("main"));
+
+static cl::list<int>
+EntryArgs("args", cl::CommaSeparated,
+          cl::desc("Integer arguments passed to the entry function"));
+
+static cl::opt<unsigned>
+MemorySize("memory-size", cl::desc("Size of the simulated memory in KiB"),
+           cl::init(16384));
+
+static cl::opt<unsigned>
+LoadLatency("load-latency",
+            cl::desc("Cycles from a load until its result can be used"),
+            cl::init(2));
+
+static cl::opt<unsigned>
+MulLatency("mul-latency",
+           cl::desc("Cycles for which a multiply occupies the pipeline"),
+           cl::init(3));
+
+static cl::opt<unsigned>
+BranchPenalty("branch-penalty",
+              cl::desc("Fetch cycles lost on a taken branch"),
+              cl::init(1));
+
+static cl::opt<unsigned>
+ICacheSize("icache-size",
+           cl::desc("Instruction cache size in bytes, 0 to disable"),
+           cl::init(8192));
+
+static cl::opt<unsigned>
+ICacheLineSize("icache-line-size",
+               cl::desc("Instruction cache line size in bytes"),
+               cl::init(32));
+
+static cl::opt<unsigned>
+ICacheWays("icache-ways", cl::desc("Instruction cache associativity"),
+           cl::init(2));
+
+static cl::opt<unsigned>
+ICacheMissPenalty("icache-miss-penalty",
+                  cl::desc("Cycles lost on an instruction cache miss"),
+                  cl::init(10));
+
+static cl::opt<unsigned long long>
+MaxInstructions("max-instructions",
+                cl::desc("Stop after this many instructions (0 = no limit)"),
+                cl::init(0));
+
+static cl::opt<bool>
+Trace("trace", cl::desc("Print each instruction as it retires"));
+
+static cl::opt<bool>
+Quiet("quiet", cl::desc("Do not print the statistics"));
+
+static std::string ToolName;
+
+/// TripleName - The triple the inputs are assembled and decoded for.
+static const char *const TripleName = "arcompact";
+
+/// LoadAddress - Where the first section is placed. The page below it is
+/// left unmapped in spirit, so that null pointers are easier to spot.
+static const uint32_t LoadAddress = 0x1000;
+
+/// SDABaseOffset - _SDA_BASE_ is placed this far into the small data, so
+/// that the signed 9-bit offsets of the GP relative loads and stores reach
+/// the start of it.
+static const uint32_t SDABaseOffset = 256;
+
+static bool error(const Twine &Msg) {
+  errs() << ToolName << ": " << Msg << "\n";
+  return false;
+}
+
+static bool error(StringRef File, error_code EC) {
+  return error(File + ": " + EC.message());
+}
+
+namespace {
+/// Linker - Lays out and links the input objects in the simulator's memory.
+class Linker {
+  arcsim::Simulator &Sim;
+  std::vector<ObjectFile*> Objects;
+
+  /// SectionAddrs - The address given to each loaded section, keyed by its
+  /// header.
+  std::map<uintptr_t, uint32_t> SectionAddrs;
+
+  /// Globals - The address of each global symbol.
+  StringMap<uint32_t> Globals;
+  StringMap<bool> WeakGlobals;
+
+  uint32_t NextAddr;
+  uint32_t SDABase;
+
+  bool allocate(uint32_t Size, uint32_t Align, uint32_t &Addr);
+  bool layoutSections(ObjectFile *Obj, bool SmallData);
+  bool defineSymbols(ObjectFile *Obj);
+  bool resolveSymbol(ObjectFile *Obj, SymbolRef Sym, uint32_t &Addr);
+  bool applyRelocations(ObjectFile *Obj);
+  bool applyRelocation(StringRef File, uint32_t Type, uint32_t P,
+                       uint32_t S, int64_t A);
+
+public:
+  explicit Linker(arcsim::Simulator &S)
+    : Sim(S), NextAddr(LoadAddress), SDABase(0) {}
+  ~Linker();
+
+  /// addObject - Adds Obj to the program, taking ownership of it.
+  bool addObject(ObjectFile *Obj);
+  bool link();
+
+  uint32_t getSDABase() const { return SDABase; }
+  uint32_t getEnd() const { return NextAddr; }
+
+  /// lookup - Finds the address of global symbol Name.
+  bool lookup(StringRef Name, uint32_t &Addr) const;
+};
+}
+
+Linker::~Linker() {
+  for (unsigned i = 0, e = Objects.size(); i != e; ++i) {
+    delete Objects[i];
+  }
+}
+
+bool Linker::addObject(ObjectFile *Obj) {
+  Objects.push_back(Obj);
+  if (Obj->getArch() != Triple::arcompact) {
+    return error(Obj->getFileName() + ": not an ARCompact object (" +
+                 Obj->getFileFormatName() + ")");
+  }
+  return true;
+}
+
+bool Linker::allocate(uint32_t Size, uint32_t Align, uint32_t &Addr) {
+  Addr = RoundUpToAlignment(NextAddr, std::max(Align, 1U));
+  if (Addr < NextAddr || Size > Sim.getMemorySize() ||
+      Addr > Sim.getMemorySize() - Size) {
+    return error("the program does not fit in memory");
+  }
+  NextAddr = Addr + Size;
+  return true;
+}
+
+/// isSmallDataSection - Returns true for the sections addressed relative to
+/// GP.
+static bool isSmallDataSection(StringRef Name) {
+  return Name.startswith(".sdata") || Name.startswith(".sbss");
+}
+
+/// layoutSections - Places the loadable sections of Obj, either the small
+/// data sections or all of the others.
+bool Linker::layoutSections(ObjectFile *Obj, bool SmallData) {
+  error_code EC;
+  for (section_iterator I = Obj->begin_sections(), E = Obj->end_sections();
+       I != E; I.increment(EC)) {
+    if (EC) {
+      return error(Obj->getFileName(), EC);
+    }
+
+    StringRef Name;
+    uint64_t Size, Align;
+    bool IsLoadable, IsBSS;
+    if ((EC = I->getName(Name)) || (EC = I->getSize(Size)) ||
+        (EC = I->getAlignment(Align)) ||
+        (EC = I->isRequiredForExecution(IsLoadable)) ||
+        (EC = I->isBSS(IsBSS))) {
+      return error(Obj->getFileName(), EC);
+    }
+    if (!IsLoadable || isSmallDataSection(Name) != SmallData) {
+      continue;
+    }
+
+    uint32_t Addr;
+    if (Size > UINT32_MAX || !allocate(Size, Align, Addr)) {
+      return error(Obj->getFileName() + ": section " + Name +
+                   " does not fit in memory");
+    }
+    SectionAddrs[I->getRawDataRefImpl().p] = Addr;
+
+    if (!IsBSS) {
+      StringRef Contents;
+      if ((EC = I->getContents(Contents))) {
+        return error(Obj->getFileName(), EC);
+      }
+      memcpy(Sim.getMemory(Addr, Size), Contents.data(), Size);
+    }
+  }
+  return true;
+}
+
+/// defineSymbols - Adds the global symbols of Obj to the symbol table, and
+/// allocates its common symbols.
+bool Linker::defineSymbols(ObjectFile *Obj) {
+  error_code EC;
+  for (symbol_iterator I = Obj->begin_symbols(), E = Obj->end_symbols();
+       I != E; I.increment(EC)) {
+    if (EC) {
+      return error(Obj->getFileName(), EC);
+    }
+
+    StringRef Name;
+    uint32_t Flags;
+    if ((EC = I->getName(Name)) || (EC = I->getFlags(Flags))) {
+      return error(Obj->getFileName(), EC);
+    }
+    if (!(Flags & SymbolRef::SF_Global) || (Flags & SymbolRef::SF_Undefined)) {
+      continue;
+    }
+
+    bool IsWeak = Flags & SymbolRef::SF_Weak;
+    uint32_t Addr;
+    if (Flags & SymbolRef::SF_Common) {
+      // Common symbols go after everything else, unless they are defined.
+      if (Globals.count(Name)) {
+        continue;
+      }
+      uint64_t Size;
+      if ((EC = I->getSize(Size))) {
+        return error(Obj->getFileName(), EC);
+      }
+      if (Size > UINT32_MAX || !allocate(Size, 8, Addr)) {
+        return false;
+      }
+      IsWeak = true;
+    } else if (!resolveSymbol(Obj, *I, Addr)) {
+      return false;
+    }
+
+    StringMap<uint32_t>::iterator G = Globals.find(Name);
+    if (G != Globals.end()) {
+      if (IsWeak) {
+        continue;
+      }
+      if (!WeakGlobals[Name]) {
+        return error(Obj->getFileName() + ": duplicate symbol " + Name);
+      }
+    }
+    Globals[Name] = Addr;
+    WeakGlobals[Name] = IsWeak;
+  }
+  return true;
+}
+
+/// resolveSymbol - Finds the address of the symbol Sym of Obj.
+bool Linker::resolveSymbol(ObjectFile *Obj, SymbolRef Sym, uint32_t &Addr) {
+  StringRef File = Obj->getFileName();
+  StringRef Name;
+  uint32_t Flags;
+  error_code EC;
+  if ((EC = Sym.getName(Name)) || (EC = Sym.getFlags(Flags))) {
+    return error(File, EC);
+  }
+
+  if ((Flags & SymbolRef::SF_Global) || (Flags & SymbolRef::SF_Undefined)) {
+    if (lookup(Name, Addr)) {
+      return true;
+    }
+    if (Flags & SymbolRef::SF_Undefined) {
+      if ((Addr = Sim.getHostCallAddress(Name))) {
+        return true;
+      }
+      return error(File + ": undefined symbol " + Name);
+    }
+  }
+
+  // A defined symbol, or the section symbol used by local relocations.
+  section_iterator Sec = Obj->end_sections();
+  uint64_t Value;
+  if ((EC = Sym.getSection(Sec)) || (EC = Sym.getAddress(Value))) {
+    return error(File, EC);
+  }
+  if (Value == UnknownAddressOrSize) {
+    return error(File + ": cannot resolve symbol " + Name);
+  }
+  if (Sec == Obj->end_sections()) {
+    Addr = Value;
+    return true;
+  }
+
+  std::map<uintptr_t, uint32_t>::iterator S =
+    SectionAddrs.find(Sec->getRawDataRefImpl().p);
+  if (S == SectionAddrs.end()) {
+    return error(File + ": symbol " + Name + " is in an unloaded section");
+  }
+  Addr = S->second + Value;
+  return true;
+}
+
+bool Linker::lookup(StringRef Name, uint32_t &Addr) const {
+  StringMap<uint32_t>::const_iterator G = Globals.find(Name);
+  if (G == Globals.end()) {
+    return false;
+  }
+  Addr = G->second;
+  return true;
+}
+
+/// writeInstWord - ORs Value into the 32-bit instruction at P, which is
+/// stored as two little endian half-words, the high one first.
+static void writeInstWord(uint8_t *P, uint32_t Value) {
+  P[0] |= uint8_t(Value >> 16);
+  P[1] |= uint8_t(Value >> 24);
+  P[2] |= uint8_t(Value);
+  P[3] |= uint8_t(Value >> 8);
+}
+
+static void writeLE(uint8_t *P, uint32_t Value, unsigned Size) {
+  for (unsigned i = 0; i != Size; ++i) {
+    P[i] = uint8_t(Value >> (i * 8));
+  }
+}
+
+/// applyRelocation - Applies relocation Type at address P, against symbol
+/// address S with addend A. The scattering of the value into the
+/// instruction follows adjustFixupValue in ARCompactAsmBackend.cpp.
+bool Linker::applyRelocation(StringRef File, uint32_t Type, uint32_t P,
+                             uint32_t S, int64_t A) {
+  uint8_t *Loc = Sim.getMemory(P, 4);
+  if (!Loc && !(Loc = Sim.getMemory(P, 1))) {
+    return error(File + ": relocation outside of memory");
+  }
+
+  int64_t PCRel = int64_t(S) + A - (P & ~3U);
+  uint32_t V = uint32_t(PCRel);
+  bool InRange = true;
+
+  switch (Type) {
+    case ELF::R_ARC_NONE:
+      return true;
+    case ELF::R_ARC_8:
+      writeLE(Loc, S + A, 1);
+      return true;
+    case ELF::R_ARC_16:
+      writeLE(Loc, S + A, 2);
+      return true;
+    case ELF::R_ARC_32:
+      writeLE(Loc, S + A, 4);
+      return true;
+    case ELF::R_ARC_PC32:
+      writeLE(Loc, S + A - P, 4);
+      return true;
+    case ELF::R_ARC_32_ME:
+      Loc[0] = Loc[1] = Loc[2] = Loc[3] = 0;
+      writeInstWord(Loc, S + A);
+      return true;
+    case ELF::R_ARC_S21H_PCREL:
+      InRange = isInt<21>(PCRel) && !(V & 0x1);
+      writeInstWord(Loc, ((V >> 1) & 0x3FF) << 17 | ((V >> 11) & 0x3FF) << 6);
+      break;
+    case ELF::R_ARC_S25H_PCREL:
+      InRange = isInt<25>(PCRel) && !(V & 0x1);
+      writeInstWord(Loc, ((V >> 1) & 0x3FF) << 17 | ((V >> 11) & 0x3FF) << 6 |
+                         ((V >> 21) & 0xF));
+      break;
+    case ELF::R_ARC_S21W_PCREL:
+      InRange = isInt<21>(PCRel) && !(V & 0x3);
+      writeInstWord(Loc, ((V >> 2) & 0x1FF) << 18 | ((V >> 11) & 0x3FF) << 6);
+      break;
+    case ELF::R_ARC_S25W_PCREL:
+      InRange = isInt<25>(PCRel) && !(V & 0x3);
+      writeInstWord(Loc, ((V >> 2) & 0x1FF) << 18 | ((V >> 11) & 0x3FF) << 6 |
+                         ((V >> 21) & 0xF));
+      break;
+    case ELF::R_ARC_S13_PCREL: {
+      InRange = isInt<13>(PCRel) && !(V & 0x3);
+      uint16_t Inst = Loc[0] | Loc[1] << 8;
+      writeLE(Loc, Inst | ((V >> 2) & 0x7FF), 2);
+      break;
+    }
+    case ELF::R_ARC_SDA_LDST:
+    case ELF::R_ARC_SDA_LDST1:
+    case ELF::R_ARC_SDA_LDST2: {
+      unsigned Shift = Type - ELF::R_ARC_SDA_LDST;
+      int64_t Offset = int64_t(S) + A - SDABase;
+      InRange = isInt<9>(Offset >> Shift) && !(Offset & ((1 << Shift) - 1));
+      uint32_t Field = uint32_t(Offset >> Shift);
+      writeInstWord(Loc, (Field & 0xFF) << 16 | ((Field >> 8) & 0x1) << 15);
+      break;
+    }
+    default:
+      return error(File + ": unsupported relocation type " + Twine(Type));
+  }
+
+  if (!InRange) {
+    return error(File + ": relocation target out of range at " +
+                 Twine::utohexstr(P));
+  }
+  return true;
+}
+
+/// applyRelocations - Applies the relocations of each loaded section of Obj.
+bool Linker::applyRelocations(ObjectFile *Obj) {
+  error_code EC;
+  for (section_iterator I = Obj->begin_sections(), E = Obj->end_sections();
+       I != E; I.increment(EC)) {
+    if (EC) {
+      return error(Obj->getFileName(), EC);
+    }
+
+    std::map<uintptr_t, uint32_t>::iterator Sec =
+      SectionAddrs.find(I->getRawDataRefImpl().p);
+    if (Sec == SectionAddrs.end()) {
+      continue;
+    }
+
+    for (relocation_iterator RI = I->begin_relocations(),
+                             RE = I->end_relocations();
+         RI != RE; RI.increment(EC)) {
+      if (EC) {
+        return error(Obj->getFileName(), EC);
+      }
+
+      uint64_t Offset, Type;
+      int64_t Addend;
+      SymbolRef Sym;
+      if ((EC = RI->getOffset(Offset)) || (EC = RI->getType(Type)) ||
+          (EC = RI->getAdditionalInfo(Addend)) ||
+          (EC = RI->getSymbol(Sym))) {
+        return error(Obj->getFileName(), EC);
+      }
+
+      uint32_t S;
+      if (!resolveSymbol(Obj, Sym, S) ||
+          !applyRelocation(Obj->getFileName(), Type, Sec->second + Offset, S,
+                           Addend)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool Linker::link() {
+  for (unsigned i = 0, e = Objects.size(); i != e; ++i) {
+    if (!layoutSections(Objects[i], false)) {
+      return false;
+    }
+  }
+
+  // The small data goes last, so that the heap and the common symbols do not
+  // come between its sections.
+  uint32_t SmallData = RoundUpToAlignment(NextAddr, 8);
+  NextAddr = SmallData;
+  for (unsigned i = 0, e = Objects.size(); i != e; ++i) {
+    if (!layoutSections(Objects[i], true)) {
+      return false;
+    }
+  }
+  SDABase = SmallData + SDABaseOffset;
+  Globals["_SDA_BASE_"] = SDABase;
+
+  for (unsigned i = 0, e = Objects.size(); i != e; ++i) {
+    if (!defineSymbols(Objects[i])) {
+      return false;
+    }
+  }
+  for (unsigned i = 0, e = Objects.size(); i != e; ++i) {
+    if (!applyRelocations(Objects[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+namespace {
+/// TargetTools - The MC layer objects the simulator and the assembler share.
+struct TargetTools {
+  const Target *TheTarget;
+  OwningPtr<const MCAsmInfo> MAI;
+  OwningPtr<const MCRegisterInfo> MRI;
+  OwningPtr<const MCInstrInfo> MII;
+  OwningPtr<MCSubtargetInfo> STI;
+  OwningPtr<const MCDisassembler> Dis;
+  OwningPtr<MCInstPrinter> IP;
+
+  bool init();
+};
+}
+
+bool TargetTools::init() {
+  std::string Error;
+  TheTarget = TargetRegistry::lookupTarget(TripleName, Error);
+  if (!TheTarget) {
+    return error(Error);
+  }
+
+  std::string FeaturesStr;
+  if (!MAttrs.empty()) {
+    SubtargetFeatures Features;
+    for (unsigned i = 0; i != MAttrs.size(); ++i) {
+      Features.AddFeature(MAttrs[i]);
+    }
+    FeaturesStr = Features.getString();
+  }
+
+  MAI.reset(TheTarget->createMCAsmInfo(TripleName));
+  MRI.reset(TheTarget->createMCRegInfo(TripleName));
+  MII.reset(TheTarget->createMCInstrInfo());
+  STI.reset(TheTarget->createMCSubtargetInfo(TripleName, MCPU, FeaturesStr));
+  if (!MAI || !MRI || !MII || !STI) {
+    return error("unable to create the ARCompact target description");
+  }
+
+  Dis.reset(TheTarget->createMCDisassembler(*STI));
+  if (!Dis) {
+    return error("no disassembler for the ARCompact target");
+  }
+
+  // The printer is only used for tracing, so it is not required.
+  IP.reset(TheTarget->createMCInstPrinter(0, *MAI, *MII, *MRI, *STI));
+  return true;
+}
+
+/// assemble - Assembles File into an in-memory object.
+static ObjectFile *assemble(StringRef File, TargetTools &T) {
+  OwningPtr<MemoryBuffer> Buffer;
+  if (error_code EC = MemoryBuffer::getFileOrSTDIN(File, Buffer)) {
+    error(File, EC);
+    return 0;
+  }
+
+  SourceMgr SrcMgr;
+  SrcMgr.AddNewSourceBuffer(Buffer.take(), SMLoc());
+
+  OwningPtr<MCObjectFileInfo> MOFI(new MCObjectFileInfo());
+  MCContext Ctx(*T.MAI, *T.MRI, MOFI.get(), &SrcMgr);
+  MOFI->InitMCObjectFileInfo(TripleName, Reloc::Default, CodeModel::Default,
+                             Ctx);
+
+  SmallString<4096> Bytes;
+  raw_svector_ostream OS(Bytes);
+  MCCodeEmitter *CE = T.TheTarget->createMCCodeEmitter(*T.MII, *T.STI, Ctx);
+  MCAsmBackend *MAB = T.TheTarget->createMCAsmBackend(TripleName);
+  OwningPtr<MCStreamer> Str(T.TheTarget->createMCObjectStreamer(
+      TripleName, Ctx, *MAB, OS, CE, false, false));
+
+  OwningPtr<MCAsmParser> Parser(createMCAsmParser(SrcMgr, Ctx, *Str,
+                                                  *T.MAI));
+  OwningPtr<MCTargetAsmParser> TAP(
+      T.TheTarget->createMCAsmParser(*T.STI, *Parser));
+  if (!TAP) {
+    error("no assembler for the ARCompact target");
+    return 0;
+  }
+  Parser->setTargetParser(*TAP);
+  if (Parser->Run(false)) {
+    return 0;
+  }
+  OS.flush();
+
+  ObjectFile *Obj = ObjectFile::createObjectFile(
+      MemoryBuffer::getMemBufferCopy(Bytes.str(), File));
+  if (!Obj) {
+    error(File + ": cannot read the assembled object");
+  }
+  return Obj;
+}
+
+/// loadInput - Reads the object File, or assembles it if it is a .s file.
+static ObjectFile *loadInput(StringRef File, TargetTools &T) {
+  if (File.endswith(".s")) {
+    return assemble(File, T);
+  }
+
+  OwningPtr<Binary> Bin;
+  if (error_code EC = createBinary(File, Bin)) {
+    error(File, EC);
+    return 0;
+  }
+  if (!isa<ObjectFile>(Bin.get())) {
+    error(File + ": not an object file");
+    return 0;
+  }
+  return cast<ObjectFile>(Bin.take());
+}
+
+int main(int argc, char **argv) {
+  // Print a stack trace if we signal out.
+  sys::PrintStackTraceOnErrorSignal();
+  PrettyStackTraceProgram X(argc, argv);
+
+  llvm_shutdown_obj Y;  // Call llvm_shutdown() on exit.
+
+  LLVMInitializeARCompactTargetInfo();
+  LLVMInitializeARCompactTargetMC();
+  LLVMInitializeARCompactAsmParser();
+  LLVMInitializeARCompactDisassembler();
+
+  cl::ParseCommandLineOptions(argc, argv, "ARCompact simulator\n");
+  ToolName = argv[0];
+
+  TargetTools T;
+  if (!T.init()) {
+    return 1;
+  }
+
+  if (MemorySize < 64 || MemorySize > 1024 * 1024) {
+    error("memory size must be between 64 KiB and 1 GiB");
+    return 1;
+  }
+
+  arcsim::Config Conf;
+  Conf.LoadLatency = LoadLatency;
+  Conf.MulLatency = MulLatency;
+  Conf.BranchPenalty = BranchPenalty;
+  Conf.ICacheSize = ICacheSize;
+  Conf.ICacheLineSize = ICacheLineSize;
+  Conf.ICacheWays = ICacheWays;
+  Conf.ICacheMissPenalty = ICacheMissPenalty;
+  Conf.MaxInstructions = MaxInstructions;
+  Conf.Trace = Trace;
+
+  arcsim::Simulator Sim(Conf, MemorySize * 1024, *T.Dis, *T.MII,
+                        T.IP.get());
+  if (!Sim.getError().empty()) {
+    error(Sim.getError());
+    return 1;
+  }
+
+  Linker L(Sim);
+  for (unsigned i = 0, e = InputFilenames.size(); i != e; ++i) {
+    ObjectFile *Obj = loadInput(InputFilenames[i], T);
+    if (!Obj || !L.addObject(Obj)) {
+      return 1;
+    }
+  }
+  if (!L.link()) {
+    return 1;
+  }
+
+  uint32_t Entry;
+  if (!L.lookup(EntryName, Entry)) {
+    error("entry function " + EntryName + " is not defined");
+    return 1;
+  }
+  if (EntryArgs.size() > 8) {
+    error("at most eight arguments can be passed to the entry function");
+    return 1;
+  }
+  for (unsigned i = 0, e = EntryArgs.size(); i != e; ++i) {
+    Sim.setReg(i, EntryArgs[i]);
+  }
+  Sim.setReg(arcsim::Simulator::GP, L.getSDABase());
+
+  // The heap takes the memory between the program and the stack, which gets
+  // the top quarter.
+  uint32_t HeapStart = RoundUpToAlignment(L.getEnd(), 16);
+  uint32_t StackLimit = Sim.getMemorySize() - Sim.getMemorySize() / 4;
+  Sim.setHeap(HeapStart, std::max(HeapStart, StackLimit));
+
+  bool Success = Sim.run(Entry);
+  outs().flush();
+
+  if (!Quiet) {
+    Sim.printStats(errs());
+  }
+  if (!Success) {
+    error(Sim.getError() + " at pc 0x" + Twine::utohexstr(Sim.getPC()));
+    return 1;
+  }
+  return Sim.getExitCode() & 0xFF;
+}
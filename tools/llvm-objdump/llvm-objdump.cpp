@@ -27,8 +27,10 @@
 #include "llvm/MC/MCInst.h"
 #include "llvm/MC/MCInstPrinter.h"
 #include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCInstrItineraries.h"
 #include "llvm/MC/MCRegisterInfo.h"
 #include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/MC/SubtargetFeature.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
@@ -84,6 +86,22 @@ cl::opt<std::string>
 llvm::ArchName("arch", cl::desc("Target arch to disassemble for, "
                                 "see -version for available targets"));
 
+static cl::opt<std::string>
+MCPU("mcpu",
+     cl::desc("Target a specific cpu type (-mcpu=help for details)"),
+     cl::value_desc("cpu-name"), cl::init(""));
+
+static cl::list<std::string>
+MAttrs("mattr", cl::CommaSeparated,
+       cl::desc("Target specific attributes (-mattr=help for details)"),
+       cl::value_desc("a1,+a2,-a3,..."));
+
+static cl::opt<bool>
+PrintCosts("print-costs",
+           cl::desc("Annotate each disassembled instruction with its size, "
+                    "and the issue cycles and latency of its scheduling "
+                    "class on the -mcpu processor"));
+
 static cl::opt<bool>
 SectionHeaders("section-headers", cl::desc("Display summaries of the headers "
                                            "for each section."));
@@ -157,6 +175,36 @@ void llvm::DumpBytes(StringRef bytes) {
   outs() << output;
 }
 
+/// PrintInstCost - Prints the encoded size of an instruction, together with
+/// the number of cycles for which it occupies its busiest pipeline stage and,
+/// if it defines a register, the number of cycles until the result can be
+/// used, as described by the itineraries.
+static void PrintInstCost(const MCInst &Inst, uint64_t Size,
+                          const MCInstrInfo &MII,
+                          const InstrItineraryData &Itins,
+                          const MCAsmInfo &MAI, uint64_t &TotalCycles) {
+  const MCInstrDesc &Desc = MII.get(Inst.getOpcode());
+  unsigned Class = Desc.getSchedClass();
+
+  unsigned Issue = 1;
+  for (const InstrStage *IS = Itins.beginStage(Class),
+         *E = Itins.endStage(Class); IS != E; ++IS)
+    Issue = std::max(Issue, IS->getCycles());
+  TotalCycles += Issue;
+
+  outs() << "\t" << MAI.getCommentString() << " size " << Size
+         << ", issue " << Issue;
+
+  // The latency is from the cycle in which the result is defined, to the one
+  // in which the first source is read.
+  if (Desc.getNumDefs() != 0 && Desc.getNumOperands() > Desc.getNumDefs()) {
+    int DefCycle = Itins.getOperandCycle(Class, 0);
+    int UseCycle = Itins.getOperandCycle(Class, Desc.getNumDefs());
+    if (DefCycle >= 0 && UseCycle >= 0)
+      outs() << ", latency " << (DefCycle - UseCycle + 1);
+  }
+}
+
 static bool RelocAddressLess(RelocationRef a, RelocationRef b) {
   uint64_t a_addr, b_addr;
   if (error(a.getAddress(a_addr))) return false;
@@ -234,8 +282,17 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
       return;
     }
 
+    // Package up features to be passed to target/subtarget
+    std::string FeaturesStr;
+    if (MAttrs.size()) {
+      SubtargetFeatures Features;
+      for (unsigned i = 0; i != MAttrs.size(); ++i)
+        Features.AddFeature(MAttrs[i]);
+      FeaturesStr = Features.getString();
+    }
+
     OwningPtr<const MCSubtargetInfo> STI(
-      TheTarget->createMCSubtargetInfo(TripleName, "", ""));
+      TheTarget->createMCSubtargetInfo(TripleName, MCPU, FeaturesStr));
 
     if (!STI) {
       errs() << "error: no subtarget info for target " << TripleName << "\n";
@@ -270,6 +327,15 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
       return;
     }
 
+    InstrItineraryData Itins;
+    if (PrintCosts) {
+      if (MCPU.empty()) {
+        errs() << "error: -print-costs requires -mcpu\n";
+        return;
+      }
+      Itins = STI->getInstrItineraryForCPU(MCPU);
+    }
+
     StringRef Bytes;
     if (error(i->getContents(Bytes))) break;
     StringRefMemoryObject memoryObject(Bytes);
@@ -296,6 +362,7 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
         continue;
 
       outs() << '\n' << Symbols[si].second << ":\n";
+      uint64_t NumInsts = 0, TotalSize = 0, TotalCycles = 0;
 
 #ifndef NDEBUG
         raw_ostream &DebugOut = DebugFlag ? dbgs() : nulls();
@@ -311,7 +378,11 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
           outs() << format("%8" PRIx64 ":\t", SectionAddr + Index);
           DumpBytes(StringRef(Bytes.data() + Index, Size));
           IP->printInst(&Inst, outs(), "");
+          if (PrintCosts)
+            PrintInstCost(Inst, Size, *MII, Itins, *AsmInfo, TotalCycles);
           outs() << "\n";
+          ++NumInsts;
+          TotalSize += Size;
         } else {
           errs() << ToolName << ": warning: invalid instruction encoding\n";
           if (Size == 0)
@@ -342,6 +413,11 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
           ++rel_cur;
         }
       }
+
+      if (PrintCosts)
+        outs() << AsmInfo->getCommentString() << " " << Symbols[si].second
+               << ": " << NumInsts << " instructions, " << TotalSize
+               << " bytes, " << TotalCycles << " issue cycles\n";
     }
   }
 }
@@ -1717,7 +1717,7 @@ static void EmitValidateOperandClass(AsmMatcherInfo &Info,
   for (std::map<Record*, ClassInfo*>::iterator
          it = Info.RegisterClasses.begin(), ie = Info.RegisterClasses.end();
        it != ie; ++it)
-    OS << "    case " << Info.Target.getName() << "::"
+    OS << "    case " << it->first->getValueAsString("Namespace") << "::"
        << it->first->getName() << ": OpKind = " << it->second->Name
        << "; break;\n";
   OS << "    }\n";
@@ -2370,7 +2370,7 @@ void AsmMatcherEmitter::run(raw_ostream &OS) {
     std::string LenMnemonic = char(II.Mnemonic.size()) + II.Mnemonic.str();
     OS << "  { " << StringTable.GetOrAddStringOffset(LenMnemonic, false)
        << " /* " << II.Mnemonic << " */, "
-       << Target.getName() << "::"
+       << Target.getInstNamespace() << "::"
        << II.getResultInst()->TheDef->getName() << ", "
        << II.ConversionFnKind << ", ";
 
@@ -22,6 +22,7 @@
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <algorithm>
 #include <vector>
 #include <map>
 #include <string>
@@ -1548,26 +1549,31 @@ void FixedLenDecoderEmitter::run(raw_ostream &o) {
     std::string DecoderNamespace = Def->getValueAsString("DecoderNamespace");
 
     if (Size) {
+      // Some targets follow the encoded instruction with data which is not
+      // part of Inst (such as the long immediates of ARCompact), and count it
+      // in the size. Such instructions are decoded at the width of Inst.
+      unsigned BitWidth = std::min(8 * Size,
+                                   getBitsField(*Def, "Inst").getNumBits());
       if (populateInstruction(*Inst, i, Operands)) {
-        OpcMap[std::make_pair(DecoderNamespace, Size)].push_back(i);
+        OpcMap[std::make_pair(DecoderNamespace, BitWidth)].push_back(i);
       }
     }
   }
 
-  std::set<unsigned> Sizes;
+  std::set<unsigned> BitWidths;
   for (std::map<std::pair<std::string, unsigned>,
                 std::vector<unsigned> >::const_iterator
        I = OpcMap.begin(), E = OpcMap.end(); I != E; ++I) {
     // If we haven't visited this instruction width before, emit the
     // helper method to extract fields.
-    if (!Sizes.count(I->first.second)) {
-      emitHelper(o, 8*I->first.second);
-      Sizes.insert(I->first.second);
+    if (!BitWidths.count(I->first.second)) {
+      emitHelper(o, I->first.second);
+      BitWidths.insert(I->first.second);
     }
 
     // Emit the decoder for this namespace+width combination.
     FilterChooser FC(NumberedInstructions, I->second, Operands,
-                     8*I->first.second, this);
+                     I->first.second, this);
     FC.emitTop(o, 0, I->first.first);
   }
 